@@ -0,0 +1,504 @@
+struct Resource {
+	char *fileName;
+	size_t offset;
+	size_t size;
+};
+struct Resource resources[] = {
+	{ .fileName = "resources/models/obj/osage-chan-lagtrain.png", .offset = 0, .size = 2829 },
+	{ .fileName = "resources/models/obj/osage-chan-lagtrain.qoi", .offset = 2830, .size = 2142 },
+	{ .fileName = "resources/shaders/gallery.fs", .offset = 4973, .size = 344 },
+	{ .fileName = "resources/shaders/gallery.vs", .offset = 5318, .size = 557 },
+};
+const size_t resources_count = 4;
+unsigned char bundle[] = {
+	0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 
+	0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x40, 
+	0x08, 0x06, 0x00, 0x00, 0x00, 0xAA, 0x69, 0x71, 0xDE, 0x00, 0x00, 0x0A, 
+	0xD4, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9C, 0xE5, 0x5B, 0x5B, 0x6F, 0x1C, 
+	0xD5, 0x1D, 0xFF, 0x9D, 0xCB, 0xCC, 0xEE, 0x7A, 0x6D, 0x12, 0x9E, 0xEA, 
+	0x4A, 0x5C, 0xD4, 0xD8, 0xEB, 0xD8, 0x06, 0xB5, 0x01, 0x04, 0x54, 0x50, 
+	0x48, 0x04, 0x51, 0x55, 0xF5, 0x9D, 0x8F, 0xD0, 0x96, 0xD0, 0x7E, 0x9A, 
+	0xB6, 0x52, 0xA1, 0xCD, 0x23, 0x6F, 0x7C, 0x81, 0xD2, 0x17, 0x20, 0x45, 
+	0x02, 0xA2, 0x42, 0x1F, 0x4A, 0x9C, 0x25, 0x04, 0x14, 0xD2, 0x2A, 0x75, 
+	0xA0, 0x69, 0x4B, 0xBC, 0xB7, 0x99, 0x73, 0xF9, 0xF7, 0x61, 0xF6, 0x7F, 
+	0x7C, 0x66, 0x2F, 0xDE, 0xB5, 0x77, 0x37, 0xB1, 0xD4, 0x9F, 0x64, 0x79, 
+	0x66, 0x76, 0x66, 0xCE, 0xF9, 0xDF, 0x2F, 0xE7, 0x8C, 0xC0, 0x04, 0x34, 
+	0x1A, 0x0D, 0x02, 0x00, 0x21, 0x04, 0x84, 0x10, 0x20, 0x22, 0x48, 0x29, 
+	0x41, 0x44, 0xE1, 0x1E, 0x3E, 0xE6, 0xDF, 0x63, 0x5C, 0xBB, 0x76, 0x4D, 
+	0x4C, 0x1A, 0x63, 0x16, 0x9C, 0x3E, 0x7D, 0x9A, 0x88, 0x08, 0xDE, 0x7B, 
+	0x5C, 0xBF, 0x7E, 0x5D, 0x00, 0xC0, 0xFA, 0xFA, 0x3A, 0x49, 0x29, 0x4B, 
+	0xD7, 0xC6, 0x41, 0x4E, 0x1A, 0x40, 0x4A, 0x19, 0x88, 0x67, 0xC4, 0xC7, 
+	0x31, 0xC1, 0xDE, 0xFB, 0x23, 0x90, 0x30, 0x1B, 0x9C, 0x73, 0xA5, 0xF9, 
+	0x00, 0xFB, 0x82, 0x50, 0x4A, 0x4D, 0x7C, 0x5E, 0x4F, 0xBA, 0xC1, 0x7B, 
+	0x3F, 0x92, 0x09, 0xDE, 0x7B, 0x28, 0xA5, 0x86, 0xA4, 0x3F, 0x4A, 0x0B, 
+	0x16, 0x89, 0x51, 0x12, 0xFE, 0xFC, 0xF3, 0xCF, 0xA7, 0xD6, 0xBA, 0x89, 
+	0x1A, 0x00, 0xEC, 0x4B, 0x99, 0x25, 0xCC, 0xDC, 0xF5, 0xDE, 0x0F, 0x71, 
+	0x9F, 0x31, 0xEE, 0xFA, 0x71, 0xC3, 0x44, 0x0D, 0x88, 0x11, 0xAB, 0x38, 
+	0x13, 0x4F, 0x44, 0xB8, 0xF2, 0xE7, 0xF7, 0x46, 0xDE, 0xFF, 0xD8, 0x0B, 
+	0x67, 0x67, 0x9B, 0xDD, 0x3D, 0xC0, 0x44, 0x0D, 0xD0, 0xBA, 0xE0, 0x51, 
+	0x2C, 0xFD, 0x58, 0xD5, 0xA5, 0x9C, 0x4A, 0x89, 0x8E, 0x2D, 0x26, 0xEA, 
+	0xE9, 0xC6, 0xC6, 0x06, 0x01, 0x85, 0x33, 0x74, 0xCE, 0x05, 0x82, 0x85, 
+	0x10, 0xF0, 0xDE, 0x8F, 0x95, 0x3E, 0x23, 0xF9, 0xCE, 0x77, 0xE7, 0x62, 
+	0x0B, 0x9B, 0x9B, 0x9B, 0x04, 0x00, 0x4A, 0x29, 0x38, 0xE7, 0xD0, 0x6C, 
+	0x36, 0x05, 0x00, 0xAC, 0xAD, 0xAD, 0xD1, 0x17, 0x5F, 0x7C, 0x31, 0x72, 
+	0x8C, 0x83, 0x7E, 0x63, 0x4C, 0x14, 0x5F, 0xEC, 0x49, 0x85, 0x10, 0x21, 
+	0x04, 0xDE, 0x4B, 0x8F, 0xBF, 0xBD, 0xBD, 0x4D, 0xAC, 0x89, 0xEC, 0x7F, 
+	0x1E, 0x7F, 0xFC, 0xF1, 0xB9, 0x78, 0x5A, 0xB1, 0xB9, 0xB9, 0x49, 0x2C, 
+	0x4D, 0x26, 0x8E, 0xFF, 0x78, 0x40, 0xAD, 0x35, 0xBC, 0xF7, 0x25, 0xCF, 
+	0x1F, 0x3B, 0x42, 0x60, 0xDF, 0xE9, 0xB1, 0x79, 0x00, 0x45, 0x88, 0xE2, 
+	0x7B, 0xF8, 0xFE, 0xF8, 0xDD, 0x42, 0x08, 0x7C, 0xF6, 0xD9, 0x67, 0x13, 
+	0x35, 0x64, 0x6B, 0x6B, 0x8B, 0xE2, 0xF7, 0xB3, 0x16, 0x5C, 0xBD, 0x7A, 
+	0x75, 0x66, 0xED, 0x92, 0xCE, 0x39, 0x58, 0x6B, 0x41, 0x44, 0xE1, 0xBF, 
+	0x94, 0x12, 0x4A, 0x29, 0x48, 0x29, 0x03, 0xF1, 0x83, 0x9E, 0x9F, 0x27, 
+	0xC1, 0x84, 0xC4, 0x4C, 0x8C, 0x99, 0xC5, 0xBF, 0x73, 0x28, 0x65, 0xE2, 
+	0xF9, 0xFD, 0x93, 0xB0, 0xBD, 0xBD, 0x4D, 0xF1, 0xB8, 0xFC, 0x0C, 0x11, 
+	0xCD, 0x45, 0x0B, 0x34, 0x13, 0x13, 0x3B, 0x37, 0x60, 0xDF, 0xE9, 0x8D, 
+	0xD2, 0x0C, 0x36, 0x81, 0xF8, 0x3A, 0x13, 0x1A, 0x27, 0x26, 0xEC, 0x33, 
+	0x78, 0xD2, 0xD6, 0xDA, 0xC0, 0x94, 0xF8, 0xF8, 0x20, 0x0C, 0x32, 0x9F, 
+	0x8F, 0x99, 0xD1, 0xB3, 0x42, 0xB2, 0x73, 0x63, 0x42, 0x9C, 0x73, 0x25, 
+	0x8F, 0xCF, 0xC4, 0xB0, 0x04, 0xB5, 0xD6, 0x25, 0x26, 0x31, 0x33, 0xF8, 
+	0x78, 0x54, 0xFC, 0xE7, 0x77, 0xF2, 0xB3, 0x71, 0x5A, 0x7D, 0x10, 0x36, 
+	0x36, 0x36, 0x28, 0x76, 0xBA, 0xAC, 0x99, 0xB1, 0x10, 0xB6, 0xB7, 0xB7, 
+	0x67, 0xD2, 0x02, 0xCD, 0x6A, 0x1C, 0xAB, 0xE3, 0xA0, 0x54, 0xFF, 0xF6, 
+	0xDE, 0x3B, 0x23, 0x1F, 0x7E, 0xEC, 0x85, 0xB3, 0x43, 0x84, 0xC4, 0xCF, 
+	0x0D, 0x32, 0x83, 0xDF, 0x1B, 0xAB, 0xF1, 0x34, 0x90, 0x52, 0xE2, 0xD3, 
+	0x4F, 0x3F, 0x15, 0x9B, 0x9B, 0x9B, 0x24, 0xA5, 0xC4, 0xCE, 0xCE, 0x8E, 
+	0xD8, 0xDA, 0xDA, 0x0A, 0x8E, 0x71, 0x16, 0xC8, 0xD8, 0x36, 0x79, 0xD2, 
+	0x52, 0x4A, 0xEC, 0xBC, 0x7F, 0x09, 0x42, 0x08, 0x7C, 0xFB, 0xED, 0xB7, 
+	0x78, 0xE4, 0xCC, 0x93, 0x78, 0xF8, 0x07, 0x4F, 0x84, 0x87, 0x1E, 0x7D, 
+	0xE2, 0x29, 0x3C, 0xF4, 0xFD, 0x33, 0xD8, 0xDB, 0xDB, 0x83, 0xF7, 0x1E, 
+	0x3B, 0xEF, 0x5F, 0x2A, 0x3D, 0x1F, 0x3B, 0xD0, 0xC1, 0x6B, 0x83, 0x6A, 
+	0x3C, 0x09, 0xDE, 0x7B, 0x5C, 0xB9, 0x72, 0x45, 0x00, 0x40, 0xB3, 0xD9, 
+	0x14, 0x3B, 0x3B, 0x3B, 0x02, 0x00, 0xAE, 0x5E, 0xBD, 0x2A, 0xA6, 0x8D, 
+	0x46, 0xEB, 0xEB, 0xEB, 0xB4, 0xBE, 0xBE, 0x1E, 0xB8, 0xDD, 0x68, 0x34, 
+	0xC2, 0xB9, 0x8C, 0xBD, 0x2B, 0xDB, 0x2F, 0x6B, 0x05, 0xE3, 0xC6, 0xCD, 
+	0x5B, 0xF8, 0xC5, 0xAB, 0xAF, 0x85, 0xF3, 0x9F, 0xFD, 0xFC, 0x55, 0xDC, 
+	0xFC, 0xC7, 0xEE, 0x50, 0x81, 0x14, 0x4B, 0x9F, 0xFF, 0xC7, 0xB5, 0xC4, 
+	0xA0, 0x2D, 0xF3, 0xE4, 0xC6, 0x4D, 0x3C, 0x8E, 0xF7, 0xA3, 0x70, 0xE5, 
+	0xCA, 0x15, 0x71, 0x10, 0x03, 0xD6, 0xD6, 0xD6, 0x68, 0x63, 0x63, 0x83, 
+	0x06, 0x35, 0x91, 0xFD, 0x52, 0xA3, 0xD1, 0x20, 0x11, 0xDF, 0xC0, 0x8E, 
+	0x85, 0x27, 0xC7, 0xE7, 0xD3, 0xA6, 0xBA, 0xA3, 0xEC, 0x3A, 0x3E, 0x8F, 
+	0x27, 0x12, 0xE7, 0x13, 0x07, 0x15, 0x2F, 0xB3, 0x24, 0x3A, 0x6B, 0x6B, 
+	0x6B, 0x14, 0x0B, 0x83, 0xC7, 0xE1, 0x12, 0x1F, 0x18, 0x91, 0x09, 0x9A, 
+	0xDB, 0xFF, 0x2C, 0x51, 0xF0, 0xA7, 0xBF, 0x7C, 0x82, 0x34, 0x49, 0x83, 
+	0xBA, 0xBE, 0x7C, 0xFE, 0xE5, 0x03, 0x63, 0x6F, 0xA3, 0xD1, 0xA0, 0x98, 
+	0xB8, 0xD8, 0x04, 0x84, 0x10, 0xF8, 0xF5, 0x6F, 0x7F, 0x03, 0x63, 0x0C, 
+	0xA4, 0x94, 0xC8, 0xF3, 0x1C, 0xCB, 0xCB, 0xCB, 0x90, 0x52, 0xA2, 0x56, 
+	0xAB, 0xC1, 0x7B, 0x8F, 0x1F, 0x3D, 0xF7, 0xFC, 0x81, 0xEF, 0xBF, 0x7C, 
+	0xF9, 0x32, 0x11, 0x08, 0xE4, 0x09, 0x4F, 0x7D, 0xEF, 0xD1, 0x70, 0xFD, 
+	0xA8, 0x19, 0xE7, 0x44, 0x2F, 0x92, 0xE8, 0xE4, 0x50, 0xF9, 0x7E, 0xDC, 
+	0x2C, 0x19, 0xEC, 0x1B, 0xF0, 0xF9, 0x83, 0x0F, 0x3E, 0x88, 0x24, 0x49, 
+	0x20, 0x84, 0x40, 0x9A, 0xA6, 0x20, 0x22, 0xE4, 0x79, 0x8E, 0x6E, 0xB7, 
+	0x3B, 0xF1, 0xFD, 0x4A, 0x6B, 0x24, 0x49, 0x82, 0x2C, 0xEB, 0x4D, 0x3D, 
+	0xA7, 0x03, 0xE7, 0x3B, 0x71, 0xC0, 0x7E, 0xD8, 0xB1, 0xCE, 0x22, 0xCB, 
+	0xB3, 0x89, 0x2F, 0x64, 0xFF, 0x31, 0xD8, 0x1B, 0x28, 0x85, 0x33, 0x51, 
+	0x48, 0x5C, 0x4A, 0x89, 0x5E, 0xAF, 0x17, 0x12, 0xB0, 0x41, 0xDF, 0x33, 
+	0x0A, 0xDE, 0x3B, 0x08, 0x00, 0xE4, 0xE7, 0xD3, 0x73, 0x98, 0xA8, 0x01, 
+	0xCE, 0x39, 0x18, 0x6B, 0x00, 0x00, 0x62, 0x72, 0xED, 0x34, 0x94, 0xDC, 
+	0x0C, 0x66, 0x80, 0x79, 0x9E, 0x17, 0xCC, 0xCC, 0x32, 0xE4, 0x79, 0x1E, 
+	0x1C, 0x52, 0x9E, 0xE5, 0x53, 0x85, 0x45, 0xEF, 0x3C, 0x72, 0x93, 0x83, 
+	0x30, 0x1F, 0x06, 0x88, 0x41, 0x9B, 0x3F, 0x2C, 0xFE, 0x7A, 0xF3, 0xEF, 
+	0x10, 0x10, 0x21, 0x95, 0x8E, 0x71, 0xEA, 0xD4, 0x29, 0x00, 0xC0, 0x97, 
+	0x5F, 0x7E, 0x09, 0xA5, 0x35, 0xBC, 0x77, 0xB0, 0xFD, 0x48, 0x53, 0xAF, 
+	0xD7, 0x0B, 0x95, 0x8F, 0x24, 0x29, 0x95, 0x84, 0x40, 0x39, 0x0A, 0x55, 
+	0xAB, 0x55, 0x00, 0x80, 0x31, 0x06, 0xCE, 0x39, 0x68, 0xAD, 0xF7, 0xB5, 
+	0x4A, 0x29, 0x60, 0x4C, 0x28, 0x7C, 0xF6, 0xD9, 0x67, 0xA7, 0xF2, 0x09, 
+	0x33, 0x67, 0x12, 0x02, 0x02, 0x49, 0x9A, 0x02, 0x02, 0xF0, 0x1D, 0x8F, 
+	0xBD, 0x56, 0x0B, 0xD5, 0x5A, 0x15, 0x4A, 0x48, 0xDC, 0xFE, 0xFA, 0x36, 
+	0x7C, 0x9F, 0xC0, 0x2C, 0xCF, 0x50, 0x5F, 0xAA, 0x43, 0x3A, 0x0B, 0x29, 
+	0x25, 0xEE, 0xDE, 0xBD, 0x5B, 0x68, 0x07, 0x01, 0x2B, 0x2B, 0x2B, 0x80, 
+	0x28, 0xD2, 0x63, 0xEF, 0x09, 0xB5, 0xA5, 0x1A, 0x40, 0x40, 0xAB, 0xD5, 
+	0x02, 0xD0, 0xAF, 0x1B, 0x94, 0x02, 0x79, 0x0F, 0x63, 0x0C, 0xAA, 0xD5, 
+	0x2A, 0x3C, 0x79, 0x38, 0xEF, 0x91, 0x26, 0x29, 0x7A, 0xDD, 0x1E, 0xBC, 
+	0xF7, 0x48, 0x2B, 0x15, 0xA8, 0xBE, 0x59, 0x4D, 0x0B, 0xFD, 0xCC, 0x4F, 
+	0x7E, 0x3A, 0xF6, 0xC7, 0x41, 0x89, 0x86, 0x87, 0xA2, 0x0C, 0xEC, 0x8D, 
+	0x37, 0xDE, 0x28, 0x18, 0xD1, 0xAF, 0x29, 0x2A, 0x95, 0x14, 0x27, 0x4E, 
+	0x9C, 0x40, 0xEB, 0xEE, 0x1E, 0xA4, 0x52, 0x90, 0x7D, 0x8B, 0x48, 0xD3, 
+	0x14, 0xD6, 0x5A, 0x18, 0x6B, 0x50, 0xA9, 0x54, 0x70, 0xF2, 0xE4, 0x49, 
+	0x74, 0x3A, 0x1D, 0x2C, 0xD7, 0xEB, 0xC1, 0x9E, 0x93, 0x24, 0x01, 0x08, 
+	0x00, 0x15, 0x3E, 0xA4, 0x5E, 0xAF, 0xA3, 0xDD, 0x6E, 0xA3, 0xBE, 0x5C, 
+	0x2F, 0x33, 0x5D, 0x49, 0xC0, 0x78, 0x08, 0xEA, 0x8F, 0xAB, 0x35, 0xA8, 
+	0x1F, 0x59, 0xC4, 0x21, 0x1B, 0x34, 0x33, 0xB7, 0x73, 0x84, 0x10, 0x21, 
+	0x98, 0x2A, 0xAD, 0x42, 0xF2, 0x33, 0x88, 0xA5, 0x5A, 0x0D, 0xCE, 0x5A, 
+	0xA4, 0xE9, 0x7E, 0x48, 0x4D, 0xD3, 0x14, 0xE4, 0x09, 0x52, 0x2B, 0x48, 
+	0xAD, 0x40, 0x84, 0xFE, 0x7F, 0x82, 0x4A, 0x34, 0xD0, 0x27, 0x4E, 0x4A, 
+	0x15, 0x98, 0x52, 0xAD, 0xD5, 0x40, 0xCE, 0xC3, 0x93, 0x07, 0xFA, 0xBE, 
+	0xC5, 0x7B, 0x07, 0x9D, 0x24, 0xF0, 0xCE, 0x41, 0x08, 0x1C, 0x2E, 0x6A, 
+	0xCD, 0xCA, 0x00, 0x29, 0x25, 0x94, 0xEC, 0x77, 0x87, 0x85, 0x40, 0x6D, 
+	0x69, 0xA9, 0x54, 0x06, 0x03, 0xC0, 0xCA, 0x89, 0x07, 0x00, 0x21, 0x90, 
+	0x56, 0xD2, 0x90, 0x19, 0x02, 0x40, 0xBB, 0xDD, 0x86, 0xE9, 0x6B, 0x19, 
+	0x11, 0x41, 0xE9, 0xFD, 0xE7, 0x9C, 0xB1, 0x30, 0xC6, 0x00, 0x44, 0x00, 
+	0x11, 0x88, 0x0B, 0xAE, 0x3E, 0x73, 0x93, 0x24, 0x01, 0x50, 0x8C, 0x29, 
+	0x95, 0x0A, 0x84, 0x7B, 0xE7, 0x0F, 0x55, 0x25, 0xCE, 0xCC, 0x00, 0x12, 
+	0x00, 0x61, 0xBF, 0xC0, 0x49, 0xFA, 0xE6, 0xB1, 0x72, 0xE2, 0x81, 0x72, 
+	0x16, 0x08, 0x51, 0x4C, 0x36, 0x92, 0x4E, 0xAD, 0xAF, 0x15, 0x43, 0xEF, 
+	0x04, 0x41, 0x48, 0x01, 0x80, 0x90, 0x24, 0x49, 0x28, 0xA2, 0x92, 0x24, 
+	0x81, 0xB5, 0xB6, 0xAF, 0x75, 0x02, 0xE4, 0xFB, 0xB9, 0x05, 0x11, 0x4C, 
+	0x6E, 0x8E, 0x54, 0x1E, 0xCF, 0x6E, 0x02, 0xD1, 0xB1, 0x77, 0xBE, 0x54, 
+	0x4E, 0xC7, 0xA0, 0x42, 0x87, 0x43, 0xA3, 0x24, 0xCE, 0x12, 0xBD, 0x1B, 
+	0x68, 0xAF, 0x13, 0xA7, 0xD0, 0xFD, 0x6B, 0x7D, 0xC6, 0x19, 0x6B, 0xA0, 
+	0xB4, 0x02, 0x81, 0xE0, 0xB9, 0x84, 0x8F, 0x1A, 0x2F, 0x00, 0xEE, 0x87, 
+	0x0F, 0x90, 0x20, 0xBF, 0x4F, 0x98, 0xB1, 0x16, 0xE4, 0xCB, 0x2D, 0xB5, 
+	0x38, 0x29, 0x22, 0x22, 0x70, 0x08, 0x77, 0xCE, 0xF5, 0x25, 0xE9, 0xE1, 
+	0xCC, 0xBE, 0x26, 0xA8, 0x44, 0x17, 0xE1, 0x30, 0xD2, 0x0E, 0xEF, 0x3D, 
+	0x9C, 0x75, 0xB0, 0xB6, 0x08, 0xA3, 0x79, 0x96, 0x17, 0x8C, 0x26, 0xC0, 
+	0x3A, 0x07, 0x35, 0xD0, 0xBD, 0x9E, 0x16, 0xFA, 0xF7, 0x17, 0xFF, 0x50, 
+	0xBA, 0x50, 0x0C, 0x64, 0x0B, 0xCF, 0x4A, 0x84, 0xF6, 0xDD, 0xD6, 0xD0, 
+	0x43, 0x69, 0x25, 0x45, 0x75, 0xA9, 0xD6, 0x27, 0xD0, 0x03, 0x42, 0x81, 
+	0x9C, 0x87, 0x73, 0x1E, 0x59, 0x96, 0x21, 0x4D, 0xD2, 0x52, 0x29, 0xCC, 
+	0x55, 0xA6, 0x35, 0x16, 0x1E, 0x04, 0x4F, 0xFB, 0x76, 0xCA, 0xD2, 0x53, 
+	0x89, 0x86, 0x33, 0xB6, 0x70, 0x7E, 0x40, 0x10, 0x7E, 0xAF, 0xD7, 0x43, 
+	0x5D, 0x15, 0xCE, 0xB5, 0x52, 0xA9, 0xC0, 0x58, 0x5B, 0x98, 0x81, 0x94, 
+	0x85, 0xF4, 0xA4, 0x00, 0x3C, 0x05, 0x3F, 0x70, 0xD8, 0x82, 0x20, 0xC4, 
+	0x33, 0x93, 0xE5, 0x80, 0x2C, 0x54, 0xED, 0xF5, 0xDF, 0xBD, 0x0E, 0x00, 
+	0x78, 0xE5, 0x95, 0x57, 0xB0, 0x54, 0x5B, 0x3A, 0xF0, 0x05, 0x6C, 0xE5, 
+	0x52, 0x4A, 0x58, 0x63, 0x43, 0x5A, 0xEB, 0xAD, 0x03, 0x54, 0xE1, 0xA4, 
+	0x84, 0x10, 0xE8, 0x76, 0xBB, 0x05, 0x53, 0x64, 0xC1, 0x10, 0x6B, 0x2C, 
+	0x7A, 0x59, 0x0F, 0xBA, 0xAE, 0xFB, 0xF6, 0xBE, 0xCF, 0x84, 0x50, 0x3A, 
+	0xF7, 0x23, 0x82, 0x73, 0x0E, 0xC6, 0x18, 0x24, 0x49, 0x02, 0x67, 0x2D, 
+	0xBC, 0x13, 0xC1, 0x0F, 0x38, 0x63, 0x83, 0xD9, 0x49, 0x29, 0x21, 0x92, 
+	0xE1, 0x72, 0x7E, 0x2A, 0x06, 0x48, 0xAD, 0xD0, 0xED, 0x76, 0xD1, 0xBA, 
+	0xBB, 0x87, 0xD7, 0x7E, 0xF5, 0x4B, 0x00, 0xC0, 0x37, 0xB7, 0xBF, 0x46, 
+	0x2F, 0xEB, 0xA1, 0x92, 0x56, 0x86, 0xD6, 0x05, 0xAD, 0xB5, 0x21, 0x91, 
+	0x11, 0x69, 0x0A, 0x6B, 0x1D, 0xA4, 0x92, 0xA8, 0x24, 0x29, 0x3C, 0xF9, 
+	0x50, 0xE4, 0x98, 0xDC, 0x20, 0xCB, 0x33, 0x58, 0x63, 0x40, 0x28, 0x3C, 
+	0x7C, 0x96, 0x65, 0x48, 0xD3, 0x34, 0x10, 0xC4, 0x8E, 0x33, 0x98, 0x81, 
+	0x40, 0x48, 0x6E, 0xB4, 0xD6, 0xC1, 0xF1, 0xF1, 0x98, 0x71, 0x67, 0xD8, 
+	0x18, 0x53, 0x6A, 0xD1, 0xE5, 0x59, 0x8E, 0xC3, 0x74, 0x8A, 0xF4, 0x7F, 
+	0xFF, 0xFD, 0x1F, 0x08, 0x29, 0x8A, 0x12, 0x55, 0xC8, 0x40, 0x78, 0x60, 
+	0x8C, 0x94, 0xC8, 0x4D, 0x0E, 0xAD, 0x74, 0x50, 0x57, 0x63, 0x0C, 0x20, 
+	0x04, 0xAC, 0x31, 0x58, 0x5A, 0x5A, 0x82, 0xB5, 0x85, 0x14, 0xC8, 0x7B, 
+	0x64, 0x79, 0x0E, 0x00, 0x20, 0xE7, 0xD1, 0xCD, 0x7A, 0x20, 0x4F, 0x70, 
+	0xDE, 0x41, 0x09, 0x09, 0x25, 0x25, 0xA4, 0x52, 0xC8, 0x7D, 0x8E, 0x4E, 
+	0xA7, 0x83, 0x95, 0xE5, 0x22, 0x03, 0xEC, 0x76, 0xBB, 0x21, 0xE5, 0xE5, 
+	0x2C, 0x8E, 0xA5, 0x78, 0xE6, 0x91, 0x87, 0xA6, 0x26, 0xE6, 0x28, 0x98, 
+	0xFB, 0x0A, 0x26, 0xAF, 0x24, 0x01, 0xFB, 0x0D, 0x15, 0xC6, 0xA2, 0xF7, 
+	0x0A, 0x1C, 0x05, 0x0B, 0x9B, 0x50, 0xCC, 0x08, 0xE0, 0x78, 0x12, 0x0F, 
+	0x2C, 0x88, 0x01, 0x83, 0xC4, 0x33, 0x8E, 0x2B, 0x13, 0xFE, 0xAF, 0x31, 
+	0xB3, 0x44, 0x76, 0x77, 0x77, 0x4B, 0xD2, 0xEE, 0x74, 0x3A, 0x00, 0x80, 
+	0x1B, 0x37, 0xBF, 0xC2, 0xC3, 0x67, 0x1F, 0xAA, 0x36, 0x44, 0x23, 0xFB, 
+	0xE3, 0xDB, 0x6F, 0xD3, 0x46, 0xA3, 0x81, 0xA5, 0xA5, 0xD1, 0x21, 0xF5, 
+	0xC5, 0x17, 0x5F, 0x0C, 0x29, 0x72, 0xAD, 0x56, 0x43, 0xB7, 0xDB, 0x85, 
+	0xF7, 0x1E, 0x97, 0x2E, 0x5D, 0xC2, 0xEA, 0xEA, 0xEA, 0x42, 0xB5, 0x66, 
+	0xE6, 0x7E, 0xC0, 0xA8, 0x09, 0xBE, 0x43, 0xEF, 0x68, 0x73, 0x3D, 0x37, 
+	0xEB, 0x58, 0xCF, 0x01, 0xA0, 0xDD, 0x6E, 0xE1, 0xD4, 0xA9, 0x53, 0x23, 
+	0x09, 0xD9, 0xDD, 0xDD, 0x25, 0x5E, 0x7F, 0x7C, 0xF7, 0xDD, 0x77, 0x01, 
+	0x00, 0x67, 0xCF, 0x9E, 0xBD, 0x67, 0xAB, 0xCF, 0x0B, 0xD9, 0xDD, 0x70, 
+	0x0E, 0xE7, 0x44, 0xA7, 0xDD, 0x81, 0x10, 0x82, 0x00, 0xA0, 0xDB, 0x19, 
+	0xDF, 0xEC, 0x7C, 0xE9, 0xA5, 0x97, 0x8A, 0x89, 0x48, 0x89, 0xD5, 0xD5, 
+	0x55, 0xB1, 0xBA, 0xBA, 0x2A, 0x94, 0x52, 0x50, 0x4A, 0xE1, 0xDC, 0xB9, 
+	0x73, 0x8B, 0x98, 0x5E, 0x09, 0xB3, 0xAF, 0x2D, 0x8D, 0x86, 0xE3, 0x6E, 
+	0x0E, 0x00, 0x9C, 0x3F, 0x7F, 0x7E, 0xEC, 0x8D, 0x71, 0xCD, 0xC0, 0xE0, 
+	0x04, 0xE8, 0x5E, 0x6C, 0xB6, 0x5A, 0x08, 0x03, 0x84, 0x10, 0x7E, 0x77, 
+	0x77, 0x37, 0x9C, 0x1F, 0x64, 0xC7, 0x9C, 0xC5, 0xC5, 0x6B, 0xFD, 0xCD, 
+	0x66, 0x53, 0xF0, 0x8E, 0x90, 0x45, 0x63, 0x61, 0x1B, 0x7C, 0xA6, 0x75, 
+	0x5E, 0x9C, 0xEB, 0x9F, 0x3E, 0x7D, 0x3A, 0x10, 0xBC, 0xBD, 0xBD, 0x4D, 
+	0xE3, 0x56, 0x9A, 0xE7, 0x8D, 0x45, 0x99, 0xC0, 0xD4, 0x18, 0x47, 0xE8, 
+	0xB8, 0xD6, 0xDA, 0xBC, 0x71, 0xDF, 0x19, 0xC0, 0xF5, 0xC5, 0xA0, 0xBD, 
+	0xF3, 0xBE, 0x85, 0x45, 0xE3, 0xBE, 0xEF, 0x71, 0x63, 0x22, 0x63, 0x69, 
+	0xC7, 0x6B, 0x89, 0x8B, 0xC6, 0x7D, 0x67, 0x40, 0xB3, 0xD9, 0x14, 0x83, 
+	0xED, 0x77, 0x66, 0xCA, 0x41, 0x4B, 0xE3, 0xF3, 0xC2, 0x48, 0x13, 0xF8, 
+	0xF0, 0xF2, 0x47, 0x04, 0x00, 0x3F, 0x7C, 0x66, 0xBA, 0xD5, 0x95, 0x59, 
+	0x21, 0x84, 0x28, 0x11, 0x1B, 0x47, 0x81, 0x8F, 0x3F, 0xFE, 0x98, 0x8C, 
+	0x31, 0xA8, 0xD5, 0x6A, 0x45, 0x7F, 0xC1, 0x18, 0x68, 0xAD, 0x83, 0x89, 
+	0xF0, 0x86, 0x0E, 0xEE, 0x19, 0xF0, 0xF2, 0xFE, 0xD3, 0x4F, 0x3F, 0x7D, 
+	0xF4, 0x95, 0xA1, 0x9B, 0x37, 0xBE, 0xAA, 0xCC, 0x87, 0xB4, 0xE9, 0xD0, 
+	0x6C, 0x36, 0xC5, 0xD6, 0xD6, 0x16, 0x71, 0x28, 0x8C, 0x8F, 0xD9, 0x47, 
+	0x64, 0x59, 0x16, 0x08, 0x36, 0xA6, 0x58, 0xAB, 0x4C, 0xD3, 0xB4, 0xE8, 
+	0x0F, 0xE6, 0x79, 0xD8, 0x92, 0xC7, 0xBD, 0x89, 0x69, 0x31, 0x77, 0x09, 
+	0x0F, 0xAE, 0x35, 0x7E, 0x78, 0xED, 0x7A, 0x90, 0x90, 0xD6, 0x1A, 0xCF, 
+	0x3F, 0x7F, 0xF0, 0xFA, 0xFF, 0x47, 0x1F, 0x15, 0xDA, 0x47, 0x34, 0x9F, 
+	0xF5, 0xFF, 0x49, 0x58, 0xB8, 0x0F, 0x88, 0x9B, 0x22, 0xE3, 0x96, 0xDA, 
+	0x06, 0x51, 0xAD, 0x56, 0xEF, 0xD9, 0x6E, 0xF3, 0x85, 0x33, 0x20, 0xCF, 
+	0x73, 0x28, 0xA5, 0x90, 0x24, 0xC9, 0x54, 0xFB, 0x02, 0xEF, 0x35, 0x16, 
+	0x9E, 0x07, 0x78, 0xEF, 0xD1, 0xEB, 0xF5, 0x86, 0x3E, 0xB3, 0x39, 0x08, 
+	0x87, 0x59, 0xDD, 0x9D, 0x15, 0x33, 0xEB, 0xD9, 0xAC, 0xFB, 0x0B, 0x3E, 
+	0xB9, 0x71, 0x73, 0xE8, 0x5A, 0xB5, 0x5A, 0x2D, 0xD6, 0x03, 0x56, 0x96, 
+	0x43, 0xA7, 0xB8, 0xDD, 0x6E, 0x97, 0x34, 0x68, 0xDA, 0xF5, 0xFF, 0x49, 
+	0xB8, 0xEF, 0x79, 0x00, 0x50, 0x10, 0x5C, 0x2C, 0x76, 0x96, 0xC1, 0x0B, 
+	0x25, 0xBD, 0x5E, 0x0F, 0x0F, 0x9C, 0x3C, 0x01, 0x29, 0x65, 0xE8, 0x1E, 
+	0xCF, 0x0B, 0x33, 0x9B, 0xC0, 0x93, 0xE7, 0x7F, 0x3C, 0xFC, 0xD2, 0x29, 
+	0xFB, 0xF2, 0xD6, 0x5A, 0x5C, 0xBC, 0x78, 0x71, 0xE2, 0x7D, 0xF5, 0x95, 
+	0x65, 0x00, 0xC3, 0xDB, 0x6F, 0xE6, 0x81, 0x63, 0xA1, 0x01, 0xF1, 0x8A, 
+	0x31, 0x4B, 0x98, 0xFF, 0x07, 0x13, 0xD8, 0x6B, 0x0D, 0xDD, 0x3B, 0x97, 
+	0xB1, 0xE7, 0xFA, 0xB6, 0x23, 0x62, 0xB0, 0xEA, 0xE3, 0x10, 0xD8, 0xEB, 
+	0xF5, 0xC2, 0x72, 0xD9, 0xB8, 0x7B, 0x67, 0xC5, 0xB1, 0x60, 0x40, 0x1C, 
+	0xF3, 0x39, 0x02, 0xF4, 0x7A, 0xBD, 0x52, 0x46, 0xB7, 0xA8, 0xEE, 0xD0, 
+	0xB1, 0x60, 0xC0, 0xE0, 0xC7, 0x57, 0x44, 0x54, 0x32, 0x01, 0x95, 0x68, 
+	0xD4, 0x6A, 0xB5, 0x85, 0x8C, 0x7D, 0x2C, 0x18, 0x00, 0x8C, 0x56, 0xED, 
+	0xD8, 0xE9, 0xB1, 0x66, 0x70, 0x1D, 0x30, 0x2F, 0xCC, 0x1C, 0x05, 0xDE, 
+	0x7C, 0xF3, 0xCD, 0xD2, 0x79, 0xBB, 0xDB, 0x09, 0xC7, 0x36, 0x37, 0x43, 
+	0x29, 0xED, 0x24, 0x1B, 0x66, 0xB5, 0x67, 0x82, 0x07, 0x7D, 0x40, 0x92, 
+	0x24, 0x73, 0x6D, 0x94, 0xCC, 0x25, 0x13, 0xE4, 0x49, 0xDE, 0xBA, 0x75, 
+	0x0B, 0xD6, 0x5A, 0xBC, 0xF5, 0xD6, 0x5B, 0x00, 0x80, 0x0B, 0x17, 0x2E, 
+	0x84, 0x8D, 0xD1, 0xF1, 0x47, 0xD7, 0x83, 0x9F, 0xE7, 0x30, 0x41, 0x9C, 
+	0x0B, 0xB0, 0xFD, 0xD7, 0xEB, 0x75, 0x38, 0x63, 0x87, 0xA4, 0x3F, 0x2A, 
+	0x67, 0x38, 0x2A, 0x66, 0xEE, 0x07, 0x64, 0x59, 0x86, 0xA4, 0xBF, 0x83, 
+	0xAB, 0x5A, 0xAD, 0xA2, 0xD5, 0x6A, 0x85, 0xFD, 0x05, 0x77, 0xBE, 0xF9, 
+	0x17, 0xD2, 0x34, 0x85, 0xD6, 0x1A, 0x95, 0x4A, 0x05, 0xAD, 0x56, 0xAB, 
+	0xF4, 0x41, 0x16, 0x80, 0xB0, 0xEE, 0xCF, 0x60, 0xA6, 0x68, 0xAD, 0x91, 
+	0x65, 0x59, 0xE9, 0x1A, 0x30, 0x5C, 0x50, 0x7D, 0xF0, 0xC1, 0x07, 0xA4, 
+	0xFA, 0x3B, 0x48, 0x9C, 0x73, 0xC5, 0x2E, 0x12, 0x63, 0x42, 0x69, 0x5C, 
+	0x6C, 0xAC, 0xCE, 0x8A, 0x8D, 0x94, 0xFD, 0x3D, 0x0B, 0x69, 0x9A, 0xE2, 
+	0xCC, 0x99, 0x33, 0x62, 0x2C, 0x03, 0x0E, 0xDB, 0x08, 0xB9, 0x73, 0xE7, 
+	0x4E, 0xA9, 0x89, 0x19, 0xEF, 0x2F, 0x60, 0xA9, 0xF1, 0x24, 0x94, 0x52, 
+	0x30, 0xC6, 0x04, 0x0D, 0x78, 0x6E, 0x73, 0xE3, 0x30, 0x43, 0x0D, 0x21, 
+	0x49, 0x12, 0x68, 0xAD, 0x61, 0x8C, 0x29, 0x7D, 0xB7, 0xA4, 0x75, 0x91, 
+	0x41, 0x26, 0x49, 0x82, 0x34, 0x4D, 0xC3, 0x5C, 0xB8, 0x6F, 0xC0, 0xF8, 
+	0x1F, 0x2C, 0xC4, 0xDF, 0x37, 0x9A, 0x11, 0x89, 0x52, 0x00, 0x00, 0x00, 
+	0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82, 0x00, 0x71, 0x6F, 
+	0x69, 0x66, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x40, 0x04, 0x00, 
+	0x00, 0xC6, 0xFF, 0x25, 0x25, 0x25, 0xFF, 0xC0, 0x7F, 0x7F, 0x2F, 0xA2, 
+	0x88, 0x3E, 0xC1, 0x2F, 0xC0, 0x3E, 0x2F, 0xC2, 0x00, 0xD6, 0x3E, 0x2F, 
+	0x40, 0x00, 0xC0, 0x11, 0x2F, 0x11, 0x00, 0xCE, 0x3E, 0x2F, 0x3E, 0xC0, 
+	0x2F, 0xA3, 0x88, 0x3E, 0xC0, 0x2F, 0xC1, 0x20, 0x2F, 0xC2, 0x00, 0xD6, 
+	0x11, 0x3E, 0x11, 0x00, 0xC0, 0x20, 0xC0, 0x3E, 0x00, 0xCE, 0x20, 0x3E, 
+	0x0D, 0x1C, 0xC1, 0x20, 0x0D, 0x2F, 0xC0, 0x3E, 0x20, 0x3E, 0x2F, 0xC1, 
+	0x00, 0xEE, 0x20, 0x2F, 0x0D, 0x3E, 0x1C, 0x0D, 0xC0, 0x2F, 0x3E, 0x2F, 
+	0x3E, 0x20, 0x3E, 0x2F, 0x3E, 0x2F, 0x00, 0xEE, 0x20, 0x2F, 0x0D, 0x20, 
+	0x3E, 0xC0, 0x20, 0x2F, 0xC0, 0xFE, 0xFB, 0xE9, 0xE7, 0xC4, 0x2F, 0x00, 
+	0xEE, 0x1C, 0x2F, 0xC0, 0x20, 0x2F, 0xC1, 0x20, 0x0D, 0x04, 0xC4, 0x2F, 
+	0x00, 0xEE, 0x2F, 0xC0, 0x0D, 0x20, 0x3E, 0xC0, 0x0D, 0x2F, 0x04, 0xC6, 
+	0x00, 0xD0, 0x0D, 0xC0, 0xA3, 0x88, 0x0D, 0x00, 0xC0, 0xFF, 0x23, 0x23, 
+	0x23, 0xFF, 0x00, 0xC4, 0x02, 0x00, 0xCE, 0x1C, 0x2F, 0x0D, 0x2F, 0x1C, 
+	0x2F, 0xC1, 0x04, 0xC6, 0x00, 0xCF, 0xFF, 0x2A, 0x2A, 0x2A, 0xFF, 0xA2, 
+	0x88, 0x0D, 0x2B, 0x3A, 0x09, 0x00, 0x02, 0x00, 0xC4, 0x02, 0x00, 0xC6, 
+	0x0D, 0x1C, 0x3E, 0x1C, 0x0D, 0x3E, 0x2F, 0xC0, 0x20, 0x1C, 0x3E, 0x20, 
+	0x0D, 0x3E, 0x2F, 0x1C, 0x3E, 0xC0, 0x0D, 0xC0, 0x3E, 0x0D, 0xC0, 0x20, 
+	0x0D, 0x2F, 0x20, 0x0D, 0x3E, 0x2F, 0xC0, 0x3E, 0x00, 0xC7, 0x1C, 0x2B, 
+	0xC0, 0x1C, 0x09, 0x1C, 0x00, 0xCF, 0x20, 0xC0, 0x2F, 0x20, 0x3E, 0x1C, 
+	0xC0, 0x0D, 0x1C, 0x3E, 0x2F, 0x0D, 0x2F, 0x0D, 0x1C, 0x2F, 0x3E, 0x0D, 
+	0x1C, 0x2F, 0x1C, 0x2F, 0xC0, 0x0D, 0xC0, 0x3E, 0xC0, 0x1C, 0x2F, 0xC0, 
+	0x1C, 0xC0, 0x00, 0xC6, 0x2B, 0x09, 0x0D, 0x3A, 0xC0, 0x09, 0x0D, 0x09, 
+	0x00, 0xCE, 0x2F, 0x1C, 0x0D, 0x3E, 0x0D, 0x1C, 0x3E, 0xC0, 0x2F, 0x0D, 
+	0x2F, 0x3E, 0x20, 0x3E, 0x2F, 0x0D, 0x3E, 0xC0, 0x0D, 0x3E, 0x2F, 0x3E, 
+	0xC0, 0x20, 0x3E, 0x1C, 0xC0, 0x20, 0x0D, 0xC0, 0x20, 0x0D, 0x00, 0xC6, 
+	0x0D, 0x1C, 0x3A, 0x1C, 0x0D, 0x3A, 0x2B, 0xC0, 0x00, 0xCE, 0x0D, 0x2F, 
+	0x3E, 0x2F, 0x20, 0x3E, 0xC0, 0x2F, 0x3E, 0x0D, 0xC1, 0x1C, 0x0D, 0x2F, 
+	0xC1, 0x20, 0x2F, 0xC0, 0x3E, 0xC1, 0x20, 0x3E, 0x2F, 0x3E, 0x1C, 0xC1, 
+	0x2F, 0x3E, 0x00, 0xC5, 0x2F, 0x2B, 0x1C, 0x09, 0x3A, 0xC0, 0x2B, 0x1C, 
+	0x0D, 0x2B, 0x00, 0xCD, 0x20, 0xC0, 0x0D, 0x3E, 0x2F, 0xC0, 0x20, 0xC0, 
+	0x3E, 0x04, 0xC4, 0x2F, 0x3E, 0x20, 0x2F, 0xC2, 0x3E, 0x2F, 0x3E, 0x2F, 
+	0x3E, 0x0D, 0x3E, 0x1C, 0x2F, 0xC0, 0x00, 0xC5, 0x2F, 0x2B, 0x3A, 0x00, 
+	0x0D, 0x2B, 0x00, 0x1C, 0x09, 0xC0, 0x00, 0xCD, 0x3E, 0x2F, 0x3E, 0x0D, 
+	0x3E, 0x0D, 0x04, 0x2F, 0x92, 0x88, 0x7F, 0x1D, 0x04, 0xC0, 0xFE, 0x1A, 
+	0x1A, 0x1A, 0x9D, 0x88, 0x2C, 0x20, 0x04, 0x20, 0x3E, 0xC0, 0x20, 0x3E, 
+	0x20, 0x0D, 0x3E, 0x2F, 0x0D, 0x20, 0x0D, 0x1C, 0x0D, 0x00, 0xC5, 0x2F, 
+	0x0D, 0x00, 0xC4, 0x3A, 0x2B, 0x00, 0xC6, 0x11, 0xC0, 0x00, 0xC0, 0x20, 
+	0x11, 0x00, 0x0D, 0x2F, 0xC0, 0x20, 0x0D, 0x20, 0x04, 0x2F, 0x1D, 0x83, 
+	0x6C, 0xFE, 0x7F, 0x80, 0x82, 0x04, 0xC0, 0x00, 0xFE, 0xF9, 0xFB, 0xFF, 
+	0x3B, 0x20, 0x04, 0x2F, 0xC0, 0x3E, 0x2F, 0x3E, 0x2F, 0xC0, 0x1C, 0x3E, 
+	0xC0, 0x0D, 0x2F, 0x0D, 0xC0, 0x11, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xC4, 
+	0x02, 0x00, 0xC6, 0x0D, 0x00, 0xC4, 0x02, 0x2F, 0x20, 0x11, 0x00, 0xC0, 
+	0x3E, 0x2F, 0x20, 0x2F, 0x3E, 0xC0, 0x1C, 0x3E, 0x2F, 0xC0, 0x0D, 0x2F, 
+	0x04, 0xC4, 0x2F, 0xC2, 0x3E, 0x2F, 0xC2, 0x20, 0xC1, 0x2F, 0xC1, 0x0D, 
+	0x3E, 0x20, 0x00, 0xC5, 0x02, 0x00, 0xC4, 0x02, 0x00, 0xC5, 0x02, 0x11, 
+	0xC0, 0x20, 0x00, 0xC0, 0x20, 0xC1, 0x00, 0xC2, 0x04, 0xC2, 0xFE, 0xB5, 
+	0xB5, 0xB5, 0xA5, 0x99, 0xA2, 0x88, 0xC0, 0x00, 0xC6, 0x20, 0x3E, 0x2F, 
+	0x11, 0x20, 0x2F, 0x20, 0x2F, 0xFE, 0xB8, 0xBA, 0xB9, 0x9B, 0x88, 0xA2, 
+	0x88, 0x9A, 0x88, 0xAC, 0x88, 0xA2, 0x88, 0xA9, 0x88, 0x40, 0x00, 0xC6, 
+	0xFF, 0xCA, 0xCA, 0xCA, 0xFF, 0x59, 0x51, 0x04, 0xC1, 0x00, 0xD0, 0x04, 
+	0xC2, 0xFE, 0xBA, 0xB9, 0xBA, 0xA3, 0x88, 0xC1, 0x00, 0xC6, 0x3E, 0x2F, 
+	0xC0, 0x55, 0xC0, 0x2F, 0x11, 0x2F, 0x0E, 0x02, 0xA5, 0x88, 0x7F, 0xA6, 
+	0x88, 0x55, 0x0D, 0x19, 0x00, 0xC6, 0xFF, 0xCD, 0xCE, 0xCE, 0xFF, 0xA5, 
+	0x88, 0x99, 0x87, 0xFE, 0xFB, 0xE9, 0xE7, 0xC1, 0x00, 0xD0, 0x04, 0xC2, 
+	0x03, 0x55, 0x9E, 0x77, 0x9D, 0x88, 0x00, 0xC6, 0x11, 0x2F, 0x20, 0x2F, 
+	0x11, 0x2F, 0xC1, 0xFE, 0xB9, 0xBB, 0xBA, 0xAC, 0x99, 0xAD, 0x77, 0x9A, 
+	0x88, 0x9C, 0x88, 0xA3, 0x88, 0x3E, 0x92, 0x88, 0x00, 0xC6, 0xFF, 0xCB, 
+	0xCC, 0xCB, 0xFF, 0xA7, 0x99, 0x0B, 0x04, 0xC1, 0x00, 0xD0, 0x04, 0xC2, 
+	0x16, 0x10, 0xC0, 0x7B, 0x00, 0xC6, 0xFF, 0x27, 0x27, 0x27, 0xFF, 0xC0, 
+	0x2F, 0xC1, 0x3E, 0x2F, 0xC0, 0xFE, 0xB3, 0xB5, 0xB4, 0xAF, 0x88, 0x2B, 
+	0x9A, 0x88, 0xA2, 0x88, 0xA6, 0x88, 0x97, 0x99, 0x1D, 0x00, 0xC6, 0xFF, 
+	0xC9, 0xC9, 0xC9, 0xFF, 0xA5, 0x77, 0x01, 0x04, 0xC1, 0x00, 0xCC, 0x04, 
+	0xCE, 0xFE, 0xCA, 0xCB, 0xCA, 0x7B, 0x0B, 0x9C, 0x88, 0xC2, 0xFE, 0xE8, 
+	0xE8, 0xE8, 0xC0, 0x0F, 0xA4, 0x78, 0x9E, 0x87, 0x9D, 0x78, 0x02, 0x27, 
+	0x97, 0x88, 0x0F, 0xC1, 0xA3, 0x77, 0x3C, 0x0F, 0xC1, 0xA8, 0x88, 0xC0, 
+	0x3C, 0x0F, 0x0B, 0x3C, 0xC0, 0xA3, 0x78, 0x1A, 0x3C, 0xC3, 0x00, 0xC8, 
+	0x04, 0xCE, 0x1A, 0xA6, 0x78, 0x36, 0x2D, 0x94, 0x78, 0x33, 0x0F, 0xAC, 
+	0x77, 0x41, 0x0F, 0x24, 0xAA, 0x99, 0x9D, 0x77, 0x2B, 0x96, 0x88, 0x33, 
+	0x76, 0xAD, 0x88, 0x39, 0x3D, 0x26, 0xA7, 0x87, 0x66, 0x0F, 0x07, 0x34, 
+	0x5A, 0x50, 0x0B, 0x34, 0x44, 0x3A, 0x08, 0x0B, 0x2D, 0xA7, 0x78, 0x34, 
+	0x3C, 0x00, 0xC8, 0xFF, 0x31, 0x31, 0x31, 0xFF, 0xC5, 0x9C, 0x88, 0xC4, 
+	0x14, 0xC1, 0x0B, 0x31, 0xA2, 0x77, 0x1A, 0x98, 0x77, 0xB1, 0x78, 0x0F, 
+	0xAF, 0x67, 0xC0, 0x0F, 0xA4, 0x67, 0x7B, 0x02, 0x2B, 0x05, 0x2F, 0xAB, 
+	0x98, 0x03, 0xC0, 0x6E, 0x03, 0xC0, 0x34, 0xC0, 0x0F, 0x39, 0x5A, 0x16, 
+	0x0B, 0x14, 0x16, 0x40, 0x17, 0x04, 0x3C, 0x31, 0xA2, 0x88, 0x3C, 0x00, 
+	0xC8, 0xFF, 0x31, 0x31, 0x31, 0xFF, 0xC5, 0x9C, 0x88, 0xC4, 0x14, 0xC1, 
+	0x1A, 0x36, 0x05, 0x9C, 0x98, 0x95, 0x88, 0x36, 0x94, 0xA9, 0x23, 0xC0, 
+	0x0F, 0x08, 0x0F, 0x1C, 0x09, 0x05, 0x09, 0x03, 0xA4, 0x67, 0xC0, 0x9C, 
+	0x99, 0x32, 0x34, 0x32, 0x00, 0x98, 0x88, 0xAA, 0x88, 0x31, 0x07, 0xA5, 
+	0x78, 0x34, 0x3D, 0x04, 0xA5, 0x87, 0x1F, 0x04, 0x07, 0x17, 0x1A, 0xFF, 
+	0x00, 0x00, 0x00, 0x00, 0xC8, 0x14, 0xC5, 0x18, 0xC4, 0x14, 0xC1, 0x38, 
+	0x1E, 0x36, 0x40, 0x3A, 0x23, 0x91, 0xA9, 0x32, 0x23, 0xC0, 0x55, 0x99, 
+	0x98, 0x3E, 0xA7, 0x88, 0x05, 0x24, 0x04, 0x32, 0x23, 0x32, 0xC0, 0x03, 
+	0x34, 0x9C, 0x78, 0x3C, 0x12, 0x16, 0x9D, 0x88, 0x34, 0xC0, 0x08, 0x3D, 
+	0x14, 0x09, 0x0C, 0xA1, 0x99, 0x34, 0x3C, 0x00, 0xC8, 0xFF, 0x31, 0x31, 
+	0x31, 0xFF, 0xC5, 0x9C, 0x88, 0xC4, 0x14, 0xC1, 0x3A, 0xA6, 0x88, 0xC0, 
+	0x9C, 0x88, 0x39, 0x23, 0xC3, 0x1E, 0x3A, 0x1C, 0x27, 0x05, 0x2B, 0x0B, 
+	0x32, 0x23, 0x32, 0xC0, 0x39, 0x08, 0x2E, 0x07, 0x03, 0x07, 0x34, 0x38, 
+	0x03, 0x14, 0x29, 0x23, 0x3D, 0x3C, 0x07, 0x34, 0x3C, 0x00, 0xC8, 0xFF, 
+	0x31, 0x31, 0x31, 0xFF, 0xC5, 0x9C, 0x88, 0xC4, 0x14, 0xC1, 0x3D, 0xA6, 
+	0x78, 0xC0, 0x35, 0x0C, 0x05, 0x23, 0xC2, 0x14, 0x2E, 0x3E, 0x14, 0x27, 
+	0x3A, 0x1A, 0xA8, 0x78, 0x32, 0xC1, 0x34, 0x39, 0x35, 0x07, 0x0F, 0x25, 
+	0x2E, 0xA4, 0x88, 0x39, 0x2A, 0x1A, 0x08, 0x2A, 0x3C, 0x07, 0x0F, 0x3C, 
+	0x00, 0xC8, 0xFF, 0x31, 0x31, 0x31, 0xFF, 0xC5, 0x18, 0xC4, 0x14, 0xC1, 
+	0x13, 0xA3, 0x88, 0x36, 0x22, 0x0D, 0x31, 0xA3, 0x77, 0x23, 0x14, 0xC0, 
+	0x23, 0x1F, 0x2F, 0x0F, 0x27, 0x0D, 0x26, 0x34, 0xC0, 0x32, 0xC1, 0x03, 
+	0x3C, 0x07, 0x0F, 0x07, 0x3C, 0x35, 0x08, 0x0B, 0x3C, 0x03, 0x3A, 0x35, 
+	0x07, 0x31, 0x3C, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xC8, 0x2B, 0xC2, 0x0D, 
+	0x9C, 0x98, 0x0D, 0x3E, 0x92, 0xBA, 0xC3, 0xA7, 0x77, 0x2B, 0xC0, 0x3D, 
+	0x05, 0x1B, 0x35, 0x24, 0xAC, 0x99, 0x05, 0x23, 0xC0, 0x36, 0x05, 0x94, 
+	0xA9, 0x11, 0x36, 0x09, 0x0D, 0x13, 0x34, 0x32, 0x34, 0x32, 0xC0, 0x08, 
+	0x3C, 0x9D, 0x88, 0x34, 0x16, 0x25, 0x26, 0x0C, 0x26, 0x29, 0xA8, 0x67, 
+	0x29, 0x13, 0x1B, 0x34, 0x3C, 0x00, 0xC8, 0x2B, 0xC0, 0x0F, 0x20, 0x3E, 
+	0xFE, 0x5E, 0x5E, 0x5E, 0xC0, 0xFE, 0xB3, 0xB3, 0xB3, 0x03, 0xC3, 0xA7, 
+	0x77, 0x2B, 0xC0, 0x3A, 0x05, 0x39, 0x1A, 0x95, 0x67, 0x13, 0x16, 0x39, 
+	0x05, 0xC0, 0x3E, 0x0F, 0x20, 0x09, 0x9B, 0x99, 0x15, 0x04, 0xA5, 0x87, 
+	0xA3, 0x78, 0xC0, 0x34, 0x7F, 0x34, 0x2E, 0x2D, 0x07, 0x3C, 0x07, 0x2D, 
+	0x3C, 0x0B, 0x1A, 0x16, 0x3C, 0x0B, 0x29, 0x2A, 0x0F, 0x00, 0xC8, 0x2B, 
+	0xC0, 0x3E, 0x97, 0x88, 0x92, 0xA9, 0x3E, 0xC0, 0x32, 0xA2, 0x88, 0xA6, 
+	0x99, 0x7F, 0xC1, 0xA5, 0x77, 0x2F, 0x0D, 0x0B, 0x14, 0x13, 0x3D, 0x97, 
+	0x99, 0x3A, 0x14, 0x05, 0x35, 0x11, 0x9B, 0x98, 0x5A, 0x15, 0x37, 0x11, 
+	0x20, 0x0B, 0xA8, 0x88, 0xA4, 0x67, 0x9B, 0xA9, 0xC0, 0x08, 0x3C, 0x1E, 
+	0x1A, 0x0B, 0xC2, 0x3C, 0x38, 0x0B, 0xC5, 0xFF, 0x00, 0x00, 0x00, 0x00, 
+	0xC8, 0xFF, 0xBB, 0xBB, 0xBB, 0xFF, 0xA2, 0x77, 0x9B, 0x88, 0xA1, 0x99, 
+	0x9A, 0x88, 0xC2, 0xA4, 0x88, 0x55, 0xA3, 0x99, 0xA3, 0x88, 0xC0, 0x59, 
+	0xA6, 0x78, 0x9B, 0x98, 0x1E, 0xA9, 0x67, 0x26, 0x0B, 0x95, 0x78, 0xA6, 
+	0x98, 0x1A, 0x24, 0x10, 0x28, 0x04, 0x22, 0xA3, 0x78, 0x37, 0x3B, 0xAC, 
+	0x99, 0xA2, 0x87, 0x3C, 0x34, 0xC0, 0x3C, 0xC0, 0x0F, 0xC0, 0xFE, 0xFB, 
+	0xE9, 0xE7, 0xCC, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xDC, 0xFF, 0x26, 0x26, 
+	0x26, 0xFF, 0xC1, 0xA2, 0x88, 0x2F, 0xC1, 0x00, 0xF9, 0x2F, 0xC2, 0x00, 
+	0xF9, 0x2F, 0xC4, 0x00, 0xFD, 0xF5, 0xFF, 0xE8, 0xE8, 0xE8, 0xFF, 0xC2, 
+	0x96, 0x88, 0xC0, 0x28, 0xFF, 0xDB, 0xFF, 0xDB, 0x07, 0x00, 0xFF, 0xB8, 
+	0xB9, 0xB9, 0xFF, 0x37, 0x0D, 0xC4, 0x2F, 0xA2, 0x88, 0xC0, 0xA9, 0x88, 
+	0x0D, 0x2F, 0xFE, 0xE8, 0xE8, 0xE8, 0x00, 0xEB, 0xFF, 0xBF, 0xFF, 0xBF, 
+	0x04, 0xFF, 0xB9, 0xBA, 0xB9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x00, 
+	0xFF, 0xAD, 0xAE, 0xAD, 0xFF, 0x00, 0xC4, 0x0D, 0xFE, 0x2A, 0x2A, 0x2A, 
+	0x40, 0xFE, 0xE8, 0xE8, 0xE8, 0xC0, 0xFE, 0x27, 0x27, 0x27, 0x9D, 0x88, 
+	0x0D, 0x00, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0x05, 0xFF, 0xAF, 0xAF, 0xAF, 
+	0xFF, 0x00, 0xC0, 0xFF, 0xA4, 0xA4, 0xA4, 0xFF, 0x00, 0xC4, 0x2B, 0xC1, 
+	0x00, 0xC0, 0x2B, 0x3E, 0x7F, 0x00, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 
+	0xFF, 0xA3, 0xA3, 0xA3, 0xFF, 0x00, 0xC0, 0xFF, 0xE8, 0xE8, 0xE8, 0xFF, 
+	0x00, 0xC4, 0xFF, 0x29, 0x29, 0x29, 0xFF, 0xC0, 0x55, 0x00, 0xC0, 0x0D, 
+	0xA3, 0x88, 0x2B, 0x00, 0xEC, 0xFF, 0xE8, 0xE8, 0xE8, 0xFF, 0x00, 0xC7, 
+	0x2B, 0xC0, 0x00, 0xC2, 0xFF, 0x28, 0x28, 0x28, 0xFF, 0xC0, 0x00, 0xF6, 
+	0x1C, 0x3E, 0xC0, 0x00, 0xC0, 0x2B, 0x3E, 0x1C, 0x00, 0xF6, 0x0D, 0xC1, 
+	0x00, 0xC0, 0x2B, 0x0D, 0x3E, 0x00, 0xF6, 0x3A, 0xC0, 0x2B, 0x00, 0xC0, 
+	0x2B, 0xC0, 0x3E, 0x00, 0xF6, 0x0D, 0x3A, 0x0D, 0x00, 0xC0, 0x3A, 0x1C, 
+	0x0D, 0x00, 0xF7, 0x3E, 0x0D, 0x00, 0xC0, 0x0D, 0x1C, 0x00, 0xDC, 0xFF, 
+	0xC8, 0xCA, 0xC9, 0xFF, 0xC0, 0x00, 0xD8, 0x0D, 0x00, 0xC2, 0x0D, 0x00, 
+	0x38, 0x2D, 0x34, 0x25, 0x1A, 0xA4, 0x88, 0x34, 0x9D, 0x88, 0x16, 0x34, 
+	0x38, 0x07, 0x29, 0x1A, 0x00, 0xCD, 0xFF, 0xAA, 0xAA, 0xAA, 0x06, 0xC0, 
+	0x00, 0xD9, 0x1C, 0x00, 0xC0, 0x1C, 0x00, 0xC0, 0x25, 0x9D, 0x88, 0x0B, 
+	0x1E, 0x2D, 0x0F, 0xC0, 0x29, 0x38, 0x9C, 0x88, 0x0F, 0x3C, 0x9C, 0x88, 
+	0x9D, 0x88, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xDC, 0x04, 0xC2, 0x22, 0xA2, 
+	0x88, 0x9C, 0x88, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xC6, 0x3C, 0xC0, 
+	0x2D, 0xFE, 0xFB, 0xE9, 0xE7, 0xC1, 0x00, 0xE8, 0x04, 0xC2, 0xFE, 0xC5, 
+	0xC5, 0xC5, 0x22, 0x40, 0xC0, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xC6, 0x3C, 
+	0x34, 0x3C, 0xFE, 0xFB, 0xE9, 0xE7, 0xC1, 0x00, 0xE8, 0x04, 0xC2, 0xFE, 
+	0xBF, 0xBF, 0xBF, 0x0F, 0xC0, 0x40, 0x00, 0xC6, 0x3C, 0x34, 0x3C, 0x04, 
+	0xC1, 0x00, 0xE8, 0x04, 0xC2, 0x08, 0x7F, 0xA2, 0x88, 0x26, 0x00, 0xC6, 
+	0x3C, 0xC1, 0x04, 0xC1, 0x00, 0xE4, 0x04, 0xCE, 0x3C, 0xC3, 0x34, 0x3C, 
+	0xAD, 0x67, 0x34, 0xC0, 0x0F, 0x3C, 0xC1, 0x00, 0xE0, 0x04, 0xCE, 0x3C, 
+	0x34, 0x07, 0x3C, 0xC0, 0x34, 0x3C, 0x34, 0x32, 0x3C, 0x32, 0x1A, 0x34, 
+	0x3C, 0x00, 0xE0, 0xFF, 0x2D, 0x2D, 0x2D, 0xFF, 0xC3, 0x14, 0xC8, 0x18, 
+	0x3C, 0x34, 0x07, 0x3C, 0xC0, 0x34, 0x3C, 0x34, 0x32, 0xC1, 0x07, 0x34, 
+	0x3C, 0x00, 0xE0, 0x18, 0xC3, 0x14, 0xC8, 0x18, 0x3C, 0x12, 0x07, 0x3C, 
+	0x34, 0xC3, 0x32, 0x3C, 0x07, 0x12, 0x3C, 0x00, 0xE0, 0x18, 0xC3, 0x14, 
+	0xC8, 0x18, 0x3C, 0x34, 0x07, 0x3C, 0x34, 0x7F, 0x34, 0x3C, 0x32, 0x34, 
+	0x3C, 0x07, 0x34, 0x3C, 0x00, 0xE0, 0x18, 0xC3, 0x14, 0xC8, 0x18, 0x3C, 
+	0x03, 0x07, 0x3C, 0xC0, 0x03, 0x3C, 0x0F, 0x32, 0x34, 0x2D, 0x07, 0x34, 
+	0x3C, 0x00, 0xE0, 0x18, 0xC3, 0x14, 0xC8, 0x18, 0x3C, 0x34, 0x25, 0x3C, 
+	0xC0, 0x34, 0xC0, 0x0F, 0x34, 0x32, 0x34, 0x07, 0x34, 0x3C, 0x00, 0xE0, 
+	0x18, 0xC3, 0x14, 0xC8, 0x18, 0x3C, 0x34, 0x07, 0x3C, 0xC0, 0x34, 0xC0, 
+	0x3C, 0x34, 0x32, 0x3C, 0x07, 0x29, 0x3C, 0x00, 0xE0, 0x34, 0xC2, 0x20, 
+	0xC1, 0x13, 0x22, 0xC2, 0x40, 0xC2, 0x3C, 0x34, 0x07, 0x3C, 0x0F, 0x34, 
+	0x3C, 0xC0, 0x32, 0x34, 0x3C, 0x07, 0x34, 0x3C, 0x00, 0xE0, 0x34, 0x32, 
+	0x34, 0x2E, 0x9C, 0x88, 0xFE, 0x5E, 0x5E, 0x5E, 0xC0, 0x1E, 0x13, 0x31, 
+	0x22, 0xA2, 0x88, 0x13, 0x04, 0x35, 0x04, 0x3C, 0x07, 0xC1, 0x3C, 0xC0, 
+	0x0F, 0x34, 0xC0, 0x3C, 0xC1, 0x07, 0xC0, 0xFF, 0x00, 0x00, 0x00, 0x00, 
+	0xD5, 0x3E, 0xC0, 0x00, 0xC7, 0x0B, 0x16, 0x38, 0x26, 0x32, 0x3E, 0xC0, 
+	0x8B, 0xA9, 0x2A, 0x26, 0x0F, 0x94, 0x88, 0xA2, 0x88, 0x26, 0x04, 0xC0, 
+	0x0B, 0xCC, 0x00, 0xC0, 0x1E, 0x0B, 0x1A, 0x2D, 0x16, 0x0B, 0x38, 0x3C, 
+	0x07, 0x1E, 0x40, 0x1A, 0x0B, 0x25, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xD0, 
+	0x0B, 0x39, 0x08, 0x2A, 0x32, 0xC2, 0x1F, 0x2A, 0x9D, 0x88, 0x1F, 0xA3, 
+	0x88, 0x2E, 0x1F, 0x2E, 0xFE, 0xFB, 0xE9, 0xE7, 0xCC, 0x00, 0xC0, 0x29, 
+	0x25, 0x1A, 0x0F, 0x07, 0x1A, 0x34, 0x94, 0x88, 0x07, 0x38, 0xC0, 0x2D, 
+	0x00, 0x38, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x01, 0x00, 0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 
+	0x6E, 0x20, 0x33, 0x33, 0x30, 0x0A, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 
+	0x63, 0x32, 0x20, 0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 0x78, 0x43, 0x6F, 
+	0x6F, 0x72, 0x64, 0x3B, 0x0A, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 
+	0x6D, 0x20, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 0x32, 0x44, 0x20, 
+	0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x30, 0x3B, 0x0A, 0x0A, 0x6F, 
+	0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x66, 0x69, 0x6E, 0x61, 
+	0x6C, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 
+	0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x0A, 0x7B, 0x0A, 0x20, 
+	0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x74, 0x65, 0x78, 0x65, 
+	0x6C, 0x20, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 
+	0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x30, 0x2C, 0x20, 0x66, 0x72, 
+	0x61, 0x67, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x29, 0x3B, 
+	0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x20, 0x50, 0x6C, 0x61, 
+	0x79, 0x65, 0x72, 0x73, 0x20, 0x61, 0x72, 0x65, 0x20, 0x64, 0x72, 0x61, 
+	0x77, 0x6E, 0x20, 0x69, 0x6E, 0x20, 0x6F, 0x6E, 0x65, 0x20, 0x62, 0x61, 
+	0x74, 0x63, 0x68, 0x2C, 0x20, 0x73, 0x6F, 0x20, 0x61, 0x6E, 0x20, 0x65, 
+	0x6D, 0x70, 0x74, 0x79, 0x20, 0x6F, 0x76, 0x65, 0x72, 0x6C, 0x61, 0x79, 
+	0x20, 0x74, 0x65, 0x78, 0x65, 0x6C, 0x20, 0x6D, 0x75, 0x73, 0x74, 0x20, 
+	0x6E, 0x6F, 0x74, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x20, 0x68, 
+	0x69, 0x64, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x6C, 0x61, 0x79, 
+	0x65, 0x72, 0x20, 0x62, 0x65, 0x68, 0x69, 0x6E, 0x64, 0x20, 0x69, 0x74, 
+	0x20, 0x74, 0x68, 0x72, 0x6F, 0x75, 0x67, 0x68, 0x20, 0x74, 0x68, 0x65, 
+	0x20, 0x64, 0x65, 0x70, 0x74, 0x68, 0x20, 0x62, 0x75, 0x66, 0x66, 0x65, 
+	0x72, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28, 0x74, 0x65, 
+	0x78, 0x65, 0x6C, 0x2E, 0x61, 0x20, 0x3D, 0x3D, 0x20, 0x30, 0x2E, 0x30, 
+	0x29, 0x20, 0x64, 0x69, 0x73, 0x63, 0x61, 0x72, 0x64, 0x3B, 0x0A, 0x20, 
+	0x20, 0x20, 0x20, 0x66, 0x69, 0x6E, 0x61, 0x6C, 0x43, 0x6F, 0x6C, 0x6F, 
+	0x72, 0x20, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6C, 0x3B, 0x0A, 0x7D, 
+	0x0A, 0x00, 0x23, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x20, 0x33, 
+	0x33, 0x30, 0x0A, 0x0A, 0x2F, 0x2F, 0x20, 0x50, 0x65, 0x72, 0x20, 0x69, 
+	0x6E, 0x73, 0x74, 0x61, 0x6E, 0x63, 0x65, 0x20, 0x70, 0x6C, 0x61, 0x63, 
+	0x65, 0x6D, 0x65, 0x6E, 0x74, 0x2C, 0x20, 0x77, 0x69, 0x74, 0x68, 0x20, 
+	0x74, 0x68, 0x65, 0x20, 0x73, 0x6B, 0x69, 0x6E, 0x27, 0x73, 0x20, 0x74, 
+	0x69, 0x6C, 0x65, 0x20, 0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x20, 0x61, 
+	0x74, 0x6C, 0x61, 0x73, 0x20, 0x73, 0x6D, 0x75, 0x67, 0x67, 0x6C, 0x65, 
+	0x64, 0x20, 0x69, 0x6E, 0x20, 0x74, 0x68, 0x65, 0x0A, 0x2F, 0x2F, 0x20, 
+	0x62, 0x6F, 0x74, 0x74, 0x6F, 0x6D, 0x20, 0x72, 0x6F, 0x77, 0x20, 0x6F, 
+	0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x72, 0x61, 0x6E, 0x73, 0x66, 
+	0x6F, 0x72, 0x6D, 0x2C, 0x20, 0x77, 0x68, 0x69, 0x63, 0x68, 0x20, 0x69, 
+	0x73, 0x20, 0x61, 0x6C, 0x77, 0x61, 0x79, 0x73, 0x20, 0x30, 0x20, 0x30, 
+	0x20, 0x30, 0x20, 0x31, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x74, 0x68, 0x65, 
+	0x73, 0x65, 0x2E, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x33, 0x20, 
+	0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 
+	0x6F, 0x6E, 0x3B, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 
+	0x76, 0x65, 0x72, 0x74, 0x65, 0x78, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 
+	0x72, 0x64, 0x3B, 0x0A, 0x69, 0x6E, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 
+	0x69, 0x6E, 0x73, 0x74, 0x61, 0x6E, 0x63, 0x65, 0x54, 0x72, 0x61, 0x6E, 
+	0x73, 0x66, 0x6F, 0x72, 0x6D, 0x3B, 0x0A, 0x0A, 0x75, 0x6E, 0x69, 0x66, 
+	0x6F, 0x72, 0x6D, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x6D, 0x76, 0x70, 
+	0x3B, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 
+	0x63, 0x32, 0x20, 0x74, 0x69, 0x6C, 0x65, 0x53, 0x63, 0x61, 0x6C, 0x65, 
+	0x3B, 0x0A, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 
+	0x66, 0x72, 0x61, 0x67, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 
+	0x3B, 0x0A, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 
+	0x28, 0x29, 0x0A, 0x7B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6D, 0x61, 0x74, 
+	0x34, 0x20, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x20, 0x3D, 0x20, 0x69, 0x6E, 
+	0x73, 0x74, 0x61, 0x6E, 0x63, 0x65, 0x54, 0x72, 0x61, 0x6E, 0x73, 0x66, 
+	0x6F, 0x72, 0x6D, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 
+	0x32, 0x20, 0x74, 0x69, 0x6C, 0x65, 0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 
+	0x32, 0x28, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x5B, 0x30, 0x5D, 0x5B, 0x33, 
+	0x5D, 0x2C, 0x20, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x5B, 0x31, 0x5D, 0x5B, 
+	0x33, 0x5D, 0x29, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6D, 0x6F, 0x64, 
+	0x65, 0x6C, 0x5B, 0x30, 0x5D, 0x5B, 0x33, 0x5D, 0x20, 0x3D, 0x20, 0x30, 
+	0x2E, 0x30, 0x3B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6D, 0x6F, 0x64, 0x65, 
+	0x6C, 0x5B, 0x31, 0x5D, 0x5B, 0x33, 0x5D, 0x20, 0x3D, 0x20, 0x30, 0x2E, 
+	0x30, 0x3B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x66, 0x72, 0x61, 0x67, 
+	0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x20, 0x3D, 0x20, 0x28, 
+	0x74, 0x69, 0x6C, 0x65, 0x20, 0x2B, 0x20, 0x76, 0x65, 0x72, 0x74, 0x65, 
+	0x78, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x29, 0x2A, 0x74, 
+	0x69, 0x6C, 0x65, 0x53, 0x63, 0x61, 0x6C, 0x65, 0x3B, 0x0A, 0x20, 0x20, 
+	0x20, 0x20, 0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 
+	0x6E, 0x20, 0x3D, 0x20, 0x6D, 0x76, 0x70, 0x2A, 0x6D, 0x6F, 0x64, 0x65, 
+	0x6C, 0x2A, 0x76, 0x65, 0x63, 0x34, 0x28, 0x76, 0x65, 0x72, 0x74, 0x65, 
+	0x78, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x2C, 0x20, 0x31, 
+	0x2E, 0x30, 0x29, 0x3B, 0x0A, 0x7D, 0x0A, 0x00, 0x00, 
+};
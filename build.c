@@ -1,4 +1,5 @@
 #include "build.h"
+#include <time.h>
 
 #if defined(_WIN32)
 #	if defined(__GNUC__)
@@ -27,7 +28,7 @@
 void
 usage(void)
 {
-	xfprintf(stderr, "Usage: ./build [build|run|clean|help]\n");
+	xfprintf(stderr, "Usage: ./build [build|run|watch [skin]|bench [baseline.json [threshold%]]|microbench|test [update|threshold%]|tools|stress|clean|help]\n");
 }
 
 void
@@ -36,6 +37,328 @@ clean(void)
 	remove_dir(".build");
 	remove_file("skin-view");
 	remove_file("skin-view.exe");
+	remove_file("skin-bench");
+	remove_file("skin-bench.exe");
+	remove_file("skin-test");
+	remove_file("skin-test.exe");
+	remove_file("skin-serve");
+	remove_file("skin-client");
+	remove_file("skin-batch");
+	remove_file("skin-index");
+	remove_file("skin-lint");
+}
+
+#define STRESS_ARGS 50000
+#define STRESS_DEPS 20000
+
+static double
+elapsed_ms(clock_t start)
+{
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/* Stress the arena and vectors with command lines and dependency lists much
+ * larger than a single chunk, checking no earlier pointer was invalidated. */
+bool
+stress(void)
+{
+	bool ok = true;
+	struct arena_mark save = arena_save();
+
+	clock_t start = clock();
+	char **args = NULL;
+	char *first = arena_strndup("-DSTRESS_FIRST", 14);
+	vec_add(&args, first);
+	for (size_t i = 1; i < STRESS_ARGS; i++) {
+		scratch.len = 0;
+		scratch_add_fmt("-DSTRESS_%zu", i);
+		vec_add(&args, arena_strndup(scratch.buf, scratch.len));
+	}
+	xfprintf(stdout, "args\t%d\t%.3f ms\n", STRESS_ARGS, elapsed_ms(start));
+
+	start = clock();
+	char **deps = NULL;
+	for (size_t i = 0; i < STRESS_DEPS; i++) {
+		scratch.len = 0;
+		scratch_add_fmt("src/dep_%zu.c", i);
+		vec_add(&deps, arena_strndup(scratch.buf, scratch.len));
+	}
+	const char **objs = string_substitute_vec(deps, "src/*.c", ".build/*.o");
+	xfprintf(stdout, "deps\t%d\t%.3f ms\n", STRESS_DEPS, elapsed_ms(start));
+
+	if (vec_size(args) != STRESS_ARGS || args[0] != first
+			|| strcmp(first, "-DSTRESS_FIRST")
+			|| strcmp(args[STRESS_ARGS - 1], "-DSTRESS_49999")) {
+		xfprintf(stderr, "Err: argument vector corrupted\n");
+		ok = false;
+	}
+	if (vec_size(deps) != STRESS_DEPS || vec_size((char **)objs) != STRESS_DEPS
+			|| strcmp(deps[0], "src/dep_0.c")
+			|| strcmp(objs[0], ".build/dep_0.o")
+			|| strcmp(objs[STRESS_DEPS - 1], ".build/dep_19999.o")) {
+		xfprintf(stderr, "Err: dependency vector corrupted\n");
+		ok = false;
+	}
+
+	arena_restore(save);
+
+	start = clock();
+	for (size_t round = 0; round < 100; round++) {
+		struct arena_mark m = arena_save();
+		char **c = NULL;
+		for (size_t i = 0; i < 1000; i++) vec_add(&c, "-Werror");
+		arena_restore(m);
+	}
+	xfprintf(stdout, "reuse\t%d\t%.3f ms\n", 100 * 1000, elapsed_ms(start));
+
+	return ok;
+}
+
+#if PLATFORM_WINDOWS
+#	define TARGET ".\\skin-view.exe"
+#else
+#	define TARGET "./skin-view"
+#endif
+
+#define BENCH_RUNS 50
+#define BENCH_SAMPLES ".build/startup.txt"
+#define BENCH_RESULT ".build/startup.json"
+
+/* Matches enum phase in src/main.c, plus process start measured here */
+const char *bench_phases[] = {
+	"process_start",
+	"window",
+	"bundle_lookup",
+	"png_decode",
+	"gpu_upload",
+	"model_load",
+	"first_frame",
+	"render",
+};
+#define BENCH_PHASES (sizeof(bench_phases)/sizeof(*bench_phases))
+
+/* skin-view writes how many poses it hashed before the hashes */
+#define BENCH_MAX_POSES 16
+
+/* A phase fails the baseline check when its median is more than the
+ * threshold percentage slower and the absolute difference is above noise */
+#define BENCH_THRESHOLD 10.0
+#define BENCH_NOISE_MS 0.05
+
+struct stats {
+	double mean;
+	double median;
+	double p99;
+};
+
+static long long
+now_ns(void)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int
+cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+/* Sorts v in place */
+static struct stats
+stats_of(double *v, size_t n)
+{
+	struct stats st = {0};
+	if (!n) return st;
+
+	qsort(v, n, sizeof(*v), cmp_double);
+	for (size_t i = 0; i < n; i++) st.mean += v[i];
+	st.mean /= (double)n;
+	st.median = n % 2 ? v[n/2] : (v[n/2 - 1] + v[n/2]) / 2;
+	size_t p = (n * 99 + 99) / 100;
+	st.p99 = v[p - 1];
+	return st;
+}
+
+static bool
+bench_write(const char *fp, size_t runs, const struct stats *st,
+	const uint64_t *hashes, size_t poses)
+{
+	FILE *f = fopen(fp, "w");
+	if (!f) {
+		xfprintf(stderr, "Err: could not open %s: %s\n", fp, strerror(errno));
+		return false;
+	}
+	/* One phase per line, so bench_compare can read it back with sscanf */
+	xfprintf(f, "{\n\t\"runs\": %zu,\n\t\"hashes\": [", runs);
+	for (size_t i = 0; i < poses; i++) {
+		xfprintf(f, "%s\"%016" PRIx64 "\"", i ? ", " : " ", hashes[i]);
+	}
+	xfprintf(f, " ],\n\t\"phases\": {\n");
+	for (size_t i = 0; i < BENCH_PHASES; i++) {
+		xfprintf(f, "\t\t\"%s\": { \"mean_ms\": %.4f, \"median_ms\": %.4f, "
+			"\"p99_ms\": %.4f }%s\n", bench_phases[i],
+			st[i].mean, st[i].median, st[i].p99,
+			i + 1 < BENCH_PHASES ? "," : "");
+	}
+	xfprintf(f, "\t}\n}\n");
+	return !fclose(f);
+}
+
+/* Fails on any phase regression past threshold. Renders that hash
+ * differently are only reported: a driver update moves an edge pixel,
+ * ./build test checks them with a tolerance. */
+static bool
+bench_compare(const char *fp, const struct stats *st, const uint64_t *hashes,
+	size_t poses, double threshold)
+{
+	FILE *f = fopen(fp, "r");
+	if (!f) {
+		xfprintf(stderr, "Err: could not open %s: %s\n", fp, strerror(errno));
+		return false;
+	}
+
+	bool ok = true;
+	uint64_t want[BENCH_MAX_POSES];
+	size_t hashes_seen = 0;
+	char line[256];
+	xfprintf(stdout, "\nphase\t\tbaseline\tcurrent\t\tdelta\n");
+	while (fgets(line, sizeof(line), f)) {
+		char *h = strstr(line, "\"hashes\": [");
+		while (h && hashes_seen < BENCH_MAX_POSES
+				&& (h = strchr(h + 1, '"'))) {
+			if (sscanf(h, "\"%" SCNx64 "\"", &want[hashes_seen]) != 1) {
+				h++;
+				continue;
+			}
+			hashes_seen++;
+			h = strchr(h + 1, '"');
+		}
+
+		char name[64];
+		struct stats b;
+		if (sscanf(line, " \"%63[^\"]\": { \"mean_ms\": %lf, "
+				"\"median_ms\": %lf, \"p99_ms\": %lf",
+				name, &b.mean, &b.median, &b.p99) != 4) {
+			continue;
+		}
+		for (size_t i = 0; i < BENCH_PHASES; i++) {
+			if (strcmp(name, bench_phases[i])) continue;
+			double d = b.median > 0
+				? (st[i].median - b.median) / b.median * 100 : 0;
+			bool slow = d > threshold
+				&& st[i].median - b.median > BENCH_NOISE_MS;
+			xfprintf(stdout, "%-15s\t%8.3f ms\t%8.3f ms\t%+6.1f%%%s\n",
+				name, b.median, st[i].median, d, slow ? "\tFAIL" : "");
+			ok = ok && !slow;
+		}
+	}
+	fclose(f);
+
+	if (hashes_seen != poses) {
+		xfprintf(stdout, "note\tbaseline %s has %zu render hashes, "
+			"skin-view rendered %zu poses\n", fp, hashes_seen, poses);
+	}
+	for (size_t i = 0; i < poses && i < hashes_seen; i++) {
+		if (want[i] == hashes[i]) continue;
+		xfprintf(stdout, "note\tpose %zu rendered %016" PRIx64
+			", baseline %016" PRIx64 ", see ./build test\n",
+			i, hashes[i], want[i]);
+	}
+	return ok;
+}
+
+/* Launch skin-view headless BENCH_RUNS times and summarize each startup
+ * phase. Checks medians against baseline when given, and reports renders
+ * that hash differently. */
+bool
+bench(const char *baseline, double threshold)
+{
+	struct arena_mark save = arena_save();
+	remove_file(BENCH_SAMPLES);
+
+	long long *launch = arena_alloc(sizeof(*launch) * BENCH_RUNS);
+	for (size_t run = 0; run < BENCH_RUNS; run++) {
+		char **c = NULL;
+		vec_add_many(&c, TARGET, "-b", BENCH_SAMPLES, 0);
+		launch[run] = now_ns();
+		if (!proc_wait(proc_run(c))) {
+			arena_restore(save);
+			return false;
+		}
+	}
+
+	FILE *f = fopen(BENCH_SAMPLES, "r");
+	if (!f) {
+		xfprintf(stderr, "Err: skin-view wrote no samples\n");
+		arena_restore(save);
+		return false;
+	}
+
+	double *samples[BENCH_PHASES];
+	for (size_t i = 0; i < BENCH_PHASES; i++) {
+		samples[i] = arena_alloc(sizeof(double) * BENCH_RUNS);
+	}
+
+	size_t runs = 0;
+	long long ts[BENCH_PHASES];
+	uint64_t hashes[BENCH_MAX_POSES], first[BENCH_MAX_POSES];
+	size_t poses = 0, first_poses = 0;
+	while (runs < BENCH_RUNS) {
+		size_t n = 0;
+		while (n < BENCH_PHASES && fscanf(f, "%lld", &ts[n]) == 1) n++;
+		if (n != BENCH_PHASES) break;
+		if (fscanf(f, "%zu", &poses) != 1 || poses > BENCH_MAX_POSES) break;
+		n = 0;
+		while (n < poses && fscanf(f, "%" SCNx64, &hashes[n]) == 1) n++;
+		if (n != poses) break;
+
+		if (!runs) {
+			memcpy(first, hashes, sizeof(*hashes) * poses);
+			first_poses = poses;
+		}
+		if (poses != first_poses
+				|| memcmp(first, hashes, sizeof(*hashes) * poses)) {
+			xfprintf(stderr, "Err: run %zu rendered differently\n", runs);
+			fclose(f);
+			arena_restore(save);
+			return false;
+		}
+
+		long long prev = launch[runs];
+		for (size_t i = 0; i < BENCH_PHASES; i++) {
+			samples[i][runs] = (double)(ts[i] - prev) / 1e6;
+			prev = ts[i];
+		}
+		runs++;
+	}
+	fclose(f);
+
+	if (runs != BENCH_RUNS) {
+		xfprintf(stderr, "Err: expected %d samples, got %zu\n",
+			BENCH_RUNS, runs);
+		arena_restore(save);
+		return false;
+	}
+
+	struct stats st[BENCH_PHASES];
+	xfprintf(stdout, "phase\t\tmean\t\tmedian\t\tp99\n");
+	for (size_t i = 0; i < BENCH_PHASES; i++) {
+		st[i] = stats_of(samples[i], runs);
+		xfprintf(stdout, "%-15s\t%8.3f ms\t%8.3f ms\t%8.3f ms\n",
+			bench_phases[i], st[i].mean, st[i].median, st[i].p99);
+	}
+
+	/* Compare first, the baseline may be a previous BENCH_RESULT */
+	bool result = !baseline
+		|| bench_compare(baseline, st, first, first_poses, threshold);
+	result = bench_write(BENCH_RESULT, runs, st, first, first_poses) && result;
+	if (result) xfprintf(stdout, "Wrote %s\n", BENCH_RESULT);
+
+	arena_restore(save);
+	return result;
 }
 
 int
@@ -59,6 +382,47 @@ main(int argc, char **argv)
 			if (!build()) return 1;
 			if (!run()) return 1;
 		}
+		else if (!strcmp(argv[i], "watch")) {
+			create_dir(".build");
+			const char *skin = i + 1 < argc ? argv[++i] : NULL;
+			if (!watch(skin)) return 1;
+		}
+		else if (!strcmp(argv[i], "bench")) {
+			create_dir(".build");
+			const char *baseline = NULL;
+			double threshold = BENCH_THRESHOLD;
+			if (i + 1 < argc && has_ext(argv[i + 1], ".json"))
+				baseline = argv[++i];
+			if (baseline && i + 1 < argc && atof(argv[i + 1]) > 0)
+				threshold = atof(argv[++i]);
+			if (!build()) return 1;
+			if (!bench(baseline, threshold)) return 1;
+		}
+		else if (!strcmp(argv[i], "microbench")) {
+			create_dir(".build");
+			if (!build() || !build_bench()) return 1;
+			if (!run_bench()) return 1;
+		}
+		else if (!strcmp(argv[i], "test")) {
+			create_dir(".build");
+			bool update = false;
+			double threshold = 0;
+			if (i + 1 < argc && !strcmp(argv[i + 1], "update")) {
+				update = true;
+				i++;
+			}
+			else if (i + 1 < argc && atof(argv[i + 1]) > 0)
+				threshold = atof(argv[++i]);
+			if (!build() || !build_test()) return 1;
+			if (!run_test(update, threshold)) return 1;
+		}
+		else if (!strcmp(argv[i], "tools")) {
+			create_dir(".build");
+			if (!build() || !build_tools()) return 1;
+		}
+		else if (!strcmp(argv[i], "stress")) {
+			if (!stress()) return 1;
+		}
 		else if (!strcmp(argv[i], "help")) {
 			usage();
 			return 0;
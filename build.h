@@ -59,13 +59,29 @@ struct scratch {
 #ifndef ARENA_SIZE
 #define ARENA_SIZE 0x4000
 #endif
-char arena_buffer[ARENA_SIZE] = {0};
-struct arena {
+#define ARENA_ALIGN 16
+
+/* Memory is handed out of a list of chunks which are never moved or freed,
+ * so pointers stay valid until the arena is restored past them. */
+struct arena_chunk {
+	struct arena_chunk *next;
 	size_t count;
-	size_t save;
 	size_t size;
 	char *buf;
-} arena = { .size = ARENA_SIZE, .buf = arena_buffer };
+};
+
+struct arena_mark {
+	struct arena_chunk *chunk;
+	size_t count;
+};
+
+/* Handed out ARENA_ALIGN aligned, which a char array alone is not */
+_Alignas(ARENA_ALIGN) char arena_buffer[ARENA_SIZE] = {0};
+struct arena_chunk arena_first = { .size = ARENA_SIZE, .buf = arena_buffer };
+struct arena {
+	struct arena_chunk *cur;
+	void *last;
+} arena = { .cur = &arena_first };
 
 struct vheader {
 	size_t size;
@@ -114,27 +130,69 @@ xfprintf(FILE *restrict f, const char *restrict fmt, ...)
 	return n;
 }
 
+static size_t
+arena_fatsize(size_t size)
+{
+	size_t fatsize = size + ARENA_ALIGN;
+	return (fatsize + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static struct arena_chunk *
+arena_chunk_fit(size_t fatsize)
+{
+	struct arena_chunk *c = arena.cur;
+	if (c->count + fatsize <= c->size) return c;
+
+	/* Chunks left behind by arena_restore are reused before new ones */
+	while (c->next) {
+		c = c->next;
+		c->count = 0;
+		if (fatsize <= c->size) return c;
+	}
+
+	size_t size = ARENA_SIZE;
+	while (size < fatsize) size *= 2;
+	struct arena_chunk *n = xcalloc(1, sizeof(*n) + size);
+	n->size = size;
+	n->buf = (char *)(n + 1);
+	c->next = n;
+	return n;
+}
+
 void *
 arena_realloc(void *p, size_t size)
 {
-	assert(size < ARENA_SIZE);
-
-	size_t fatsize = size + sizeof(size_t);
-	while (arena.count + fatsize > arena.size) {
-		arena.size *= 2;
-		arena.buf = xrealloc(arena.buf, arena.size);
+	size_t oldsize = p ? ((size_t*)p)[-1] : 0;
+
+	/* Grow the most recent allocation in place if the chunk has room */
+	if (p && p == arena.last) {
+		struct arena_chunk *c = arena.cur;
+		size_t oldfat = arena_fatsize(oldsize);
+		size_t newfat = arena_fatsize(size);
+		if (c->count - oldfat + newfat <= c->size) {
+			if (size > oldsize) {
+				memset((char *)p + oldsize, 0, size - oldsize);
+			}
+			c->count = c->count - oldfat + newfat;
+			((size_t*)p)[-1] = size;
+			return p;
+		}
 	}
 
-	size_t *fatpointer = (size_t*)&arena.buf[arena.count];
-	void *pointer = fatpointer + 1;
+	size_t fatsize = arena_fatsize(size);
+	struct arena_chunk *c = arena_chunk_fit(fatsize);
+	arena.cur = c;
+
+	char *fatpointer = &c->buf[c->count];
+	void *pointer = fatpointer + ARENA_ALIGN;
 	memset(fatpointer, 0, fatsize);
-	*fatpointer = size;
+	((size_t*)pointer)[-1] = size;
 
 	if (p) {
-		size_t oldsize = ((size_t*)p)[-1];
 		memcpy(pointer, p, (size < oldsize ? size : oldsize));
 	}
-	arena.count += fatsize;
+	c->count += fatsize;
+	arena.last = pointer;
 
 	return pointer;
 }
@@ -153,6 +211,21 @@ arena_strndup(const char *str, const size_t len)
 	return dup;
 }
 
+struct arena_mark
+arena_save(void)
+{
+	return (struct arena_mark){ .chunk = arena.cur, .count = arena.cur->count };
+}
+
+/* Release everything allocated since the mark. Chunks are kept for reuse. */
+void
+arena_restore(struct arena_mark m)
+{
+	arena.cur = m.chunk;
+	arena.cur->count = m.count;
+	arena.last = NULL;
+}
+
 void
 scratch_add_char(const char ch)
 {
@@ -209,7 +282,7 @@ scratch_tostring(void)
 static struct vheader *
 vec_create(size_t capacity)
 {
-	assert(capacity < SIZE_MAX);
+	assert(capacity < SIZE_MAX / sizeof(char*));
 	struct vheader *header =
 		arena_alloc(sizeof(*header) + sizeof(char*) * capacity);
 	header->capacity = capacity;
@@ -236,11 +309,11 @@ vec_expand(char **vec)
 	}
 
 	if (header->size == header->capacity) {
-		struct vheader *newvec =
-			vec_create(header->capacity << 1U);
-		size_t z = sizeof(char*) * header->size + sizeof(*header);
-		memcpy(newvec, header, z);
-		newvec->capacity = header->capacity << 1U;
+		size_t capacity = header->capacity << 1U;
+		assert(capacity < SIZE_MAX / sizeof(char*));
+		header = arena_realloc(header,
+			sizeof(*header) + sizeof(char*) * capacity);
+		header->capacity = capacity;
 	}
 	header->size++;
 	return (char **)&(header[1]);
@@ -367,7 +440,7 @@ string_substitute_vec(char **vec, const char *pattern, const char *replacement)
 		scratch_add_str_len(re_prefix, re_prefix_len);
 		scratch_add_str_len(&pre[pa_prefix_len], core_len);
 		scratch_add_str_len(re_suffix, re_suffix_len);
-		vec_add(&mapped, scratch_tostring());
+		vec_add(&mapped, arena_strndup(scratch.buf, scratch.len));
 	}
 	return (const char **)mapped;
 }
@@ -476,6 +549,80 @@ create_dir(const char* pathname)
 	return true;
 }
 
+static bool
+has_ext(const char *name, const char *ext)
+{
+	if (!ext) return true;
+	size_t n = strlen(name), e = strlen(ext);
+	return n >= e && !strcmp(&name[n - e], ext);
+}
+
+/* Append every file below dir ending in ext (NULL for any) to vec */
+bool
+list_files(const char *dir, const char *ext, char ***vec)
+{
+#if PLATFORM_WINDOWS
+	WIN32_FIND_DATA data;
+	char search[MAX_PATH] = {0};
+	snprintf(search, MAX_PATH, "%s\\*", dir);
+
+	HANDLE find = FindFirstFile(search, &data);
+	if (find == INVALID_HANDLE_VALUE) return false;
+
+	bool result = true;
+	do {
+		if (!strcmp(data.cFileName, ".") || !strcmp(data.cFileName, "..")) {
+			continue;
+		}
+
+		scratch.len = 0;
+		scratch_add_fmt("%s\\%s", dir, data.cFileName);
+		char *path = arena_strndup(scratch.buf, scratch.len);
+
+		if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+			result = list_files(path, ext, vec) && result;
+		} else if (has_ext(path, ext)) {
+			vec_add(vec, path);
+		}
+	} while (FindNextFile(find, &data));
+	FindClose(find);
+	return result;
+#else
+	DIR *d = opendir(dir);
+	if (!d) {
+		xfprintf(stderr, "Err: could not open dir %s: %s\n",
+			dir, strerror(errno));
+		return false;
+	}
+
+	bool result = true;
+	struct dirent *p;
+	while ((p = readdir(d))) {
+		if (!strcmp(p->d_name, ".") || !strcmp(p->d_name, "..")) {
+			continue;
+		}
+
+		scratch.len = 0;
+		scratch_add_fmt("%s/%s", dir, p->d_name);
+		char *path = arena_strndup(scratch.buf, scratch.len);
+
+		struct stat st;
+		if (stat(path, &st)) {
+			result = false;
+			continue;
+		}
+
+		if (S_ISDIR(st.st_mode)) {
+			result = list_files(path, ext, vec) && result;
+		} else if (has_ext(path, ext)) {
+			vec_add(vec, path);
+		}
+	}
+	closedir(d);
+	return result;
+#endif
+}
+
 int /* ( -1:error | 0:false | 1:true ) */
 target_needs_rebuild(const char *output, const char **inputs, size_t input_count)
 {
@@ -533,7 +680,7 @@ target_needs_rebuild(const char *output, const char **inputs, size_t input_count
 			output, strerror(errno));
 		return -1;
 	}
-	int64_t outtime = st.st_mtime;
+	struct timespec outtime = st.st_mtim;
 
 	for (size_t i = 0; i < input_count; i += 1) {
 		const char *input = inputs[i];
@@ -542,8 +689,10 @@ target_needs_rebuild(const char *output, const char **inputs, size_t input_count
 				input, strerror(errno));
 			return -1;
 		}
-		int64_t intime = st.st_mtime;
-		if (intime > outtime) return 1;
+		struct timespec intime = st.st_mtim;
+		if (intime.tv_sec > outtime.tv_sec) return 1;
+		if (intime.tv_sec == outtime.tv_sec
+				&& intime.tv_nsec > outtime.tv_nsec) return 1;
 	}
 
 	return 0;
@@ -589,6 +738,8 @@ proc_run(char **vec)
 
 #else
 
+	/* Flush so buffered output is neither duplicated nor reordered */
+	fflush(NULL);
 	pid_t pid = fork();
 	if (pid < 0) {
 		xfprintf(stderr, "Err: Could not fork process: %s\n", strerror(errno));
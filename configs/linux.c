@@ -1,16 +1,23 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/inotify.h>
+#include <time.h>
+
 bool
 build_bundle(void)
 {
 	const char *o = ".build/bundle";
-	const char *s = "src/bundle.c";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	/* The bundler transcodes with these, see src/bundle.c */
+	const char *s[] = { "src/bundle.c", "src/inflate.h", "src/qoi.h" };
+	if (!target_needs_rebuild(o, s, 3)) return true;
 
 	xfprintf(stdout, "CCLD\t%s\n", o);
 	char **c = NULL;
-	size_t save = arena.count;
-	vec_add_many(&c, CC, "-o", o, s, 0);
+	struct arena_mark save = arena_save();
+	vec_add_many(&c, CC, "-o", o, s[0], 0);
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 
 	return result;
 }
@@ -19,30 +26,47 @@ bool
 build_bundle_h(void)
 {
 	const char *o = ".build/bundle.h";
-	const char *s = ".build/bundle";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	struct arena_mark save = arena_save();
+	char **s = NULL;
+	vec_add(&s, ".build/bundle");
+	if (!list_files("resources", NULL, &s)) {
+		arena_restore(save);
+		return false;
+	}
+	int rebuild = target_needs_rebuild(o, (const char **)s, vec_size(s));
+	if (rebuild <= 0) {
+		arena_restore(save);
+		return rebuild == 0;
+	}
 
 	xfprintf(stdout, "BUNDLE\t%s\n", o);
 	char **c = NULL;
-	size_t save = arena.count;
-	vec_add(&c, (char*)s);
+	vec_add(&c, s[0]);
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 
 	return result;
 }
 
 bool
-build_target(void)
+build_program(const char *o, const char *s)
 {
-	const char *o = "skin-view";
-	const char *s = "src/main.c";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	struct arena_mark save = arena_save();
+	char **deps = NULL;
+	vec_add_many(&deps, s, ".build/bundle.h", 0);
+	if (!list_files("src", ".h", &deps)) {
+		arena_restore(save);
+		return false;
+	}
+	int rebuild = target_needs_rebuild(o, (const char **)deps, vec_size(deps));
+	if (rebuild <= 0) {
+		arena_restore(save);
+		return rebuild == 0;
+	}
 
 	xfprintf(stdout, "CCLD\t%s\n", o);
 	char **c = NULL;
 
-	size_t save = arena.count;
 	vec_add_many(&c, CC, "--std=c11", "-pedantic", "-Os", 0);
 	vec_add_many(&c, "-Wall", "-Wextra", "-Wshadow", 0);
 	vec_add_many(&c, "-Wconversion", "-Werror", 0);
@@ -50,13 +74,42 @@ build_target(void)
 	vec_add_many(&c, "-Iraylib/include", "-I.build", 0);
 	vec_add_many(&c, "-o", o, s, 0);
 	vec_add_many(&c, "-s", "-Lraylib/lib/x86_64-linux-gnu", 0);
-	vec_add_many(&c, "-l:libraylib.a", "-lm", 0);
+	vec_add_many(&c, "-l:libraylib.a", "-lm", "-lpthread", 0);
 
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 	return result;
 }
 
+bool
+build_target(void)
+{
+	return build_program("skin-view", "src/main.c");
+}
+
+bool
+build_bench(void)
+{
+	return build_program("skin-bench", "src/bench.c");
+}
+
+/* Optional tools, not part of the default build */
+bool
+build_tools(void)
+{
+	return build_program("skin-serve", "src/serve.c")
+		&& build_program("skin-client", "src/client.c")
+		&& build_program("skin-batch", "src/batch.c")
+		&& build_program("skin-index", "src/index.c")
+		&& build_program("skin-lint", "src/lint.c");
+}
+
+bool
+build_test(void)
+{
+	return build_program("skin-test", "src/test.c");
+}
+
 bool
 build(void)
 {
@@ -65,13 +118,228 @@ build(void)
 		&& build_target();
 }
 
+bool
+run_bench(void)
+{
+	char **c = NULL;
+	struct arena_mark save = arena_save();
+	vec_add(&c, "./skin-bench");
+	bool result = proc_wait(proc_run(c));
+	arena_restore(save);
+	return result;
+}
+
+bool
+run_test(bool update, double threshold)
+{
+	char **c = NULL;
+	char t[32];
+	struct arena_mark save = arena_save();
+	vec_add(&c, "./skin-test");
+	if (update) vec_add(&c, "-u");
+	if (threshold > 0) {
+		snprintf(t, sizeof(t), "%g", threshold);
+		vec_add_many(&c, "-t", t, 0);
+	}
+	bool result = proc_wait(proc_run(c));
+	arena_restore(save);
+	return result;
+}
+
 bool
 run(void)
 {
 	char **c = NULL;
-	size_t save = arena.count;
+	struct arena_mark save = arena_save();
 	vec_add(&c, "./skin-view");
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
+	return result;
+}
+
+#define WATCH_STATE ".build/state"
+#define WATCH_DEBOUNCE_MS 50
+#define WATCH_READY_MS 10000
+
+/* Watched directory of each watch descriptor, to add the ones created
+ * under it later */
+char **watch_dirs = NULL;
+
+static double
+now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static bool
+watch_add_tree(int fd, const char *dir)
+{
+	const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+	int wd = inotify_add_watch(fd, dir, mask);
+	if (wd < 0) {
+		xfprintf(stderr, "Err: could not watch %s: %s\n",
+			dir, strerror(errno));
+		return false;
+	}
+	while (vec_size(watch_dirs) <= (size_t)wd) vec_add(&watch_dirs, NULL);
+	watch_dirs[wd] = arena_strndup(dir, strlen(dir));
+
+	DIR *d = opendir(dir);
+	if (!d) return false;
+
+	bool result = true;
+	struct dirent *p;
+	while ((p = readdir(d))) {
+		if (!strcmp(p->d_name, ".") || !strcmp(p->d_name, "..")) {
+			continue;
+		}
+		char buf[PATH_MAX];
+		snprintf(buf, PATH_MAX, "%s/%s", dir, p->d_name);
+		struct stat st;
+		if (!stat(buf, &st) && S_ISDIR(st.st_mode)) {
+			result = watch_add_tree(fd, buf) && result;
+		}
+	}
+	closedir(d);
 	return result;
 }
+
+/* Read events until the tree has been quiet for WATCH_DEBOUNCE_MS, so an
+ * editor writing several files at once only triggers one rebuild.
+ * Directories created meanwhile are watched from here on. */
+static void
+watch_drain(int fd)
+{
+	_Alignas(struct inotify_event) char buf[4096];
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	do {
+		ssize_t n = read(fd, buf, sizeof(buf));
+		if (n < 0 && errno != EINTR) return;
+
+		for (ssize_t i = 0; i < n;) {
+			const struct inotify_event *e = (void *)&buf[i];
+			i += (ssize_t)(sizeof(*e) + e->len);
+			if (!(e->mask & IN_ISDIR) || !(e->mask & (IN_CREATE | IN_MOVED_TO))
+					|| e->wd < 0 || (size_t)e->wd >= vec_size(watch_dirs)
+					|| !watch_dirs[e->wd]) {
+				continue;
+			}
+			char path[PATH_MAX];
+			snprintf(path, PATH_MAX, "%s/%s", watch_dirs[e->wd], e->name);
+			watch_add_tree(fd, path);
+		}
+	} while (poll(&pfd, 1, WATCH_DEBOUNCE_MS) > 0);
+}
+
+static bool
+mtime_of(const char *path, struct timespec *ts)
+{
+	struct stat st;
+	if (stat(path, &st) < 0) return false;
+	*ts = st.st_mtim;
+	return true;
+}
+
+/* Starts skin-view and, when ready is given, waits until it has shown its
+ * first frame (or exited), which it reports by writing to a pipe. */
+static Proc
+watch_launch(const char *skin, bool ready)
+{
+	int fds[2] = { -1, -1 };
+	if (ready && pipe(fds) < 0) {
+		xfprintf(stderr, "Err: pipe: %s\n", strerror(errno));
+		ready = false;
+	}
+	/* Only the write end reaches skin-view */
+	if (ready) fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+	char **c = NULL;
+	char fd[16];
+	struct arena_mark save = arena_save();
+	vec_add_many(&c, "./skin-view", "-s", WATCH_STATE, 0);
+	if (ready) {
+		snprintf(fd, sizeof(fd), "%d", fds[1]);
+		vec_add_many(&c, "-r", fd, 0);
+	}
+	if (skin) vec_add(&c, (char*)skin);
+	Proc p = proc_run(c);
+	arena_restore(save);
+	if (!ready) return p;
+
+	close(fds[1]);
+	struct pollfd pfd = { .fd = fds[0], .events = POLLIN };
+	if (p != INVALID_PROC) {
+		while (poll(&pfd, 1, WATCH_READY_MS) < 0 && errno == EINTR);
+	}
+	close(fds[0]);
+	return p;
+}
+
+bool
+watch(const char *skin)
+{
+	int fd = inotify_init1(IN_CLOEXEC);
+	if (fd < 0) {
+		xfprintf(stderr, "Err: inotify_init1: %s\n", strerror(errno));
+		return false;
+	}
+	if (!watch_add_tree(fd, "src")
+			|| !watch_add_tree(fd, "resources")
+			|| !watch_add_tree(fd, "raylib/include")) {
+		close(fd);
+		return false;
+	}
+
+	if (!build()) {
+		close(fd);
+		return false;
+	}
+	remove_file(WATCH_STATE);
+	Proc p = watch_launch(skin, false);
+
+	while (p != INVALID_PROC) {
+		struct pollfd pfd = { .fd = fd, .events = POLLIN };
+		int r = poll(&pfd, 1, 250);
+		if (r < 0 && errno != EINTR) {
+			xfprintf(stderr, "Err: poll: %s\n", strerror(errno));
+			break;
+		}
+
+		if (waitpid(p, NULL, WNOHANG) == p) {
+			p = INVALID_PROC;
+			break;
+		}
+		if (r <= 0) continue;
+
+		double t0 = now_ms();
+		watch_drain(fd);
+
+		struct timespec before = {0}, after = {0};
+		mtime_of("skin-view", &before);
+		if (!build()) {
+			xfprintf(stderr, "WATCH\tbuild failed, keeping old binary\n");
+			continue;
+		}
+		double t1 = now_ms();
+
+		mtime_of("skin-view", &after);
+		if (before.tv_sec == after.tv_sec && before.tv_nsec == after.tv_nsec) {
+			continue;
+		}
+
+		/* skin-view saves skin path and camera to WATCH_STATE on SIGTERM */
+		kill(p, SIGTERM);
+		proc_wait(p);
+		p = watch_launch(NULL, true);
+		double t2 = now_ms();
+
+		/* Up to skin-view's first frame, not just its process start */
+		xfprintf(stdout, "WATCH\tbuild %.1f ms, relaunch %.1f ms, "
+			"save to running %.1f ms\n", t1 - t0, t2 - t1, t2 - t0);
+	}
+
+	close(fd);
+	return true;
+}
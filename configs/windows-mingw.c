@@ -2,15 +2,16 @@ bool
 build_bundle(void)
 {
 	const char *o = ".build/bundle.exe";
-	const char *s = "src/bundle.c";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	/* The bundler transcodes with these, see src/bundle.c */
+	const char *s[] = { "src/bundle.c", "src/inflate.h", "src/qoi.h" };
+	if (!target_needs_rebuild(o, s, 3)) return true;
 
 	xfprintf(stdout, "CCLD\t%s\n", o);
 	char **c = NULL;
-	size_t save = arena.count;
-	vec_add_many(&c, CC, "-o", o, s, 0);
+	struct arena_mark save = arena_save();
+	vec_add_many(&c, CC, "-o", o, s[0], 0);
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 
 	return result;
 }
@@ -19,30 +20,47 @@ bool
 build_bundle_h(void)
 {
 	const char *o = ".build/bundle.h";
-	const char *s = ".build/bundle.exe";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	struct arena_mark save = arena_save();
+	char **s = NULL;
+	vec_add(&s, ".build/bundle.exe");
+	if (!list_files("resources", NULL, &s)) {
+		arena_restore(save);
+		return false;
+	}
+	int rebuild = target_needs_rebuild(o, (const char **)s, vec_size(s));
+	if (rebuild <= 0) {
+		arena_restore(save);
+		return rebuild == 0;
+	}
 
 	xfprintf(stdout, "BUNDLE\t%s\n", o);
 	char **c = NULL;
-	size_t save = arena.count;
-	vec_add(&c, (char*)s);
+	vec_add(&c, s[0]);
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 
 	return result;
 }
 
 bool
-build_target(void)
+build_program(const char *o, const char *s)
 {
-	const char *o = "skin-view.exe";
-	const char *s = "src/main.c";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	struct arena_mark save = arena_save();
+	char **deps = NULL;
+	vec_add_many(&deps, s, ".build/bundle.h", 0);
+	if (!list_files("src", ".h", &deps)) {
+		arena_restore(save);
+		return false;
+	}
+	int rebuild = target_needs_rebuild(o, (const char **)deps, vec_size(deps));
+	if (rebuild <= 0) {
+		arena_restore(save);
+		return rebuild == 0;
+	}
 
 	xfprintf(stdout, "CCLD\t%s\n", o);
 	char **c = NULL;
 
-	size_t save = arena.count;
 	vec_add_many(&c, CC, "--std=c11", "-pedantic", "-Os", 0);
 	vec_add_many(&c, "-Wall", "-Wextra", "-Wshadow", 0);
 	vec_add_many(&c, "-Wconversion", "-Werror", 0);
@@ -50,13 +68,39 @@ build_target(void)
 	vec_add_many(&c, "-Iraylib/include", "-I.build", 0);
 	vec_add_many(&c, "-o", o, s, 0);
 	vec_add_many(&c, "-s", "-Lraylib/lib/x86_64-w64-mingw32", 0);
-	vec_add_many(&c, "-l:libraylib.a", "-lgdi32", "-lwinmm", 0);
+	vec_add_many(&c, "-l:libraylib.a", "-lgdi32", "-lwinmm", "-lpthread", 0);
 
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 	return result;
 }
 
+bool
+build_target(void)
+{
+	return build_program("skin-view.exe", "src/main.c");
+}
+
+bool
+build_bench(void)
+{
+	return build_program("skin-bench.exe", "src/bench.c");
+}
+
+/* Optional tools use POSIX sockets and threads */
+bool
+build_tools(void)
+{
+	xfprintf(stderr, "Tools are only built on Linux, skipping\n");
+	return true;
+}
+
+bool
+build_test(void)
+{
+	return build_program("skin-test.exe", "src/test.c");
+}
+
 bool
 build(void)
 {
@@ -65,13 +109,49 @@ build(void)
 		&& build_target();
 }
 
+bool
+run_bench(void)
+{
+	char **c = NULL;
+	struct arena_mark save = arena_save();
+	vec_add(&c, "./skin-bench.exe");
+	bool result = proc_wait(proc_run(c));
+	arena_restore(save);
+	return result;
+}
+
+bool
+run_test(bool update, double threshold)
+{
+	char **c = NULL;
+	char t[32];
+	struct arena_mark save = arena_save();
+	vec_add(&c, "./skin-test.exe");
+	if (update) vec_add(&c, "-u");
+	if (threshold > 0) {
+		snprintf(t, sizeof(t), "%g", threshold);
+		vec_add_many(&c, "-t", t, 0);
+	}
+	bool result = proc_wait(proc_run(c));
+	arena_restore(save);
+	return result;
+}
+
 bool
 run(void)
 {
 	char **c = NULL;
-	size_t save = arena.count;
+	struct arena_mark save = arena_save();
 	vec_add(&c, "./skin-view.exe");
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 	return result;
 }
+
+bool
+watch(const char *skin)
+{
+	(void)skin;
+	xfprintf(stderr, "Err: watch is only supported on Linux\n");
+	return false;
+}
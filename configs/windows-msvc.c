@@ -2,15 +2,16 @@ bool
 build_bundle(void)
 {
 	const char *o = ".build\\bundle.exe";
-	const char *s = "src\\bundle.c";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	/* The bundler transcodes with these, see src/bundle.c */
+	const char *s[] = { "src\\bundle.c", "src\\inflate.h", "src\\qoi.h" };
+	if (!target_needs_rebuild(o, s, 3)) return true;
 
 	xfprintf(stdout, "CCLD\t%s\n", o);
 	char **c = NULL;
-	size_t save = arena.count;
-	vec_add_many(&c, CC, "/Fo.build\\", "/Fe:", o, s, 0);
+	struct arena_mark save = arena_save();
+	vec_add_many(&c, CC, "/Fo.build\\", "/Fe:", o, s[0], 0);
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 
 	return result;
 }
@@ -19,25 +20,43 @@ bool
 build_bundle_h(void)
 {
 	const char *o = ".build\\bundle.h";
-	const char *s = ".build\\bundle.exe";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	struct arena_mark save = arena_save();
+	char **s = NULL;
+	vec_add(&s, ".build\\bundle.exe");
+	if (!list_files("resources", NULL, &s)) {
+		arena_restore(save);
+		return false;
+	}
+	int rebuild = target_needs_rebuild(o, (const char **)s, vec_size(s));
+	if (rebuild <= 0) {
+		arena_restore(save);
+		return rebuild == 0;
+	}
 
 	xfprintf(stdout, "BUNDLE\t%s\n", o);
 	char **c = NULL;
-	size_t save = arena.count;
-	vec_add(&c, (char*)s);
+	vec_add(&c, s[0]);
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 
 	return result;
 }
 
 bool
-build_target(void)
+build_program(const char *o, const char *s)
 {
-	const char *o = "skin-view.exe";
-	const char *s = "src/main.c";
-	if (!target_needs_rebuild(o, &s, 1)) return true;
+	struct arena_mark save = arena_save();
+	char **deps = NULL;
+	vec_add_many(&deps, s, ".build\\bundle.h", 0);
+	if (!list_files("src", ".h", &deps)) {
+		arena_restore(save);
+		return false;
+	}
+	int rebuild = target_needs_rebuild(o, (const char **)deps, vec_size(deps));
+	if (rebuild <= 0) {
+		arena_restore(save);
+		return rebuild == 0;
+	}
 
 	/* https://github.com/tsoding/musializer/blob/master/src_build/nob_win64_msvc.c */
 	/* https://github.com/raysan5/raylib/wiki/Working-on-Windows */
@@ -45,7 +64,6 @@ build_target(void)
 	xfprintf(stdout, "CCLD\t%s\n", o);
 	char **c = NULL;
 
-	size_t save = arena.count;
 	vec_add_many(&c, CC, "/std:c11", "/Os", "/Wall", 0);
 	vec_add_many(&c, "/D_WINSOCK_DEPRECATED_NO_WARNINGS", 0);
 	vec_add_many(&c, "/D_CRT_SECURE_NO_WARNINGS", 0);
@@ -53,17 +71,45 @@ build_target(void)
 	vec_add_many(&c, "/Fo.build\\", "/Fe:", o, s, 0);
 
 	vec_add_many(&c, "/link", "/NODEFAULTLIB:libcmt", 0);
-	vec_add_many(&c, "/SUBSYSTEM:WINDOWS", 0);
+	/* The viewer opens no console, the command line tools need one */
+	vec_add_many(&c, strcmp(o, "skin-view.exe")
+		? "/SUBSYSTEM:CONSOLE" : "/SUBSYSTEM:WINDOWS", 0);
 	vec_add_many(&c, "/LIBPATH:raylib\\lib\\x86_64-w64-msvc", 0);
 	vec_add_many(&c, "raylib.lib", "Winmm.lib", 0);
 	vec_add_many(&c, "gdi32.lib", "msvcrt.lib", 0);
 	vec_add_many(&c, "user32.lib", "shell32.lib", 0);
 
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 	return result;
 }
 
+bool
+build_target(void)
+{
+	return build_program("skin-view.exe", "src\\main.c");
+}
+
+bool
+build_bench(void)
+{
+	return build_program("skin-bench.exe", "src\\bench.c");
+}
+
+/* Optional tools use POSIX sockets and threads */
+bool
+build_tools(void)
+{
+	xfprintf(stderr, "Tools are only built on Linux, skipping\n");
+	return true;
+}
+
+bool
+build_test(void)
+{
+	return build_program("skin-test.exe", "src\\test.c");
+}
+
 bool
 build(void)
 {
@@ -72,13 +118,49 @@ build(void)
 		&& build_target();
 }
 
+bool
+run_bench(void)
+{
+	char **c = NULL;
+	struct arena_mark save = arena_save();
+	vec_add(&c, ".\\skin-bench.exe");
+	bool result = proc_wait(proc_run(c));
+	arena_restore(save);
+	return result;
+}
+
+bool
+run_test(bool update, double threshold)
+{
+	char **c = NULL;
+	char t[32];
+	struct arena_mark save = arena_save();
+	vec_add(&c, ".\\skin-test.exe");
+	if (update) vec_add(&c, "-u");
+	if (threshold > 0) {
+		snprintf(t, sizeof(t), "%g", threshold);
+		vec_add_many(&c, "-t", t, 0);
+	}
+	bool result = proc_wait(proc_run(c));
+	arena_restore(save);
+	return result;
+}
+
 bool
 run(void)
 {
 	char **c = NULL;
-	size_t save = arena.count;
+	struct arena_mark save = arena_save();
 	vec_add(&c, ".\\skin-view.exe");
 	bool result = proc_wait(proc_run(c));
-	arena.count = save;
+	arena_restore(save);
 	return result;
 }
+
+bool
+watch(const char *skin)
+{
+	(void)skin;
+	xfprintf(stderr, "Err: watch is only supported on Linux\n");
+	return false;
+}
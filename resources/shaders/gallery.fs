@@ -0,0 +1,17 @@
+#version 330
+
+in vec2 fragTexCoord;
+
+uniform sampler2D texture0;
+
+out vec4 finalColor;
+
+void main()
+{
+    vec4 texel = texture(texture0, fragTexCoord);
+
+    // Players are drawn in one batch, so an empty overlay texel must not
+    // hide the player behind it through the depth buffer
+    if (texel.a == 0.0) discard;
+    finalColor = texel;
+}
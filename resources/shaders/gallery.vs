@@ -0,0 +1,23 @@
+#version 330
+
+// Per instance placement, with the skin's tile in the atlas smuggled in the
+// bottom row of the transform, which is always 0 0 0 1 for these.
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+uniform vec2 tileScale;
+
+out vec2 fragTexCoord;
+
+void main()
+{
+    mat4 model = instanceTransform;
+    vec2 tile = vec2(model[0][3], model[1][3]);
+    model[0][3] = 0.0;
+    model[1][3] = 0.0;
+
+    fragTexCoord = (tile + vertexTexCoord)*tileScale;
+    gl_Position = mvp*model*vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,363 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "skin.h"
+
+#if defined(__SSE2__) || defined(_M_X64) \
+		|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIM_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Built-in animations for the six body parts. Each part turns about a
+ * pivot taken from its box: the head about the middle of its bottom face,
+ * legs about the middle of their top face and arms half their depth below
+ * that, where a shoulder would be. Overlay parts follow the part they
+ * cover.
+ *
+ * An animation is a loop of hz cycles a second, and every angle in it is
+ * bias + a * sin + b * cos of the loop's phase, so one sine and cosine per
+ * character and two per part are all the trigonometry a frame needs.
+ * Characters are kept as a struct of arrays and evaluated four at a time
+ * with SSE2 where there is one. What a frame leaves per part is the sine
+ * and cosine of both angles, stored the same way, four characters' worth
+ * of each next to each other; anim_matrix() makes the transform about the
+ * pivot from those for the characters that are drawn. Whole matrices
+ * would be three times the size, and for a crowd of 10k no longer fit in
+ * L2. */
+
+#define ANIM_JOINTS MODEL_LAYER_HEAD
+#define ANIM_LANES 4
+#define ANIM_TURN 4 /* floats a part: sin, cos of pitch, sin, cos of roll */
+
+static_assert(MODEL_COUNT == 2 * ANIM_JOINTS,
+	"every overlay part needs a part under it");
+
+enum anim {
+	ANIM_NONE = 0,
+	ANIM_IDLE,
+	ANIM_WALK,
+	ANIM_WAVE,
+	ANIM_COUNT
+};
+
+const char *anim_names[] = {
+	[ANIM_NONE] = "none",
+	[ANIM_IDLE] = "idle",
+	[ANIM_WALK] = "walk",
+	[ANIM_WAVE] = "wave",
+};
+
+/* Angles of a part about x (pitch, positive swings the lower end forward,
+ * towards -z) and then about z (roll, positive swings it towards +x), each
+ * as { bias, sin, cos } */
+struct anim_curve {
+	float hz;
+	float k[ANIM_JOINTS][2][3];
+};
+
+const struct anim_curve anim_curves[ANIM_COUNT] = {
+	[ANIM_NONE] = { 0 },
+	[ANIM_IDLE] = {
+		.hz = 0.25f,
+		.k = {
+			[MODEL_HEAD] = { { 0, 0.03f, 0 } },
+			[MODEL_RARM] = { { 0, 0.05f, 0 }, { 0.05f, 0, 0.05f } },
+			[MODEL_LARM] = { { 0, -0.05f, 0 }, { -0.05f, 0, -0.05f } },
+		},
+	},
+	[ANIM_WALK] = {
+		.hz = 1.0f,
+		.k = {
+			[MODEL_RARM] = { { 0, -0.6f, 0 }, { 0.05f, 0, 0 } },
+			[MODEL_LARM] = { { 0, 0.6f, 0 }, { -0.05f, 0, 0 } },
+			[MODEL_RLEG] = { { 0, 0.7f, 0 } },
+			[MODEL_LLEG] = { { 0, -0.7f, 0 } },
+		},
+	},
+	[ANIM_WAVE] = {
+		.hz = 1.5f,
+		.k = {
+			[MODEL_HEAD] = { { 0 }, { 0, 0.05f, 0 } },
+			[MODEL_RARM] = { { 0 }, { 2.6f, 0.35f, 0 } },
+			[MODEL_LARM] = { { 0 }, { -0.05f, 0, 0 } },
+		},
+	},
+};
+
+struct anim_rig {
+	float pivot[ANIM_JOINTS][3];
+};
+
+/* Characters, count of them in use and room for cap, which is a multiple
+ * of ANIM_LANES. Set anim[] and phase[] freely; the characters past count
+ * up to cap are evaluated too and stay in the rest pose. */
+struct anim_batch {
+	size_t count, cap;
+	unsigned char *anim; /* enum anim */
+	float *phase;        /* cycles into the loop, in [0, 1) */
+	float *turn;         /* per ANIM_LANES characters and part: ANIM_TURN
+	                        values, each one for every lane */
+};
+
+/* Pivots from the bounding boxes of the parts (indexed by enum model, the
+ * overlay ones are not looked at) */
+void
+anim_rig_init(struct anim_rig *rig, const BoundingBox *parts)
+{
+	for (size_t j = 0; j < ANIM_JOINTS; j++) {
+		const BoundingBox b = parts[j];
+		float *p = rig->pivot[j];
+		p[0] = (b.min.x + b.max.x) / 2;
+		p[1] = b.max.y;
+		p[2] = (b.min.z + b.max.z) / 2;
+		if (j == MODEL_HEAD)
+			p[1] = b.min.y;
+		else if (j == MODEL_LARM || j == MODEL_RARM)
+			p[1] = b.max.y - (b.max.z - b.min.z) / 2;
+	}
+}
+
+void
+anim_batch_free(struct anim_batch *b)
+{
+	free(b->anim);
+	free(b->phase);
+	free(b->turn);
+	*b = (struct anim_batch){ 0 };
+}
+
+/* Makes room for count characters, new ones standing still at phase 0.
+ * False if memory runs out, leaving b as it was. */
+bool
+anim_batch_resize(struct anim_batch *b, size_t count)
+{
+	if (count > b->cap) {
+		size_t cap = b->cap ? b->cap : ANIM_LANES;
+		while (cap < count)
+			cap *= 2;
+		unsigned char *anim = realloc(b->anim, cap);
+		if (anim)
+			b->anim = anim;
+		float *phase = realloc(b->phase, sizeof(*phase) * cap);
+		if (phase)
+			b->phase = phase;
+		float *turn = realloc(b->turn,
+			sizeof(*turn) * cap * ANIM_JOINTS * ANIM_TURN);
+		if (turn)
+			b->turn = turn;
+		if (!anim || !phase || !turn)
+			return 0;
+		memset(b->anim + b->cap, ANIM_NONE, cap - b->cap);
+		memset(b->phase + b->cap, 0, sizeof(*phase) * (cap - b->cap));
+		b->cap = cap;
+	}
+	if (count > b->count) {
+		memset(b->anim + b->count, ANIM_NONE, count - b->count);
+		memset(b->phase + b->count, 0, sizeof(*b->phase)
+			* (count - b->count));
+	}
+	b->count = count;
+	return 1;
+}
+
+/* Where value e of part j of character i lives in turn */
+static size_t
+anim_turn_index(size_t i, size_t j, size_t e)
+{
+	return ((i / ANIM_LANES * ANIM_JOINTS + j) * ANIM_TURN + e)
+		* ANIM_LANES + i % ANIM_LANES;
+}
+
+static void
+anim_eval_one(struct anim_batch *b, size_t i, float dt)
+{
+	const struct anim_curve *c = &anim_curves[b->anim[i]];
+	float phase = b->phase[i] + dt * c->hz;
+	phase -= floorf(phase);
+	b->phase[i] = phase;
+	const float s = sinf(phase * 6.28318531f), co = cosf(phase * 6.28318531f);
+
+	float *out = b->turn + anim_turn_index(i, 0, 0);
+	for (size_t a = 0; a < ANIM_JOINTS * 2; a++, out += 2 * ANIM_LANES) {
+		const float *k = (const float *)c->k + a * 3;
+		const float angle = k[0] + k[1] * s + k[2] * co;
+		out[0] = sinf(angle);
+		out[ANIM_LANES] = cosf(angle);
+	}
+}
+
+#if defined(ANIM_SSE2)
+/* Sine and cosine of n vectors of four angles, to about float precision
+ * for angles of a few turns: a quarter turn reduction split in three so it
+ * stays exact, then minimax polynomials on [-pi/4, pi/4]. Taking arrays
+ * keeps the work in one call, -Os would not inline a call per vector. */
+static void
+anim_sincos4(const __m128 *x, size_t n, __m128 *sin_out, __m128 *cos_out)
+{
+	for (size_t i = 0; i < n; i++) {
+		const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x[i],
+			_mm_set1_ps(0.636619772f)));
+		const __m128 qf = _mm_cvtepi32_ps(q);
+		__m128 r = _mm_sub_ps(x[i], _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+		r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+		r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+
+		const __m128 r2 = _mm_mul_ps(r, r);
+		__m128 sp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2),
+			_mm_set1_ps(8.3321608736e-3f));
+		sp = _mm_add_ps(_mm_mul_ps(sp, r2), _mm_set1_ps(-1.6666654611e-1f));
+		sp = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sp, r2), r), r);
+		__m128 cp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), r2),
+			_mm_set1_ps(-1.388731625493765e-3f));
+		cp = _mm_add_ps(_mm_mul_ps(cp, r2), _mm_set1_ps(4.166664568298827e-2f));
+		cp = _mm_mul_ps(_mm_mul_ps(cp, r2), r2);
+		cp = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f),
+			_mm_mul_ps(r2, _mm_set1_ps(0.5f))), cp);
+
+		/* Odd quadrants swap the two, and each gets the sign of its own */
+		const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(
+			_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		const __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+		const __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)),
+			_mm_set1_epi32(2)), 30));
+		sin_out[i] = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cp),
+			_mm_andnot_ps(swap, sp)), sin_sign);
+		cos_out[i] = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sp),
+			_mm_andnot_ps(swap, cp)), cos_sign);
+	}
+}
+
+static void
+anim_eval_lanes(struct anim_batch *b, size_t i, float dt)
+{
+	const float *k[ANIM_LANES];
+	float hz[ANIM_LANES];
+	for (size_t l = 0; l < ANIM_LANES; l++) {
+		const struct anim_curve *c = &anim_curves[b->anim[i + l]];
+		k[l] = (const float *)c->k;
+		hz[l] = c->hz;
+	}
+	const size_t lanes = k[0] == k[1] && k[0] == k[2] && k[0] == k[3]
+		? 1 : ANIM_LANES;
+
+	/* Phases are never negative, so truncating is flooring */
+	__m128 phase = _mm_add_ps(_mm_loadu_ps(b->phase + i),
+		_mm_mul_ps(_mm_set1_ps(dt), _mm_loadu_ps(hz)));
+	phase = _mm_sub_ps(phase, _mm_cvtepi32_ps(_mm_cvttps_epi32(phase)));
+	_mm_storeu_ps(b->phase + i, phase);
+	__m128 s, co;
+	phase = _mm_mul_ps(phase, _mm_set1_ps(6.28318531f));
+	anim_sincos4(&phase, 1, &s, &co);
+
+	/* Most parts hold still in most animations, so only the angles some
+	 * lane moves are worked out */
+	__m128 angle[ANIM_JOINTS * 2], sin_moved[ANIM_JOINTS * 2],
+		cos_moved[ANIM_JOINTS * 2];
+	size_t moved[ANIM_JOINTS * 2], n = 0;
+	for (size_t a = 0; a < ANIM_JOINTS * 2; a++) {
+		bool moves = 0;
+		for (size_t l = 0; l < lanes; l++) {
+			const float *f = k[l] + a * 3;
+			moves |= f[0] != 0 || f[1] != 0 || f[2] != 0;
+		}
+		if (!moves)
+			continue;
+		__m128 f[3];
+		for (size_t m = 0; m < 3; m++) {
+			const size_t at = a * 3 + m;
+			f[m] = lanes == 1 ? _mm_set1_ps(k[0][at])
+				: _mm_setr_ps(k[0][at], k[1][at], k[2][at], k[3][at]);
+		}
+		angle[n] = _mm_add_ps(f[0], _mm_add_ps(_mm_mul_ps(f[1], s),
+			_mm_mul_ps(f[2], co)));
+		moved[n++] = a;
+	}
+	anim_sincos4(angle, n, sin_moved, cos_moved);
+
+	float *out = b->turn + anim_turn_index(i, 0, 0);
+	for (size_t a = 0; a < ANIM_JOINTS * 2; a++) {
+		_mm_storeu_ps(out + a * 2 * ANIM_LANES, _mm_setzero_ps());
+		_mm_storeu_ps(out + (a * 2 + 1) * ANIM_LANES, _mm_set1_ps(1.0f));
+	}
+	for (size_t m = 0; m < n; m++) {
+		_mm_storeu_ps(out + moved[m] * 2 * ANIM_LANES, sin_moved[m]);
+		_mm_storeu_ps(out + (moved[m] * 2 + 1) * ANIM_LANES, cos_moved[m]);
+	}
+}
+#endif
+
+/* Moves every character dt seconds along its animation and works out how
+ * far each part is turned where that leaves it */
+void
+anim_batch_update(struct anim_batch *b, float dt)
+{
+	size_t i = 0;
+#if defined(ANIM_SSE2)
+	for (; i + ANIM_LANES <= b->cap; i += ANIM_LANES)
+		anim_eval_lanes(b, i, dt);
+#endif
+	for (; i < b->cap; i++)
+		anim_eval_one(b, i, dt);
+}
+
+/* The transform of part j (enum model) of character i as of the last
+ * update: pitch, then roll, about the part's pivot */
+Matrix
+anim_matrix(const struct anim_batch *b, const struct anim_rig *rig,
+	size_t i, size_t j)
+{
+	j %= ANIM_JOINTS;
+	const float *t = b->turn + anim_turn_index(i, j, 0);
+	const float sa = t[0], ca = t[ANIM_LANES];
+	const float sb = t[2 * ANIM_LANES], cb = t[3 * ANIM_LANES];
+	const float r[3][3] = {
+		{ cb, -sb * ca,  sb * sa },
+		{ sb,  cb * ca, -cb * sa },
+		{ 0,   sa,       ca      },
+	};
+	const float *p = rig->pivot[j];
+	float o[3];
+	for (size_t row = 0; row < 3; row++)
+		o[row] = p[row] - (r[row][0] * p[0] + r[row][1] * p[1]
+			+ r[row][2] * p[2]);
+	return (Matrix){
+		r[0][0], r[0][1], r[0][2], o[0],
+		r[1][0], r[1][1], r[1][2], o[1],
+		r[2][0], r[2][1], r[2][2], o[2],
+		0,       0,       0,       1,
+	};
+}
+
+/* Poses models as character i */
+void
+anim_apply(Model *models, const struct anim_batch *b,
+	const struct anim_rig *rig, size_t i)
+{
+	for (size_t j = 0; j < MODEL_COUNT; j++)
+		models[j].transform = anim_matrix(b, rig, i, j);
+}
+
+/* Parses an animation name, false if there is none by that name */
+bool
+anim_parse(const char *name, enum anim *anim)
+{
+	for (size_t i = 0; i < ANIM_COUNT; i++) {
+		if (!strcmp(name, anim_names[i])) {
+			*anim = (enum anim)i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+#endif /* ANIM_H */
@@ -0,0 +1,670 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "inflate.h"
+#include "thread.h"
+
+/* Skins straight out of tar and zip archives, without extracting them.
+ *
+ * A reader thread goes through the archive once, front to back: tar
+ * headers as they come (so "-" reads a tar from a pipe, compressed by
+ * whatever is on the other end), zip members in central directory order.
+ * Member bytes wait in a queue bounded both in members and in bytes, so
+ * an archive of any size takes at most ARCHIVE_BUDGET bytes of memory
+ * plus one member too large to share. Deflated zip members are inflated
+ * by whichever thread takes them in archive_next(), so decompression runs
+ * on the decode threads in parallel rather than in front of them. */
+
+#define ARCHIVE_DEPTH 256
+#define ARCHIVE_BUDGET (32 << 20)
+#define ARCHIVE_MAX_MEMBER (64 << 20)
+#define ARCHIVE_MAX_NAME 4096
+#define ARCHIVE_CHUNK (256 * 1024) /* fits any zip directory record */
+
+enum archive_kind {
+	ARCHIVE_TAR = 0,
+	ARCHIVE_ZIP,
+};
+
+const char *archive_kind_names[] = {
+	[ARCHIVE_TAR] = "tar",
+	[ARCHIVE_ZIP] = "zip",
+};
+
+struct archive_member {
+	char *name;
+	unsigned char *data;
+	size_t size;
+	const char *error; /* NULL when data holds the whole member */
+	size_t index;      /* among the members handed out */
+
+	size_t packed;     /* bytes of data as read, deflated or not */
+	size_t charge;     /* bytes counted against the budget */
+	bool deflated;
+};
+
+struct archive {
+	enum archive_kind kind;
+	int fd;
+	const char *ext; /* only members with these extensions, ';' separated,
+	                  * NULL for all */
+	const char *error; /* why reading stopped early, NULL at the end */
+	size_t members, skipped;
+
+	/* Buffered reads for tar members and zip directory records */
+	unsigned char *chunk;
+	size_t chunk_pos, chunk_len;
+	int64_t offset; /* of chunk[chunk_len] in the file */
+	uint64_t zip_entries;
+	int64_t zip_dir;
+
+	thread_mutex lock;
+	thread_cond wake;
+	thread_handle reader;
+	struct archive_member queue[ARCHIVE_DEPTH];
+	unsigned head, nqueued;
+	size_t bytes;
+	bool done, quit;
+};
+
+static uint16_t
+archive_le16(const unsigned char *p)
+{
+	return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t
+archive_le32(const unsigned char *p)
+{
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16
+		| (uint32_t)p[3] << 24;
+}
+
+static uint64_t
+archive_le64(const unsigned char *p)
+{
+	return archive_le32(p) | (uint64_t)archive_le32(p + 4) << 32;
+}
+
+static bool
+archive_pread(int fd, void *buf, size_t len, int64_t offset)
+{
+	unsigned char *p = buf;
+	while (len) {
+		ssize_t n = pread(fd, p, len, (off_t)offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return 0;
+		p += n;
+		len -= (size_t)n;
+		offset += n;
+	}
+	return 1;
+}
+
+/* Makes at least need bytes available at chunk + chunk_pos. Tar reads go
+ * through read() so pipes work, zip directory reads through pread(). */
+static bool
+archive_fill(struct archive *a, size_t need)
+{
+	if (a->chunk_len - a->chunk_pos >= need)
+		return 1;
+	memmove(a->chunk, a->chunk + a->chunk_pos, a->chunk_len - a->chunk_pos);
+	a->chunk_len -= a->chunk_pos;
+	a->chunk_pos = 0;
+	while (a->chunk_len < need) {
+		ssize_t n = a->kind == ARCHIVE_TAR
+			? read(a->fd, a->chunk + a->chunk_len,
+				ARCHIVE_CHUNK - a->chunk_len)
+			: pread(a->fd, a->chunk + a->chunk_len,
+				ARCHIVE_CHUNK - a->chunk_len, (off_t)a->offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return 0;
+		a->chunk_len += (size_t)n;
+		a->offset += n;
+	}
+	return 1;
+}
+
+/* Copies the next len bytes of a tar stream to buf, or drops them when buf
+ * is NULL */
+static bool
+archive_take(struct archive *a, unsigned char *buf, size_t len)
+{
+	while (len) {
+		if (!archive_fill(a, 1))
+			return 0;
+		size_t n = a->chunk_len - a->chunk_pos;
+		if (n > len)
+			n = len;
+		if (buf) {
+			memcpy(buf, a->chunk + a->chunk_pos, n);
+			buf += n;
+		}
+		a->chunk_pos += n;
+		len -= n;
+	}
+	return 1;
+}
+
+/* Whether name is a file ending in one of a->ext, in any case.
+ * IsFileExtension() would do, but not from the reader thread. */
+static bool
+archive_wanted(const struct archive *a, const char *name)
+{
+	const size_t len = strlen(name);
+	if (!len || name[len - 1] == '/')
+		return 0;
+	if (!a->ext)
+		return 1;
+	for (const char *ext = a->ext; *ext; ext += strspn(ext, ";")) {
+		const size_t n = strcspn(ext, ";");
+		bool match = n && n <= len;
+		for (size_t i = 0; match && i < n; i++) {
+			match = tolower((unsigned char)name[len - n + i])
+				== tolower((unsigned char)ext[i]);
+		}
+		if (match)
+			return 1;
+		ext += n;
+	}
+	return 0;
+}
+
+/* Queues a member, waiting for room first. Takes name and data. */
+static bool
+archive_push(struct archive *a, struct archive_member *m)
+{
+	m->charge = m->packed + (m->deflated ? m->size : 0);
+	thread_mutex_lock(&a->lock);
+	while (!a->quit && (a->nqueued == ARCHIVE_DEPTH
+			|| (a->bytes && a->bytes + m->charge > ARCHIVE_BUDGET)))
+		thread_cond_wait(&a->wake, &a->lock);
+	bool ok = !a->quit;
+	if (ok) {
+		m->index = a->members++;
+		a->queue[(a->head + a->nqueued++) % ARCHIVE_DEPTH] = *m;
+		a->bytes += m->charge;
+		thread_cond_broadcast(&a->wake);
+	}
+	thread_mutex_unlock(&a->lock);
+	if (!ok) {
+		free(m->name);
+		free(m->data);
+	}
+	return ok;
+}
+
+/* Room for the packed bytes of m, or NULL with m->error set. Members
+ * that do not fit are not read and count for nothing against the budget. */
+static unsigned char *
+archive_load(struct archive_member *m)
+{
+	unsigned char *data = NULL;
+	if (m->packed > ARCHIVE_MAX_MEMBER || m->size > ARCHIVE_MAX_MEMBER)
+		m->error = "too large";
+	else if (!(data = malloc(m->packed ? m->packed : 1)))
+		m->error = "out of memory";
+	if (!data)
+		m->packed = m->size = 0;
+	return data;
+}
+
+/* A tar number: octal, or base 256 when the top bit is set */
+static bool
+archive_tar_number(const unsigned char *p, size_t len, uint64_t *v)
+{
+	*v = 0;
+	if (p[0] & 0x80) {
+		if (p[0] != 0x80)
+			return 0;
+		for (size_t i = 1; i < len; i++) {
+			if (*v >> 56)
+				return 0;
+			*v = *v << 8 | p[i];
+		}
+		return 1;
+	}
+	size_t i = 0;
+	while (i < len && p[i] == ' ')
+		i++;
+	for (; i < len && p[i] >= '0' && p[i] <= '7'; i++)
+		*v = *v << 3 | (uint64_t)(p[i] - '0');
+	return i == len || p[i] == ' ' || p[i] == '\0';
+}
+
+static bool
+archive_tar_header(const unsigned char *h)
+{
+	uint64_t sum;
+	if (!archive_tar_number(h + 148, 8, &sum))
+		return 0;
+	uint64_t check = 8 * ' ';
+	for (size_t i = 0; i < 512; i++)
+		check += i >= 148 && i < 156 ? 0 : h[i];
+	return sum == check;
+}
+
+/* The path record of a pax extended header, if there is one */
+static char *
+archive_pax_path(const unsigned char *data, size_t len)
+{
+	size_t i = 0;
+	while (i < len) {
+		size_t rec = 0, j = i;
+		while (j < len && data[j] >= '0' && data[j] <= '9')
+			rec = rec * 10 + (size_t)(data[j++] - '0');
+		if (rec > len - i || j + 1 >= i + rec || data[j] != ' ')
+			return NULL;
+		const char *kv = (const char *)data + j + 1;
+		const size_t kvlen = i + rec - (j + 1) - 1; /* minus newline */
+		if (kvlen > 5 && !memcmp(kv, "path=", 5)
+				&& kvlen - 5 < ARCHIVE_MAX_NAME) {
+			char *name = malloc(kvlen - 4);
+			if (name) {
+				memcpy(name, kv + 5, kvlen - 5);
+				name[kvlen - 5] = '\0';
+			}
+			return name;
+		}
+		i += rec;
+	}
+	return NULL;
+}
+
+static const char *
+archive_tar(struct archive *a)
+{
+	char *longname = NULL;
+	const char *error = NULL;
+	for (;;) {
+		if (!archive_fill(a, 512)) {
+			error = "truncated"; /* no end of archive blocks */
+			break;
+		}
+		unsigned char *h = a->chunk + a->chunk_pos;
+		unsigned char zero[512] = { 0 };
+		if (!memcmp(h, zero, 512))
+			break; /* end of archive */
+		if (!archive_tar_header(h)) {
+			error = "bad tar header";
+			break;
+		}
+
+		uint64_t size;
+		if (!archive_tar_number(h + 124, 12, &size)
+				|| size > INT64_MAX - 511) {
+			error = "bad tar header";
+			break;
+		}
+		const char type = (char)h[156];
+		char name[256 + 100 + 1];
+		if (!memcmp(h + 257, "ustar", 5) && h[345]) {
+			snprintf(name, sizeof(name), "%.155s/%.100s", h + 345, h);
+		} else {
+			snprintf(name, sizeof(name), "%.100s", h);
+		}
+		a->chunk_pos += 512;
+		const uint64_t padded = (size + 511) & ~(uint64_t)511;
+
+		/* GNU long names and pax headers name the member after them */
+		if ((type == 'L' || type == 'x') && size < ARCHIVE_MAX_NAME) {
+			unsigned char buf[ARCHIVE_MAX_NAME];
+			if (!archive_take(a, buf, (size_t)size)
+					|| !archive_take(a, NULL, (size_t)(padded - size))) {
+				error = "truncated";
+				break;
+			}
+			char *next = type == 'L'
+				? strndup((const char *)buf, (size_t)size)
+				: archive_pax_path(buf, (size_t)size);
+			if (next) {
+				free(longname);
+				longname = next;
+			}
+			continue;
+		}
+
+		const char *path = longname ? longname : name;
+		bool file = type == '0' || type == '\0' || type == '7';
+		if (!file || !archive_wanted(a, path)) {
+			a->skipped += file;
+			free(longname);
+			longname = NULL;
+			if (!archive_take(a, NULL, padded)) {
+				error = "truncated";
+				break;
+			}
+			continue;
+		}
+
+		struct archive_member m = {
+			.name = longname ? longname : strdup(name),
+			.size = (size_t)size,
+			.packed = (size_t)size,
+		};
+		longname = NULL;
+		if (!m.name) {
+			error = "out of memory";
+			break;
+		}
+		m.data = archive_load(&m);
+		if (!m.data) {
+			if (!archive_take(a, NULL, padded)) {
+				free(m.name);
+				error = "truncated";
+				break;
+			}
+		} else if (!archive_take(a, m.data, m.size)
+				|| !archive_take(a, NULL, padded - size)) {
+			free(m.name);
+			free(m.data);
+			error = "truncated";
+			break;
+		}
+		if (!archive_push(a, &m))
+			break;
+	}
+	free(longname);
+	return error;
+}
+
+/* Finds the central directory from the end of central directory record,
+ * or its zip64 version */
+static bool
+archive_zip_directory(struct archive *a)
+{
+	const off_t end = lseek(a->fd, 0, SEEK_END);
+	if (end < 22)
+		return 0;
+	size_t tail = end < 65536 + 22 ? (size_t)end : 65536 + 22;
+	unsigned char *buf = malloc(tail);
+	if (!buf || !archive_pread(a->fd, buf, tail, end - (off_t)tail)) {
+		free(buf);
+		return 0;
+	}
+
+	bool ok = false;
+	for (size_t i = tail - 22 + 1; i-- > 0;) {
+		const unsigned char *e = buf + i;
+		if (archive_le32(e) != 0x06054b50
+				|| i + 22 + archive_le16(e + 20) != tail)
+			continue;
+		a->zip_entries = archive_le16(e + 10);
+		a->zip_dir = archive_le32(e + 16);
+		ok = true;
+
+		/* The zip64 locator sits right before it */
+		const int64_t at = end - (off_t)tail + (off_t)i;
+		unsigned char loc[20], rec[56];
+		if (at >= 20 && archive_pread(a->fd, loc, 20, at - 20)
+				&& archive_le32(loc) == 0x07064b50) {
+			const uint64_t off = archive_le64(loc + 8);
+			ok = off <= INT64_MAX
+				&& archive_pread(a->fd, rec, 56, (int64_t)off)
+				&& archive_le32(rec) == 0x06064b50
+				&& archive_le64(rec + 48) <= INT64_MAX;
+			if (ok) {
+				a->zip_entries = archive_le64(rec + 32);
+				a->zip_dir = (int64_t)archive_le64(rec + 48);
+			}
+		}
+		break;
+	}
+	free(buf);
+	return ok;
+}
+
+/* Sizes and offset that do not fit in 32 bits are in the zip64 field of
+ * extra, in that order and only if they overflowed */
+static bool
+archive_zip64(const unsigned char *extra, size_t len, uint64_t *usize,
+	uint64_t *csize, uint64_t *offset)
+{
+	uint64_t *fields[3] = { usize, csize, offset };
+	while (len >= 4) {
+		const uint16_t id = archive_le16(extra);
+		const size_t n = archive_le16(extra + 2);
+		if (n > len - 4)
+			return 0;
+		if (id == 0x0001) {
+			const unsigned char *p = extra + 4;
+			size_t left = n;
+			for (size_t i = 0; i < 3; i++) {
+				if (*fields[i] != 0xffffffffu)
+					continue;
+				if (left < 8)
+					return 0;
+				*fields[i] = archive_le64(p);
+				p += 8;
+				left -= 8;
+			}
+			return 1;
+		}
+		extra += 4 + n;
+		len -= 4 + n;
+	}
+	return *usize != 0xffffffffu && *csize != 0xffffffffu
+		&& *offset != 0xffffffffu;
+}
+
+static const char *
+archive_zip(struct archive *a)
+{
+	if (!archive_zip_directory(a))
+		return "no zip directory";
+	a->offset = a->zip_dir;
+
+	for (uint64_t e = 0; e < a->zip_entries; e++) {
+		if (!archive_fill(a, 46))
+			return "truncated";
+		const unsigned char *d = a->chunk + a->chunk_pos;
+		if (archive_le32(d) != 0x02014b50)
+			return "bad zip directory";
+		const size_t name_len = archive_le16(d + 28);
+		const size_t extra_len = archive_le16(d + 30);
+		const size_t record = 46 + name_len + extra_len
+			+ archive_le16(d + 32);
+		if (!archive_fill(a, record))
+			return "truncated";
+		d = a->chunk + a->chunk_pos;
+		a->chunk_pos += record;
+
+		char name[ARCHIVE_MAX_NAME];
+		if (name_len >= sizeof(name))
+			continue;
+		memcpy(name, d + 46, name_len);
+		name[name_len] = '\0';
+		if (memchr(name, '\0', name_len) || !archive_wanted(a, name)) {
+			a->skipped += name_len && name[name_len - 1] != '/';
+			continue;
+		}
+
+		const uint16_t flags = archive_le16(d + 8);
+		const uint16_t method = archive_le16(d + 10);
+		uint64_t csize = archive_le32(d + 20), usize = archive_le32(d + 24);
+		uint64_t offset = archive_le32(d + 42);
+		struct archive_member m = { .name = strdup(name) };
+		if (!m.name)
+			return "out of memory";
+		if (!archive_zip64(d + 46 + name_len, extra_len, &usize, &csize,
+				&offset))
+			m.error = "bad zip64 sizes";
+		else if (flags & 1)
+			m.error = "encrypted";
+		else if (method != 0 && method != 8)
+			m.error = "unsupported compression";
+		else if (method == 0 && csize != usize)
+			m.error = "bad zip directory";
+		else if (csize > ARCHIVE_MAX_MEMBER || usize > ARCHIVE_MAX_MEMBER)
+			m.error = "too large";
+		m.packed = m.error ? 0 : (size_t)csize;
+		m.size = m.error ? 0 : (size_t)usize;
+		m.deflated = method == 8;
+
+		/* The local header's own name and extra fields come first */
+		unsigned char local[30];
+		if (!m.error && (offset > INT64_MAX - 30
+				|| !archive_pread(a->fd, local, 30, (int64_t)offset)
+				|| archive_le32(local) != 0x04034b50))
+			m.error = "bad local header";
+		if (!m.error) {
+			m.data = archive_load(&m);
+			const int64_t at = (int64_t)offset + 30
+				+ archive_le16(local + 26) + archive_le16(local + 28);
+			if (m.data && !archive_pread(a->fd, m.data, m.packed, at))
+				m.error = "truncated";
+		}
+		if (m.error) {
+			free(m.data);
+			m.data = NULL;
+			m.packed = m.size = 0;
+			m.deflated = false;
+		}
+		if (!archive_push(a, &m))
+			return NULL;
+	}
+	return NULL;
+}
+
+static void
+archive_reader(void *arg)
+{
+	struct archive *a = arg;
+	const char *error = a->kind == ARCHIVE_ZIP ? archive_zip(a)
+		: archive_tar(a);
+	thread_mutex_lock(&a->lock);
+	a->error = error;
+	a->done = true;
+	thread_cond_broadcast(&a->wake);
+	thread_mutex_unlock(&a->lock);
+}
+
+/* Opens a tar or zip archive, or a tar on stdin for "-", and starts
+ * reading members whose name ends in ext (any if NULL). Returns false with
+ * a->error set if it is neither. */
+bool
+archive_open(struct archive *a, const char *path, const char *ext)
+{
+	*a = (struct archive){ .fd = -1, .ext = ext };
+	a->fd = strcmp(path, "-") ? open(path, O_RDONLY | O_CLOEXEC) : 0;
+	a->chunk = malloc(ARCHIVE_CHUNK);
+	if (a->fd < 0 || !a->chunk) {
+		a->error = a->fd < 0 ? strerror(errno) : "out of memory";
+		goto fail;
+	}
+
+	/* Zip archives start with a local header (or the end record, when
+	 * empty); anything else has to be a tar from its first header on */
+	if (!archive_fill(a, 4)) {
+		a->error = "not a tar or zip archive";
+		goto fail;
+	}
+	const uint32_t magic = archive_le32(a->chunk);
+	if (magic == 0x04034b50 || magic == 0x06054b50) {
+		if (lseek(a->fd, 0, SEEK_CUR) < 0) {
+			a->error = "zip archives can not be read from a pipe";
+			goto fail;
+		}
+		a->kind = ARCHIVE_ZIP;
+		a->chunk_pos = a->chunk_len = 0;
+	} else if (!archive_fill(a, 512)
+			|| !archive_tar_header(a->chunk)) {
+		a->error = "not a tar or zip archive";
+		goto fail;
+	}
+
+	thread_mutex_init(&a->lock);
+	thread_cond_init(&a->wake);
+	if (thread_start(&a->reader, archive_reader, a))
+		return 1;
+	thread_cond_destroy(&a->wake);
+	thread_mutex_destroy(&a->lock);
+	a->error = "could not start a thread";
+fail:
+	if (a->fd > 0)
+		close(a->fd);
+	free(a->chunk);
+	a->fd = -1;
+	a->chunk = NULL;
+	return 0;
+}
+
+/* Waits for the next member and inflates it if need be. Returns false at
+ * the end of the archive, with a->error saying if that came early. */
+bool
+archive_next(struct archive *a, struct archive_member *m)
+{
+	thread_mutex_lock(&a->lock);
+	while (!a->nqueued && !a->done)
+		thread_cond_wait(&a->wake, &a->lock);
+	bool ok = a->nqueued;
+	if (ok) {
+		*m = a->queue[a->head];
+		a->head = (a->head + 1) % ARCHIVE_DEPTH;
+		a->nqueued--;
+		thread_cond_broadcast(&a->wake);
+	}
+	thread_mutex_unlock(&a->lock);
+	if (!ok || !m->deflated)
+		return ok;
+
+	unsigned char *out = malloc(m->size ? m->size : 1);
+	if (!out)
+		m->error = "out of memory";
+	else if (!inflate_raw(m->data, m->packed, out, m->size))
+		m->error = "bad deflate data";
+	free(m->data);
+	m->data = out;
+	return 1;
+}
+
+/* Frees a member and makes room for more */
+void
+archive_release(struct archive *a, struct archive_member *m)
+{
+	free(m->name);
+	free(m->data);
+	thread_mutex_lock(&a->lock);
+	a->bytes -= m->charge;
+	thread_cond_broadcast(&a->wake);
+	thread_mutex_unlock(&a->lock);
+}
+
+/* Stops reading, early or not; members handed out must be released first */
+void
+archive_close(struct archive *a)
+{
+	thread_mutex_lock(&a->lock);
+	a->quit = true;
+	thread_cond_broadcast(&a->wake);
+	thread_mutex_unlock(&a->lock);
+	thread_join(a->reader);
+
+	for (; a->nqueued; a->nqueued--) {
+		struct archive_member *m = &a->queue[a->head];
+		free(m->name);
+		free(m->data);
+		a->head = (a->head + 1) % ARCHIVE_DEPTH;
+	}
+	thread_cond_destroy(&a->wake);
+	thread_mutex_destroy(&a->lock);
+	if (a->fd > 0)
+		close(a->fd);
+	free(a->chunk);
+}
+
+#endif /* ARCHIVE_H */
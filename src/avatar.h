@@ -0,0 +1,104 @@
+#ifndef AVATAR_H
+#define AVATAR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "raylib.h"
+#include "ortho.h"
+
+/* Head avatars: the front of the head with the hat layer over it. Skins are
+ * 64 texels wide scaled by an integer u, either square or (legacy) half as
+ * tall; the head sits at the same place in both layouts. */
+
+#define AVATAR_FACE_X 8
+#define AVATAR_HAT_X 40
+#define AVATAR_Y 8
+#define AVATAR_EDGE 8
+
+/* Texels per skin texel, or 0 if the size is not one we know */
+int
+avatar_unit(int width, int height)
+{
+	if (width < 64 || width % 64)
+		return 0;
+	if (height != width && height != width / 2)
+		return 0;
+	return width / 64;
+}
+
+/* Old clients ignored hat transparency, and legacy skins often fill the hat
+ * area with an opaque colour. Like the game, treat a hat without a single
+ * transparent texel as absent on those. */
+static bool
+avatar_hat_used(const uint32_t *px, int stride, int x0, int y0, int edge)
+{
+	for (int y = 0; y < edge; y++) {
+		const uint32_t *row = px + (size_t)(y0 + y) * (size_t)stride + x0;
+		for (int x = 0; x < edge; x++) {
+			if (row[x] >> 24 != 255)
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/* Writes the composited head (8u by 8u texels) of an RGBA8 skin to out,
+ * returning its edge length or 0 for unsupported sizes. */
+int
+avatar_extract(const Image *skin, uint32_t *out)
+{
+	int u = avatar_unit(skin->width, skin->height);
+	if (!u || skin->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+		return 0;
+
+	const uint32_t *px = skin->data;
+	const int edge = AVATAR_EDGE * u;
+	const int stride = skin->width;
+	const int y0 = AVATAR_Y * u;
+	bool hat = skin->height == skin->width
+		|| avatar_hat_used(px, stride, AVATAR_HAT_X * u, y0, edge);
+
+	for (int y = 0; y < edge; y++) {
+		const uint32_t *face = px + (size_t)(y0 + y) * (size_t)stride
+			+ AVATAR_FACE_X * u;
+		const uint32_t *top = px + (size_t)(y0 + y) * (size_t)stride
+			+ AVATAR_HAT_X * u;
+		uint32_t *dst = out + (size_t)y * (size_t)edge;
+		for (int x = 0; x < edge; x++)
+			dst[x] = hat ? ortho_blend(face[x], top[x]) : face[x];
+	}
+	return edge;
+}
+
+/* Nearest neighbour resize of a square image. Whole number upscales, by
+ * far the common case, build each distinct row once and copy it. */
+void
+avatar_scale(const uint32_t *src, int edge, uint32_t *dst, int size)
+{
+	if (size % edge == 0) {
+		const int k = size / edge;
+		for (int y = 0; y < edge; y++) {
+			uint32_t *row = dst + (size_t)y * (size_t)k * (size_t)size;
+			const uint32_t *s = src + (size_t)y * (size_t)edge;
+			for (int x = 0; x < edge; x++) {
+				for (int i = 0; i < k; i++)
+					row[x * k + i] = s[x];
+			}
+			for (int i = 1; i < k; i++)
+				memcpy(row + (size_t)i * (size_t)size, row,
+					sizeof(*row) * (size_t)size);
+		}
+		return;
+	}
+
+	for (int y = 0; y < size; y++) {
+		const uint32_t *s = src + (size_t)(y * edge / size) * (size_t)edge;
+		uint32_t *row = dst + (size_t)y * (size_t)size;
+		for (int x = 0; x < size; x++)
+			row[x] = s[x * edge / size];
+	}
+}
+
+#endif /* AVATAR_H */
@@ -0,0 +1,484 @@
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "raylib.h"
+#include "skin.h"
+#include "avatar.h"
+#include "archive.h"
+#include "index.h"
+#include "ingest.h"
+#include "cache.h"
+#include "png.h"
+#include "outpath.h"
+
+/* skin-batch turns many skins into head avatars without a window. Every
+ * skin is read through ingest.h, or out of an archive with archive.h,
+ * decoded once from memory (PNG or QOI) and written at each requested size
+ * with png.h (-z picks the effort) or, with -f qoi, qoi.h; decoding is
+ * spread over a thread per core.
+ *
+ * With -c, written avatars also go to a cache.h file keyed by the skin's
+ * bytes, and a skin whose avatars are all there is not decoded again. */
+
+#define BATCH_MAX_SIZES 16
+#define BATCH_MAX_SIZE 4096
+#define BATCH_CACHE_MB 256
+
+struct batch {
+	char **files;
+	size_t count;
+	const char *outdir;
+	int sizes[BATCH_MAX_SIZES];
+	size_t nsizes;
+	bool read_only; /* only read the files, to time the engines */
+	enum png_effort effort;
+	bool qoi; /* write QOI instead of PNG */
+	struct cache cache;
+	bool use_cache;
+
+	struct ingest in;
+	const char *archive_path;
+	struct archive archive;
+	pthread_mutex_t lock;
+	size_t failed;
+	size_t written;
+};
+
+long long
+now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* "dir/name.png" becomes "outdir/dir/name-size.png", or .qoi */
+bool
+output_path(char *buf, size_t len, const char *outdir, const char *file,
+	int size, bool qoi)
+{
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), "-%d.%s", size, qoi ? "qoi" : "png");
+	return out_path(buf, len, outdir, file, suffix);
+}
+
+/* Per thread buffers for encoding */
+struct batch_out {
+	struct png_scratch png;
+	unsigned char *qoi;
+	size_t qoi_cap;
+};
+
+/* The avatar encoded as b asks, NULL if out of memory */
+const unsigned char *
+batch_encode(struct batch *b, struct batch_out *out, const uint32_t *pixels,
+	int size, size_t *bytes)
+{
+	if (!b->qoi)
+		return png_encode(&out->png, pixels, size, size, b->effort, bytes);
+
+	const size_t need = qoi_bound((unsigned)size, (unsigned)size);
+	if (need > out->qoi_cap) {
+		unsigned char *grown = realloc(out->qoi, need);
+		if (!grown)
+			return NULL;
+		out->qoi = grown;
+		out->qoi_cap = need;
+	}
+	*bytes = qoi_pack((const unsigned char *)pixels, (unsigned)size,
+		(unsigned)size, out->qoi);
+	return out->qoi;
+}
+
+/* The PNG effort or, past the efforts, QOI: both change the bytes */
+struct cache_key
+batch_key(const struct batch *b, uint64_t source, int size)
+{
+	return (struct cache_key){
+		.source = source,
+		.width = (uint16_t)size,
+		.height = (uint16_t)size,
+		.preset = CACHE_PRESET_AVATAR,
+		.format = (uint8_t)(b->qoi ? PNG_EFFORT_COUNT : b->effort),
+	};
+}
+
+bool
+batch_write(const struct batch *b, const char *file, int size,
+	const unsigned char *out, size_t bytes)
+{
+	char path[4096];
+	if (!output_path(path, sizeof(path), b->outdir, file, size, b->qoi)) {
+		fprintf(stderr, "%s: %s\n", file, strerror(errno));
+		return 0;
+	}
+	if (!out || bytes > INT32_MAX
+			|| !SaveFileData(path, (void *)out, (int)bytes)) {
+		fprintf(stderr, "%s: could not write\n", path);
+		return 0;
+	}
+	return 1;
+}
+
+bool
+batch_one(struct batch *b, const char *file, const unsigned char *data,
+	size_t len, uint32_t *head, uint32_t *scaled, struct batch_out *enc)
+{
+	/* Sizes the cache had, written without decoding */
+	bool cached[BATCH_MAX_SIZES] = { 0 };
+	size_t missing = b->nsizes;
+	bool ok = true;
+	const uint64_t source = b->use_cache ? fnv1a(data, len) : 0;
+	for (size_t i = 0; b->use_cache && i < b->nsizes; i++) {
+		struct cache_key k = batch_key(b, source, b->sizes[i]);
+		uint32_t bytes;
+		unsigned char *hit = cache_get(&b->cache, &k, &bytes);
+		if (!hit)
+			continue;
+		ok = batch_write(b, file, b->sizes[i], hit, bytes) && ok;
+		free(hit);
+		cached[i] = true;
+		missing--;
+	}
+	if (!missing)
+		return ok;
+
+	Image skin = len <= INT32_MAX
+		? skin_decode(data, (int)len) : (Image){ 0 };
+	if (!skin.data) {
+		fprintf(stderr, "%s: could not decode\n", file);
+		return 0;
+	}
+	ImageFormat(&skin, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	int edge = avatar_unit(skin.width, skin.height) <= BATCH_MAX_SIZE / 64
+		? avatar_extract(&skin, head) : 0;
+	if (!edge)
+		fprintf(stderr, "%s: unsupported size %dx%d\n", file,
+			skin.width, skin.height);
+	UnloadImage(skin);
+	if (!edge)
+		return 0;
+
+	for (size_t i = 0; i < b->nsizes; i++) {
+		if (cached[i])
+			continue;
+		int size = b->sizes[i];
+		avatar_scale(head, edge, scaled, size);
+		size_t bytes = 0;
+		const unsigned char *out = batch_encode(b, enc, scaled, size,
+			&bytes);
+		ok = batch_write(b, file, size, out, bytes) && ok;
+		if (out && b->use_cache && bytes <= UINT32_MAX) {
+			struct cache_key k = batch_key(b, source, size);
+			cache_put(&b->cache, &k, out, (uint32_t)bytes);
+		}
+	}
+	return ok;
+}
+
+void
+batch_count(struct batch *b, bool ok)
+{
+	pthread_mutex_lock(&b->lock);
+	if (!ok)
+		b->failed++;
+	else if (!b->read_only)
+		b->written += b->nsizes;
+	pthread_mutex_unlock(&b->lock);
+}
+
+void *
+batch_worker(void *arg)
+{
+	struct batch *b = arg;
+	int largest = 0;
+	for (size_t i = 0; i < b->nsizes; i++) {
+		if (b->sizes[i] > largest)
+			largest = b->sizes[i];
+	}
+
+	/* The head of a 4096 wide skin is 512 texels square */
+	uint32_t *head = malloc(sizeof(*head) * 512 * 512);
+	uint32_t *scaled = malloc(sizeof(*scaled)
+		* (size_t)largest * (size_t)largest);
+	struct batch_out enc = { 0 };
+	if (!head || !scaled) {
+		fprintf(stderr, "Out of memory!\n");
+		free(head);
+		free(scaled);
+		return NULL;
+	}
+
+	struct ingest_file f;
+	while (!b->archive_path && ingest_next(&b->in, &f)) {
+		const char *file = b->files[f.index];
+		bool ok = !f.error;
+		if (!ok)
+			fprintf(stderr, "%s: %s\n", file, strerror(f.error));
+		else if (!b->read_only)
+			ok = batch_one(b, file, f.data, f.size, head, scaled,
+				&enc);
+		ingest_release(&b->in, &f);
+		batch_count(b, ok);
+	}
+
+	struct archive_member m;
+	while (b->archive_path && archive_next(&b->archive, &m)) {
+		bool ok = !m.error;
+		if (!ok)
+			fprintf(stderr, "%s: %s: %s\n", b->archive_path, m.name,
+				m.error);
+		else if (!b->read_only)
+			ok = batch_one(b, m.name, m.data, m.size, head, scaled,
+				&enc);
+		archive_release(&b->archive, &m);
+		batch_count(b, ok);
+	}
+
+	png_scratch_free(&enc.png);
+	free(enc.qoi);
+	free(scaled);
+	free(head);
+	return NULL;
+}
+
+/* One path per line, for lists too long for the command line */
+bool
+read_list(FILE *f, char ***files, size_t *count, size_t *cap)
+{
+	char line[4096];
+	while (fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (!line[0])
+			continue;
+		if (*count == *cap) {
+			*cap = *cap ? *cap * 2 : 256;
+			char **grown = realloc(*files, sizeof(**files) * *cap);
+			if (!grown)
+				return 0;
+			*files = grown;
+		}
+		if (!((*files)[(*count)++] = strdup(line)))
+			return 0;
+	}
+	return 1;
+}
+
+/* Every skin a directory's library index lists, without opening them */
+bool
+add_indexed(const char *dir, char ***files, size_t *count, size_t *cap)
+{
+	struct index x;
+	if (!index_open_dir(&x, dir)) {
+		fprintf(stderr, "%s: no library index, run skin-index first\n", dir);
+		return 0;
+	}
+	bool ok = true;
+	for (size_t i = 0; ok && i < x.count; i++) {
+		if (x.entries[i].kind == SKIN_INVALID)
+			continue;
+		if (*count == *cap) {
+			*cap = *cap ? *cap * 2 : 256;
+			char **grown = realloc(*files, sizeof(**files) * *cap);
+			if (!grown) {
+				ok = false;
+				break;
+			}
+			*files = grown;
+		}
+		ok = ((*files)[*count] = index_path(&x, dir, &x.entries[i]));
+		*count += ok;
+	}
+	index_close(&x);
+	if (!ok)
+		fprintf(stderr, "Out of memory!\n");
+	return ok;
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-batch [-o outdir] [-s size[,size...]]"
+		" [-j threads]\n"
+		"\t[-e uring|threads] [-n] [-f png|qoi] [-z store|rle|fast|small]\n"
+		"\t[-c cachefile [-C megabytes]]\n"
+		"\tskin.png|skin.qoi|dir... | - | -a archive\n"
+		"\t-s\tavatar edge lengths in pixels, default 64\n"
+		"\t-f\toutput format, default png\n"
+		"\t-z\tPNG compression effort, default small\n"
+		"\t-e\thow files are read, default uring where available\n"
+		"\t-n\tonly read the files, to compare the engines\n"
+		"\t-c\tkeep avatars in a cache file, skins found there are not"
+		" decoded\n"
+		"\tdir\tevery skin in the directory's library index\n"
+		"\t-\tread skin paths from stdin, one per line\n"
+		"\t-a\tthe skins in a tar or zip archive, - for a tar on stdin\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct batch b = { .outdir = ".", .effort = PNG_SMALL };
+	const char *cachefile = NULL;
+	long cache_mb = BATCH_CACHE_MB;
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t cap = 0;
+	bool from_stdin = false;
+	enum ingest_engine engine = INGEST_URING;
+
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+		if (!strcmp(argv[i], "-o") && more)
+			b.outdir = argv[++i];
+		else if (!strcmp(argv[i], "-j") && more)
+			threads = atol(argv[++i]);
+		else if (!strcmp(argv[i], "-e") && more
+				&& !strcmp(argv[i + 1], "uring"))
+			engine = INGEST_URING, i++;
+		else if (!strcmp(argv[i], "-e") && more
+				&& !strcmp(argv[i + 1], "threads"))
+			engine = INGEST_THREADS, i++;
+		else if (!strcmp(argv[i], "-n"))
+			b.read_only = true;
+		else if (!strcmp(argv[i], "-f") && more
+				&& !strcmp(argv[i + 1], "png"))
+			b.qoi = false, i++;
+		else if (!strcmp(argv[i], "-f") && more
+				&& !strcmp(argv[i + 1], "qoi"))
+			b.qoi = true, i++;
+		else if (!strcmp(argv[i], "-z") && more
+				&& png_effort_parse(argv[i + 1], &b.effort))
+			i++;
+		else if (!strcmp(argv[i], "-a") && more)
+			b.archive_path = argv[++i];
+		else if (!strcmp(argv[i], "-c") && more)
+			cachefile = argv[++i];
+		else if (!strcmp(argv[i], "-C") && more)
+			cache_mb = atol(argv[++i]);
+		else if (!strcmp(argv[i], "-s") && more) {
+			char *s = argv[++i], *end;
+			b.nsizes = 0;
+			while (*s) {
+				if (b.nsizes == BATCH_MAX_SIZES) {
+					fprintf(stderr, "skin-batch: at most %d "
+						"sizes\n", BATCH_MAX_SIZES);
+					return EXIT_FAILURE;
+				}
+				long size = strtol(s, &end, 10);
+				if (end == s || size < 1 || size > BATCH_MAX_SIZE) {
+					usage();
+					return EXIT_FAILURE;
+				}
+				b.sizes[b.nsizes++] = (int)size;
+				s = *end == ',' ? end + 1 : end;
+			}
+		} else if (!strcmp(argv[i], "-"))
+			from_stdin = true;
+		else if (argv[i][0] != '-' && DirectoryExists(argv[i])) {
+			if (!add_indexed(argv[i], &b.files, &b.count, &cap))
+				return EXIT_FAILURE;
+		} else if (argv[i][0] != '-') {
+			if (b.count == cap) {
+				cap = cap ? cap * 2 : 256;
+				b.files = realloc(b.files, sizeof(*b.files) * cap);
+				if (!b.files) {
+					fprintf(stderr, "Out of memory!\n");
+					return EXIT_FAILURE;
+				}
+			}
+			b.files[b.count++] = strdup(argv[i]);
+		} else {
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (from_stdin && !read_list(stdin, &b.files, &b.count, &cap)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	if (!b.count == !b.archive_path) {
+		usage();
+		return EXIT_FAILURE;
+	}
+	if (!b.nsizes)
+		b.sizes[b.nsizes++] = 64;
+	if (threads < 1)
+		threads = 1;
+	if (!b.archive_path && (size_t)threads > b.count)
+		threads = (long)b.count;
+
+	if (cachefile) {
+		if (cache_mb < 1)
+			cache_mb = 1;
+		if (!cache_open(&b.cache, cachefile, (uint64_t)cache_mb << 20))
+			return EXIT_FAILURE;
+		b.use_cache = true;
+	}
+
+	SetTraceLogLevel(LOG_WARNING);
+	png_init();
+	pthread_mutex_init(&b.lock, NULL);
+
+	long long start = now_ns();
+	if (b.archive_path && !archive_open(&b.archive, b.archive_path,
+			".png;.qoi")) {
+		fprintf(stderr, "%s: %s\n", b.archive_path, b.archive.error);
+		return EXIT_FAILURE;
+	}
+	if (!b.archive_path && !ingest_start(&b.in, b.files, b.count, engine)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	pthread_t *t = calloc((size_t)threads, sizeof(*t));
+	long started = 0;
+	for (; t && started < threads; started++) {
+		if (pthread_create(&t[started], NULL, batch_worker, &b))
+			break;
+	}
+	if (!started) {
+		perror("pthread_create");
+		return EXIT_FAILURE;
+	}
+	for (long i = 0; i < started; i++)
+		pthread_join(t[i], NULL);
+	const char *source;
+	size_t skins = b.count;
+	if (b.archive_path) {
+		archive_close(&b.archive);
+		skins = b.archive.members;
+		source = archive_kind_names[b.archive.kind];
+		if (b.archive.error) {
+			fprintf(stderr, "%s: %s\n", b.archive_path, b.archive.error);
+			b.failed++;
+		}
+	} else {
+		ingest_stop(&b.in);
+		source = ingest_engine_names[b.in.engine];
+	}
+	double secs = (double)(now_ns() - start) / 1e9;
+
+	fprintf(stderr, "{ \"skins\": %zu, \"failed\": %zu, \"written\": %zu, "
+		"\"engine\": \"%s\", \"enters\": %zu, \"threads\": %ld, "
+		"\"seconds\": %.3f, \"skins_per_s\": %.0f }\n",
+		skins, b.failed, b.written, source, b.in.enters, started, secs,
+		(double)skins / secs);
+	if (b.use_cache) {
+		cache_print_stats(&b.cache, stderr);
+		cache_close(&b.cache);
+	}
+
+	for (size_t i = 0; i < b.count; i++)
+		free(b.files[i]);
+	free(b.files);
+	free(t);
+	return b.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,527 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "skin.h"
+#include "ortho.h"
+#include "phash.h"
+#include "png.h"
+#include "palette.h"
+#include "anim.h"
+#include "voxel.h"
+#include "cull.h"
+
+#define SKIN_DEFAULT "resources/models/obj/osage-chan-lagtrain.png"
+#define SKIN_QOI "resources/models/obj/osage-chan-lagtrain.qoi"
+#define CROWD 10000
+
+/* Each case runs for BENCH_WARMUP_NS before measuring, so the CPU has
+ * settled at its sustained clock, then in batches long enough that timer
+ * resolution does not matter. */
+#define BENCH_WARMUP_NS 100000000LL
+#define BENCH_SAMPLE_NS 2000000LL
+#define BENCH_SAMPLES 31
+
+struct bench {
+	const char *name;
+	void (*fn)(void);
+	bool gpu;
+};
+
+volatile size_t sink;
+size_t bench_bytes; /* output size, for the cases that encode */
+
+Image skin64;
+Image skinhd;
+unsigned char *skinhd_png;
+int skinhd_png_size;
+unsigned char *skinhd_qoi;
+size_t skinhd_qoi_size;
+unsigned char *qoi_out; /* room for the HD skin */
+struct palette_image skin64_packed;
+struct palette_image skinhd_packed;
+struct button buttons[MODEL_COUNT];
+struct ortho_plan ortho;
+uint32_t *ortho_out;
+Image render;
+struct png_scratch png;
+struct anim_rig rig;
+struct anim_batch crowd;       /* everyone walking */
+struct anim_batch crowd_mixed; /* every animation, in no order */
+struct voxel_part voxel64[VOXEL_PARTS];
+struct voxel_part voxelhd[VOXEL_PARTS];
+struct voxel_mesh voxel_mesh;
+struct cull_layer cull;
+float cull_uv[CULL_PARTS][6 * 6 * 2];
+Texture2D skin64_texture;
+Model models[MODEL_COUNT];
+RenderTexture2D rt;
+
+long long
+now_ns(void)
+{
+	struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	timespec_get(&ts, TIME_UTC);
+#endif
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int
+cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+void
+bench_get_bundle(void)
+{
+	sink ^= (size_t)get_bundle(SKIN_DEFAULT);
+}
+
+void
+bench_get_bundle_size(void)
+{
+	sink ^= get_bundle_size(SKIN_DEFAULT);
+}
+
+/* Every part of both builds, as switching between them would */
+void
+bench_skin_vertices(void)
+{
+	static float pos[3 * SKIN_VERTICES], uv[2 * SKIN_VERTICES];
+	static float normal[3 * SKIN_VERTICES];
+	for (size_t slim = 0; slim < 2; slim++) {
+		for (size_t i = 0; i < MODEL_COUNT; i++) {
+			skin_vertices(i, slim, pos, uv, normal);
+			sink ^= (size_t)pos[0];
+		}
+	}
+}
+
+void
+bench_load_models(void)
+{
+	Model m[MODEL_COUNT];
+	if (load_models(m, true, (Texture2D){ 0 })) {
+		sink ^= (size_t)m[0].meshCount;
+		for (size_t i = 0; i < MODEL_COUNT; i++)
+			UnloadModel(m[i]);
+	}
+}
+
+void
+bench_png_decode_64(void)
+{
+	Image img = LoadImageFromMemory(".png", get_bundle(SKIN_DEFAULT),
+		(int)get_bundle_size(SKIN_DEFAULT));
+	sink ^= (size_t)img.width;
+	UnloadImage(img);
+}
+
+void
+bench_png_decode_hd(void)
+{
+	Image img = LoadImageFromMemory(".png", skinhd_png, skinhd_png_size);
+	sink ^= (size_t)img.width;
+	UnloadImage(img);
+}
+
+void
+bench_qoi_decode_64(void)
+{
+	Image img = skin_decode(get_bundle(SKIN_QOI),
+		(int)get_bundle_size(SKIN_QOI));
+	sink ^= (size_t)img.width;
+	UnloadImage(img);
+}
+
+void
+bench_qoi_decode_hd(void)
+{
+	Image img = skin_decode(skinhd_qoi, (int)skinhd_qoi_size);
+	sink ^= (size_t)img.width;
+	UnloadImage(img);
+}
+
+void
+bench_palette_pack(const Image *img)
+{
+	struct palette_image p;
+	palette_pack(&p, img);
+	bench_bytes = palette_size(&p);
+	palette_free(&p);
+}
+
+void
+bench_palette_expand(const struct palette_image *p)
+{
+	Image img = palette_expand(p);
+	sink ^= (size_t)img.width;
+	UnloadImage(img);
+}
+
+void bench_palette_pack_64(void)   { bench_palette_pack(&skin64); }
+void bench_palette_pack_hd(void)   { bench_palette_pack(&skinhd); }
+void bench_palette_expand_64(void) { bench_palette_expand(&skin64_packed); }
+void bench_palette_expand_hd(void) { bench_palette_expand(&skinhd_packed); }
+
+void
+bench_buttons_update(void)
+{
+	buttons_update(buttons, 1920, 1080);
+	sink ^= (size_t)buttons[MODEL_LAYER_LLEG].rec.x;
+}
+
+void
+bench_ortho_front(void)
+{
+	ortho_render(&ortho, skin64.data, 0, ortho_out);
+	sink ^= ortho_out[ortho.width / 2];
+}
+
+/* One frame for a crowd */
+void bench_anim_10k(void)       { anim_batch_update(&crowd, 1 / 60.0f); }
+void bench_anim_mixed_10k(void) { anim_batch_update(&crowd_mixed, 1 / 60.0f); }
+
+/* Sorting the overlay triangles for a newly loaded skin */
+void bench_cull_classify_64(void) { cull_classify(&cull, &skin64_packed); }
+void bench_cull_classify_hd(void) { cull_classify(&cull, &skinhd_packed); }
+
+/* Meshes the whole overlay, as a reload that changed every part would */
+void
+bench_voxel_build(const struct voxel_part *parts, const Image *img)
+{
+	for (size_t j = 0; j < VOXEL_PARTS; j++) {
+		voxel_build(&voxel_mesh, &parts[j], img->data, img->width,
+			img->height);
+		sink ^= voxel_mesh.quads;
+	}
+}
+
+void bench_voxel_build_64(void) { bench_voxel_build(voxel64, &skin64); }
+void bench_voxel_build_hd(void) { bench_voxel_build(voxelhd, &skinhd); }
+
+void
+bench_voxel_key_hd(void)
+{
+	for (size_t j = 0; j < VOXEL_PARTS; j++)
+		sink ^= (size_t)voxel_key(&voxelhd[j], skinhd.data, skinhd.width);
+}
+
+void
+bench_phash_64(void)
+{
+	sink ^= (size_t)phash_image(&skin64);
+}
+
+/* Encoding what skin-serve and skin-batch write, raylib's way and ours */
+void
+bench_png_export(const Image *img)
+{
+	int size = 0;
+	unsigned char *data = ExportImageToMemory(*img, ".png", &size);
+	bench_bytes = (size_t)size;
+	MemFree(data);
+}
+
+void
+bench_png_encode(const Image *img, enum png_effort effort)
+{
+	png_encode(&png, img->data, img->width, img->height, effort,
+		&bench_bytes);
+}
+
+void bench_png_export_64(void)    { bench_png_export(&skin64); }
+void bench_png_store_64(void)     { bench_png_encode(&skin64, PNG_STORE); }
+void bench_png_rle_64(void)       { bench_png_encode(&skin64, PNG_RLE); }
+void bench_png_fast_64(void)      { bench_png_encode(&skin64, PNG_FAST); }
+void bench_png_small_64(void)     { bench_png_encode(&skin64, PNG_SMALL); }
+void bench_png_fast_hd(void)      { bench_png_encode(&skinhd, PNG_FAST); }
+void bench_png_small_hd(void)     { bench_png_encode(&skinhd, PNG_SMALL); }
+void bench_png_export_render(void) { bench_png_export(&render); }
+void bench_png_store_render(void) { bench_png_encode(&render, PNG_STORE); }
+void bench_png_rle_render(void)   { bench_png_encode(&render, PNG_RLE); }
+void bench_png_fast_render(void)  { bench_png_encode(&render, PNG_FAST); }
+void bench_png_small_render(void) { bench_png_encode(&render, PNG_SMALL); }
+
+void
+bench_qoi_encode(const Image *img)
+{
+	bench_bytes = qoi_pack(img->data, (unsigned)img->width,
+		(unsigned)img->height, qoi_out);
+}
+
+void bench_qoi_encode_64(void)    { bench_qoi_encode(&skin64); }
+void bench_qoi_encode_hd(void)    { bench_qoi_encode(&skinhd); }
+
+/* The same job on the GPU, including the read back skin-serve does */
+void
+bench_render_3d(void)
+{
+	render_models(rt, models, camera_preset(0), 0);
+	Image img = LoadImageFromTexture(rt.texture);
+	sink ^= (size_t)img.width;
+	UnloadImage(img);
+}
+
+struct bench benches[] = {
+	{ "get_bundle",        bench_get_bundle,       false },
+	{ "get_bundle_size",   bench_get_bundle_size,  false },
+	{ "skin_vertices",     bench_skin_vertices,    false },
+	{ "load_models",       bench_load_models,      true  },
+	{ "png_decode_64",     bench_png_decode_64,    false },
+	{ "png_decode_hd",     bench_png_decode_hd,    false },
+	{ "qoi_decode_64",     bench_qoi_decode_64,    false },
+	{ "qoi_decode_hd",     bench_qoi_decode_hd,    false },
+	{ "palette_pack_64",   bench_palette_pack_64,  false },
+	{ "palette_pack_hd",   bench_palette_pack_hd,  false },
+	{ "palette_expand_64", bench_palette_expand_64, false },
+	{ "palette_expand_hd", bench_palette_expand_hd, false },
+	{ "buttons_update",    bench_buttons_update,   false },
+	{ "ortho_front",       bench_ortho_front,      false },
+	{ "phash_64",          bench_phash_64,         false },
+	{ "anim_10k",          bench_anim_10k,         false },
+	{ "anim_mixed_10k",    bench_anim_mixed_10k,   false },
+	{ "cull_classify_64",  bench_cull_classify_64, false },
+	{ "cull_classify_hd",  bench_cull_classify_hd, false },
+	{ "voxel_build_64",    bench_voxel_build_64,   false },
+	{ "voxel_build_hd",    bench_voxel_build_hd,   false },
+	{ "voxel_key_hd",      bench_voxel_key_hd,     false },
+	{ "png_export_64",     bench_png_export_64,    false },
+	{ "png_store_64",      bench_png_store_64,     false },
+	{ "png_rle_64",        bench_png_rle_64,       false },
+	{ "png_fast_64",       bench_png_fast_64,      false },
+	{ "png_small_64",      bench_png_small_64,     false },
+	{ "png_fast_hd",       bench_png_fast_hd,      false },
+	{ "png_small_hd",      bench_png_small_hd,     false },
+	{ "png_export_render", bench_png_export_render, false },
+	{ "png_store_render",  bench_png_store_render, false },
+	{ "png_rle_render",    bench_png_rle_render,   false },
+	{ "png_fast_render",   bench_png_fast_render,  false },
+	{ "png_small_render",  bench_png_small_render, false },
+	{ "qoi_encode_64",     bench_qoi_encode_64,    false },
+	{ "qoi_encode_hd",     bench_qoi_encode_hd,    false },
+	{ "render_3d",         bench_render_3d,        true  },
+};
+
+/* Prints one JSON object per line, times are per call in nanoseconds */
+void
+bench_run(const struct bench *b)
+{
+	bench_bytes = 0;
+	long long start = now_ns();
+	size_t warm = 0;
+	while (now_ns() - start < BENCH_WARMUP_NS) {
+		b->fn();
+		warm++;
+	}
+
+	double per_call = (double)(now_ns() - start) / (double)warm;
+	size_t batch = (size_t)((double)BENCH_SAMPLE_NS / per_call);
+	if (batch < 1)
+		batch = 1;
+
+	double samples[BENCH_SAMPLES];
+	for (size_t s = 0; s < BENCH_SAMPLES; s++) {
+		long long t0 = now_ns();
+		for (size_t i = 0; i < batch; i++)
+			b->fn();
+		samples[s] = (double)(now_ns() - t0) / (double)batch;
+	}
+	qsort(samples, BENCH_SAMPLES, sizeof(*samples), cmp_double);
+
+	double mean = 0;
+	for (size_t s = 0; s < BENCH_SAMPLES; s++)
+		mean += samples[s];
+	mean /= BENCH_SAMPLES;
+	double median = samples[BENCH_SAMPLES / 2];
+
+	/* Median absolute deviation, robust against the odd preempted batch */
+	double dev[BENCH_SAMPLES];
+	for (size_t s = 0; s < BENCH_SAMPLES; s++)
+		dev[s] = samples[s] > median
+			? samples[s] - median : median - samples[s];
+	qsort(dev, BENCH_SAMPLES, sizeof(*dev), cmp_double);
+
+	printf("{ \"name\": \"%s\", \"batch\": %zu, \"samples\": %d, "
+		"\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f, "
+		"\"p99_ns\": %.1f, \"mad_ns\": %.1f",
+		b->name, batch, BENCH_SAMPLES, samples[0], median, mean,
+		samples[BENCH_SAMPLES - 1], dev[BENCH_SAMPLES / 2]);
+	if (bench_bytes)
+		printf(", \"bytes\": %zu", bench_bytes);
+	printf(" }\n");
+	fflush(stdout);
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-bench [-g] [filter]\n"
+		"\t-g\talso run cases that need a GL context\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	bool gpu = false;
+	const char *filter = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-g"))
+			gpu = true;
+		else if (argv[i][0] == '-') {
+			usage();
+			return EXIT_FAILURE;
+		} else
+			filter = argv[i];
+	}
+
+	SetTraceLogLevel(LOG_WARNING);
+	if (gpu) {
+		SetConfigFlags(FLAG_WINDOW_HIDDEN);
+		InitWindow(64, 64, "skin-bench");
+	}
+
+	skin64 = LoadImageFromMemory(".png", get_bundle(SKIN_DEFAULT),
+		(int)get_bundle_size(SKIN_DEFAULT));
+	ImageFormat(&skin64, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	skinhd = ImageCopy(skin64);
+	ImageResizeNN(&skinhd, 1024, 1024);
+	skinhd_png = ExportImageToMemory(skinhd, ".png", &skinhd_png_size);
+	qoi_out = malloc(qoi_bound(1024, 1024));
+	if (!qoi_out) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	skinhd_qoi_size = qoi_pack(skinhd.data, 1024, 1024, qoi_out);
+	skinhd_qoi = malloc(skinhd_qoi_size);
+	if (!skinhd_qoi) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	memcpy(skinhd_qoi, qoi_out, skinhd_qoi_size);
+	if (!palette_pack(&skin64_packed, &skin64)
+			|| !palette_pack(&skinhd_packed, &skinhd)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+
+	/* Scale 4 gives about the 256 pixel tall render of render_3d */
+	phash_init();
+	if (!ortho_plan(&ortho, ORTHO_FRONT, 4, 64, 64,
+			skin_is_slim(&skin64))) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	ortho_out = malloc(sizeof(*ortho_out)
+		* (size_t)ortho.width * (size_t)ortho.height);
+	ortho_render(&ortho, skin64.data, 0, ortho_out);
+	render = (Image){
+		.data = ortho_out,
+		.width = ortho.width,
+		.height = ortho.height,
+		.mipmaps = 1,
+		.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+	};
+
+	/* Pivots from the same boxes load_models() would give */
+	BoundingBox parts[ANIM_JOINTS];
+	for (size_t j = 0; j < ANIM_JOINTS; j++) {
+		parts[j].min = (Vector3){ INFINITY, INFINITY, INFINITY };
+		parts[j].max = (Vector3){ -INFINITY, -INFINITY, -INFINITY };
+		for (size_t f = 0; f < 6; f++) {
+			for (size_t v = 0; v < 4; v++) {
+				const float *pos = ortho_quads[1][j][f].pos[v];
+				parts[j].min = Vector3Min(parts[j].min,
+					(Vector3){ pos[0], pos[1], pos[2] });
+				parts[j].max = Vector3Max(parts[j].max,
+					(Vector3){ pos[0], pos[1], pos[2] });
+			}
+		}
+	}
+	anim_rig_init(&rig, parts);
+	if (!anim_batch_resize(&crowd, CROWD)
+			|| !anim_batch_resize(&crowd_mixed, CROWD)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	for (size_t i = 0; i < CROWD; i++) {
+		crowd.anim[i] = ANIM_WALK;
+		crowd.phase[i] = crowd_mixed.phase[i] = (float)(i % 97) / 97;
+		crowd_mixed.anim[i] = (unsigned char)(i * 7 % 11 % ANIM_COUNT);
+	}
+	voxel_plan(voxel64, skin64.width, skin64.height, true);
+
+	/* The overlay triangles as LoadModel() gives them, without the GPU */
+	for (size_t j = 0; j < CULL_PARTS; j++) {
+		static const int fan[6] = { 0, 1, 2, 0, 2, 3 };
+		for (size_t v = 0; v < 6 * 6; v++) {
+			const float *uv = ortho_quads[1][MODEL_LAYER_HEAD + j][v / 6]
+				.uv[fan[v % 6]];
+			cull_uv[j][v * 2] = uv[0];
+			cull_uv[j][v * 2 + 1] = 1 - uv[1];
+		}
+		Mesh mesh = {
+			.vertexCount = 6 * 6,
+			.triangleCount = 6 * 2,
+			.texcoords = cull_uv[j],
+		};
+		if (!cull_plan(&cull.parts[j], &mesh)) {
+			fprintf(stderr, "Out of memory!\n");
+			return EXIT_FAILURE;
+		}
+	}
+	voxel_plan(voxelhd, skinhd.width, skinhd.height, true);
+
+	png_init();
+	if (gpu) {
+		skin64_texture = LoadTextureFromImage(skin64);
+		if (!load_models(models, true, skin64_texture)) {
+			fprintf(stderr, "Out of memory!\n");
+			return EXIT_FAILURE;
+		}
+		rt = LoadRenderTexture(ortho.width, ortho.height);
+	}
+
+	for (size_t i = 0; i < sizeof(benches)/sizeof(*benches); i++) {
+		if (benches[i].gpu && !gpu)
+			continue;
+		if (filter && !strstr(benches[i].name, filter))
+			continue;
+		bench_run(&benches[i]);
+	}
+
+	if (gpu) {
+		UnloadRenderTexture(rt);
+		UnloadTexture(skin64_texture);
+		for (size_t i = 0; i < MODEL_COUNT; i++)
+			UnloadModel(models[i]);
+	}
+	cull_free(&cull);
+	voxel_mesh_free(&voxel_mesh);
+	anim_batch_free(&crowd_mixed);
+	anim_batch_free(&crowd);
+	png_scratch_free(&png);
+	free(ortho_out);
+	ortho_plan_free(&ortho);
+	palette_free(&skinhd_packed);
+	palette_free(&skin64_packed);
+	free(skinhd_qoi);
+	free(qoi_out);
+	MemFree(skinhd_png);
+	UnloadImage(skinhd);
+	UnloadImage(skin64);
+	if (gpu)
+		CloseWindow();
+
+	return EXIT_SUCCESS;
+}
@@ -1,29 +1,171 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include "inflate.h"
+#include "qoi.h"
 
 struct Resource {
 	char *fileName;
+	char *from; /* a PNG embedded as QOI under fileName */
 	size_t offset;
 	size_t size;
 };
 
 struct Resource resources[] = {
-	{ .fileName = "resources/models/obj/alex/layer/body.obj" },
-	{ .fileName = "resources/models/obj/alex/layer/head.obj" },
-	{ .fileName = "resources/models/obj/alex/layer/left_arm.obj" },
-	{ .fileName = "resources/models/obj/alex/layer/left_leg.obj" },
-	{ .fileName = "resources/models/obj/alex/layer/right_arm.obj" },
-	{ .fileName = "resources/models/obj/alex/layer/right_leg.obj" },
-	{ .fileName = "resources/models/obj/alex/skin/body.obj" },
-	{ .fileName = "resources/models/obj/alex/skin/head.obj" },
-	{ .fileName = "resources/models/obj/alex/skin/left_arm.obj" },
-	{ .fileName = "resources/models/obj/alex/skin/left_leg.obj" },
-	{ .fileName = "resources/models/obj/alex/skin/right_arm.obj" },
-	{ .fileName = "resources/models/obj/alex/skin/right_leg.obj" },
 	{ .fileName = "resources/models/obj/osage-chan-lagtrain.png" },
+	{ .fileName = "resources/models/obj/osage-chan-lagtrain.qoi",
+	  .from = "resources/models/obj/osage-chan-lagtrain.png" },
+	{ .fileName = "resources/shaders/gallery.fs" },
+	{ .fileName = "resources/shaders/gallery.vs" },
 };
 size_t resources_count = sizeof(resources)/sizeof(*resources);
 
+char *
+read_file(const char *fileName, size_t *size)
+{
+	FILE *f = fopen(fileName, "rb");
+	if (!f) {
+		perror("fopen");
+		return NULL;
+	}
+
+	fseek(f, 0, SEEK_END);
+	*size = (size_t)ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	char *data = malloc(*size ? *size : 1);
+	if (!data) {
+		perror("malloc");
+		fclose(f);
+		return NULL;
+	}
+	size_t count = fread(data, 1, *size, f);
+	fclose(f);
+	if (count != *size) {
+		fprintf(stderr, "fread() failed: %zu\n", count);
+		free(data);
+		return NULL;
+	}
+	return data;
+}
+
+uint32_t
+be32(const unsigned char *p)
+{
+	return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16
+		| (uint32_t)p[2] << 8 | p[3];
+}
+
+/* Just enough PNG for our own resources: 8 bit RGB or RGBA, not
+ * interlaced. Returns RGBA8 pixels. */
+unsigned char *
+png_pixels(const unsigned char *png, size_t size, unsigned *w, unsigned *h)
+{
+	static const unsigned char sig[8] = {
+		0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n',
+	};
+	if (size < 8 || memcmp(png, sig, 8))
+		return NULL;
+
+	unsigned char *idat = NULL;
+	size_t idat_size = 0, channels = 0;
+	for (size_t pos = 8; pos + 12 <= size;) {
+		size_t len = be32(png + pos);
+		const unsigned char *type = png + pos + 4, *body = png + pos + 8;
+		if (len > size - pos - 12)
+			break;
+		if (!memcmp(type, "IHDR", 4) && len == 13) {
+			*w = be32(body);
+			*h = be32(body + 4);
+			if (body[8] == 8 && !body[12])
+				channels = body[9] == 6 ? 4 : body[9] == 2 ? 3 : 0;
+		} else if (!memcmp(type, "IDAT", 4)) {
+			unsigned char *grown = realloc(idat, idat_size + len);
+			if (!grown) {
+				free(idat);
+				return NULL;
+			}
+			idat = grown;
+			memcpy(idat + idat_size, body, len);
+			idat_size += len;
+		}
+		pos += len + 12;
+	}
+	if (!channels || !*w || !*h || *w > 4096 || *h > 4096 || idat_size < 2) {
+		free(idat);
+		return NULL;
+	}
+
+	const size_t stride = *w * channels;
+	unsigned char *raw = malloc((stride + 1) * *h);
+	unsigned char *out = malloc((size_t)*w * *h * 4);
+	if (!raw || !out || !inflate_raw(idat + 2, idat_size - 2, raw,
+			(stride + 1) * *h)) {
+		free(idat);
+		free(raw);
+		free(out);
+		return NULL;
+	}
+	free(idat);
+
+	for (size_t y = 0; y < *h; y++) {
+		unsigned char *row = raw + y * (stride + 1) + 1;
+		const unsigned char *up = y ? row - stride - 1 : NULL;
+		if (row[-1] > 4) {
+			free(raw);
+			free(out);
+			return NULL;
+		}
+		for (size_t x = 0; x < stride; x++) {
+			int a = x >= channels ? row[x - channels] : 0;
+			int b = up ? up[x] : 0;
+			int c = up && x >= channels ? up[x - channels] : 0;
+			int p = a + b - c, pa = abs(p - a), pb = abs(p - b),
+				pc = abs(p - c);
+			switch (row[-1]) {
+			case 1: row[x] = (unsigned char)(row[x] + a); break;
+			case 2: row[x] = (unsigned char)(row[x] + b); break;
+			case 3: row[x] = (unsigned char)(row[x] + (a + b) / 2); break;
+			case 4:
+				row[x] = (unsigned char)(row[x] + (pa <= pb && pa <= pc
+					? a : pb <= pc ? b : c));
+				break;
+			}
+		}
+		for (size_t x = 0; x < *w; x++) {
+			unsigned char *o = out + (y * *w + x) * 4;
+			memcpy(o, row + x * channels, channels);
+			if (channels == 3)
+				o[3] = 255;
+		}
+	}
+	free(raw);
+	return out;
+}
+
+/* The PNG at fileName, encoded as QOI */
+char *
+read_as_qoi(const char *fileName, size_t *size)
+{
+	size_t png_size;
+	unsigned char *png = (unsigned char *)read_file(fileName, &png_size);
+	if (!png)
+		return NULL;
+	unsigned w = 0, h = 0;
+	unsigned char *pixels = png_pixels(png, png_size, &w, &h);
+	free(png);
+	if (!pixels) {
+		fprintf(stderr, "%s: not an 8 bit RGB(A) PNG\n", fileName);
+		return NULL;
+	}
+	unsigned char *qoi = malloc(qoi_bound(w, h));
+	if (qoi)
+		*size = qoi_pack(pixels, w, h, qoi);
+	else
+		perror("malloc");
+	free(pixels);
+	return (char *)qoi;
+}
+
 int
 main(void)
 {
@@ -37,39 +179,32 @@ main(void)
 	}
 
 	for (size_t i = 0; i < resources_count; i += 1) {
-		FILE *f = fopen(resources[i].fileName, "rb");
-		if (!f) {
-			perror("fopen");
+		size_t size = 0;
+		char *data = resources[i].from
+			? read_as_qoi(resources[i].from, &size)
+			: read_file(resources[i].fileName, &size);
+		if (!data) {
 			free(bundle);
 			return EXIT_FAILURE;
 		}
-
-		fseek(f, 0, SEEK_END);
-		size_t size = (size_t)ftell(f);
-		fseek(f, 0, SEEK_SET);
 		resources[i].size = size;
 
 		char *new = realloc(bundle, bundle_size + size + 1);
 		if (!new) {
 			perror("realloc");
+			free(data);
 			free(bundle);
 			exit(EXIT_FAILURE);
 		}
 		bundle = new;
 		bundle_size += size + 1;
 
-		size_t count = fread(&bundle[offset], 1, size, f);
-		if (count != size) {
-			fprintf(stderr, "fread() failed: %zu\n", count);
-			free(bundle);
-			exit(EXIT_FAILURE);
-		}
+		memcpy(&bundle[offset], data, size);
+		free(data);
 
 		resources[i].offset = offset;
 		offset += size + 1;
 		bundle[offset - 1] = '\0';
-
-		fclose(f);
 	}
 	bundle[bundle_size - 1] = '\0';
 
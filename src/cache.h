@@ -0,0 +1,334 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "skin.h"
+
+/* Content addressed render cache in one memory mapped file: a header, an
+ * open addressing index, then a data area used as an append only ring.
+ * Appending past the end wraps around and evicts the oldest entries, so the
+ * file never grows past its capacity. Hits on entries in the older half of
+ * the ring are appended again, which keeps recently used renders alive
+ * roughly like an LRU.
+ *
+ * Keys hash the skin file as it arrived rather than its pixels, so a hit
+ * costs no decode; the same skin saved twice by different encoders is
+ * cached twice.
+ *
+ * Positions are logical byte counts since the cache was created; an entry
+ * is live while its position is at or after the tail. One process writes a
+ * cache file at a time. */
+
+#define CACHE_MAGIC 0x32484353u /* "SCH2" */
+#define CACHE_SLOTS 65536
+#define CACHE_PROBES 16
+
+/* Preset of skin-batch's head avatars, apart from skin-serve's */
+#define CACHE_PRESET_AVATAR 0xffu
+
+/* Everything that changes the rendered bytes */
+struct cache_key {
+	uint64_t source; /* fnv1a of the skin file */
+	uint16_t width;
+	uint16_t height;
+	uint16_t hidden;
+	uint8_t preset;
+	uint8_t format;
+};
+
+struct cache_slot {
+	uint64_t hash; /* 0 when empty */
+	uint64_t pos;
+};
+
+struct cache_entry {
+	struct cache_key key;
+	uint32_t length; /* UINT32_MAX pads to the end of the ring */
+	uint32_t reserved;
+};
+
+struct cache_header {
+	uint32_t magic;
+	uint32_t slots;
+	uint64_t capacity;
+	uint64_t head;
+	uint64_t tail;
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t inserts;
+	uint64_t evictions;
+};
+
+struct cache {
+	int fd;
+	size_t size;
+	struct cache_header *hdr;
+	struct cache_slot *slots;
+	unsigned char *data;
+	pthread_mutex_t lock;
+};
+
+uint64_t
+cache_key_hash(const struct cache_key *k)
+{
+	uint64_t h = fnv1a(k, sizeof(*k));
+	return h ? h : 1;
+}
+
+static uint64_t
+cache_entry_size(uint32_t length)
+{
+	return (sizeof(struct cache_entry) + length + 7) & ~(uint64_t)7;
+}
+
+/* Opens or creates the cache at path. Only an empty file or one holding a
+ * cache is ever (re)initialised; anything else, or a cache of another
+ * capacity, is refused with a message rather than overwritten. */
+bool
+cache_open(struct cache *c, const char *path, uint64_t capacity)
+{
+	capacity &= ~(uint64_t)7;
+	size_t size = sizeof(struct cache_header)
+		+ sizeof(struct cache_slot) * CACHE_SLOTS + capacity;
+
+	c->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (c->fd < 0) {
+		perror(path);
+		return 0;
+	}
+
+	struct stat st;
+	if (fstat(c->fd, &st) < 0) {
+		perror(path);
+		close(c->fd);
+		return 0;
+	}
+
+	struct cache_header old = { 0 };
+	if (st.st_size > 0 && (pread(c->fd, &old, sizeof(old), 0)
+			!= (ssize_t)sizeof(old) || old.magic != CACHE_MAGIC)) {
+		fprintf(stderr, "%s: not a render cache, leaving it alone\n",
+			path);
+		close(c->fd);
+		return 0;
+	}
+	if (st.st_size > 0 && old.slots == CACHE_SLOTS
+			&& old.capacity != capacity) {
+		fprintf(stderr, "%s: cache holds %llu MB, not %llu MB; pass "
+			"-C %llu or remove it\n", path,
+			(unsigned long long)(old.capacity >> 20),
+			(unsigned long long)(capacity >> 20),
+			(unsigned long long)(old.capacity >> 20));
+		close(c->fd);
+		return 0;
+	}
+
+	/* Ours but cut short by a crash, or of another layout */
+	bool fresh = (size_t)st.st_size != size;
+	if (fresh && (ftruncate(c->fd, 0) < 0
+			|| ftruncate(c->fd, (off_t)size) < 0)) {
+		perror(path);
+		close(c->fd);
+		return 0;
+	}
+
+	void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, c->fd, 0);
+	if (p == MAP_FAILED) {
+		perror(path);
+		close(c->fd);
+		return 0;
+	}
+
+	c->size = size;
+	c->hdr = p;
+	c->slots = (struct cache_slot *)(c->hdr + 1);
+	c->data = (unsigned char *)(c->slots + CACHE_SLOTS);
+	pthread_mutex_init(&c->lock, NULL);
+
+	if (fresh || c->hdr->slots != CACHE_SLOTS
+			|| c->hdr->capacity != capacity
+			|| c->hdr->tail > c->hdr->head
+			|| c->hdr->head - c->hdr->tail > capacity) {
+		memset(c->hdr, 0, sizeof(*c->hdr)
+			+ sizeof(struct cache_slot) * CACHE_SLOTS);
+		c->hdr->magic = CACHE_MAGIC;
+		c->hdr->slots = CACHE_SLOTS;
+		c->hdr->capacity = capacity;
+	}
+	return 1;
+}
+
+void
+cache_close(struct cache *c)
+{
+	msync(c->hdr, c->size, MS_ASYNC);
+	munmap(c->hdr, c->size);
+	close(c->fd);
+	pthread_mutex_destroy(&c->lock);
+}
+
+static struct cache_entry *
+cache_entry_at(struct cache *c, uint64_t pos)
+{
+	return (struct cache_entry *)&c->data[pos % c->hdr->capacity];
+}
+
+/* The file outlives us and may hold anything: an entry is only read when
+ * it lies between tail and head without crossing the end of the ring */
+static bool
+cache_entry_valid(struct cache *c, uint64_t pos)
+{
+	const struct cache_header *h = c->hdr;
+	const uint64_t left = h->capacity - pos % h->capacity;
+	if (pos < h->tail || pos >= h->head
+			|| left < sizeof(struct cache_entry))
+		return 0;
+	const uint32_t length = cache_entry_at(c, pos)->length;
+	const uint64_t size = cache_entry_size(length);
+	return length != UINT32_MAX && size <= left
+		&& size <= h->head - pos;
+}
+
+/* Drop the oldest entries until the ring has room for need more bytes */
+static void
+cache_evict(struct cache *c, uint64_t need)
+{
+	struct cache_header *h = c->hdr;
+	while (h->head + need - h->tail > h->capacity) {
+		uint64_t left = h->capacity - h->tail % h->capacity;
+		if (left < sizeof(struct cache_entry)) {
+			h->tail += left;
+			continue;
+		}
+		struct cache_entry *e = cache_entry_at(c, h->tail);
+		if (e->length == UINT32_MAX && h->tail + left <= h->head) {
+			h->tail += left;
+			continue;
+		}
+		if (!cache_entry_valid(c, h->tail)) {
+			/* Nothing after a broken entry can be found */
+			h->tail = h->head;
+			continue;
+		}
+		h->tail += cache_entry_size(e->length);
+		h->evictions++;
+	}
+}
+
+static uint64_t
+cache_append(struct cache *c, const struct cache_key *k,
+	const void *data, uint32_t length)
+{
+	struct cache_header *h = c->hdr;
+	uint64_t size = cache_entry_size(length);
+
+	/* Entries never straddle the end of the ring */
+	uint64_t left = h->capacity - h->head % h->capacity;
+	if (left < size) {
+		cache_evict(c, left);
+		if (left >= sizeof(struct cache_entry))
+			cache_entry_at(c, h->head)->length = UINT32_MAX;
+		h->head += left;
+	}
+
+	cache_evict(c, size);
+	uint64_t pos = h->head;
+	struct cache_entry *e = cache_entry_at(c, pos);
+	e->key = *k;
+	e->length = length;
+	memcpy(e + 1, data, length);
+	h->head += size;
+	return pos;
+}
+
+static struct cache_slot *
+cache_find(struct cache *c, const struct cache_key *k, uint64_t hash)
+{
+	for (size_t i = 0; i < CACHE_PROBES; i++) {
+		struct cache_slot *s = &c->slots[(hash + i) % CACHE_SLOTS];
+		if (s->hash != hash || !cache_entry_valid(c, s->pos))
+			continue;
+		if (!memcmp(&cache_entry_at(c, s->pos)->key, k, sizeof(*k)))
+			return s;
+	}
+	return NULL;
+}
+
+/* Returns a malloc'd copy of the cached bytes, or NULL on a miss */
+unsigned char *
+cache_get(struct cache *c, const struct cache_key *k, uint32_t *length)
+{
+	uint64_t hash = cache_key_hash(k);
+	unsigned char *out = NULL;
+
+	pthread_mutex_lock(&c->lock);
+	struct cache_slot *s = cache_find(c, k, hash);
+	if (s) {
+		struct cache_entry *e = cache_entry_at(c, s->pos);
+		out = malloc(e->length ? e->length : 1);
+		if (out) {
+			*length = e->length;
+			memcpy(out, e + 1, e->length);
+			/* Counted back from head: the ring may be far from full */
+			if (c->hdr->head - s->pos > c->hdr->capacity / 2)
+				s->pos = cache_append(c, k, out, *length);
+		}
+	}
+	if (out)
+		c->hdr->hits++;
+	else
+		c->hdr->misses++;
+	pthread_mutex_unlock(&c->lock);
+	return out;
+}
+
+void
+cache_put(struct cache *c, const struct cache_key *k,
+	const void *data, uint32_t length)
+{
+	/* Big entries would flush most of the ring for one render */
+	if (cache_entry_size(length) > c->hdr->capacity / 4)
+		return;
+
+	uint64_t hash = cache_key_hash(k);
+	pthread_mutex_lock(&c->lock);
+	struct cache_slot *s = cache_find(c, k, hash);
+	for (size_t i = 0; !s && i < CACHE_PROBES; i++) {
+		struct cache_slot *t = &c->slots[(hash + i) % CACHE_SLOTS];
+		if (!t->hash || t->pos < c->hdr->tail)
+			s = t;
+	}
+	if (!s)
+		s = &c->slots[hash % CACHE_SLOTS];
+
+	s->pos = cache_append(c, k, data, length);
+	s->hash = hash;
+	c->hdr->inserts++;
+	pthread_mutex_unlock(&c->lock);
+}
+
+void
+cache_print_stats(struct cache *c, FILE *f)
+{
+	pthread_mutex_lock(&c->lock);
+	struct cache_header *h = c->hdr;
+	fprintf(f, "cache: %llu hits, %llu misses, %llu inserts, "
+		"%llu evictions, %llu of %llu bytes used\n",
+		(unsigned long long)h->hits, (unsigned long long)h->misses,
+		(unsigned long long)h->inserts, (unsigned long long)h->evictions,
+		(unsigned long long)(h->head - h->tail),
+		(unsigned long long)h->capacity);
+	pthread_mutex_unlock(&c->lock);
+}
+
+#endif /* CACHE_H */
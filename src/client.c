@@ -0,0 +1,326 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "proto.h"
+
+/* Client for skin-serve. With -n it turns into a load generator that keeps
+ * up to -c requests in flight on one connection and reports latency. */
+
+struct loadgen {
+	int fd;
+	struct proto_request req;
+	const void *payload;
+	uint32_t count;
+	uint32_t window;
+	long long *sent;
+	pthread_mutex_t lock;
+	pthread_cond_t room;
+	uint32_t outstanding;
+};
+
+long long
+now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int
+cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+int
+connect_to(const char *path)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "Socket path too long!\n");
+		return -1;
+	}
+	strcpy(addr.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		perror(path);
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+unsigned char *
+read_file(const char *path, uint32_t *size)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f) {
+		perror(path);
+		return NULL;
+	}
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (len <= 0 || (unsigned long)len > PROTO_MAX_PAYLOAD) {
+		fprintf(stderr, "%s: bad size\n", path);
+		fclose(f);
+		return NULL;
+	}
+
+	unsigned char *buf = malloc((size_t)len);
+	if (buf && fread(buf, 1, (size_t)len, f) != (size_t)len) {
+		free(buf);
+		buf = NULL;
+	}
+	fclose(f);
+	*size = (uint32_t)len;
+	return buf;
+}
+
+bool
+send_request(int fd, const struct proto_request *req, const void *payload)
+{
+	return write_full(fd, req, sizeof(*req))
+		&& write_full(fd, payload, req->length);
+}
+
+void *
+loadgen_send(void *arg)
+{
+	struct loadgen *g = arg;
+	struct proto_request req = g->req;
+
+	for (uint32_t id = 0; id < g->count; id++) {
+		pthread_mutex_lock(&g->lock);
+		while (g->outstanding >= g->window)
+			pthread_cond_wait(&g->room, &g->lock);
+		g->outstanding++;
+		g->sent[id] = now_ns();
+		pthread_mutex_unlock(&g->lock);
+
+		req.id = id;
+		if (!send_request(g->fd, &req, g->payload)) {
+			perror("write");
+			break;
+		}
+	}
+	return NULL;
+}
+
+int
+loadgen(struct loadgen *g)
+{
+	g->sent = calloc(g->count, sizeof(*g->sent));
+	double *lat = calloc(g->count, sizeof(*lat));
+	size_t cap = (size_t)g->req.width * g->req.height * 4;
+	unsigned char *buf = malloc(cap);
+	if (!g->sent || !lat || !buf) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	pthread_mutex_init(&g->lock, NULL);
+	pthread_cond_init(&g->room, NULL);
+
+	long long start = now_ns();
+	pthread_t sender;
+	if (pthread_create(&sender, NULL, loadgen_send, g)) {
+		perror("pthread_create");
+		return EXIT_FAILURE;
+	}
+
+	uint32_t errors = 0;
+	uint32_t done = 0;
+	for (; done < g->count; done++) {
+		struct proto_response res;
+		bool ok = read_full(g->fd, &res, sizeof(res))
+			&& res.magic == PROTO_RESPONSE_MAGIC
+			&& res.id < g->count;
+		if (ok && res.length > cap) {
+			unsigned char *grown = realloc(buf, res.length);
+			ok = grown;
+			if (grown) {
+				buf = grown;
+				cap = res.length;
+			}
+		}
+		if (!ok || !read_full(g->fd, buf, res.length)) {
+			fprintf(stderr, "Connection lost after %u responses\n", done);
+			break;
+		}
+		long long t = now_ns();
+		if (res.status != PROTO_OK)
+			errors++;
+
+		pthread_mutex_lock(&g->lock);
+		lat[done] = (double)(t - g->sent[res.id]) / 1e3;
+		g->outstanding--;
+		pthread_cond_signal(&g->room);
+		pthread_mutex_unlock(&g->lock);
+	}
+	double secs = (double)(now_ns() - start) / 1e9;
+	pthread_join(sender, NULL);
+
+	if (!done)
+		return EXIT_FAILURE;
+
+	qsort(lat, done, sizeof(*lat), cmp_double);
+	double mean = 0;
+	for (uint32_t i = 0; i < done; i++)
+		mean += lat[i];
+	mean /= done;
+	size_t p99 = ((size_t)done * 99 + 99) / 100;
+
+	printf("{ \"requests\": %u, \"errors\": %u, \"window\": %u, "
+		"\"rps\": %.1f, \"mean_us\": %.1f, \"median_us\": %.1f, "
+		"\"p99_us\": %.1f, \"max_us\": %.1f }\n",
+		done, errors, g->window, (double)done / secs, mean,
+		lat[done / 2], lat[p99 - 1], lat[done - 1]);
+
+	free(buf);
+	free(lat);
+	free(g->sent);
+	return done == g->count && !errors ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int
+request_one(int fd, const struct proto_request *req, const void *payload,
+	const char *out)
+{
+	struct proto_response res;
+	if (!send_request(fd, req, payload)
+			|| !read_full(fd, &res, sizeof(res))
+			|| res.magic != PROTO_RESPONSE_MAGIC) {
+		fprintf(stderr, "Connection lost!\n");
+		return EXIT_FAILURE;
+	}
+	if (res.status != PROTO_OK) {
+		fprintf(stderr, "Server returned error %u\n", res.status);
+		return EXIT_FAILURE;
+	}
+
+	unsigned char *buf = malloc(res.length);
+	if (!buf || !read_full(fd, buf, res.length)) {
+		fprintf(stderr, "Connection lost!\n");
+		return EXIT_FAILURE;
+	}
+
+	FILE *f = strcmp(out, "-") ? fopen(out, "wb") : stdout;
+	if (!f || fwrite(buf, 1, res.length, f) != res.length) {
+		perror(out);
+		return EXIT_FAILURE;
+	}
+	if (f != stdout)
+		fclose(f);
+	free(buf);
+	return EXIT_SUCCESS;
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-client [-s socket] [-p preset] [-W width]"
+		" [-H height]\n"
+		"                   [-f png|rgba] [-P] [-o out] [-n count]"
+		" [-c window] [-x mask] skin.png\n"
+		"\t-x\tmask of parts to hide, bit per part\n"
+		"\t-P\tsend the path instead of the file contents\n"
+		"\t-n\tsend count requests and report latency\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *path = PROTO_SOCKET;
+	const char *out = "out.png";
+	const char *skin = NULL;
+	struct proto_request req = {
+		.magic = PROTO_REQUEST_MAGIC,
+		.source = PROTO_SOURCE_PNG,
+		.format = PROTO_FORMAT_PNG,
+		.width = 256,
+		.height = 256,
+	};
+	uint32_t count = 0, window = 32;
+
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+		if (!strcmp(argv[i], "-s") && more)
+			path = argv[++i];
+		else if (!strcmp(argv[i], "-p") && more)
+			req.preset = (uint8_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-W") && more)
+			req.width = (uint16_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-H") && more)
+			req.height = (uint16_t)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && more)
+			req.format = strcmp(argv[++i], "rgba")
+				? PROTO_FORMAT_PNG : PROTO_FORMAT_RGBA;
+		else if (!strcmp(argv[i], "-x") && more)
+			req.hidden = (uint16_t)strtoul(argv[++i], NULL, 0);
+		else if (!strcmp(argv[i], "-P"))
+			req.source = PROTO_SOURCE_PATH;
+		else if (!strcmp(argv[i], "-o") && more)
+			out = argv[++i];
+		else if (!strcmp(argv[i], "-n") && more)
+			count = (uint32_t)atol(argv[++i]);
+		else if (!strcmp(argv[i], "-c") && more)
+			window = (uint32_t)atol(argv[++i]);
+		else if (argv[i][0] != '-' && !skin)
+			skin = argv[i];
+		else {
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (!skin || !window) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	unsigned char *payload = NULL;
+	if (req.source == PROTO_SOURCE_PATH) {
+		/* The server resolves it from its own directory otherwise */
+		payload = (unsigned char *)realpath(skin, NULL);
+		if (!payload)
+			perror(skin);
+		else
+			req.length = (uint32_t)strlen((char *)payload);
+	} else {
+		payload = read_file(skin, &req.length);
+	}
+	if (!payload)
+		return EXIT_FAILURE;
+
+	int fd = connect_to(path);
+	if (fd < 0)
+		return EXIT_FAILURE;
+
+	int result;
+	if (count) {
+		struct loadgen g = {
+			.fd = fd,
+			.req = req,
+			.payload = payload,
+			.count = count,
+			.window = window,
+		};
+		result = loadgen(&g);
+	} else {
+		result = request_one(fd, &req, payload, out);
+	}
+
+	close(fd);
+	free(payload);
+	return result;
+}
@@ -0,0 +1,291 @@
+#ifndef CULL_H
+#define CULL_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "rlgl.h"
+#include "skin.h"
+#include "palette.h"
+
+/* Most of the overlay is fully transparent on most skins, but drawn as is
+ * every frame: blended, and writing depth where nothing shows. When a skin
+ * is loaded the texels under each overlay triangle are looked at once.
+ * Triangles with none visible are left out, ones with all fully opaque
+ * are drawn first with blending off, and only the rest are blended.
+ *
+ * Each overlay part gets two meshes over its own vertices, one for each
+ * kind, whose index lists are rewritten for every skin; the vertices are
+ * uploaded once. Triangles are looked at by the texel box of their UVs,
+ * which holds the texels they sample and those of nothing else on the
+ * box-shaped parts. */
+
+#define CULL_PARTS (MODEL_COUNT - MODEL_LAYER_HEAD)
+
+enum cull_kind {
+	CULL_EMPTY = 0,
+	CULL_OPAQUE,
+	CULL_BLEND,
+	CULL_KINDS
+};
+
+struct cull_part {
+	int triangles;
+	unsigned short *corners; /* 3 vertices a triangle */
+	float (*boxes)[4];       /* UV min and max of each triangle */
+	unsigned char *kinds;    /* enum cull_kind of each triangle */
+	Mesh meshes[CULL_KINDS]; /* none for CULL_EMPTY */
+};
+
+struct cull_layer {
+	struct cull_part parts[CULL_PARTS];
+	size_t triangles[CULL_KINDS]; /* of the current skin */
+	size_t drawn[CULL_KINDS];     /* by the last cull_draw() */
+	size_t calls;
+};
+
+/* Triangles of mesh, by their UVs. False if out of memory. */
+bool
+cull_plan(struct cull_part *p, const Mesh *mesh)
+{
+	const int n = mesh->triangleCount;
+	p->triangles = n;
+	p->corners = RL_MALLOC(sizeof(*p->corners) * 3 * (size_t)n);
+	p->boxes = RL_MALLOC(sizeof(*p->boxes) * (size_t)n);
+	p->kinds = RL_MALLOC((size_t)n);
+	if (!p->corners || !p->boxes || !p->kinds || !mesh->texcoords)
+		return 0;
+
+	for (int t = 0; t < n; t++) {
+		float *box = p->boxes[t];
+		box[0] = box[1] = INFINITY;
+		box[2] = box[3] = -INFINITY;
+		for (int k = 0; k < 3; k++) {
+			const int i = t * 3 + k;
+			const unsigned short v = mesh->indices
+				? mesh->indices[i] : (unsigned short)i;
+			const float *uv = mesh->texcoords + (size_t)v * 2;
+			p->corners[i] = v;
+			box[0] = fminf(box[0], uv[0]);
+			box[1] = fminf(box[1], uv[1]);
+			box[2] = fmaxf(box[2], uv[0]);
+			box[3] = fmaxf(box[3], uv[1]);
+		}
+		p->kinds[t] = CULL_BLEND;
+	}
+	return 1;
+}
+
+/* Texel edge nearest to f of size texels, clamped to the texture */
+static int
+cull_edge(float f, int size)
+{
+	const float e = floorf(f * (float)size + 0.5f);
+	return e < 0 ? 0 : e > (float)size ? size : (int)e;
+}
+
+/* Bit 1 for a transparent texel, 2 for an opaque one, 4 for the rest */
+static unsigned
+cull_alpha(unsigned char a)
+{
+	return a == 0 ? 1 : a == 255 ? 2 : 4;
+}
+
+static enum cull_kind
+cull_box(const struct palette_image *skin, const unsigned char *classes,
+	const float box[4])
+{
+	const int x0 = cull_edge(box[0], skin->width);
+	const int y0 = cull_edge(box[1], skin->height);
+	int x1 = cull_edge(box[2], skin->width);
+	int y1 = cull_edge(box[3], skin->height);
+	if (x1 <= x0)
+		x1 = x0 < skin->width ? x0 + 1 : x0;
+	if (y1 <= y0)
+		y1 = y0 < skin->height ? y0 + 1 : y0;
+
+	unsigned seen = 0;
+	for (int y = y0; y < y1 && seen < 3; y++) {
+		const unsigned char *row = skin->data + (size_t)y * skin->stride;
+		for (int x = x0; x < x1; x++) {
+			if (skin->bits == 32)
+				seen |= cull_alpha(row[(size_t)x * 4 + 3]);
+			else if (skin->bits == 8)
+				seen |= classes[row[x]];
+			else
+				seen |= classes[x % 2 ? row[x / 2] & 15 : row[x / 2] >> 4];
+		}
+	}
+	return seen == 1 ? CULL_EMPTY : seen == 2 ? CULL_OPAQUE : CULL_BLEND;
+}
+
+/* Sorts the triangles by what skin has under them into the index lists.
+ * Without pixels everything is blended, as it is drawn without culling. */
+void
+cull_classify(struct cull_layer *c, const struct palette_image *skin)
+{
+	unsigned char classes[256] = { 0 };
+	if (skin->data && skin->bits != 32) {
+		for (unsigned i = 0; i < skin->ncolors; i++)
+			classes[i] = (unsigned char)cull_alpha(
+				((const unsigned char *)&skin->colors[i])[3]);
+	}
+
+	memset(c->triangles, 0, sizeof(c->triangles));
+	for (size_t j = 0; j < CULL_PARTS; j++) {
+		struct cull_part *p = &c->parts[j];
+		int count[CULL_KINDS] = { 0 };
+		for (int t = 0; t < p->triangles; t++) {
+			/* The two triangles of a face have the same box */
+			enum cull_kind kind = !skin->data ? CULL_BLEND
+				: t && !memcmp(p->boxes[t], p->boxes[t - 1],
+					sizeof(p->boxes[t])) ? p->kinds[t - 1]
+				: cull_box(skin, classes, p->boxes[t]);
+			p->kinds[t] = (unsigned char)kind;
+			if (kind != CULL_EMPTY && p->meshes[kind].indices)
+				memcpy(p->meshes[kind].indices + count[kind] * 3,
+					p->corners + t * 3, sizeof(*p->corners) * 3);
+			count[kind]++;
+		}
+		for (size_t k = 0; k < CULL_KINDS; k++) {
+			p->meshes[k].triangleCount = count[k];
+			c->triangles[k] += (size_t)count[k];
+		}
+	}
+}
+
+/* Sends the index lists made by cull_classify(), needs a GL context */
+void
+cull_upload(struct cull_layer *c)
+{
+	for (size_t j = 0; j < CULL_PARTS; j++) {
+		for (size_t k = CULL_OPAQUE; k < CULL_KINDS; k++) {
+			Mesh *m = &c->parts[j].meshes[k];
+			if (!m->vboId || !m->triangleCount)
+				continue;
+			/* Bound with its own vertex array, where there are any, as
+			 * that keeps the binding */
+			rlEnableVertexArray(m->vaoId);
+			rlUpdateVertexBufferElements(m->vboId[6], m->indices,
+				m->triangleCount * 3 * (int)sizeof(*m->indices), 0);
+			rlDisableVertexArray();
+		}
+	}
+}
+
+void
+cull_free(struct cull_layer *c)
+{
+	for (size_t j = 0; j < CULL_PARTS; j++) {
+		struct cull_part *p = &c->parts[j];
+		for (size_t k = CULL_OPAQUE; k < CULL_KINDS; k++) {
+			if (p->meshes[k].vboId)
+				UnloadMesh(p->meshes[k]);
+			else
+				RL_FREE(p->meshes[k].indices);
+		}
+		RL_FREE(p->corners);
+		RL_FREE(p->boxes);
+		RL_FREE(p->kinds);
+	}
+	*c = (struct cull_layer){ 0 };
+}
+
+/* Plans the overlay parts of models and uploads their meshes, everything
+ * blended until cull_update(). Needs a GL context; false if out of
+ * memory, with c freed. */
+bool
+cull_init(struct cull_layer *c, const Model *models)
+{
+	*c = (struct cull_layer){ 0 };
+	for (size_t j = 0; j < CULL_PARTS; j++) {
+		const Mesh *src = &models[MODEL_LAYER_HEAD + j].meshes[0];
+		struct cull_part *p = &c->parts[j];
+		if (!cull_plan(p, src)) {
+			cull_free(c);
+			return 0;
+		}
+		for (size_t k = CULL_OPAQUE; k < CULL_KINDS; k++) {
+			Mesh *m = &p->meshes[k];
+			*m = (Mesh){
+				.vertexCount = src->vertexCount,
+				.triangleCount = p->triangles,
+				.vertices = src->vertices,
+				.texcoords = src->texcoords,
+				.normals = src->normals,
+				.indices = RL_MALLOC(sizeof(*p->corners)
+					* 3 * (size_t)p->triangles),
+			};
+			if (!m->indices) {
+				cull_free(c);
+				return 0;
+			}
+			memcpy(m->indices, p->corners,
+				sizeof(*p->corners) * 3 * (size_t)p->triangles);
+			UploadMesh(m, true);
+			/* The model keeps these, only the GPU copy is drawn */
+			m->vertices = m->texcoords = m->normals = NULL;
+		}
+		p->meshes[CULL_OPAQUE].triangleCount = 0;
+		c->triangles[CULL_BLEND] += (size_t)p->triangles;
+	}
+	return 1;
+}
+
+/* cull_classify() and cull_upload() for a new skin */
+void
+cull_update(struct cull_layer *c, const struct palette_image *skin)
+{
+	cull_classify(c, skin);
+	cull_upload(c);
+}
+
+/* Draws the overlay parts of models not set in hidden (bit per enum
+ * model), opaque triangles first and unblended. Inside BeginMode3D(). */
+void
+cull_draw(struct cull_layer *c, const Model *models, unsigned hidden)
+{
+	memset(c->drawn, 0, sizeof(c->drawn));
+	c->calls = 0;
+	for (size_t k = CULL_OPAQUE; k < CULL_KINDS; k++) {
+		rlDrawRenderBatchActive();
+		if (k == CULL_OPAQUE)
+			rlDisableColorBlend();
+		else
+			rlEnableColorBlend();
+		for (size_t j = 0; j < CULL_PARTS; j++) {
+			const Model *model = &models[MODEL_LAYER_HEAD + j];
+			const struct cull_part *p = &c->parts[j];
+			if (hidden & (1u << (MODEL_LAYER_HEAD + j)))
+				continue;
+			if (k == CULL_OPAQUE)
+				c->drawn[CULL_EMPTY] += (size_t)(p->triangles
+					- p->meshes[CULL_OPAQUE].triangleCount
+					- p->meshes[CULL_BLEND].triangleCount);
+			if (!p->meshes[k].triangleCount)
+				continue;
+			DrawMesh(p->meshes[k], model->materials[0], model->transform);
+			c->drawn[k] += (size_t)p->meshes[k].triangleCount;
+			c->calls++;
+		}
+	}
+}
+
+/* One line summary of the last cull_draw(), in a static buffer */
+const char *
+cull_stats(const struct cull_layer *c)
+{
+	static char buf[128];
+	snprintf(buf, sizeof(buf), "overlay %zu opaque, %zu blended, "
+		"%zu culled triangles in %zu calls",
+		c->drawn[CULL_OPAQUE], c->drawn[CULL_BLEND], c->drawn[CULL_EMPTY],
+		c->calls);
+	return buf;
+}
+
+#endif /* CULL_H */
@@ -0,0 +1,165 @@
+#ifndef DYNRES_H
+#define DYNRES_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "raylib.h"
+#include "rlgl.h"
+
+/* Dynamic resolution: the 3D pass is drawn into an offscreen texture at a
+ * fraction of the window's size and stretched over it, the fraction
+ * following how long frames take against a budget. The texture is as big
+ * as the window and only a corner of it is drawn into, so the scale can
+ * change every frame without reallocating anything.
+ *
+ * raylib has no GPU timers, but a GPU that is behind holds up the buffer
+ * swap, so the whole frame's time shows it. The CPU time of a frame is
+ * measured separately: when that alone is over budget, fewer pixels would
+ * not help and the scale is left alone. Going down is immediate, by the
+ * square root of how far over budget a frame is as the work goes with
+ * the area. Frames limited to the budget never show how much room is
+ * left, so going up is tried a step at a time after a calm spell, and the
+ * spell doubles each time a step has to be taken back and halves each
+ * time one holds. */
+
+#define DYNRES_MIN 0.25f       /* of the window, each way */
+#define DYNRES_STEP 0.05f      /* up after a calm spell */
+#define DYNRES_SLACK 1.1f      /* over budget beyond this much of it */
+#define DYNRES_SETTLE 8        /* frames ignored after a change */
+#define DYNRES_CALM 30         /* frames within budget before a step up */
+#define DYNRES_CALM_MAX 480
+#define DYNRES_SMOOTH 0.1f
+
+struct dynres {
+	float budget;     /* seconds a frame, 0 keeps the full size */
+	float scale;
+	float frame, cpu; /* smoothed seconds */
+	int settle, calm, patience;
+	bool raised; /* the last change was a step up */
+	size_t changes;
+
+	RenderTexture2D target;
+	int width, height; /* of the part drawn into */
+};
+
+void
+dynres_init(struct dynres *d, float budget)
+{
+	*d = (struct dynres){
+		.budget = budget,
+		.scale = 1,
+		.settle = DYNRES_SETTLE,
+		.patience = DYNRES_CALM,
+	};
+}
+
+void
+dynres_free(struct dynres *d)
+{
+	if (d->target.id)
+		UnloadRenderTexture(d->target);
+	d->target = (RenderTexture2D){ 0 };
+}
+
+static void
+dynres_set(struct dynres *d, float scale)
+{
+	scale = fminf(fmaxf(scale, DYNRES_MIN), 1);
+	if (scale == d->scale)
+		return;
+	d->scale = scale;
+	d->settle = DYNRES_SETTLE;
+	d->calm = 0;
+	d->changes++;
+}
+
+/* Takes the time of the last frame and the CPU's part of it, both in
+ * seconds, and picks the scale of the next */
+void
+dynres_update(struct dynres *d, float frame, float cpu)
+{
+	if (d->settle) {
+		/* Starts over from the first frame at the new scale */
+		if (--d->settle == 0) {
+			d->frame = frame;
+			d->cpu = cpu;
+		}
+		return;
+	}
+	d->frame += (frame - d->frame) * DYNRES_SMOOTH;
+	d->cpu += (cpu - d->cpu) * DYNRES_SMOOTH;
+	if (d->budget <= 0)
+		return;
+
+	const float limit = d->budget * DYNRES_SLACK;
+	if (d->frame > limit && d->cpu < d->budget) {
+		const float down = sqrtf(d->budget / d->frame);
+		if (d->raised && d->patience < DYNRES_CALM_MAX)
+			d->patience *= 2;
+		d->raised = 0;
+		dynres_set(d, d->scale * fminf(down, 1 - DYNRES_STEP));
+	} else if (d->frame <= limit && ++d->calm >= d->patience) {
+		/* The last step up held */
+		if (d->raised && d->patience > DYNRES_CALM)
+			d->patience /= 2;
+		d->raised = d->scale < 1;
+		dynres_set(d, d->scale + DYNRES_STEP);
+		if (d->scale == 1)
+			d->patience = DYNRES_CALM;
+	}
+}
+
+/* Starts drawing the 3D pass for a width x height window, to be ended
+ * with EndTextureMode(). False if there is no texture to draw into. */
+bool
+dynres_begin(struct dynres *d, int width, int height)
+{
+	if (d->target.texture.width != width
+			|| d->target.texture.height != height) {
+		dynres_free(d);
+		if (width < 1 || height < 1)
+			return 0;
+		d->target = LoadRenderTexture(width, height);
+		if (!d->target.id)
+			return 0;
+		SetTextureFilter(d->target.texture, TEXTURE_FILTER_BILINEAR);
+	}
+	d->width = (int)fmaxf(1, roundf((float)width * d->scale));
+	d->height = (int)fmaxf(1, roundf((float)height * d->scale));
+
+	BeginTextureMode(d->target);
+	/* The projection keeps the window's aspect, which this has too */
+	rlViewport(0, 0, d->width, d->height);
+	return 1;
+}
+
+/* Stretches what dynres_begin() drew over the window */
+void
+dynres_draw(const struct dynres *d)
+{
+	const Rectangle src = {
+		0, 0, (float)d->width, -(float)d->height,
+	};
+	const Rectangle dst = {
+		0, 0, (float)d->target.texture.width,
+		(float)d->target.texture.height,
+	};
+	DrawTexturePro(d->target.texture, src, dst, (Vector2){ 0 }, 0, WHITE);
+}
+
+/* One line summary, in a static buffer */
+const char *
+dynres_stats(const struct dynres *d)
+{
+	static char buf[128];
+	snprintf(buf, sizeof(buf), "3D at %.0f%% (%dx%d), frame %.1f ms, "
+		"cpu %.1f ms, budget %.1f ms, %zu changes",
+		(double)d->scale * 100, d->width, d->height,
+		(double)d->frame * 1000, (double)d->cpu * 1000,
+		(double)d->budget * 1000, d->changes);
+	return buf;
+}
+
+#endif /* DYNRES_H */
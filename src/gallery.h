@@ -0,0 +1,375 @@
+#ifndef GALLERY_H
+#define GALLERY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "raymath.h"
+#include "index.h"
+#include "lint.h"
+#include "skin.h"
+#include "thread.h"
+
+/* Gallery mode shows every skin of a directory as a grid of players.
+ *
+ * Skins are normalized to 64x64 and packed into atlas textures, and the
+ * twelve parts are merged into one mesh per arm shape, so each atlas is at
+ * most two instanced draws no matter how many players it holds. A loader thread
+ * decodes skins and hands them over through a bounded queue; the main
+ * thread only copies a limited number of tiles into the atlases per frame,
+ * which keeps the window responsive while a big directory streams in. A
+ * library index, if the directory has one, replaces the listing and lets
+ * the loader skip files that are not skins without decoding them. */
+
+#define GALLERY_TILE 64
+#define GALLERY_ATLAS 2048
+#define GALLERY_PER_ROW (GALLERY_ATLAS / GALLERY_TILE)
+#define GALLERY_PER_ATLAS (GALLERY_PER_ROW * GALLERY_PER_ROW)
+#define GALLERY_PENDING 512
+#define GALLERY_UPLOADS 128
+#define GALLERY_COLUMNS 32
+#define GALLERY_SPACING 1.0f
+#define GALLERY_ROW 2.5f
+
+struct gallery_loader {
+	const char *dir;
+	thread_mutex lock;
+	thread_cond room;
+
+	/* Decoded, not yet uploaded skins as a ring */
+	Image pending[GALLERY_PENDING];
+	size_t head, count;
+
+	size_t total, failed;
+	bool scanned, done, quit;
+};
+
+struct gallery_atlas {
+	Texture2D texture;
+	Matrix *transforms[2]; /* indexed by slim */
+	int count[2];
+};
+
+struct gallery {
+	Mesh meshes[2]; /* indexed by slim */
+	Material material;
+	struct gallery_atlas *atlases;
+	size_t natlases;
+	int placed;
+};
+
+static void
+gallery_load(void *arg)
+{
+	struct gallery_loader *l = arg;
+	struct index x;
+	bool indexed = index_open_dir(&x, l->dir);
+	FilePathList files = indexed ? (FilePathList){ 0 }
+		: LoadDirectoryFilesEx(l->dir, ".png;.qoi", false);
+	size_t count = indexed ? x.count : files.count;
+
+	thread_mutex_lock(&l->lock);
+	l->total = count;
+	l->scanned = true;
+	thread_mutex_unlock(&l->lock);
+
+	for (size_t i = 0; i < count; i++) {
+		Image img = { 0 };
+		struct lint_png png;
+		if (!indexed) {
+			if (!lint_peek(files.paths[i], &png))
+				img = skin_load(files.paths[i]);
+		} else if (x.entries[i].kind != SKIN_INVALID) {
+			char *path = index_path(&x, l->dir, &x.entries[i]);
+			if (path)
+				img = skin_load(path);
+			free(path);
+		}
+		if (img.data) {
+			ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+			image_upgrade_legacy(&img);
+		}
+		if (!img.data || img.width != img.height
+				|| img.width % GALLERY_TILE) {
+			UnloadImage(img);
+			thread_mutex_lock(&l->lock);
+			l->failed++;
+			thread_mutex_unlock(&l->lock);
+			continue;
+		}
+		if (img.width != GALLERY_TILE)
+			ImageResizeNN(&img, GALLERY_TILE, GALLERY_TILE);
+
+		thread_mutex_lock(&l->lock);
+		while (l->count == GALLERY_PENDING && !l->quit)
+			thread_cond_wait(&l->room, &l->lock);
+		bool quit = l->quit;
+		if (!quit)
+			l->pending[(l->head + l->count++) % GALLERY_PENDING] = img;
+		thread_mutex_unlock(&l->lock);
+		if (quit) {
+			UnloadImage(img);
+			break;
+		}
+	}
+
+	UnloadDirectoryFiles(files);
+	index_close(&x);
+	thread_mutex_lock(&l->lock);
+	l->done = true;
+	thread_mutex_unlock(&l->lock);
+}
+
+/* All parts as one non-indexed mesh, uploaded to the GPU */
+Mesh
+gallery_mesh(const Model *models)
+{
+	Mesh m = { 0 };
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		for (int j = 0; j < models[i].meshCount; j++) {
+			const Mesh *p = &models[i].meshes[j];
+			m.vertexCount += p->indices ? p->triangleCount * 3
+				: p->vertexCount;
+		}
+	}
+	m.triangleCount = m.vertexCount / 3;
+	m.vertices = MemAlloc(sizeof(float) * 3 * (unsigned)m.vertexCount);
+	m.texcoords = MemAlloc(sizeof(float) * 2 * (unsigned)m.vertexCount);
+
+	int n = 0;
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		for (int j = 0; j < models[i].meshCount; j++) {
+			const Mesh *p = &models[i].meshes[j];
+			int count = p->indices ? p->triangleCount * 3 : p->vertexCount;
+			for (int k = 0; k < count; k++, n++) {
+				int v = p->indices ? p->indices[k] : k;
+				memcpy(&m.vertices[n * 3], &p->vertices[v * 3],
+					sizeof(float) * 3);
+				memcpy(&m.texcoords[n * 2], &p->texcoords[v * 2],
+					sizeof(float) * 2);
+			}
+		}
+	}
+	UploadMesh(&m, false);
+	return m;
+}
+
+/* Where the player in slot stands */
+Matrix
+gallery_transform(int slot)
+{
+	const int col = slot % GALLERY_COLUMNS, row = slot / GALLERY_COLUMNS;
+	return MatrixMultiply(MatrixRotateY(-0.5f),
+		MatrixTranslate(-(float)col * GALLERY_SPACING,
+			-(float)row * GALLERY_ROW, 0.0f));
+}
+
+static void
+gallery_place(struct gallery_atlas *a, int slot, bool slim)
+{
+	const int tile = slot % GALLERY_PER_ATLAS;
+	Matrix t = gallery_transform(slot);
+	t.m3 = (float)(tile % GALLERY_PER_ROW);
+	t.m7 = (float)(tile / GALLERY_PER_ROW);
+	a->transforms[slim][a->count[slim]++] = t;
+}
+
+/* Builds the meshes and the instancing material, needs a GL context */
+bool
+gallery_init(struct gallery *g)
+{
+	*g = (struct gallery){ 0 };
+	for (size_t slim = 0; slim < 2; slim++) {
+		Model models[MODEL_COUNT] = { 0 };
+		if (!load_models(models, slim, (Texture2D){ 0 }))
+			return 0;
+		g->meshes[slim] = gallery_mesh(models);
+		for (size_t i = 0; i < MODEL_COUNT; i++)
+			UnloadModel(models[i]);
+	}
+
+	Shader shader = LoadShaderFromMemory(
+		(const char *)get_bundle("resources/shaders/gallery.vs"),
+		(const char *)get_bundle("resources/shaders/gallery.fs"));
+	shader.locs[SHADER_LOC_MATRIX_MODEL] =
+		GetShaderLocationAttrib(shader, "instanceTransform");
+	const float scale = (float)GALLERY_TILE / GALLERY_ATLAS;
+	SetShaderValue(shader, GetShaderLocation(shader, "tileScale"),
+		&(Vector2){ scale, scale }, SHADER_UNIFORM_VEC2);
+	g->material = LoadMaterialDefault();
+	g->material.shader = shader;
+	return 1;
+}
+
+/* Copies a 64x64 RGBA8 skin into the next tile and places its player.
+ * False if out of memory. */
+bool
+gallery_add(struct gallery *g, const Image *img)
+{
+	if (g->placed / GALLERY_PER_ATLAS == (int)g->natlases) {
+		struct gallery_atlas *grown = realloc(g->atlases,
+			sizeof(*g->atlases) * (g->natlases + 1));
+		if (grown)
+			g->atlases = grown;
+		Matrix *t[2] = {
+			malloc(sizeof(Matrix) * GALLERY_PER_ATLAS),
+			malloc(sizeof(Matrix) * GALLERY_PER_ATLAS),
+		};
+		if (!grown || !t[0] || !t[1]) {
+			free(t[0]);
+			free(t[1]);
+			return 0;
+		}
+		Image blank = GenImageColor(GALLERY_ATLAS, GALLERY_ATLAS, BLANK);
+		g->atlases[g->natlases++] = (struct gallery_atlas){
+			.texture = LoadTextureFromImage(blank),
+			.transforms = { t[0], t[1] },
+		};
+		UnloadImage(blank);
+	}
+
+	struct gallery_atlas *a = &g->atlases[g->placed / GALLERY_PER_ATLAS];
+	const int tile = g->placed % GALLERY_PER_ATLAS;
+	UpdateTextureRec(a->texture, (Rectangle){
+		(float)(tile % GALLERY_PER_ROW * GALLERY_TILE),
+		(float)(tile / GALLERY_PER_ROW * GALLERY_TILE),
+		GALLERY_TILE, GALLERY_TILE,
+	}, img->data);
+	gallery_place(a, g->placed++, skin_is_slim(img));
+	return 1;
+}
+
+/* Draws every player, inside BeginMode3D(). Returns the draw calls made. */
+size_t
+gallery_draw(struct gallery *g)
+{
+	size_t draws = 0;
+	for (size_t i = 0; i < g->natlases; i++) {
+		struct gallery_atlas *a = &g->atlases[i];
+		g->material.maps[MATERIAL_MAP_DIFFUSE].texture = a->texture;
+		for (size_t slim = 0; slim < 2; slim++) {
+			if (!a->count[slim])
+				continue;
+			DrawMeshInstanced(g->meshes[slim], g->material,
+				a->transforms[slim], a->count[slim]);
+			draws++;
+		}
+	}
+	return draws;
+}
+
+void
+gallery_free(struct gallery *g)
+{
+	for (size_t i = 0; i < g->natlases; i++) {
+		UnloadTexture(g->atlases[i].texture);
+		free(g->atlases[i].transforms[0]);
+		free(g->atlases[i].transforms[1]);
+	}
+	free(g->atlases);
+	g->material.maps[MATERIAL_MAP_DIFFUSE].texture = (Texture2D){ 0 };
+	UnloadMaterial(g->material);
+	UnloadMesh(g->meshes[0]);
+	UnloadMesh(g->meshes[1]);
+	*g = (struct gallery){ 0 };
+}
+
+/* Runs until the window is closed, needs a GL context */
+int
+gallery_run(const char *dir)
+{
+	struct gallery_loader l = { .dir = dir };
+	thread_mutex_init(&l.lock);
+	thread_cond_init(&l.room);
+	thread_handle loader;
+	if (!thread_start(&loader, gallery_load, &l)) {
+		fprintf(stderr, "Could not start the loader thread!\n");
+		return EXIT_FAILURE;
+	}
+
+	struct gallery g;
+	if (!gallery_init(&g)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+
+	Camera camera = {
+		.up = { 0.0f, 1.0f, 0.0f },
+		.projection = CAMERA_ORTHOGRAPHIC,
+	};
+	const float center = -(GALLERY_COLUMNS - 1) * GALLERY_SPACING / 2;
+	float top = GALLERY_ROW - 0.25f;
+	float width = GALLERY_COLUMNS * GALLERY_SPACING;
+
+	while (!WindowShouldClose()) {
+		/* Take a frame's worth of decoded skins off the queue */
+		Image batch[GALLERY_UPLOADS];
+		size_t nbatch = 0;
+		thread_mutex_lock(&l.lock);
+		while (l.count && nbatch < GALLERY_UPLOADS) {
+			batch[nbatch++] = l.pending[l.head];
+			l.head = (l.head + 1) % GALLERY_PENDING;
+			l.count--;
+		}
+		size_t total = l.total, failed = l.failed;
+		bool scanned = l.scanned, done = l.done && !l.count;
+		if (nbatch)
+			thread_cond_signal(&l.room);
+		thread_mutex_unlock(&l.lock);
+
+		for (size_t i = 0; i < nbatch; i++) {
+			gallery_add(&g, &batch[i]);
+			UnloadImage(batch[i]);
+		}
+
+		/* Wheel scrolls, with control it zooms */
+		float wheel = GetMouseWheelMove();
+		if (IsKeyDown(KEY_LEFT_CONTROL))
+			width = Clamp(width * (1.0f - wheel * 0.1f), 2.0f,
+				GALLERY_COLUMNS * GALLERY_SPACING * 2);
+		else
+			top += wheel * GALLERY_ROW;
+		if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_PAGE_DOWN))
+			top -= GALLERY_ROW * 0.25f;
+		if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_PAGE_UP))
+			top += GALLERY_ROW * 0.25f;
+		if (IsKeyPressed(KEY_HOME))
+			top = GALLERY_ROW - 0.25f;
+
+		const float aspect = (float)GetScreenWidth()
+			/ (float)(GetScreenHeight() ? GetScreenHeight() : 1);
+		camera.fovy = width / aspect;
+		camera.target = (Vector3){ center, top - camera.fovy / 2, 0.0f };
+		camera.position = camera.target;
+		camera.position.z = -8.0f;
+
+		BeginDrawing();
+		ClearBackground(BLACK);
+		BeginMode3D(camera);
+		size_t draws = gallery_draw(&g);
+		EndMode3D();
+
+		DrawText(TextFormat("%d of %zu%s skins, %zu failed, "
+			"%zu draw calls, %d fps%s",
+			g.placed, total, scanned ? "" : "+", failed, draws,
+			GetFPS(), done ? "" : ", loading"), 8, 8, 10, RAYWHITE);
+		EndDrawing();
+	}
+
+	thread_mutex_lock(&l.lock);
+	l.quit = true;
+	thread_cond_broadcast(&l.room);
+	thread_mutex_unlock(&l.lock);
+	thread_join(loader);
+	for (size_t i = 0; i < l.count; i++)
+		UnloadImage(l.pending[(l.head + i) % GALLERY_PENDING]);
+	thread_cond_destroy(&l.room);
+	thread_mutex_destroy(&l.lock);
+
+	gallery_free(&g);
+	return EXIT_SUCCESS;
+}
+
+#endif /* GALLERY_H */
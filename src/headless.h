@@ -0,0 +1,144 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "raylib.h"
+#include "rlgl.h"
+
+/* A GL context for programs that only draw offscreen. raylib always opens
+ * a window, which needs a display even when hidden; on Linux this tries an
+ * EGL context on Mesa's surfaceless platform first, so renders work on
+ * machines without one (CI, servers). libEGL is opened at run time, the
+ * programs do not link against it. Anywhere else, or when that fails, it
+ * opens the hidden window raylib would.
+ *
+ * Without the window only drawing works: textures, render textures, models
+ * and reading pixels back. Whatever raylib asks GLFW (GetTime(), screen
+ * sizes, input, BeginDrawing()) does not. */
+
+#if defined(__linux__)
+#include <dlfcn.h>
+
+#define HEADLESS_EGL_DEFAULT_DISPLAY ((void *)0)
+#define HEADLESS_EGL_NONE 0x3038
+#define HEADLESS_EGL_OPENGL_API 0x30A2
+#define HEADLESS_EGL_CONTEXT_MAJOR_VERSION 0x3098
+#define HEADLESS_EGL_CONTEXT_MINOR_VERSION 0x30FB
+#define HEADLESS_EGL_CONTEXT_OPENGL_PROFILE_MASK 0x30FD
+#define HEADLESS_EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT 0x0001
+#define HEADLESS_EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+
+struct headless_egl {
+	void *lib;
+	void *display;
+	void *context;
+	void *(*get_proc)(const char *);
+	void *(*get_display)(unsigned, void *, const int *);
+	unsigned (*initialize)(void *, int *, int *);
+	unsigned (*bind_api)(unsigned);
+	void *(*create_context)(void *, void *, void *, const int *);
+	unsigned (*make_current)(void *, void *, void *, void *);
+	unsigned (*destroy_context)(void *, void *);
+	unsigned (*terminate)(void *);
+};
+
+struct headless_egl headless_egl;
+
+static bool
+headless_egl_init(int width, int height)
+{
+	struct headless_egl *e = &headless_egl;
+	void *get_proc;
+	if (!(e->lib = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL))
+			|| !(get_proc = dlsym(e->lib, "eglGetProcAddress")))
+		return 0;
+
+	/* Function pointers are copied out of void *, which ISO C does not
+	 * convert directly */
+	*(void **)&e->get_proc = get_proc;
+	*(void **)&e->get_display = e->get_proc("eglGetPlatformDisplayEXT");
+	*(void **)&e->initialize = dlsym(e->lib, "eglInitialize");
+	*(void **)&e->bind_api = dlsym(e->lib, "eglBindAPI");
+	*(void **)&e->create_context = dlsym(e->lib, "eglCreateContext");
+	*(void **)&e->make_current = dlsym(e->lib, "eglMakeCurrent");
+	*(void **)&e->destroy_context = dlsym(e->lib, "eglDestroyContext");
+	*(void **)&e->terminate = dlsym(e->lib, "eglTerminate");
+	if (!e->get_display || !e->initialize || !e->bind_api
+			|| !e->create_context || !e->make_current
+			|| !e->destroy_context || !e->terminate)
+		return 0;
+
+	/* The same 3.3 core profile raylib asks GLFW for */
+	const int attribs[] = {
+		HEADLESS_EGL_CONTEXT_MAJOR_VERSION, 3,
+		HEADLESS_EGL_CONTEXT_MINOR_VERSION, 3,
+		HEADLESS_EGL_CONTEXT_OPENGL_PROFILE_MASK,
+		HEADLESS_EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		HEADLESS_EGL_NONE,
+	};
+	e->display = e->get_display(HEADLESS_EGL_PLATFORM_SURFACELESS_MESA,
+		HEADLESS_EGL_DEFAULT_DISPLAY, NULL);
+	if (!e->display || !e->initialize(e->display, NULL, NULL))
+		return 0;
+	if (!e->bind_api(HEADLESS_EGL_OPENGL_API)
+			|| !(e->context = e->create_context(e->display, NULL, NULL,
+				attribs))
+			|| !e->make_current(e->display, NULL, NULL, e->context))
+		return 0;
+
+	rlLoadExtensions(get_proc);
+	rlglInit(width, height);
+	return 1;
+}
+
+static void
+headless_egl_close(void)
+{
+	struct headless_egl *e = &headless_egl;
+	if (e->context) {
+		rlglClose();
+		e->make_current(e->display, NULL, NULL, NULL);
+		e->destroy_context(e->display, e->context);
+	}
+	if (e->display)
+		e->terminate(e->display);
+	if (e->lib)
+		dlclose(e->lib);
+	*e = (struct headless_egl){ 0 };
+}
+#endif
+
+bool headless_windowed = false;
+
+/* Makes a context, width x height being the size of the window when there
+ * has to be one. False when neither way works. */
+bool
+headless_init(int width, int height, const char *title)
+{
+#if defined(__linux__)
+	if (headless_egl_init(width, height))
+		return 1;
+	headless_egl_close();
+	TraceLog(LOG_INFO, "HEADLESS: No surfaceless EGL, opening a window");
+#endif
+	SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	InitWindow(width, height, title);
+	headless_windowed = IsWindowReady();
+	return headless_windowed;
+}
+
+void
+headless_close(void)
+{
+#if defined(__linux__)
+	if (!headless_windowed) {
+		headless_egl_close();
+		return;
+	}
+#endif
+	CloseWindow();
+	headless_windowed = false;
+}
+
+#endif /* HEADLESS_H */
@@ -0,0 +1,456 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "raylib.h"
+#include "skin.h"
+#include "index.h"
+#include "phash.h"
+
+/* skin-index builds or refreshes the library index of a directory. Files
+ * whose size and mtime match the previous index keep their entry; only new
+ * and changed files are decoded, spread over a thread per core. */
+
+#define SCAN_CHUNK 64
+
+struct file {
+	char *name;
+	int64_t mtime_ns;
+	uint64_t size;
+	struct index_entry e;
+};
+
+struct scan {
+	const char *root;
+	int rootfd;
+	struct index old;
+	struct file *files;
+	size_t count, cap;
+
+	pthread_mutex_t lock;
+	size_t next;
+	size_t reused, decoded, invalid;
+};
+
+long long
+now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static char *
+join(const char *a, const char *b)
+{
+	size_t la = strlen(a), lb = strlen(b);
+	char *s = malloc(la + lb + 2);
+	if (!s)
+		return NULL;
+	memcpy(s, a, la);
+	s[la] = '/';
+	memcpy(s + la + 1, b, lb + 1);
+	return s;
+}
+
+/* Collects PNG and QOI paths under rel (relative to the root) with their
+ * size and mtime, skipping dot files. Symlinks to skins are indexed, but
+ * symlinked directories are not entered, so a link loop can not recurse
+ * forever. */
+bool
+walk(struct scan *s, const char *rel)
+{
+	int fd = rel ? openat(s->rootfd, rel,
+		O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC)
+		: dup(s->rootfd);
+	DIR *d = fd >= 0 ? fdopendir(fd) : NULL;
+	if (!d) {
+		if (fd >= 0)
+			close(fd);
+		perror(rel ? rel : s->root);
+		return 0;
+	}
+
+	bool ok = true;
+	struct dirent *ent;
+	while (ok && (ent = readdir(d))) {
+		if (ent->d_name[0] == '.')
+			continue;
+
+		struct stat st;
+		if (fstatat(dirfd(d), ent->d_name, &st, AT_SYMLINK_NOFOLLOW) < 0)
+			continue;
+		bool dir = S_ISDIR(st.st_mode);
+		if (S_ISLNK(st.st_mode) && (fstatat(dirfd(d), ent->d_name, &st, 0)
+				< 0 || S_ISDIR(st.st_mode)))
+			continue;
+		if (!dir && (!S_ISREG(st.st_mode) || !skin_file_name(ent->d_name)))
+			continue;
+
+		char *name = rel ? join(rel, ent->d_name) : strdup(ent->d_name);
+		if (!name) {
+			ok = false;
+			break;
+		}
+		if (dir) {
+			ok = walk(s, name);
+			free(name);
+			continue;
+		}
+
+		if (s->count == s->cap) {
+			size_t cap = s->cap ? s->cap * 2 : 1024;
+			struct file *grown = realloc(s->files, sizeof(*grown) * cap);
+			if (!grown) {
+				free(name);
+				ok = false;
+				break;
+			}
+			s->files = grown;
+			s->cap = cap;
+		}
+		s->files[s->count++] = (struct file){
+			.name = name,
+			.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000
+				+ st.st_mtim.tv_nsec,
+			.size = (uint64_t)st.st_size,
+		};
+	}
+	closedir(d);
+	return ok;
+}
+
+static int
+cmp_file(const void *a, const void *b)
+{
+	return strcmp(((const struct file *)a)->name,
+		((const struct file *)b)->name);
+}
+
+/* Fills in e from the pixels, kind is SKIN_INVALID if it does not decode */
+void
+describe(struct scan *s, struct file *f)
+{
+	char *path = join(s->root, f->name);
+	int size = 0;
+	unsigned char *data = path ? LoadFileData(path, &size) : NULL;
+	free(path);
+
+	Image img = skin_decode(data, size);
+	UnloadFileData(data);
+	if (!img.data)
+		return;
+
+	ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	f->e.width = (uint16_t)img.width;
+	f->e.height = (uint16_t)img.height;
+	f->e.kind = (uint8_t)skin_kind_of(img.width, img.height);
+	f->e.slim = skin_is_slim(&img);
+	f->e.hash = fnv1a(img.data, (size_t)img.width * (size_t)img.height * 4);
+	f->e.phash = phash_image(&img);
+	UnloadImage(img);
+}
+
+void *
+scan_worker(void *arg)
+{
+	struct scan *s = arg;
+	size_t reused = 0, decoded = 0, invalid = 0;
+
+	for (;;) {
+		pthread_mutex_lock(&s->lock);
+		size_t start = s->next;
+		s->next += SCAN_CHUNK;
+		pthread_mutex_unlock(&s->lock);
+		if (start >= s->count)
+			break;
+
+		size_t end = start + SCAN_CHUNK < s->count
+			? start + SCAN_CHUNK : s->count;
+		for (size_t i = start; i < end; i++) {
+			struct file *f = &s->files[i];
+			const struct index_entry *old = index_find(&s->old, f->name);
+			if (old && old->mtime_ns == f->mtime_ns
+					&& old->size == f->size) {
+				f->e = *old;
+				reused++;
+			} else {
+				f->e = (struct index_entry){ 0 };
+				describe(s, f);
+				decoded++;
+			}
+			f->e.mtime_ns = f->mtime_ns;
+			f->e.size = f->size;
+			if (f->e.kind == SKIN_INVALID)
+				invalid++;
+		}
+	}
+
+	pthread_mutex_lock(&s->lock);
+	s->reused += reused;
+	s->decoded += decoded;
+	s->invalid += invalid;
+	pthread_mutex_unlock(&s->lock);
+	return NULL;
+}
+
+/* Writes next to the destination and renames over it, so readers never
+ * see half an index */
+bool
+write_index(const struct scan *s, const char *path)
+{
+	struct index_header hdr = {
+		.magic = INDEX_MAGIC,
+		.version = INDEX_VERSION,
+		.count = s->count,
+	};
+	for (size_t i = 0; i < s->count; i++)
+		hdr.names_size += strlen(s->files[i].name) + 1;
+	if (hdr.names_size > UINT32_MAX) {
+		fprintf(stderr, "Too many names for one index!\n");
+		return 0;
+	}
+
+	char *tmp = malloc(strlen(path) + 5);
+	if (!tmp)
+		return 0;
+	sprintf(tmp, "%s.tmp", path);
+	FILE *f = fopen(tmp, "wb");
+	if (!f) {
+		perror(tmp);
+		free(tmp);
+		return 0;
+	}
+
+	bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+	uint32_t name = 0;
+	for (size_t i = 0; ok && i < s->count; i++) {
+		struct index_entry e = s->files[i].e;
+		e.name = name;
+		name += (uint32_t)strlen(s->files[i].name) + 1;
+		ok = fwrite(&e, sizeof(e), 1, f) == 1;
+	}
+	for (size_t i = 0; ok && i < s->count; i++)
+		ok = fwrite(s->files[i].name, strlen(s->files[i].name) + 1, 1, f) == 1;
+	ok = fclose(f) == 0 && ok;
+	ok = ok && rename(tmp, path) == 0;
+	if (!ok) {
+		perror(tmp);
+		unlink(tmp);
+	}
+	free(tmp);
+	return ok;
+}
+
+void
+print_index(const struct index *x)
+{
+	for (size_t i = 0; i < x->count; i++) {
+		const struct index_entry *e = &x->entries[i];
+		printf("%s\t%s\t%ux%u\t%s\t%016llx\t%016llx\n", index_name(x, e),
+			skin_kind_names[e->kind < SKIN_HD + 1 ? e->kind : 0],
+			e->width, e->height, e->slim ? "slim" : "classic",
+			(unsigned long long)e->hash, (unsigned long long)e->phash);
+	}
+}
+
+struct search {
+	const struct index *x;
+	size_t *entry; /* hash number to index entry */
+	size_t found;
+};
+
+void
+print_pair(size_t a, size_t b, int distance, void *ctx)
+{
+	struct search *s = ctx;
+	const struct index_entry *e = s->x->entries;
+	printf("%s\t%s\t%d\n", index_name(s->x, &e[s->entry[a]]),
+		index_name(s->x, &e[s->entry[b]]), distance);
+	s->found++;
+}
+
+void
+print_match(size_t a, size_t b, int distance, void *ctx)
+{
+	struct search *s = ctx;
+	(void)b;
+	printf("%s\t%d\n", index_name(s->x, &s->x->entries[s->entry[a]]),
+		distance);
+	s->found++;
+}
+
+/* Near duplicates among the indexed skins, or of the skin at query */
+bool
+search_index(const struct index *x, int radius, const char *query)
+{
+	uint64_t q = 0;
+	if (query) {
+		Image img = skin_load(query);
+		ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		q = img.data ? phash_image(&img) : 0;
+		UnloadImage(img);
+		if (!q) {
+			fprintf(stderr, "%s: not a skin\n", query);
+			return 0;
+		}
+	}
+
+	long long start = now_ns();
+	uint64_t *hashes = malloc(sizeof(*hashes) * (x->count ? x->count : 1));
+	struct search s = {
+		.x = x,
+		.entry = malloc(sizeof(*s.entry) * (x->count ? x->count : 1)),
+	};
+	size_t n = 0;
+	for (size_t i = 0; hashes && s.entry && i < x->count; i++) {
+		if (x->entries[i].kind != SKIN_INVALID && x->entries[i].phash) {
+			s.entry[n] = i;
+			hashes[n++] = x->entries[i].phash;
+		}
+	}
+
+	struct phash_table t;
+	bool ok = hashes && s.entry && phash_table_build(&t, hashes, n, radius);
+	long long built = now_ns();
+	size_t compared = 0;
+	if (ok) {
+		compared = query ? phash_table_query(&t, q, print_match, &s)
+			: phash_table_pairs(&t, print_pair, &s);
+		phash_table_free(&t);
+	} else {
+		fprintf(stderr, "Out of memory!\n");
+	}
+
+	fprintf(stderr, "{ \"skins\": %zu, \"radius\": %d, \"%s\": %zu, "
+		"\"compared\": %zu, \"build_s\": %.3f, \"search_s\": %.3f }\n",
+		n, radius, query ? "matches" : "pairs", s.found, compared,
+		(double)(built - start) / 1e9, (double)(now_ns() - built) / 1e9);
+	free(hashes);
+	free(s.entry);
+	return ok;
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-index [-j threads] [-o index] [-p]"
+		" [-d radius [-q skin.png]] dir\n"
+		"\t-o\tindex file, default dir/" INDEX_FILE "\n"
+		"\t-p\tprint the index instead of refreshing it\n"
+		"\t-d\tprint the pairs of skins whose perceptual hashes are\n"
+		"\t\tat most radius bits apart\n"
+		"\t-q\tprint the indexed skins within radius of skin.png\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct scan s = { 0 };
+	const char *out = NULL;
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+	bool print = false;
+	int radius = -1;
+	const char *query = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+		if (!strcmp(argv[i], "-o") && more)
+			out = argv[++i];
+		else if (!strcmp(argv[i], "-j") && more)
+			threads = atol(argv[++i]);
+		else if (!strcmp(argv[i], "-p"))
+			print = true;
+		else if (!strcmp(argv[i], "-d") && more)
+			radius = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-q") && more)
+			query = argv[++i];
+		else if (argv[i][0] != '-' && !s.root)
+			s.root = argv[i];
+		else {
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (!s.root || radius > 32 || (query && radius < 0)) {
+		usage();
+		return EXIT_FAILURE;
+	}
+	char *defpath = join(s.root, INDEX_FILE);
+	if (!out)
+		out = defpath;
+	if (threads < 1)
+		threads = 1;
+
+	SetTraceLogLevel(LOG_WARNING);
+	phash_init();
+
+	index_open(&s.old, out);
+	if (print || radius >= 0) {
+		if (!s.old.map) {
+			fprintf(stderr, "%s: no valid index\n", out);
+			return EXIT_FAILURE;
+		}
+		bool ok = true;
+		if (print)
+			print_index(&s.old);
+		else
+			ok = search_index(&s.old, radius, query);
+		index_close(&s.old);
+		free(defpath);
+		return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	s.rootfd = open(s.root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (s.rootfd < 0) {
+		perror(s.root);
+		return EXIT_FAILURE;
+	}
+
+	long long start = now_ns();
+	if (!walk(&s, NULL))
+		return EXIT_FAILURE;
+	qsort(s.files, s.count, sizeof(*s.files), cmp_file);
+	long long walked = now_ns();
+
+	pthread_mutex_init(&s.lock, NULL);
+	pthread_t *t = calloc((size_t)threads, sizeof(*t));
+	long started = 0;
+	for (; t && started < threads; started++) {
+		if (pthread_create(&t[started], NULL, scan_worker, &s))
+			break;
+	}
+	if (!started) {
+		perror("pthread_create");
+		return EXIT_FAILURE;
+	}
+	for (long i = 0; i < started; i++)
+		pthread_join(t[i], NULL);
+	long long scanned = now_ns();
+
+	index_close(&s.old);
+	bool ok = write_index(&s, out);
+
+	fprintf(stderr, "{ \"files\": %zu, \"reused\": %zu, \"decoded\": %zu, "
+		"\"invalid\": %zu, \"threads\": %ld, "
+		"\"walk_s\": %.3f, \"scan_s\": %.3f, \"seconds\": %.3f }\n",
+		s.count, s.reused, s.decoded, s.invalid, started,
+		(double)(walked - start) / 1e9, (double)(scanned - walked) / 1e9,
+		(double)(now_ns() - start) / 1e9);
+
+	for (size_t i = 0; i < s.count; i++)
+		free(s.files[i].name);
+	free(s.files);
+	free(t);
+	free(defpath);
+	close(s.rootfd);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,181 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Library index: what a directory of skins contains, so nobody has to open
+ * the files to find out. Written by skin-index, read by anything that lists
+ * skins. The file is a header, entries sorted by name, then the names as
+ * NUL terminated strings relative to the indexed directory. It is used in
+ * place once mapped. Fields are in host byte order. */
+
+#define INDEX_MAGIC 0x31584953u /* "SIX1" */
+#define INDEX_VERSION 2
+#define INDEX_FILE ".skin-index"
+
+struct index_header {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t count;
+	uint64_t names_size;
+	uint64_t reserved;
+};
+static_assert(sizeof(struct index_header) == 32, "Index header is padded");
+
+struct index_entry {
+	int64_t mtime_ns;
+	uint64_t size;
+	uint64_t hash;   /* fnv1a of the RGBA8 pixels */
+	uint64_t phash;  /* phash_image() */
+	uint32_t name;   /* offset into the names */
+	uint16_t width;
+	uint16_t height;
+	uint8_t kind;    /* enum skin_kind */
+	uint8_t slim;
+	uint8_t reserved[6];
+};
+static_assert(sizeof(struct index_entry) == 48, "Index entry is padded");
+
+struct index {
+	void *map;
+	size_t size;
+	const struct index_header *hdr;
+	const struct index_entry *entries;
+	const char *names;
+	size_t count;
+};
+
+/* Opens an index file, returning false if it is missing or not valid */
+bool
+index_open(struct index *x, const char *path)
+{
+	*x = (struct index){ 0 };
+#if defined(_WIN32)
+	int size = 0;
+	x->map = LoadFileData(path, &size);
+	x->size = (size_t)size;
+#else
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return 0;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		x->size = (size_t)st.st_size;
+		x->map = mmap(NULL, x->size, PROT_READ, MAP_SHARED, fd, 0);
+		if (x->map == MAP_FAILED)
+			x->map = NULL;
+	}
+	close(fd);
+#endif
+	if (!x->map || x->size < sizeof(struct index_header)) {
+		x->map = NULL;
+		return 0;
+	}
+
+	/* Checked without multiplying or adding what the file says, so huge
+	 * counts can not wrap around into sizes that look right */
+	x->hdr = x->map;
+	const size_t rest = x->size - sizeof(*x->hdr);
+	const uint64_t count = x->hdr->count;
+	if (x->hdr->magic != INDEX_MAGIC || x->hdr->version != INDEX_VERSION
+			|| count > rest / sizeof(struct index_entry)
+			|| x->hdr->names_size
+				!= rest - count * sizeof(struct index_entry)
+			|| (x->hdr->names_size
+				&& ((const char *)x->map)[x->size - 1] != '\0')) {
+#if defined(_WIN32)
+		UnloadFileData(x->map);
+#else
+		munmap(x->map, x->size);
+#endif
+		*x = (struct index){ 0 };
+		return 0;
+	}
+	x->entries = (const struct index_entry *)(x->hdr + 1);
+	x->names = (const char *)(x->entries + x->hdr->count);
+	x->count = (size_t)x->hdr->count;
+	return 1;
+}
+
+void
+index_close(struct index *x)
+{
+	if (!x->map)
+		return;
+#if defined(_WIN32)
+	UnloadFileData(x->map);
+#else
+	munmap(x->map, x->size);
+#endif
+	*x = (struct index){ 0 };
+}
+
+const char *
+index_name(const struct index *x, const struct index_entry *e)
+{
+	return e->name < x->hdr->names_size ? x->names + e->name : "";
+}
+
+/* Binary search by name */
+const struct index_entry *
+index_find(const struct index *x, const char *name)
+{
+	size_t lo = 0, hi = x->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		int c = strcmp(index_name(x, &x->entries[mid]), name);
+		if (!c)
+			return &x->entries[mid];
+		if (c < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return NULL;
+}
+
+/* dir/name of e, to be freed by the caller */
+char *
+index_path(const struct index *x, const char *dir, const struct index_entry *e)
+{
+	const char *name = index_name(x, e);
+	size_t a = strlen(dir), b = strlen(name);
+	char *s = malloc(a + b + 2);
+	if (s) {
+		memcpy(s, dir, a);
+		s[a] = '/';
+		memcpy(s + a + 1, name, b + 1);
+	}
+	return s;
+}
+
+/* Opens the index skin-index keeps inside dir */
+bool
+index_open_dir(struct index *x, const char *dir)
+{
+	char *path = malloc(strlen(dir) + sizeof("/" INDEX_FILE));
+	if (!path) {
+		*x = (struct index){ 0 };
+		return 0;
+	}
+	sprintf(path, "%s/" INDEX_FILE, dir);
+	bool ok = index_open(x, path);
+	free(path);
+	return ok;
+}
+
+#endif /* INDEX_H */
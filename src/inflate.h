@@ -0,0 +1,319 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Raw DEFLATE (RFC 1951) decoding into a buffer of known size, for the
+ * deflated members of zip archives. Input comes from archives nobody
+ * checked, so every read and write is bounds checked and a broken stream
+ * only makes inflate_raw() fail. Codes up to INFLATE_FAST bits long are
+ * decoded with one table lookup, longer ones a bit at a time. */
+
+#define INFLATE_FAST 9
+#define INFLATE_MAX_BITS 15
+
+struct inflate_huff {
+	uint16_t count[INFLATE_MAX_BITS + 1]; /* codes of each length */
+	uint16_t symbol[288];                 /* symbols in code order */
+	uint16_t fast[1 << INFLATE_FAST];     /* length << 9 | symbol */
+};
+
+struct inflate {
+	const unsigned char *in;
+	size_t in_len, in_pos;
+	uint64_t bits;
+	unsigned nbits;
+	bool bad; /* read past the end of the input */
+	unsigned char *out;
+	size_t out_len, out_pos;
+};
+
+static void
+inflate_refill(struct inflate *s)
+{
+	while (s->nbits <= 56 && s->in_pos < s->in_len) {
+		s->bits |= (uint64_t)s->in[s->in_pos++] << s->nbits;
+		s->nbits += 8;
+	}
+}
+
+/* The next n bits, zeros past the end of the input */
+static unsigned
+inflate_peek(struct inflate *s, unsigned n)
+{
+	if (s->nbits < n)
+		inflate_refill(s);
+	return (unsigned)(s->bits & ((1u << n) - 1));
+}
+
+static void
+inflate_drop(struct inflate *s, unsigned n)
+{
+	if (n > s->nbits) {
+		s->bad = true;
+		n = s->nbits;
+	}
+	s->bits >>= n;
+	s->nbits -= n;
+}
+
+static unsigned
+inflate_bits(struct inflate *s, unsigned n)
+{
+	unsigned v = inflate_peek(s, n);
+	inflate_drop(s, n);
+	return v;
+}
+
+/* Builds the canonical code for lengths[0..n). Returns false for a set of
+ * lengths no code can have; incomplete codes are fine until a missing
+ * code turns up. */
+static bool
+inflate_build(struct inflate_huff *h, const unsigned char *lengths, unsigned n)
+{
+	uint16_t offs[INFLATE_MAX_BITS + 1];
+	memset(h->count, 0, sizeof(h->count));
+	memset(h->fast, 0, sizeof(h->fast));
+	for (unsigned i = 0; i < n; i++)
+		h->count[lengths[i]]++;
+	h->count[0] = 0;
+
+	int left = 1;
+	for (unsigned len = 1; len <= INFLATE_MAX_BITS; len++) {
+		left = left * 2 - h->count[len];
+		if (left < 0)
+			return 0;
+	}
+
+	offs[1] = 0;
+	for (unsigned len = 1; len < INFLATE_MAX_BITS; len++)
+		offs[len + 1] = (uint16_t)(offs[len] + h->count[len]);
+	for (unsigned i = 0; i < n; i++) {
+		if (lengths[i])
+			h->symbol[offs[lengths[i]]++] = (uint16_t)i;
+	}
+
+	/* Codes are sent from the top bit down, so the table is indexed by
+	 * the code bit reversed */
+	unsigned code = 0, index = 0;
+	for (unsigned len = 1; len <= INFLATE_FAST; len++) {
+		for (unsigned k = 0; k < h->count[len]; k++, code++) {
+			unsigned rev = 0;
+			for (unsigned b = 0; b < len; b++)
+				rev |= (code >> b & 1) << (len - 1 - b);
+			const uint16_t entry = (uint16_t)(len << 9 | h->symbol[index++]);
+			for (unsigned i = rev; i < 1u << INFLATE_FAST; i += 1u << len)
+				h->fast[i] = entry;
+		}
+		code <<= 1;
+	}
+	return 1;
+}
+
+/* The next symbol, or -1 for a code that is not in h */
+static int
+inflate_decode(struct inflate *s, const struct inflate_huff *h)
+{
+	const unsigned entry = h->fast[inflate_peek(s, INFLATE_FAST)];
+	if (entry) {
+		inflate_drop(s, entry >> 9);
+		return (int)(entry & 511);
+	}
+
+	int code = 0, first = 0, index = 0;
+	for (unsigned len = 1; len <= INFLATE_MAX_BITS; len++) {
+		code |= (int)inflate_bits(s, 1);
+		const int count = h->count[len];
+		if (code - count < first)
+			return h->symbol[index + (code - first)];
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+	return -1;
+}
+
+static bool
+inflate_stored(struct inflate *s)
+{
+	/* Give back the whole bytes already taken into the bit buffer */
+	inflate_drop(s, s->nbits % 8);
+	s->in_pos -= s->nbits / 8;
+	s->bits = 0;
+	s->nbits = 0;
+
+	if (s->in_len - s->in_pos < 4)
+		return 0;
+	const unsigned char *p = s->in + s->in_pos;
+	const size_t len = (size_t)(p[0] | p[1] << 8);
+	if ((p[0] ^ p[2]) != 0xff || (p[1] ^ p[3]) != 0xff)
+		return 0;
+	s->in_pos += 4;
+	if (len > s->in_len - s->in_pos || len > s->out_len - s->out_pos)
+		return 0;
+	memcpy(s->out + s->out_pos, s->in + s->in_pos, len);
+	s->in_pos += len;
+	s->out_pos += len;
+	return 1;
+}
+
+static bool
+inflate_codes(struct inflate *s, const struct inflate_huff *lit,
+	const struct inflate_huff *dist)
+{
+	static const uint16_t len_base[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+	};
+	static const uint8_t len_extra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+	};
+	static const uint16_t dist_base[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+		8193, 12289, 16385, 24577,
+	};
+	static const uint8_t dist_extra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+	};
+
+	for (;;) {
+		int sym = inflate_decode(s, lit);
+		if (sym < 0 || s->bad)
+			return 0;
+		if (sym < 256) {
+			if (s->out_pos == s->out_len)
+				return 0;
+			s->out[s->out_pos++] = (unsigned char)sym;
+			continue;
+		}
+		if (sym == 256)
+			return 1;
+
+		sym -= 257;
+		if (sym >= 29)
+			return 0;
+		const size_t len = len_base[sym] + inflate_bits(s, len_extra[sym]);
+		sym = inflate_decode(s, dist);
+		if (sym < 0 || sym >= 30)
+			return 0;
+		const size_t d = dist_base[sym] + inflate_bits(s, dist_extra[sym]);
+		if (s->bad || d > s->out_pos || len > s->out_len - s->out_pos)
+			return 0;
+		unsigned char *o = s->out + s->out_pos;
+		for (size_t i = 0; i < len; i++)
+			o[i] = o[i - d];
+		s->out_pos += len;
+	}
+}
+
+static bool
+inflate_fixed(struct inflate *s, struct inflate_huff *lit,
+	struct inflate_huff *dist)
+{
+	unsigned char lengths[288];
+	memset(lengths, 8, 144);
+	memset(lengths + 144, 9, 112);
+	memset(lengths + 256, 7, 24);
+	memset(lengths + 280, 8, 8);
+	inflate_build(lit, lengths, 288);
+	memset(lengths, 5, 30);
+	inflate_build(dist, lengths, 30);
+	return inflate_codes(s, lit, dist);
+}
+
+static bool
+inflate_dynamic(struct inflate *s, struct inflate_huff *lit,
+	struct inflate_huff *dist)
+{
+	static const uint8_t order[19] = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+	};
+	unsigned char lengths[288 + 32];
+	const unsigned nlen = inflate_bits(s, 5) + 257;
+	const unsigned ndist = inflate_bits(s, 5) + 1;
+	const unsigned ncode = inflate_bits(s, 4) + 4;
+	if (nlen > 286 || ndist > 30)
+		return 0;
+
+	memset(lengths, 0, 19);
+	for (unsigned i = 0; i < ncode; i++)
+		lengths[order[i]] = (unsigned char)inflate_bits(s, 3);
+	if (!inflate_build(lit, lengths, 19))
+		return 0;
+
+	for (unsigned i = 0; i < nlen + ndist;) {
+		const int sym = inflate_decode(s, lit);
+		if (sym < 0 || s->bad)
+			return 0;
+		if (sym < 16) {
+			lengths[i++] = (unsigned char)sym;
+			continue;
+		}
+		unsigned char len = 0;
+		unsigned repeat;
+		if (sym == 16) {
+			if (!i)
+				return 0;
+			len = lengths[i - 1];
+			repeat = 3 + inflate_bits(s, 2);
+		} else if (sym == 17) {
+			repeat = 3 + inflate_bits(s, 3);
+		} else {
+			repeat = 11 + inflate_bits(s, 7);
+		}
+		if (repeat > nlen + ndist - i)
+			return 0;
+		memset(lengths + i, len, repeat);
+		i += repeat;
+	}
+
+	if (!lengths[256] || !inflate_build(lit, lengths, nlen)
+			|| !inflate_build(dist, lengths + nlen, ndist))
+		return 0;
+	return inflate_codes(s, lit, dist);
+}
+
+/* Inflates in into out, true only if the stream ends having filled out
+ * exactly */
+bool
+inflate_raw(const unsigned char *in, size_t in_len, unsigned char *out,
+	size_t out_len)
+{
+	struct inflate s = {
+		.in = in,
+		.in_len = in_len,
+		.out = out,
+		.out_len = out_len,
+	};
+	struct inflate_huff lit, dist;
+	bool last = false;
+	while (!last) {
+		last = inflate_bits(&s, 1);
+		bool ok;
+		switch (inflate_bits(&s, 2)) {
+		case 0:
+			ok = inflate_stored(&s);
+			break;
+		case 1:
+			ok = inflate_fixed(&s, &lit, &dist);
+			break;
+		case 2:
+			ok = inflate_dynamic(&s, &lit, &dist);
+			break;
+		default:
+			ok = false;
+			break;
+		}
+		if (!ok || s.bad)
+			return 0;
+	}
+	return s.out_pos == s.out_len;
+}
+
+#endif /* INFLATE_H */
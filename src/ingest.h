@@ -0,0 +1,509 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "thread.h"
+
+#if defined(__linux__)
+#if !defined(_DEFAULT_SOURCE)
+#error "ingest.h needs _DEFAULT_SOURCE for syscall()"
+#endif
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+/* Reads a list of small files into a fixed pool of buffers for a decode
+ * stage, for tools that go through whole directories of skins.
+ *
+ * Two engines: io_uring submits the open, read and close of many files
+ * per system call, reading straight into registered pool buffers; the
+ * fallback, used where io_uring is missing or not allowed, is a few
+ * threads doing blocking reads. Either way consumers take finished files
+ * with ingest_next() and give the buffer back with ingest_release(), in
+ * any order and from any thread. Files larger than a pool buffer are
+ * finished with a blocking read into memory of their own. */
+
+#define INGEST_DEPTH 64
+#define INGEST_BUFFER (128 * 1024)
+#define INGEST_READERS 4
+
+enum ingest_engine {
+	INGEST_URING = 0,
+	INGEST_THREADS,
+};
+
+const char *ingest_engine_names[] = {
+	[INGEST_URING]   = "uring",
+	[INGEST_THREADS] = "threads",
+};
+
+struct ingest_file {
+	size_t index; /* into the paths given to ingest_start() */
+	const unsigned char *data;
+	size_t size;
+	int error;    /* errno value, 0 when data is valid */
+	unsigned slot;
+};
+
+enum ingest_op {
+	INGEST_IDLE = 0,
+	INGEST_OPEN,
+	INGEST_READ,
+	INGEST_CLOSE,
+};
+
+struct ingest_slot {
+	unsigned char *buffer;
+	unsigned char *large; /* owned copy of a file bigger than buffer */
+	struct ingest_file file;
+	int fd;
+	enum ingest_op op; /* in flight in the ring */
+	bool held;         /* ready or handed out */
+};
+
+struct ingest {
+	enum ingest_engine engine;
+	char **paths;
+	size_t count;
+	size_t next;    /* first path not started */
+	size_t handed;  /* files given to consumers */
+	size_t enters;  /* io_uring_enter calls, to see the batching */
+
+	unsigned char *pool;
+	struct ingest_slot slots[INGEST_DEPTH];
+	unsigned free[INGEST_DEPTH], nfree;
+	unsigned ready[INGEST_DEPTH], ready_head, nready;
+
+	thread_mutex lock;
+	thread_cond wake;
+	bool quit;
+
+	thread_handle readers[INGEST_READERS];
+	unsigned nreaders;
+
+#if defined(__linux__)
+	int ring;
+	bool fixed; /* pool registered with the ring */
+	unsigned inflight, unsubmitted;
+	bool reaping; /* a consumer is in ingest_enter(), maybe unlocked */
+	void *sq_map, *cq_map;
+	size_t sq_size, cq_size;
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+	unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_cqe *cqes;
+#endif
+};
+
+/* Reads the rest of a file whose first INGEST_BUFFER bytes are in s */
+static void
+ingest_read_rest(struct ingest_slot *s, int fd)
+{
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size <= s->file.size)
+		return;
+
+	size_t size = (size_t)st.st_size;
+	unsigned char *large = malloc(size);
+	if (!large) {
+		s->file.error = ENOMEM;
+		return;
+	}
+	memcpy(large, s->buffer, s->file.size);
+	while (s->file.size < size) {
+		ssize_t n = pread(fd, large + s->file.size, size - s->file.size,
+			(off_t)s->file.size);
+		if (n <= 0)
+			break;
+		s->file.size += (size_t)n;
+	}
+	s->large = large;
+	s->file.data = large;
+}
+
+/* Call with the lock held */
+static void
+ingest_finish(struct ingest *g, unsigned slot)
+{
+	g->ready[(g->ready_head + g->nready++) % INGEST_DEPTH] = slot;
+	thread_cond_broadcast(&g->wake);
+}
+
+static void
+ingest_begin(struct ingest *g, unsigned slot)
+{
+	struct ingest_slot *s = &g->slots[slot];
+	s->file = (struct ingest_file){
+		.index = g->next++,
+		.data = s->buffer,
+		.slot = slot,
+	};
+	s->held = true;
+	s->fd = -1;
+}
+
+#if defined(__linux__)
+static struct io_uring_sqe *
+ingest_sqe(struct ingest *g)
+{
+	unsigned tail = *g->sq_tail;
+	unsigned i = tail & *g->sq_mask;
+	struct io_uring_sqe *sqe = &g->sqes[i];
+	memset(sqe, 0, sizeof(*sqe));
+	g->sq_array[i] = i;
+	__atomic_store_n(g->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	g->unsubmitted++;
+	g->inflight++;
+	return sqe;
+}
+
+static void
+ingest_submit(struct ingest *g, unsigned slot, enum ingest_op op)
+{
+	struct ingest_slot *s = &g->slots[slot];
+	struct io_uring_sqe *sqe = ingest_sqe(g);
+	s->op = op;
+	sqe->user_data = slot;
+	switch (op) {
+	case INGEST_OPEN:
+		sqe->opcode = IORING_OP_OPENAT;
+		sqe->fd = AT_FDCWD;
+		sqe->addr = (uint64_t)(uintptr_t)g->paths[s->file.index];
+		sqe->open_flags = O_RDONLY | O_CLOEXEC;
+		break;
+	case INGEST_READ:
+		sqe->opcode = g->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+		sqe->fd = s->fd;
+		sqe->addr = (uint64_t)(uintptr_t)s->buffer;
+		sqe->len = INGEST_BUFFER;
+		sqe->buf_index = (uint16_t)slot;
+		break;
+	case INGEST_CLOSE:
+		sqe->opcode = IORING_OP_CLOSE;
+		sqe->fd = s->fd;
+		break;
+	case INGEST_IDLE:
+		break;
+	}
+}
+
+/* Moves a slot on after its operation completed with res */
+static void
+ingest_complete(struct ingest *g, unsigned slot, int res)
+{
+	struct ingest_slot *s = &g->slots[slot];
+	enum ingest_op op = s->op;
+	s->op = INGEST_IDLE;
+	g->inflight--;
+
+	switch (op) {
+	case INGEST_OPEN:
+		if (res < 0) {
+			s->file.error = -res;
+			if (!g->quit)
+				ingest_finish(g, slot);
+			else
+				s->held = false;
+			return;
+		}
+		s->fd = res;
+		ingest_submit(g, slot, g->quit ? INGEST_CLOSE : INGEST_READ);
+		return;
+	case INGEST_READ:
+		if (res < 0)
+			s->file.error = -res;
+		else
+			s->file.size = (size_t)res;
+		/* Rare enough to do right here; the slot is ours meanwhile
+		 * and g->reaping keeps others off the completion queue */
+		if (res == INGEST_BUFFER && !g->quit) {
+			thread_mutex_unlock(&g->lock);
+			ingest_read_rest(s, s->fd);
+			thread_mutex_lock(&g->lock);
+		}
+		ingest_submit(g, slot, INGEST_CLOSE);
+		if (!g->quit)
+			ingest_finish(g, slot);
+		else
+			s->held = false;
+		return;
+	case INGEST_CLOSE:
+		s->fd = -1;
+		if (!s->held)
+			g->free[g->nfree++] = slot;
+		return;
+	case INGEST_IDLE:
+		return;
+	}
+}
+
+/* Submits what is queued and reaps completions, waiting for at least one
+ * if wait. Call with the lock held and g->reaping clear; the lock is let
+ * go while the kernel waits and while large files are read, so others
+ * can take ready files, queue opens and release buffers meanwhile. Only
+ * the reaper reads the completion queue. */
+static bool
+ingest_enter(struct ingest *g, bool wait)
+{
+	bool ok = true;
+	unsigned submit = g->unsubmitted;
+	g->unsubmitted = 0;
+	g->reaping = true;
+	if (submit || wait) {
+		g->enters++;
+		thread_mutex_unlock(&g->lock);
+		ok = syscall(__NR_io_uring_enter, g->ring, submit, wait ? 1 : 0,
+			wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0) >= 0
+			|| errno == EINTR;
+		thread_mutex_lock(&g->lock);
+	}
+
+	unsigned head = *g->cq_head;
+	while (ok && head != __atomic_load_n(g->cq_tail, __ATOMIC_ACQUIRE)) {
+		const struct io_uring_cqe cqe = g->cqes[head & *g->cq_mask];
+		__atomic_store_n(g->cq_head, ++head, __ATOMIC_RELEASE);
+		ingest_complete(g, (unsigned)cqe.user_data, cqe.res);
+	}
+	g->reaping = false;
+	thread_cond_broadcast(&g->wake);
+	return ok;
+}
+
+static bool
+ingest_uring_setup(struct ingest *g)
+{
+	struct io_uring_params p = { 0 };
+	g->ring = (int)syscall(__NR_io_uring_setup, INGEST_DEPTH, &p);
+	if (g->ring < 0)
+		return 0;
+
+	g->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	g->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+	if (single && g->cq_size > g->sq_size)
+		g->sq_size = g->cq_size;
+
+	g->sq_map = mmap(NULL, g->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		g->ring, IORING_OFF_SQ_RING);
+	g->cq_map = single ? g->sq_map : mmap(NULL, g->cq_size,
+		PROT_READ | PROT_WRITE, MAP_SHARED, g->ring, IORING_OFF_CQ_RING);
+	g->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	g->sqes = mmap(NULL, g->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		g->ring, IORING_OFF_SQES);
+	if (g->sq_map == MAP_FAILED || g->cq_map == MAP_FAILED
+			|| g->sqes == MAP_FAILED) {
+		if (g->sqes != MAP_FAILED)
+			munmap(g->sqes, g->sqes_size);
+		if (g->cq_map != MAP_FAILED && !single)
+			munmap(g->cq_map, g->cq_size);
+		if (g->sq_map != MAP_FAILED)
+			munmap(g->sq_map, g->sq_size);
+		close(g->ring);
+		return 0;
+	}
+
+	unsigned char *sq = g->sq_map, *cq = g->cq_map;
+	g->sq_head = (unsigned *)(sq + p.sq_off.head);
+	g->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+	g->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+	g->sq_array = (unsigned *)(sq + p.sq_off.array);
+	g->cq_head = (unsigned *)(cq + p.cq_off.head);
+	g->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+	g->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+	g->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+	/* Registered buffers save pinning pages on every read; without the
+	 * locked memory to register them plain reads do */
+	struct iovec iov[INGEST_DEPTH];
+	for (unsigned i = 0; i < INGEST_DEPTH; i++)
+		iov[i] = (struct iovec){ g->slots[i].buffer, INGEST_BUFFER };
+	g->fixed = syscall(__NR_io_uring_register, g->ring,
+		IORING_REGISTER_BUFFERS, iov, INGEST_DEPTH) == 0;
+	return 1;
+}
+
+static void
+ingest_uring_stop(struct ingest *g)
+{
+	while (g->reaping)
+		thread_cond_wait(&g->wake, &g->lock);
+	while (g->inflight && ingest_enter(g, true))
+		;
+	munmap(g->sqes, g->sqes_size);
+	if (g->cq_map != g->sq_map)
+		munmap(g->cq_map, g->cq_size);
+	munmap(g->sq_map, g->sq_size);
+	close(g->ring);
+}
+#endif
+
+static void
+ingest_reader(void *arg)
+{
+	struct ingest *g = arg;
+	thread_mutex_lock(&g->lock);
+	while (!g->quit) {
+		if (g->next == g->count || !g->nfree) {
+			thread_cond_wait(&g->wake, &g->lock);
+			continue;
+		}
+		unsigned slot = g->free[--g->nfree];
+		ingest_begin(g, slot);
+		struct ingest_slot *s = &g->slots[slot];
+		const char *path = g->paths[s->file.index];
+		thread_mutex_unlock(&g->lock);
+
+		int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			s->file.error = errno;
+		} else {
+			while (s->file.size < INGEST_BUFFER) {
+				ssize_t n = read(fd, s->buffer + s->file.size,
+					INGEST_BUFFER - s->file.size);
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n < 0)
+					s->file.error = errno;
+				if (n <= 0)
+					break;
+				s->file.size += (size_t)n;
+			}
+			if (s->file.size == INGEST_BUFFER)
+				ingest_read_rest(s, fd);
+			close(fd);
+		}
+
+		thread_mutex_lock(&g->lock);
+		ingest_finish(g, slot);
+	}
+	thread_mutex_unlock(&g->lock);
+}
+
+/* Starts reading paths, which must stay valid until ingest_stop(). Falls
+ * back from io_uring to threads if the ring can not be set up; g->engine
+ * says which one runs. */
+bool
+ingest_start(struct ingest *g, char **paths, size_t count,
+	enum ingest_engine engine)
+{
+	*g = (struct ingest){
+		.engine = engine,
+		.paths = paths,
+		.count = count,
+	};
+	g->pool = malloc((size_t)INGEST_DEPTH * INGEST_BUFFER);
+	if (!g->pool)
+		return 0;
+	for (unsigned i = 0; i < INGEST_DEPTH; i++) {
+		g->slots[i].buffer = g->pool + (size_t)i * INGEST_BUFFER;
+		g->slots[i].fd = -1;
+		g->free[g->nfree++] = INGEST_DEPTH - 1 - i;
+	}
+	thread_mutex_init(&g->lock);
+	thread_cond_init(&g->wake);
+
+#if defined(__linux__)
+	if (g->engine == INGEST_URING && ingest_uring_setup(g))
+		return 1;
+#endif
+	g->engine = INGEST_THREADS;
+	for (; g->nreaders < INGEST_READERS; g->nreaders++) {
+		if (!thread_start(&g->readers[g->nreaders], ingest_reader, g))
+			break;
+	}
+	if (g->nreaders)
+		return 1;
+
+	thread_cond_destroy(&g->wake);
+	thread_mutex_destroy(&g->lock);
+	free(g->pool);
+	return 0;
+}
+
+/* Waits for the next file. Returns false once every file was handed out. */
+bool
+ingest_next(struct ingest *g, struct ingest_file *f)
+{
+	thread_mutex_lock(&g->lock);
+	while (!g->nready && g->handed < g->count) {
+#if defined(__linux__)
+		if (g->engine == INGEST_URING) {
+			while (g->nfree && g->next < g->count) {
+				unsigned slot = g->free[--g->nfree];
+				ingest_begin(g, slot);
+				ingest_submit(g, slot, INGEST_OPEN);
+			}
+			/* With nothing in flight only a release can help,
+			 * and while another consumer reaps, its wake-up */
+			if (g->inflight && !g->reaping) {
+				if (!ingest_enter(g, true))
+					break;
+				continue;
+			}
+		}
+#endif
+		thread_cond_wait(&g->wake, &g->lock);
+	}
+
+	bool ok = g->nready;
+	if (ok) {
+		unsigned slot = g->ready[g->ready_head];
+		g->ready_head = (g->ready_head + 1) % INGEST_DEPTH;
+		g->nready--;
+		g->handed++;
+		*f = g->slots[slot].file;
+	}
+	thread_mutex_unlock(&g->lock);
+	return ok;
+}
+
+/* Gives the buffer of f back to the pool */
+void
+ingest_release(struct ingest *g, const struct ingest_file *f)
+{
+	thread_mutex_lock(&g->lock);
+	struct ingest_slot *s = &g->slots[f->slot];
+	free(s->large);
+	s->large = NULL;
+	s->held = false;
+	if (s->op == INGEST_IDLE) {
+		g->free[g->nfree++] = f->slot;
+		thread_cond_broadcast(&g->wake);
+	}
+	thread_mutex_unlock(&g->lock);
+}
+
+/* Stops early if need be; files handed out must be released first */
+void
+ingest_stop(struct ingest *g)
+{
+	thread_mutex_lock(&g->lock);
+	g->quit = true;
+	thread_cond_broadcast(&g->wake);
+#if defined(__linux__)
+	if (g->engine == INGEST_URING)
+		ingest_uring_stop(g);
+#endif
+	thread_mutex_unlock(&g->lock);
+
+	for (unsigned i = 0; i < g->nreaders; i++)
+		thread_join(g->readers[i]);
+	for (unsigned i = 0; i < INGEST_DEPTH; i++)
+		free(g->slots[i].large);
+	thread_cond_destroy(&g->wake);
+	thread_mutex_destroy(&g->lock);
+	free(g->pool);
+}
+
+#endif /* INGEST_H */
@@ -0,0 +1,337 @@
+#include <dirent.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "raylib.h"
+#include "skin.h"
+#include "lint.h"
+#include "archive.h"
+#include "outpath.h"
+
+/* skin-lint checks skins before anything renders them. Each file gets one
+ * JSON line on stdout; files whose header rules them out are never read
+ * past the IHDR chunk. With -a the skins come out of an archive instead. */
+
+struct lint {
+	char **files;
+	size_t count;
+	const char *fixdir;
+	const char *archive_path;
+	struct archive archive;
+
+	pthread_mutex_t lock;
+	size_t next;
+	size_t ok, rejected, flagged, fixed, decoded;
+};
+
+long long
+now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* One file's JSON line, cut short rather than overrun */
+struct report {
+	char buf[8192];
+	size_t n;
+};
+
+void
+report_add(struct report *r, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	int n = vsnprintf(r->buf + r->n, sizeof(r->buf) - r->n, fmt, ap);
+	va_end(ap);
+	if (n > 0)
+		r->n += (size_t)n;
+	if (r->n >= sizeof(r->buf))
+		r->n = sizeof(r->buf) - 1;
+}
+
+void
+report_string(struct report *r, const char *s)
+{
+	report_add(r, "\"");
+	for (; *s; s++) {
+		unsigned char c = (unsigned char)*s;
+		if (c == '"' || c == '\\')
+			report_add(r, "\\%c", c);
+		else if (c < 0x20)
+			report_add(r, "\\u%04x", c);
+		else
+			report_add(r, "%c", c);
+	}
+	report_add(r, "\"");
+}
+
+/* Checks one file, or with data an archive member already in memory,
+ * writing its report to r. Returns 0 for a rejected file, 1 for a flagged
+ * one and 2 for a clean one. */
+int
+lint_one(struct lint *l, const char *file, const unsigned char *data,
+	size_t size, struct report *r, bool *decoded, bool *fixed)
+{
+	r->n = 0;
+	report_add(r, "{ \"file\": ");
+	report_string(r, file);
+
+	struct lint_png png;
+	const char *error = data ? lint_header(data, size, &png)
+		: lint_peek(file, &png);
+	report_add(r, ", \"width\": %u, \"height\": %u", png.width, png.height);
+
+	Image img = { 0 };
+	if (!error) {
+		img = data ? skin_decode(data, (int)size) : skin_load(file);
+		*decoded = true;
+		if (!img.data)
+			error = "could not decode";
+	}
+	if (error) {
+		report_add(r, ", \"ok\": false, \"error\": \"%s\" }\n", error);
+		return 0;
+	}
+
+	ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	const bool slim = skin_is_slim(&img);
+	struct lint_regions g = lint_regions(&img, slim, l->fixdir != NULL);
+	const bool clean = !g.transparent_base && !g.opaque_unused;
+	report_add(r, ", \"kind\": \"%s\", \"slim\": %s, "
+		"\"transparent_base\": %zu, \"opaque_unused\": %zu, \"ok\": %s",
+		skin_kind_names[skin_kind_of(img.width, img.height)],
+		slim ? "true" : "false", g.transparent_base, g.opaque_unused,
+		clean ? "true" : "false");
+
+	if (!clean && l->fixdir) {
+		/* "dir/name.png" becomes "fixdir/dir/name.png" */
+		char path[4096];
+		*fixed = out_path(path, sizeof(path), l->fixdir, file, NULL)
+			&& ExportImage(img, path);
+		report_add(r, ", \"fixed\": ");
+		if (*fixed)
+			report_string(r, path);
+		else
+			report_add(r, "null");
+	}
+	UnloadImage(img);
+	report_add(r, " }\n");
+	return clean ? 2 : 1;
+}
+
+void
+lint_tally(struct lint *l, const struct report *r, int result, bool decoded,
+	bool fixed)
+{
+	pthread_mutex_lock(&l->lock);
+	fputs(r->buf, stdout);
+	l->rejected += result == 0;
+	l->flagged += result == 1;
+	l->ok += result == 2;
+	l->decoded += decoded;
+	l->fixed += fixed;
+	pthread_mutex_unlock(&l->lock);
+}
+
+void *
+lint_worker(void *arg)
+{
+	struct lint *l = arg;
+	struct report r;
+
+	while (!l->archive_path) {
+		pthread_mutex_lock(&l->lock);
+		size_t i = l->next++;
+		pthread_mutex_unlock(&l->lock);
+		if (i >= l->count)
+			break;
+
+		bool decoded = false, fixed = false;
+		int result = lint_one(l, l->files[i], NULL, 0, &r, &decoded,
+			&fixed);
+		lint_tally(l, &r, result, decoded, fixed);
+	}
+
+	struct archive_member m;
+	while (l->archive_path && archive_next(&l->archive, &m)) {
+		bool decoded = false, fixed = false;
+		int result = 0;
+		if (m.error) {
+			r.n = 0;
+			report_add(&r, "{ \"file\": ");
+			report_string(&r, m.name);
+			report_add(&r, ", \"ok\": false, \"error\": \"%s\" }\n",
+				m.error);
+		} else {
+			result = lint_one(l, m.name, m.data, m.size, &r, &decoded,
+				&fixed);
+		}
+		archive_release(&l->archive, &m);
+		lint_tally(l, &r, result, decoded, fixed);
+	}
+	return NULL;
+}
+
+bool
+add_file(char ***files, size_t *count, size_t *cap, char *file)
+{
+	if (!file)
+		return 0;
+	if (*count == *cap) {
+		*cap = *cap ? *cap * 2 : 256;
+		char **grown = realloc(*files, sizeof(**files) * *cap);
+		if (!grown) {
+			free(file);
+			return 0;
+		}
+		*files = grown;
+	}
+	(*files)[(*count)++] = file;
+	return 1;
+}
+
+/* Every .png and .qoi directly in dir, whatever it holds; the header
+ * check is what sorts them out */
+bool
+add_dir(const char *dir, char ***files, size_t *count, size_t *cap)
+{
+	DIR *d = opendir(dir);
+	if (!d) {
+		perror(dir);
+		return 0;
+	}
+	bool ok = true;
+	struct dirent *ent;
+	while (ok && (ent = readdir(d))) {
+		size_t len = strlen(ent->d_name);
+		if (ent->d_name[0] == '.' || !skin_file_name(ent->d_name))
+			continue;
+		char *path = malloc(strlen(dir) + len + 2);
+		if (path)
+			sprintf(path, "%s/%s", dir, ent->d_name);
+		ok = add_file(files, count, cap, path);
+	}
+	closedir(d);
+	return ok;
+}
+
+/* One path per line */
+bool
+read_list(FILE *f, char ***files, size_t *count, size_t *cap)
+{
+	char line[4096];
+	while (fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (line[0] && !add_file(files, count, cap, strdup(line)))
+			return 0;
+	}
+	return 1;
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-lint [-j threads] [-f fixdir]"
+		" skin.png|dir... | - | -a archive\n"
+		"\t-f\twrite fixed copies of flagged skins to fixdir\n"
+		"\t-\tread skin paths from stdin, one per line\n"
+		"\t-a\tthe skins in a tar or zip archive, - for a tar on stdin\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct lint l = { 0 };
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t cap = 0;
+	bool from_stdin = false;
+
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+		bool ok = true;
+		if (!strcmp(argv[i], "-j") && more)
+			threads = atol(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && more)
+			l.fixdir = argv[++i];
+		else if (!strcmp(argv[i], "-a") && more)
+			l.archive_path = argv[++i];
+		else if (!strcmp(argv[i], "-"))
+			from_stdin = true;
+		else if (argv[i][0] != '-' && DirectoryExists(argv[i]))
+			ok = add_dir(argv[i], &l.files, &l.count, &cap);
+		else if (argv[i][0] != '-')
+			ok = add_file(&l.files, &l.count, &cap, strdup(argv[i]));
+		else {
+			usage();
+			return EXIT_FAILURE;
+		}
+		if (!ok)
+			return EXIT_FAILURE;
+	}
+	if (from_stdin && !read_list(stdin, &l.files, &l.count, &cap)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+	if (!l.count == !l.archive_path) {
+		usage();
+		return EXIT_FAILURE;
+	}
+	if (threads < 1)
+		threads = 1;
+	if (!l.archive_path && (size_t)threads > l.count)
+		threads = (long)l.count;
+
+	SetTraceLogLevel(LOG_WARNING);
+	pthread_mutex_init(&l.lock, NULL);
+
+	long long start = now_ns();
+	if (l.archive_path && !archive_open(&l.archive, l.archive_path,
+			".png;.qoi")) {
+		fprintf(stderr, "%s: %s\n", l.archive_path, l.archive.error);
+		return EXIT_FAILURE;
+	}
+	pthread_t *t = calloc((size_t)threads, sizeof(*t));
+	long started = 0;
+	for (; t && started < threads; started++) {
+		if (pthread_create(&t[started], NULL, lint_worker, &l))
+			break;
+	}
+	if (!started) {
+		perror("pthread_create");
+		return EXIT_FAILURE;
+	}
+	for (long i = 0; i < started; i++)
+		pthread_join(t[i], NULL);
+	size_t files = l.count;
+	bool ok = true;
+	if (l.archive_path) {
+		archive_close(&l.archive);
+		files = l.archive.members;
+		if (l.archive.error) {
+			fprintf(stderr, "%s: %s\n", l.archive_path, l.archive.error);
+			ok = false;
+		}
+	}
+	double secs = (double)(now_ns() - start) / 1e9;
+
+	fprintf(stderr, "{ \"files\": %zu, \"ok\": %zu, \"flagged\": %zu, "
+		"\"rejected\": %zu, \"decoded\": %zu, \"fixed\": %zu, "
+		"\"threads\": %ld, \"seconds\": %.3f, \"files_per_s\": %.0f }\n",
+		files, l.ok, l.flagged, l.rejected, l.decoded, l.fixed, started,
+		secs, (double)files / secs);
+
+	for (size_t i = 0; i < l.count; i++)
+		free(l.files[i]);
+	free(l.files);
+	free(t);
+	return ok && l.ok == files ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,214 @@
+#ifndef LINT_H
+#define LINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "raylib.h"
+#include "skin.h"
+
+/* Checks on skin files, cheapest first. lint_header() looks at the first
+ * LINT_PEEK bytes only: the PNG signature and the IHDR chunk (or the QOI
+ * header) say whether the file is an image we read and what size it
+ * decodes to, so anything that could never be a skin is turned away
+ * before it is read whole or decoded.
+ * lint_regions() then checks the decoded pixels against the box layout:
+ * base layer texels should be opaque and texels no face uses should be
+ * transparent. */
+
+#define LINT_PEEK 33 /* signature, IHDR length, type, data and CRC */
+#define LINT_MAX_EDGE 4096
+
+struct lint_png {
+	uint32_t width, height;
+	uint8_t depth, color, interlace;
+};
+
+static uint32_t
+lint_be32(const unsigned char *p)
+{
+	return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16
+		| (uint32_t)p[2] << 8 | p[3];
+}
+
+static uint32_t
+lint_crc32(const unsigned char *p, size_t len)
+{
+	uint32_t crc = 0xffffffffu;
+	for (size_t i = 0; i < len; i++) {
+		crc ^= p[i];
+		for (int k = 0; k < 8; k++)
+			crc = crc >> 1 ^ (0xedb88320u & (0u - (crc & 1)));
+	}
+	return ~crc;
+}
+
+static const char *
+lint_size(const struct lint_png *png)
+{
+	if (png->width > LINT_MAX_EDGE || png->height > LINT_MAX_EDGE)
+		return "too large";
+	if (skin_kind_of((int)png->width, (int)png->height) == SKIN_INVALID)
+		return "not a skin size";
+	return NULL;
+}
+
+/* The header of a QOI file, described as the PNG it could have been */
+static const char *
+lint_qoi(const unsigned char *data, size_t size, struct lint_png *png)
+{
+	if (size < QOI_HEADER)
+		return "truncated";
+	png->width = lint_be32(data + 4);
+	png->height = lint_be32(data + 8);
+	png->depth = 8;
+	png->color = data[12] == 4 ? 6 : 2;
+	if ((data[12] != 3 && data[12] != 4) || data[13] > 1)
+		return "bad QOI header";
+	return NULL;
+}
+
+/* NULL if data starts like a PNG or QOI file a skin can be decoded from,
+ * otherwise why not. Fills in png either way as far as it got. */
+const char *
+lint_header(const unsigned char *data, size_t size, struct lint_png *png)
+{
+	static const unsigned char sig[8] = {
+		0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n',
+	};
+	*png = (struct lint_png){ 0 };
+	if (qoi_is(data, size)) {
+		const char *error = lint_qoi(data, size, png);
+		return error ? error : lint_size(png);
+	}
+	if (size < sizeof(sig) || memcmp(data, sig, sizeof(sig)))
+		return "not a PNG";
+	if (size < LINT_PEEK)
+		return "truncated";
+	if (lint_be32(data + 8) != 13 || memcmp(data + 12, "IHDR", 4))
+		return "no IHDR";
+	if (lint_crc32(data + 12, 17) != lint_be32(data + 29))
+		return "bad IHDR checksum";
+
+	const unsigned char *h = data + 16;
+	png->width = lint_be32(h);
+	png->height = lint_be32(h + 4);
+	png->depth = h[8];
+	png->color = h[9];
+	png->interlace = h[12];
+
+	/* Allowed bit depths for each colour type, as a bit mask */
+	static const unsigned char depths[7] = {
+		[0] = 1 | 2 | 4 | 8 | 16, /* grey */
+		[2] = 8 | 16,             /* RGB */
+		[3] = 1 | 2 | 4 | 8,      /* palette */
+		[4] = 8 | 16,             /* grey and alpha */
+		[6] = 8 | 16,             /* RGBA */
+	};
+	const unsigned d = png->depth;
+	if (png->color > 6 || !d || d > 16 || (d & (d - 1))
+			|| !(depths[png->color] & d) || h[10] || h[11]
+			|| png->interlace > 1)
+		return "bad IHDR";
+	return lint_size(png);
+}
+
+/* lint_header() on the start of a file */
+const char *
+lint_peek(const char *path, struct lint_png *png)
+{
+	unsigned char buf[LINT_PEEK];
+	FILE *f = fopen(path, "rb");
+	*png = (struct lint_png){ 0 };
+	if (!f)
+		return "could not open";
+	size_t n = fread(buf, 1, sizeof(buf), f);
+	fclose(f);
+	return lint_header(buf, n, png);
+}
+
+enum lint_class {
+	LINT_UNUSED = 0,
+	LINT_BASE,
+	LINT_OVERLAY,
+};
+
+static void
+lint_fill(unsigned char *mask, int x, int y, int w, int h, unsigned char c)
+{
+	for (int j = y; j < y + h; j++)
+		memset(mask + j * 64 + x, c, (size_t)w);
+}
+
+/* enum lint_class of each texel of a 64x64 skin. Legacy skins only have
+ * the parts in the top half. */
+void
+lint_layout(unsigned char mask[64 * 64], enum skin_kind kind, bool slim)
+{
+	memset(mask, LINT_UNUSED, 64 * 64);
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		const struct skin_box *b = &skin_boxes[i];
+		if (kind == SKIN_LEGACY && b->v >= 32)
+			continue;
+		const int u = b->u, v = b->v, h = b->h, d = b->d;
+		const int w = skin_box_width(i, slim);
+		const unsigned char c = i >= MODEL_LAYER_HEAD
+			? LINT_OVERLAY : LINT_BASE;
+		lint_fill(mask, u + d, v, w, d, c);         /* top */
+		lint_fill(mask, u + d + w, v, w, d, c);     /* bottom */
+		lint_fill(mask, u, v + d, 2 * (d + w), h, c); /* sides */
+	}
+}
+
+struct lint_regions {
+	size_t transparent_base; /* pixels, not texels, on HD skins */
+	size_t opaque_unused;
+};
+
+/* Counts the pixels of an RGBA8 skin that break the region rules, and with
+ * fix makes base pixels opaque and unused ones transparent. Does one
+ * branchless pass over the pixels. */
+struct lint_regions
+lint_regions(Image *img, bool slim, bool fix)
+{
+	struct lint_regions r = { 0 };
+	const enum skin_kind kind = skin_kind_of(img->width, img->height);
+	if (kind == SKIN_INVALID || img->width > LINT_MAX_EDGE
+			|| img->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+		return r;
+
+	unsigned char mask[64 * 64], cls[LINT_MAX_EDGE];
+	lint_layout(mask, kind, slim);
+	const int u = img->width / 64;
+	unsigned char *px = img->data;
+	for (int y = 0; y < img->height; y++) {
+		if (y % u == 0) {
+			for (int x = 0; x < img->width; x++)
+				cls[x] = mask[y / u * 64 + x / u];
+		}
+		unsigned char *row = px + (size_t)y * (size_t)img->width * 4;
+		size_t base = 0, unused = 0;
+		for (int x = 0; x < img->width; x++) {
+			const unsigned a = row[x * 4 + 3];
+			base += (cls[x] == LINT_BASE) & (a != 255);
+			unused += (cls[x] == LINT_UNUSED) & (a != 0);
+		}
+		r.transparent_base += base;
+		r.opaque_unused += unused;
+
+		if (fix && (base || unused)) {
+			for (int x = 0; x < img->width; x++) {
+				unsigned char *p = row + x * 4;
+				if (cls[x] == LINT_BASE)
+					p[3] = 255;
+				else if (cls[x] == LINT_UNUSED)
+					memset(p, 0, 4);
+			}
+		}
+	}
+	return r;
+}
+
+#endif /* LINT_H */
@@ -1,6 +1,8 @@
 #include <assert.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <limits.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -8,11 +10,22 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <time.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 #include "raylib.h"
 #include "raymath.h"
 #include "rcamera.h"
 #include "rlgl.h"
-#include "bundle.h"
+#include "skin.h"
+#include "gallery.h"
+#include "lint.h"
+#include "residency.h"
+#include "playlist.h"
+#include "anim.h"
+#include "voxel.h"
+#include "cull.h"
+#include "dynres.h"
 
 #if defined(_WIN32) && !defined(PATH_MAX)
 #define PATH_MAX 255
@@ -20,184 +33,174 @@
 
 #define VERSION "0.6.0"
 
-enum model {
-	MODEL_HEAD = 0,
-	MODEL_BODY,
-	MODEL_LARM,
-	MODEL_LLEG,
-	MODEL_RARM,
-	MODEL_RLEG,
-	MODEL_LAYER_HEAD,
-	MODEL_LAYER_BODY,
-	MODEL_LAYER_LARM,
-	MODEL_LAYER_LLEG,
-	MODEL_LAYER_RARM,
-	MODEL_LAYER_RLEG,
-	MODEL_COUNT
+/* Startup phases timed by -b, in the order main() reaches them */
+enum phase {
+	PHASE_MAIN = 0,
+	PHASE_WINDOW,
+	PHASE_BUNDLE,
+	PHASE_DECODE,
+	PHASE_UPLOAD,
+	PHASE_MODELS,
+	PHASE_FRAME,
+	PHASE_RENDER,
+	PHASE_COUNT
 };
 
-struct button {
-	Rectangle rec;
-	bool active;
-};
+/* Offscreen renders made by -b to catch output changes */
+#define POSE_SIZE 256
+#define POSE_COUNT CAMERA_PRESET_COUNT
 
-char *models_paths[] = {
-	[MODEL_HEAD]       = "resources/models/obj/alex/skin/head.obj",
-	[MODEL_BODY]       = "resources/models/obj/alex/skin/body.obj",
-	[MODEL_LARM]       = "resources/models/obj/alex/skin/left_arm.obj",
-	[MODEL_LLEG]       = "resources/models/obj/alex/skin/left_leg.obj",
-	[MODEL_RARM]       = "resources/models/obj/alex/skin/right_arm.obj",
-	[MODEL_RLEG]       = "resources/models/obj/alex/skin/right_leg.obj",
-	[MODEL_LAYER_HEAD] = "resources/models/obj/alex/layer/head.obj",
-	[MODEL_LAYER_BODY] = "resources/models/obj/alex/layer/body.obj",
-	[MODEL_LAYER_LARM] = "resources/models/obj/alex/layer/left_arm.obj",
-	[MODEL_LAYER_LLEG] = "resources/models/obj/alex/layer/left_leg.obj",
-	[MODEL_LAYER_RARM] = "resources/models/obj/alex/layer/right_arm.obj",
-	[MODEL_LAYER_RLEG] = "resources/models/obj/alex/layer/right_leg.obj",
-};
-static_assert(MODEL_COUNT == sizeof(models_paths)/sizeof(*models_paths),
-	"Model count is wrong");
+volatile sig_atomic_t quit = 0;
+long long phase_ns[PHASE_COUNT];
+uint64_t pose_hash[POSE_COUNT];
 
-char *
-lft(const char *fileName)
+long long
+now_ns(void)
 {
-	for (size_t i = 0; i < resources_count; i += 1) {
-		if (strcmp(fileName, resources[i].fileName) != 0)
-			continue;
-
-		char *res = ((char *)&bundle) + resources[i].offset;
-		size_t size = resources[i].size;
-
-		char *buf = calloc(size + 1, sizeof(*buf));
-		memcpy(buf, res, size);
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
-		return buf;
-	}
-	fprintf(stderr, "REACHED WHERE SHOULD NOT HAVE\n");
-	exit(1);
+/* Append one line of absolute phase timestamps followed by the pose hashes,
+ * read back by ./build bench */
+bool
+phases_save(const char *fp)
+{
+	FILE *f = fopen(fp, "a");
+	if (!f) return 0;
+
+	for (size_t i = 0; i < PHASE_COUNT; i++)
+		fprintf(f, "%s%lld", i ? " " : "", phase_ns[i]);
+	/* How many first, so ./build bench needs no copy of POSE_COUNT */
+	fprintf(f, " %zu", (size_t)POSE_COUNT);
+	for (size_t i = 0; i < POSE_COUNT; i++)
+		fprintf(f, " %016" PRIx64, pose_hash[i]);
+	fprintf(f, "\n");
+	return fclose(f) == 0;
 }
 
-const unsigned char *
-get_bundle(char *f)
+void
+render_poses(const Model *models)
 {
-	for (size_t i = 0; i < resources_count; i += 1) {
-		char *b = &((char *)bundle)[resources[i].offset];
-		if (strcmp(f, resources[i].fileName) == 0)
-			return (unsigned char *)b;
+	RenderTexture2D rt = LoadRenderTexture(POSE_SIZE, POSE_SIZE);
+
+	for (size_t p = 0; p < POSE_COUNT; p++) {
+		render_models(rt, models, camera_preset(p), 0);
+		Image img = LoadImageFromTexture(rt.texture);
+		pose_hash[p] = fnv1a(img.data, (size_t)GetPixelDataSize(
+			img.width, img.height, img.format));
+		UnloadImage(img);
 	}
-	return NULL;
+	UnloadRenderTexture(rt);
 }
 
-size_t
-get_bundle_size(char *f)
+void
+on_terminate(int sig)
 {
-	for (size_t i = 0; i < resources_count; i += 1) {
-		if (strcmp(f, resources[i].fileName) == 0)
-			return resources[i].size;
-	}
-	return 0;
+	(void)sig;
+	quit = 1;
 }
 
+/* State file lets a relaunched viewer pick up where the last one left off */
 bool
-update_model_with_png(char const *const fp, Model *m, Texture2D *t)
+state_load(const char *fp, char *skinfile, Camera *camera)
 {
-	if (!IsFileExtension(fp, ".png"))
-		return 0;
-
-	UnloadTexture(*t);
-	*t = LoadTexture(fp);
-	for (size_t i = 0; i < MODEL_COUNT; i++) {
-		m[i].materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = *t;
-	}
+	FILE *f = fopen(fp, "r");
+	if (!f) return 0;
+
+	char line[PATH_MAX + 8] = {0};
+	Camera c = *camera;
+	bool ok = fgets(line, sizeof(line), f) && !strncmp(line, "skin ", 5);
+	ok = ok && fscanf(f, "camera %f %f %f %f %f %f %f %f %f",
+		&c.position.x, &c.position.y, &c.position.z,
+		&c.target.x, &c.target.y, &c.target.z,
+		&c.up.x, &c.up.y, &c.up.z) == 9;
+	fclose(f);
+	if (!ok) return 0;
+
+	char *path = &line[5];
+	path[strcspn(path, "\n")] = '\0';
+	if (strlen(path) >= PATH_MAX) return 0;
+
+	struct stat st;
+	if (get_bundle(path) || stat(path, &st) == 0)
+		strcpy(skinfile, path);
+	*camera = c;
 	return 1;
 }
 
 bool
-update_skin(char *dst, Model *models, Texture2D *texture)
+state_save(const char *fp, const char *skinfile, const Camera *c)
 {
-	FilePathList files = LoadDroppedFiles();
-	if (!update_model_with_png(files.paths[0], models, texture))
-		return 0;
-	dst = strncpy(dst, files.paths[0], PATH_MAX);
-	UnloadDroppedFiles(files);
-	return 1;
+	FILE *f = fopen(fp, "w");
+	if (!f) return 0;
+
+	fprintf(f, "skin %s\n", skinfile);
+	fprintf(f, "camera %f %f %f %f %f %f %f %f %f\n",
+		c->position.x, c->position.y, c->position.z,
+		c->target.x, c->target.y, c->target.z,
+		c->up.x, c->up.y, c->up.z);
+	return fclose(f) == 0;
 }
 
+/* Lets whoever started us with -r fd (./build watch) know the first frame
+ * is on screen */
 void
-buttons_update(struct button *button)
+notify_ready(int fd)
 {
-	const int w = GetScreenWidth();
-	const int h = GetScreenHeight();
-	const float min = (float)(w < h ? w : h);
-	const float UI_PIXEL = min * 0.01f;
-
-	button[MODEL_HEAD].rec = (Rectangle){
-		UI_PIXEL * 4, 0,
-		UI_PIXEL * 8, UI_PIXEL * 8,
-	};
-
-	button[MODEL_BODY].rec = (Rectangle){
-		UI_PIXEL * 4, UI_PIXEL * 8,
-		UI_PIXEL * 8, UI_PIXEL * 12,
-	};
-
-	button[MODEL_RARM].rec = (Rectangle){
-		0, UI_PIXEL * 8,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	button[MODEL_LARM].rec = (Rectangle){
-		UI_PIXEL * 12, UI_PIXEL * 8,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	button[MODEL_RLEG].rec = (Rectangle){
-		UI_PIXEL * 4, UI_PIXEL * 20,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	button[MODEL_LLEG].rec = (Rectangle){
-		UI_PIXEL * 8, UI_PIXEL * 20,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	const float pad = UI_PIXEL * (16 + 1);
-
-	button[MODEL_LAYER_HEAD].rec = (Rectangle){
-		pad + UI_PIXEL * 4, 0,
-		UI_PIXEL * 8, UI_PIXEL * 8,
-	};
-
-	button[MODEL_LAYER_BODY].rec = (Rectangle){
-		pad + UI_PIXEL * 4, UI_PIXEL * 8,
-		UI_PIXEL * 8, UI_PIXEL * 12,
-	};
-
-	/* position of arms/legs are swapped */
-	button[MODEL_LAYER_RARM].rec = (Rectangle){
-		pad, UI_PIXEL * 8,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	button[MODEL_LAYER_LARM].rec = (Rectangle){
-		pad + UI_PIXEL * 12, UI_PIXEL * 8,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	button[MODEL_LAYER_RLEG].rec = (Rectangle){
-		pad + UI_PIXEL * 4, UI_PIXEL * 20,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
-
-	button[MODEL_LAYER_LLEG].rec = (Rectangle){
-		pad + UI_PIXEL * 8, UI_PIXEL * 20,
-		UI_PIXEL * 4, UI_PIXEL * 12,
-	};
+#if !defined(_WIN32)
+	if (write(fd, "\n", 1) < 0)
+		perror("notify");
+	close(fd);
+#else
+	(void)fd;
+#endif
+}
 
-	for (size_t i = 0; i < MODEL_COUNT; i++) {
-		button[i].rec.x += UI_PIXEL;
-		button[i].rec.y += (float)h - UI_PIXEL * 33;
+/* Opens a dropped PNG or QOI file, returning its entry. Files whose header says they
+ * are not a skin are turned away without being read. */
+struct resident *
+update_skin(char *dst, struct residency *res, const char *path)
+{
+	struct resident *e = NULL;
+	struct lint_png png;
+	const char *error = strlen(path) < PATH_MAX
+		? lint_peek(path, &png) : "path too long";
+	if (error)
+		TraceLog(LOG_WARNING, "%s: %s", path, error);
+	else
+		e = residency_open(res, path);
+
+	/* Seen before, but edited since */
+	if (e && e->source_owned && GetFileModTime(e->path) != e->mtime)
+		residency_refresh(res, e);
+
+	if (e && residency_image(res, e)->data)
+		strcpy(dst, path);
+	else
+		e = NULL;
+	return e;
+}
+
+/* skin_is_slim() on a resident skin, reading only the texels it needs */
+bool
+packed_is_slim(const struct palette_image *p)
+{
+	if (!p->data || skin_kind_of(p->width, p->height) < SKIN_MODERN)
+		return 0;
+
+	const int u = p->width / 64;
+	for (size_t i = 0; i < SKIN_SLIM_UNUSED; i++) {
+		const Rectangle r = skin_slim_unused[i];
+		for (int y = (int)r.y * u; y < (int)(r.y + r.height) * u; y++) {
+			for (int x = (int)r.x * u; x < (int)(r.x + r.width) * u; x++) {
+				if (palette_pixel(p, x, y) >> 24)
+					return 0;
+			}
+		}
 	}
+	return 1;
 }
 
 #ifdef _MSC_VER
@@ -206,6 +209,8 @@ buttons_update(struct button *button)
 int
 main(int argc, char **argv)
 {
+	phase_ns[PHASE_MAIN] = now_ns();
+
 	Camera camera = { 0 };
 	camera.position = (Vector3){ -1.0f, 2.0f, -1.0f };
 	camera.target = (Vector3){ 0.0f, 1.0f, 0.0f };
@@ -214,45 +219,165 @@ main(int argc, char **argv)
 	camera.projection = CAMERA_PERSPECTIVE;
 
 	char skinfile[PATH_MAX + 1];
-	strcpy(skinfile, "resources/models/obj/osage-chan-lagtrain.png");
+	/* The bundler stores a QOI copy of the default skin, the quickest to
+	 * decode at startup */
+	strcpy(skinfile, "resources/models/obj/osage-chan-lagtrain.qoi");
 	long old_time = GetFileModTime(skinfile);
 	int queue_update = 0;
 
+	const char *statefile = NULL;
+	const char *benchfile = NULL;
+	int ready_fd = -1;
+	const char *gallerydir = NULL;
+	const char *skinarg = NULL;
+	const char *playlistdir = NULL;
+	size_t cpu_mb = RESIDENCY_CPU_MB, gpu_mb = RESIDENCY_GPU_MB;
+	bool report = false;
+	enum anim anim = ANIM_NONE;
+	bool voxels = false;
+	float budget_ms = 1000.0f / 60;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-s") && i + 1 < argc)
+			statefile = argv[++i];
+		else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+			benchfile = argv[++i];
+		else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+			ready_fd = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-g") && i + 1 < argc)
+			gallerydir = argv[++i];
+		else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+			if (sscanf(argv[++i], "%zu:%zu", &cpu_mb, &gpu_mb) != 2) {
+				fprintf(stderr, "Expected -m cpu_mb:gpu_mb\n");
+				return EXIT_FAILURE;
+			}
+			report = true;
+		}
+		else if (!strcmp(argv[i], "-v"))
+			voxels = true;
+		else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+			if (sscanf(argv[++i], "%f", &budget_ms) != 1
+					|| !(budget_ms >= 0)) {
+				fprintf(stderr, "Expected -f frame_ms\n");
+				return EXIT_FAILURE;
+			}
+		}
+		else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+			if (!anim_parse(argv[++i], &anim)) {
+				fprintf(stderr, "Expected -p none|idle|walk|wave\n");
+				return EXIT_FAILURE;
+			}
+		}
+		else
+			skinarg = argv[i];
+	}
+
+	if (statefile)
+		state_load(statefile, skinfile, &camera);
+
 	struct stat statbuf;
-	if (argc > 1) {
-		if (stat(argv[1], &statbuf) < 0) {
+	if (skinarg && stat(skinarg, &statbuf) == 0 && S_ISDIR(statbuf.st_mode)) {
+		playlistdir = skinarg;
+		skinarg = NULL;
+	}
+	if (skinarg) {
+		if (stat(skinarg, &statbuf) < 0) {
 			if (errno == ENOENT)
 				fprintf(stderr, "File does not exist!\n");
 			else
-				fprintf(stderr, "Could not check file %s: %s!\n", argv[1], strerror(errno));
+				fprintf(stderr, "Could not check file %s: %s!\n", skinarg, strerror(errno));
 
 			return EXIT_FAILURE;
 		}
 
-		size_t len = strnlen(argv[1], PATH_MAX);
+		size_t len = strnlen(skinarg, PATH_MAX);
 		if (len >= PATH_MAX) {
 			fprintf(stderr, "Filename too long!\n");
 			return EXIT_FAILURE;
 		}
 
-		strcpy(skinfile, argv[1]);
+		strcpy(skinfile, skinarg);
 		skinfile[len] = '\0';
 	}
+	old_time = GetFileModTime(skinfile);
+
+	signal(SIGTERM, on_terminate);
+	signal(SIGINT, on_terminate);
 
 	SetTraceLogLevel(LOG_WARNING);
-	SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+	SetConfigFlags(FLAG_WINDOW_RESIZABLE
+		| (benchfile ? FLAG_WINDOW_HIDDEN : 0));
 	InitWindow(400, 600, "SkinView " VERSION);
+	phase_ns[PHASE_WINDOW] = now_ns();
 
-	Image image = LoadImageFromMemory(".png", get_bundle(skinfile),
-			(int)get_bundle_size(skinfile));
-	Texture2D texture = LoadTextureFromImage(image);
-	SetLoadFileTextCallback(lft);
-	Model models[MODEL_COUNT] = {0};
-	for (size_t i = 0; i < MODEL_COUNT; i++) {
-		models[i] = LoadModel(models_paths[i]);
-		models[i].materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+	if (gallerydir) {
+		SetTargetFPS(60);
+		int result = gallery_run(gallerydir);
+		CloseWindow();
+		return result;
 	}
-	SetLoadFileTextCallback(NULL);
+
+	struct residency res;
+	residency_init(&res, cpu_mb << 20, gpu_mb << 20);
+	struct resident *current = residency_open(&res, skinfile);
+	if (!current) {
+		fprintf(stderr, "Could not read %s!\n", skinfile);
+		CloseWindow();
+		return EXIT_FAILURE;
+	}
+	current->pinned = true;
+	phase_ns[PHASE_BUNDLE] = now_ns();
+
+	residency_image(&res, current);
+	phase_ns[PHASE_DECODE] = now_ns();
+
+	Texture2D texture = residency_texture(&res, current);
+	phase_ns[PHASE_UPLOAD] = now_ns();
+
+	/* Classic and slim arms are both kept, with their own pivots and
+	 * overlay culling, so a skin of the other kind only swaps them */
+	Model shapes[2][MODEL_COUNT] = {0};
+	struct anim_rig rigs[2];
+	struct cull_layer culls[2];
+	for (size_t s = 0; s < 2; s++) {
+		if (!load_models(shapes[s], s, texture)
+				|| !cull_init(&culls[s], shapes[s])) {
+			fprintf(stderr, "Out of memory!\n");
+			CloseWindow();
+			return EXIT_FAILURE;
+		}
+		BoundingBox parts[ANIM_JOINTS];
+		for (size_t i = 0; i < ANIM_JOINTS; i++)
+			parts[i] = GetMeshBoundingBox(shapes[s][i].meshes[0]);
+		anim_rig_init(&rigs[s], parts);
+	}
+	bool slim = packed_is_slim(residency_image(&res, current));
+	Model *models = shapes[slim];
+	phase_ns[PHASE_MODELS] = now_ns();
+
+	/* A crowd of one */
+	struct anim_batch poser = { 0 };
+	if (!anim_batch_resize(&poser, 1)) {
+		fprintf(stderr, "Out of memory!\n");
+		CloseWindow();
+		return EXIT_FAILURE;
+	}
+	struct resident *shown = NULL;
+	unsigned shown_version = 0;
+
+	bool show_stats = false;
+
+	struct playlist *playlist = NULL;
+	size_t play_index = 0;
+	bool play_pending = false;
+	if (playlistdir) {
+		char *dirs[] = { (char *)playlistdir };
+		playlist = playlist_new(dirs, 1);
+		play_pending = playlist != NULL;
+	}
+
+	struct voxel_layer voxel = { 0 };
+	struct resident *voxel_of = NULL;
+	unsigned voxel_version = 0;
 
 	Vector3 position = { 0.0f, 0.0f, 0.0f };
 
@@ -260,24 +385,110 @@ main(int argc, char **argv)
 
 	struct button button[MODEL_COUNT] = {0};
 
-	SetTargetFPS(60);
+	/* Frames are paced to the budget, or 60 a second without one */
+	struct dynres dynres;
+	dynres_init(&dynres, budget_ms / 1000);
+	long long frame_cpu = 0;
+
+	/* Frame pacing would add up to a frame of sleep to the first frame */
+	if (!benchfile)
+		SetTargetFPS(budget_ms > 0 ? (int)(1000 / budget_ms + 0.5f) : 60);
 
 	/* Main loop */
-	while (!WindowShouldClose()) {
+	while (!WindowShouldClose() && !quit) {
+	const long long frame_start = now_ns();
+	dynres_update(&dynres, GetFrameTime(), (float)frame_cpu / 1e9f);
 
 	/* Update */
-	buttons_update(button);
+	buttons_update(button, GetScreenWidth(), GetScreenHeight());
 
 	if (IsFileDropped()) {
-		update_skin(skinfile, models, &texture);
+		FilePathList files = LoadDroppedFiles();
+		if (files.count > 1 || DirectoryExists(files.paths[0])) {
+			playlist_free(playlist);
+			playlist = playlist_new(files.paths, files.count);
+			play_index = 0;
+			play_pending = playlist != NULL;
+		} else if (files.count) {
+			struct resident *e = update_skin(skinfile, &res, files.paths[0]);
+			if (e) {
+				current->pinned = false;
+				current = e;
+				current->pinned = true;
+			}
+		}
+		UnloadDroppedFiles(files);
 		old_time = GetFileModTime(skinfile);
 	}
 
+	if (playlist) {
+		size_t count = playlist_poll(playlist, &res);
+		if ((IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_PAGE_DOWN))
+				&& play_index + 1 < count) {
+			play_index++;
+			play_pending = true;
+		}
+		if ((IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_PAGE_UP))
+				&& play_index > 0) {
+			play_index--;
+			play_pending = true;
+		}
+
+		/* Prefetched entries are resident already, others load here */
+		if (play_pending && play_index < count) {
+			const char *path = playlist_path(playlist, play_index);
+			struct resident *e = strlen(path) < PATH_MAX
+				? residency_open(&res, path) : NULL;
+			playlist_seek(playlist, play_index, &res);
+			if (e && residency_image(&res, e)->data) {
+				current = e;
+				strcpy(skinfile, path);
+			}
+			current->pinned = true;
+			SetWindowTitle(TextFormat("SkinView " VERSION " - %s (%zu/%zu)",
+				GetFileName(path), play_index + 1, count));
+			play_pending = false;
+			old_time = GetFileModTime(skinfile);
+		}
+	}
+
 	if (queue_update) {
-		update_model_with_png(skinfile, models, &texture);
+		residency_refresh(&res, current);
 		old_time = GetFileModTime(skinfile);
 		queue_update = 0;
 	}
+
+	/* Uploaded again after a change */
+	texture = residency_texture(&res, current);
+	if (shown != current || shown_version != current->version) {
+		const struct palette_image *img = residency_image(&res, current);
+		slim = packed_is_slim(img);
+		models = shapes[slim];
+		cull_update(&culls[slim], img);
+		shown = current;
+		shown_version = current->version;
+	}
+	set_models_texture(models, texture);
+	residency_trim(&res);
+
+	/* The voxels follow the skin through reloads and playlist steps */
+	if (IsKeyPressed(KEY_V))
+		voxels = !voxels;
+	if (voxels && (voxel_of != current
+			|| voxel_version != current->version)) {
+		voxel_layer_update(&voxel, residency_image(&res, current), slim);
+		voxel_of = current;
+		voxel_version = current->version;
+	}
+	voxel_layer_texture(&voxel, texture);
+
+	if (IsKeyPressed(KEY_F3))
+		show_stats = !show_stats;
+	if (IsKeyPressed(KEY_P))
+		anim = (anim + 1) % ANIM_COUNT;
+	poser.anim[0] = (unsigned char)anim;
+	anim_batch_update(&poser, GetFrameTime());
+	anim_apply(models, &poser, &rigs[slim], 0);
 	long new_time = GetFileModTime(skinfile);
 	if (new_time != old_time)
 		queue_update = 1;
@@ -325,30 +536,86 @@ main(int argc, char **argv)
 		}
 	}
 
-	/* Draw */
-	BeginDrawing();
+	/* Draw, the 3D pass at the scale picked for the frame time */
+	const bool scaled = dynres_begin(&dynres, GetScreenWidth(),
+		GetScreenHeight());
+	if (!scaled)
+		BeginDrawing();
 	ClearBackground(BLACK);
 
 	BeginMode3D(camera);
+	unsigned hidden = 0;
 	for (size_t i = 0; i < MODEL_COUNT; i++) {
-		if (!button[i].active)
+		if (button[i].active) {
+			hidden |= 1u << i;
+			continue;
+		}
+		if (i < VOXEL_PARTS) {
 			DrawModel(models[i], position, 1.0f, WHITE);
+		} else if (voxels) {
+			Model *v = &voxel.models[i - VOXEL_PARTS];
+			v->transform = models[i].transform;
+			if (v->meshCount)
+				DrawModel(*v, position, 1.0f, WHITE);
+		}
 	}
+	if (!voxels)
+		cull_draw(&culls[slim], models, hidden);
 	EndMode3D();
 
+	if (scaled) {
+		EndTextureMode();
+		BeginDrawing();
+		ClearBackground(BLACK);
+		dynres_draw(&dynres);
+	}
+
+	/* The buttons and text stay sharp at the window's size */
 	for (size_t i = 0; i < MODEL_COUNT; i++) {
 		DrawRectangleRec(button[i].rec,
 			(button[i].active ? DARKGRAY : WHITE));
 	}
 
+	if (show_stats)
+		DrawText(TextFormat("%s, pose %s, %s arms\n%s\n%s",
+			residency_stats(&res), anim_names[anim],
+			slim ? "slim" : "classic", voxels ? "overlay as voxels"
+			: cull_stats(&culls[slim]), dynres_stats(&dynres)),
+			4, 4, 10, RAYWHITE);
+
+	/* Up to here is the CPU's part, the rest waits on the swap */
+	frame_cpu = now_ns() - frame_start;
 	EndDrawing();
 
+	if (ready_fd >= 0) {
+		notify_ready(ready_fd);
+		ready_fd = -1;
+	}
+
+	if (benchfile) {
+		phase_ns[PHASE_FRAME] = now_ns();
+		render_poses(models);
+		phase_ns[PHASE_RENDER] = now_ns();
+		phases_save(benchfile);
+		break;
+	}
+
 	} /* End Main Loop */
 
-	UnloadTexture(texture);
-	UnloadImage(image);
-	for (size_t i = 0; i < MODEL_COUNT; i++) {
-		UnloadModel(models[i]);
+	if (statefile)
+		state_save(statefile, skinfile, &camera);
+
+	if (report)
+		fprintf(stderr, "%s\n", residency_stats(&res));
+	dynres_free(&dynres);
+	voxel_layer_free(&voxel);
+	anim_batch_free(&poser);
+	playlist_free(playlist);
+	residency_free(&res);
+	for (size_t s = 0; s < 2; s++) {
+		cull_free(&culls[s]);
+		for (size_t i = 0; i < MODEL_COUNT; i++)
+			UnloadModel(shapes[s][i]);
 	}
 
 	return EXIT_SUCCESS;
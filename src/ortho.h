@@ -0,0 +1,299 @@
+#ifndef ORTHO_H
+#define ORTHO_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "skin.h"
+
+/* Orthographic renders along an axis without the GPU. Looking straight at a
+ * box, exactly one face of each part is visible and it maps to a texel
+ * rectangle, so the picture is a handful of scaled blits drawn back to
+ * front. Face positions and UVs come from skin_face(), like the meshes
+ * load_models() builds, so this stays in sync with what DrawModel shows.
+ *
+ * Faces at equal depth are drawn in enum model order, the later one winning
+ * like it does under the GL_LEQUAL depth test, and blending uses the same
+ * SRC_ALPHA, ONE_MINUS_SRC_ALPHA factors for all four channels as raylib's
+ * default blend mode. One difference is left on purpose: GL writes depth
+ * for transparent texels too, so an overlay part drawn after a nearer one
+ * goes missing behind its transparent texels, where here it shows. */
+
+enum ortho_view {
+	ORTHO_FRONT = 0,
+	ORTHO_BACK,
+	ORTHO_LEFT,  /* looking at the model's left side */
+	ORTHO_RIGHT,
+	ORTHO_VIEW_COUNT
+};
+
+const char *ortho_view_names[] = {
+	[ORTHO_FRONT] = "front",
+	[ORTHO_BACK]  = "back",
+	[ORTHO_LEFT]  = "left",
+	[ORTHO_RIGHT] = "right",
+};
+
+/* One face of a part, in model units, UVs with v up */
+struct ortho_quad {
+	float pos[4][3];
+	float uv[4][2];
+	float normal[3];
+};
+
+struct ortho_face {
+	unsigned part;
+	int x0, y0, x1, y1; /* canvas pixels, end exclusive */
+	int *cols;          /* texel column for each pixel column */
+	int *rows;          /* texel row for each pixel row */
+};
+
+struct ortho_plan {
+	enum ortho_view view;
+	bool slim;
+	int scale;
+	int texw, texh;
+	int width, height;
+	int ox, oy; /* canvas top left, pixels from the model origin */
+	size_t count;
+	struct ortho_face faces[MODEL_COUNT];
+	int *tables;
+};
+
+/* Indexed by slim */
+struct ortho_quad ortho_quads[2][MODEL_COUNT][6];
+
+/* Screen right and camera forward for each view */
+const float ortho_axes[ORTHO_VIEW_COUNT][2][3] = {
+	[ORTHO_FRONT] = { { -1, 0,  0 }, {  0, 0,  1 } },
+	[ORTHO_BACK]  = { {  1, 0,  0 }, {  0, 0, -1 } },
+	[ORTHO_LEFT]  = { {  0, 0,  1 }, {  1, 0,  0 } },
+	[ORTHO_RIGHT] = { {  0, 0, -1 }, { -1, 0,  0 } },
+};
+
+static float
+ortho_dot(const float a[3], const float b[3])
+{
+	return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+/* Fills ortho_quads with both models */
+void
+ortho_init(void)
+{
+	for (size_t s = 0; s < 2; s++) {
+		for (size_t i = 0; i < MODEL_COUNT; i++) {
+			for (size_t f = 0; f < 6; f++) {
+				struct ortho_quad *q = &ortho_quads[s][i][f];
+				skin_face(i, s, f, q->pos, q->uv);
+				for (size_t k = 0; k < 4; k++)
+					q->uv[k][1] = 1 - q->uv[k][1];
+				memcpy(q->normal, skin_faces[f].normal,
+					sizeof(q->normal));
+			}
+		}
+	}
+}
+
+static int
+ortho_pixel(float f)
+{
+	/* First pixel whose centre is at or past f */
+	return (int)ceilf(f - 0.5f);
+}
+
+/* lo wins when the range is empty */
+static int
+ortho_clamp(int v, int lo, int hi)
+{
+	if (hi < lo)
+		return lo;
+	return v < lo ? lo : v > hi ? hi : v;
+}
+
+static int
+ortho_cmp(const void *a, const void *b, const float *depth)
+{
+	const struct ortho_face *fa = a, *fb = b;
+	float da = depth[fa->part], db = depth[fb->part];
+	if (da != db)
+		return da < db ? 1 : -1;
+	return (fa->part > fb->part) - (fa->part < fb->part);
+}
+
+/* Lays out the visible face of every part of the slim or classic model for
+ * view at an integer scale (pixels per texel of a 64 wide skin) and texture
+ * size. Fails for textures that are not 64x64 or HD: upgrade legacy ones
+ * first, anything smaller has faces under a texel wide. */
+bool
+ortho_plan(struct ortho_plan *p, enum ortho_view view, int scale,
+	int texw, int texh, bool slim)
+{
+	free(p->tables);
+	p->tables = NULL;
+	if (skin_kind_of(texw, texh) < SKIN_MODERN)
+		return 0;
+
+	struct ortho_quad (*quads)[6] = ortho_quads[slim];
+	const float *right = ortho_axes[view][0];
+	const float *forward = ortho_axes[view][1];
+	const float k = 16.0f * (float)scale;
+
+	/* Canvas covers every part so sizes do not depend on what is hidden */
+	float minx = INFINITY, maxx = -INFINITY, miny = INFINITY, maxy = -INFINITY;
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		for (size_t f = 0; f < 6; f++) {
+			for (size_t c = 0; c < 4; c++) {
+				const float *pos = quads[i][f].pos[c];
+				float x = ortho_dot(pos, right) * k;
+				float y = -pos[1] * k;
+				minx = fminf(minx, x);
+				maxx = fmaxf(maxx, x);
+				miny = fminf(miny, y);
+				maxy = fmaxf(maxy, y);
+			}
+		}
+	}
+	float ox = floorf(minx), oy = floorf(miny);
+
+	*p = (struct ortho_plan){
+		.view = view,
+		.slim = slim,
+		.scale = scale,
+		.texw = texw,
+		.texh = texh,
+		.width = (int)(ceilf(maxx) - ox),
+		.height = (int)(ceilf(maxy) - oy),
+		.ox = (int)ox,
+		.oy = (int)oy,
+	};
+	p->tables = malloc(sizeof(int) * MODEL_COUNT
+		* (size_t)(p->width + p->height));
+	if (!p->tables)
+		return 0;
+
+	float depth[MODEL_COUNT];
+	int *table = p->tables;
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		const struct ortho_quad *q = NULL;
+		for (size_t f = 0; f < 6 && !q; f++) {
+			if (ortho_dot(quads[i][f].normal, forward) < -0.5f)
+				q = &quads[i][f];
+		}
+		if (!q)
+			continue;
+
+		/* Corners a (top left), b (top right) and c (bottom left) */
+		float sx[4], sy[4];
+		size_t a = 0, b = 0, c = 0;
+		for (size_t v = 0; v < 4; v++) {
+			sx[v] = ortho_dot(q->pos[v], right) * k - ox;
+			sy[v] = -q->pos[v][1] * k - oy;
+		}
+		for (size_t v = 1; v < 4; v++) {
+			if (sx[v] <= sx[a] && sy[v] <= sy[a]) a = v;
+			if (sx[v] >= sx[b] && sy[v] <= sy[b]) b = v;
+			if (sx[v] <= sx[c] && sy[v] >= sy[c]) c = v;
+		}
+
+		struct ortho_face *face = &p->faces[p->count++];
+		face->part = (unsigned)i;
+		face->x0 = ortho_pixel(sx[a]);
+		face->x1 = ortho_pixel(sx[b]);
+		face->y0 = ortho_pixel(sy[a]);
+		face->y1 = ortho_pixel(sy[c]);
+		depth[i] = ortho_dot(q->pos[0], forward);
+
+		float u0 = q->uv[a][0] * (float)texw, u1 = q->uv[b][0] * (float)texw;
+		float v0 = (1 - q->uv[a][1]) * (float)texh;
+		float v1 = (1 - q->uv[c][1]) * (float)texh;
+		int ulo = (int)floorf(fminf(u0, u1) + 0.5f);
+		int uhi = (int)floorf(fmaxf(u0, u1) + 0.5f) - 1;
+		int vlo = (int)floorf(fminf(v0, v1) + 0.5f);
+		int vhi = (int)floorf(fmaxf(v0, v1) + 0.5f) - 1;
+
+		face->cols = table;
+		for (int x = face->x0; x < face->x1; x++) {
+			float t = ((float)x + 0.5f - sx[a]) / (sx[b] - sx[a]);
+			*table++ = ortho_clamp((int)floorf(u0 + (u1 - u0) * t),
+				ulo, uhi);
+		}
+		face->rows = table;
+		for (int y = face->y0; y < face->y1; y++) {
+			float t = ((float)y + 0.5f - sy[a]) / (sy[c] - sy[a]);
+			*table++ = ortho_clamp((int)floorf(v0 + (v1 - v0) * t),
+				vlo, vhi);
+		}
+	}
+
+	/* Insertion sort, qsort has no context argument in C11 */
+	for (size_t i = 1; i < p->count; i++) {
+		struct ortho_face f = p->faces[i];
+		size_t j = i;
+		while (j && ortho_cmp(&p->faces[j - 1], &f, depth) > 0) {
+			p->faces[j] = p->faces[j - 1];
+			j--;
+		}
+		p->faces[j] = f;
+	}
+	return 1;
+}
+
+void
+ortho_plan_free(struct ortho_plan *p)
+{
+	free(p->tables);
+	p->tables = NULL;
+}
+
+/* src over dst for RGBA8 in a uint32_t, two channels per multiply */
+static uint32_t
+ortho_blend(uint32_t dst, uint32_t src)
+{
+	uint32_t a = src >> 24;
+	if (a == 255)
+		return src;
+	if (a == 0)
+		return dst;
+
+	uint32_t ia = 255 - a;
+	uint32_t rb = (src & 0x00ff00ffu) * a + (dst & 0x00ff00ffu) * ia;
+	uint32_t ga = ((src >> 8) & 0x00ff00ffu) * a
+		+ ((dst >> 8) & 0x00ff00ffu) * ia;
+
+	/* Divide each 16 bit lane by 255, rounding to nearest */
+	rb += 0x00800080u;
+	ga += 0x00800080u;
+	rb = ((rb + ((rb >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+	ga = ((ga + ((ga >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+	return rb | (ga << 8);
+}
+
+/* tex is the skin as RGBA8 of the size the plan was made for, out holds
+ * width*height pixels. Parts set in hidden are skipped. */
+void
+ortho_render(const struct ortho_plan *p, const uint32_t *tex,
+	unsigned hidden, uint32_t *out)
+{
+	memset(out, 0, sizeof(*out) * (size_t)p->width * (size_t)p->height);
+
+	for (size_t i = 0; i < p->count; i++) {
+		const struct ortho_face *f = &p->faces[i];
+		if (hidden & (1u << f->part))
+			continue;
+
+		const int w = f->x1 - f->x0;
+		for (int y = f->y0; y < f->y1; y++) {
+			const uint32_t *src = tex
+				+ (size_t)f->rows[y - f->y0] * (size_t)p->texw;
+			uint32_t *dst = out + (size_t)y * (size_t)p->width + f->x0;
+			for (int x = 0; x < w; x++)
+				dst[x] = ortho_blend(dst[x], src[f->cols[x]]);
+		}
+	}
+}
+
+#endif /* ORTHO_H */
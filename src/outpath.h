@@ -0,0 +1,65 @@
+#ifndef OUTPATH_H
+#define OUTPATH_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* Where the command line tools write what they make of an input file: the
+ * input's path is kept below the output directory, so skins of the same
+ * name in different directories, or archive members, never overwrite each
+ * other. Paths are made relative first: leading slashes and "." go, and
+ * ".." becomes "__" so nothing lands outside the output directory. */
+
+/* Writes outdir/path to buf, the extension of the file name swapped for
+ * suffix unless suffix is NULL, and creates the directories it needs.
+ * Returns 0 with errno set if the path does not fit or a directory can
+ * not be made. */
+bool
+out_path(char *buf, size_t len, const char *outdir, const char *file,
+	const char *suffix)
+{
+	int n = snprintf(buf, len, "%s", outdir);
+	if (n < 0 || (size_t)n >= len) {
+		errno = ENAMETOOLONG;
+		return 0;
+	}
+	size_t at = (size_t)n;
+
+	const char *s = file;
+	while (*s) {
+		size_t part = strcspn(s, "/");
+		const bool last = !s[part];
+		const char *name = s;
+		int keep = (int)part;
+		if (part == 2 && !strncmp(s, "..", 2))
+			name = "__";
+		else if (last && suffix) {
+			for (int k = keep; k-- > 0;) {
+				if (s[k] == '.') {
+					keep = k;
+					break;
+				}
+			}
+		}
+		s += part + !last;
+		if (!part || (part == 1 && *name == '.'))
+			continue;
+
+		n = snprintf(buf + at, len - at, "/%.*s%s", keep, name,
+			last && suffix ? suffix : "");
+		if (n < 0 || (size_t)n >= len - at) {
+			errno = ENAMETOOLONG;
+			return 0;
+		}
+		if (!last && mkdir(buf, 0755) < 0 && errno != EEXIST)
+			return 0;
+		at += (size_t)n;
+	}
+	return 1;
+}
+
+#endif /* OUTPATH_H */
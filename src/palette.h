@@ -0,0 +1,212 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+
+/* Decoded skins in the form they are kept around in: most use a few dozen
+ * colours, so a skin with at most 16 is stored as 4 bit palette indices,
+ * one with at most 256 as 8 bit ones, and only the rest as RGBA8. For a
+ * 64x64 skin that is 2 KB, 4 KB or 16 KB plus the palette. Colours are
+ * kept exactly, including whatever sits under zero alpha, and pixels are
+ * only expanded back to RGBA8 to be uploaded or compared.
+ *
+ * 4 bit rows are expanded through a table of the 256 possible pixel pairs,
+ * one 8 byte copy per index byte; SSE2 has no byte shuffle or gather that
+ * would do better. */
+
+#define PALETTE_HASH 512 /* twice the colours an 8 bit palette holds */
+
+struct palette_image {
+	unsigned char *data; /* indices, stride bytes a row, or RGBA8 */
+	uint32_t *colors;    /* ncolors RGBA8 colours, as in memory */
+	int width, height;
+	size_t stride;
+	unsigned bits;       /* per pixel: 4, 8 or 32 */
+	unsigned ncolors;
+};
+
+size_t
+palette_size(const struct palette_image *p)
+{
+	return p->data ? p->stride * (size_t)p->height
+		+ sizeof(*p->colors) * p->ncolors : 0;
+}
+
+void
+palette_free(struct palette_image *p)
+{
+	RL_FREE(p->data);
+	RL_FREE(p->colors);
+	*p = (struct palette_image){ 0 };
+}
+
+/* Packs an RGBA8 image into p, in the smallest form its colours fit. img
+ * stays the caller's. False if img has no pixels or memory runs out. */
+bool
+palette_pack(struct palette_image *p, const Image *img)
+{
+	*p = (struct palette_image){ 0 };
+	if (!img->data || img->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+			|| img->width < 1 || img->height < 1)
+		return 0;
+
+	const size_t w = (size_t)img->width, h = (size_t)img->height;
+	const size_t n = w * h;
+	const uint32_t *px = img->data;
+	uint32_t colors[256];
+	uint16_t slot[PALETTE_HASH] = { 0 }; /* colour index + 1 */
+	unsigned ncolors = 0;
+
+	unsigned char *index = RL_MALLOC(n);
+	if (!index)
+		return 0;
+	uint32_t last = px[0];
+	unsigned last_index = 0;
+	colors[ncolors++] = last;
+	slot[(last * 2654435761u) >> 23] = 1;
+	size_t i = 0;
+	for (; i < n; i++) {
+		const uint32_t c = px[i];
+		if (c != last) {
+			unsigned k = (c * 2654435761u) >> 23;
+			while (slot[k] && colors[slot[k] - 1] != c)
+				k = (k + 1) % PALETTE_HASH;
+			if (!slot[k]) {
+				if (ncolors == 256)
+					break;
+				colors[ncolors++] = c;
+				slot[k] = (uint16_t)ncolors;
+			}
+			last = c;
+			last_index = slot[k] - 1u;
+		}
+		index[i] = (unsigned char)last_index;
+	}
+
+	p->width = img->width;
+	p->height = img->height;
+	if (i < n) {
+		/* Too many colours */
+		RL_FREE(index);
+		p->data = RL_MALLOC(n * 4);
+		if (!p->data)
+			return 0;
+		memcpy(p->data, px, n * 4);
+		p->stride = w * 4;
+		p->bits = 32;
+		return 1;
+	}
+
+	p->colors = RL_MALLOC(sizeof(*p->colors) * ncolors);
+	if (!p->colors) {
+		RL_FREE(index);
+		return 0;
+	}
+	memcpy(p->colors, colors, sizeof(*p->colors) * ncolors);
+	p->ncolors = ncolors;
+	p->data = index;
+	p->stride = w;
+	p->bits = 8;
+	if (ncolors > 16)
+		return 1;
+
+	/* Two to a byte, first pixel in the high nibble. Packing in place
+	 * only ever writes behind what is still to be read. */
+	const size_t stride = (w + 1) / 2;
+	for (size_t y = 0; y < h; y++) {
+		const unsigned char *in = index + y * w;
+		unsigned char *out = index + y * stride;
+		for (size_t x = 0; x + 1 < w; x += 2)
+			out[x / 2] = (unsigned char)(in[x] << 4 | in[x + 1]);
+		if (w % 2)
+			out[w / 2] = (unsigned char)(in[w - 1] << 4);
+	}
+	unsigned char *shrunk = RL_REALLOC(index, stride * h);
+	p->data = shrunk ? shrunk : index;
+	p->stride = stride;
+	p->bits = 4;
+	return 1;
+}
+
+/* Writes rows [first, first + count) of p as RGBA8 to out */
+void
+palette_expand_rows(const struct palette_image *p, int first, int count,
+	uint32_t *out)
+{
+	const size_t w = (size_t)p->width;
+	const unsigned char *in = p->data + (size_t)first * p->stride;
+	if (p->bits == 32) {
+		memcpy(out, in, (size_t)count * p->stride);
+		return;
+	}
+
+	if (p->bits == 8) {
+		const uint32_t *c = p->colors;
+		for (int y = 0; y < count; y++, in += p->stride, out += w) {
+			size_t x = 0;
+			for (; x + 4 <= w; x += 4) {
+				out[x] = c[in[x]];
+				out[x + 1] = c[in[x + 1]];
+				out[x + 2] = c[in[x + 2]];
+				out[x + 3] = c[in[x + 3]];
+			}
+			for (; x < w; x++)
+				out[x] = c[in[x]];
+		}
+		return;
+	}
+
+	uint32_t c[16] = { 0 };
+	uint32_t pair[256][2];
+	memcpy(c, p->colors, sizeof(*c) * p->ncolors);
+	for (unsigned b = 0; b < 256; b++) {
+		pair[b][0] = c[b >> 4];
+		pair[b][1] = c[b & 15];
+	}
+	for (int y = 0; y < count; y++, in += p->stride, out += w) {
+		for (size_t x = 0; x < w / 2; x++)
+			memcpy(out + x * 2, pair[in[x]], 8);
+		if (w % 2)
+			out[w - 1] = c[in[w / 2] >> 4];
+	}
+}
+
+/* Pixel (x, y) of p as RGBA8, as in memory */
+uint32_t
+palette_pixel(const struct palette_image *p, int x, int y)
+{
+	const unsigned char *row = p->data + (size_t)y * p->stride;
+	if (p->bits == 32) {
+		uint32_t c;
+		memcpy(&c, row + (size_t)x * 4, sizeof(c));
+		return c;
+	}
+	if (p->bits == 8)
+		return p->colors[row[x]];
+	return p->colors[x % 2 ? row[x / 2] & 15 : row[x / 2] >> 4];
+}
+
+/* A new RGBA8 image of p, no data if out of memory */
+Image
+palette_expand(const struct palette_image *p)
+{
+	Image img = {
+		.data = p->data ? RL_MALLOC((size_t)p->width
+			* (size_t)p->height * 4) : NULL,
+		.width = p->width,
+		.height = p->height,
+		.mipmaps = 1,
+		.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+	};
+	if (!img.data)
+		return (Image){ 0 };
+	palette_expand_rows(p, 0, p->height, img.data);
+	return img;
+}
+
+#endif /* PALETTE_H */
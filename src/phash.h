@@ -0,0 +1,422 @@
+#ifndef PHASH_H
+#define PHASH_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "skin.h"
+#include "ortho.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Perceptual hashes of skins, for finding re-uploads with small edits.
+ *
+ * Only texels some face of the bundled models shows take part; the rest of
+ * the texture is filled with the mean, and so are overlay texels that are
+ * less than half opaque. The 64x64 luminance is halved to 32x32 and the
+ * bits are the signs of the lowest 8x8 DCT coefficients (DC left out)
+ * against their median, which survives recolours, brightness changes and
+ * rescaling. Two skins are alike when few bits differ.
+ *
+ * Searching within r bits uses multi-index hashing: split the hash into m
+ * chunks and two hashes within r bits are within r / m bits of each other
+ * on at least one of them. Each chunk buckets the hashes by its value, and
+ * a search only looks into the buckets near its own chunks. m is picked to
+ * balance the buckets probed against the entries in each. */
+
+#define PHASH_EDGE 64
+#define PHASH_SMALL 32
+
+/* 1 for base layer texels, 2 for overlay texels */
+unsigned char phash_mask[PHASH_EDGE * PHASH_EDGE];
+float phash_cos[8][PHASH_SMALL];
+
+void
+phash_init(void)
+{
+	ortho_init();
+
+	memset(phash_mask, 0, sizeof(phash_mask));
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		const unsigned char layer = i >= MODEL_LAYER_HEAD ? 2 : 1;
+		for (size_t f = 0; f < 6; f++) {
+			/* Slim: existing indexes were hashed with it */
+			const struct ortho_quad *q = &ortho_quads[1][i][f];
+			float u0 = 1, u1 = 0, v0 = 1, v1 = 0;
+			for (size_t k = 0; k < 4; k++) {
+				u0 = fminf(u0, q->uv[k][0]);
+				u1 = fmaxf(u1, q->uv[k][0]);
+				v0 = fminf(v0, 1 - q->uv[k][1]);
+				v1 = fmaxf(v1, 1 - q->uv[k][1]);
+			}
+			for (int y = (int)lroundf(v0 * PHASH_EDGE);
+					y < (int)lroundf(v1 * PHASH_EDGE); y++) {
+				for (int x = (int)lroundf(u0 * PHASH_EDGE);
+						x < (int)lroundf(u1 * PHASH_EDGE); x++)
+					phash_mask[y * PHASH_EDGE + x] = layer;
+			}
+		}
+	}
+
+	const double pi = 3.14159265358979323846;
+	for (int k = 0; k < 8; k++) {
+		for (int n = 0; n < PHASH_SMALL; n++)
+			phash_cos[k][n] = (float)cos(pi * (2 * n + 1) * (k + 1)
+				/ (2 * PHASH_SMALL));
+	}
+}
+
+static int
+phash_cmp(const void *a, const void *b)
+{
+	float x = *(const float *)a, y = *(const float *)b;
+	return (x > y) - (x < y);
+}
+
+/* Hash of an RGBA8 skin of any kind, 0 if it is not a skin. Needs
+ * phash_init(). */
+uint64_t
+phash_image(const Image *img)
+{
+	enum skin_kind kind = skin_kind_of(img->width, img->height);
+	if (kind == SKIN_INVALID
+			|| img->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+		return 0;
+
+	/* Legacy skins hash like their upgraded selves */
+	Image upgraded = { 0 };
+	if (kind == SKIN_LEGACY) {
+		upgraded = ImageCopy(*img);
+		image_upgrade_legacy(&upgraded);
+		if (!upgraded.data)
+			return 0;
+		img = &upgraded;
+	}
+
+	const int u = img->width / PHASH_EDGE;
+	const unsigned char *px = img->data;
+	float lum[PHASH_EDGE * PHASH_EDGE];
+	double sum = 0;
+	size_t seen = 0;
+	for (int y = 0; y < PHASH_EDGE; y++) {
+		for (int x = 0; x < PHASH_EDGE; x++) {
+			const int m = phash_mask[y * PHASH_EDGE + x];
+			lum[y * PHASH_EDGE + x] = -1;
+			if (!m)
+				continue;
+
+			unsigned r = 0, g = 0, b = 0, a = 0;
+			for (int dy = 0; dy < u; dy++) {
+				const unsigned char *p = px + (((size_t)(y * u + dy)
+					* (size_t)img->width + (size_t)(x * u)) * 4);
+				for (int dx = 0; dx < u; dx++, p += 4) {
+					r += p[0];
+					g += p[1];
+					b += p[2];
+					a += p[3];
+				}
+			}
+			if (m == 2 && a < 128u * (unsigned)(u * u))
+				continue;
+
+			float l = (0.299f * (float)r + 0.587f * (float)g
+				+ 0.114f * (float)b) / (float)(u * u);
+			lum[y * PHASH_EDGE + x] = l;
+			sum += l;
+			seen++;
+		}
+	}
+	UnloadImage(upgraded);
+	if (!seen)
+		return 0;
+
+	const float mean = (float)(sum / (double)seen);
+	float small[PHASH_SMALL][PHASH_SMALL];
+	for (int y = 0; y < PHASH_SMALL; y++) {
+		for (int x = 0; x < PHASH_SMALL; x++) {
+			float s = 0;
+			for (int k = 0; k < 4; k++) {
+				float l = lum[(y * 2 + k / 2) * PHASH_EDGE + x * 2 + k % 2];
+				s += l < 0 ? mean : l;
+			}
+			small[y][x] = s / 4;
+		}
+	}
+
+	/* Separable DCT, only the coefficients 1 to 8 of each axis */
+	float rows[PHASH_SMALL][8], coef[64], sorted[64];
+	for (int y = 0; y < PHASH_SMALL; y++) {
+		for (int k = 0; k < 8; k++) {
+			float s = 0;
+			for (int x = 0; x < PHASH_SMALL; x++)
+				s += small[y][x] * phash_cos[k][x];
+			rows[y][k] = s;
+		}
+	}
+	for (int ky = 0; ky < 8; ky++) {
+		for (int kx = 0; kx < 8; kx++) {
+			float s = 0;
+			for (int y = 0; y < PHASH_SMALL; y++)
+				s += rows[y][kx] * phash_cos[ky][y];
+			coef[ky * 8 + kx] = sorted[ky * 8 + kx] = s;
+		}
+	}
+	qsort(sorted, 64, sizeof(*sorted), phash_cmp);
+	const float median = (sorted[31] + sorted[32]) / 2;
+
+	uint64_t h = 0;
+	for (int i = 0; i < 64; i++)
+		h |= (uint64_t)(coef[i] > median) << i;
+	return h;
+}
+
+int
+phash_distance(uint64_t a, uint64_t b)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(a ^ b);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(a ^ b);
+#else
+	uint64_t x = a ^ b;
+	x -= (x >> 1) & 0x5555555555555555u;
+	x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+	return (int)((x * 0x0101010101010101u) >> 56);
+#endif
+}
+
+/* The hashes bucketed by each of a few chunks, for searches within radius
+ * bits. Chunks are at most 16 bits wide, which keeps the bucket offsets of
+ * a chunk small enough to stay in cache while probing. */
+#define PHASH_MIN_CHUNKS 4
+#define PHASH_MAX_CHUNKS 8
+
+struct phash_table {
+	const uint64_t *hashes;
+	size_t count;
+	int radius;
+	int subradius; /* per chunk, radius / chunks */
+	unsigned chunks;
+	uint32_t *start[PHASH_MAX_CHUNKS]; /* bucket offsets into items */
+	uint32_t *items[PHASH_MAX_CHUNKS]; /* indices in bucket order */
+	uint64_t *sorted[PHASH_MAX_CHUNKS]; /* their hashes, read in a row */
+};
+
+static unsigned
+phash_chunk_lo(unsigned chunks, unsigned c)
+{
+	return c * 64 / chunks;
+}
+
+static uint64_t
+phash_chunk(const struct phash_table *t, unsigned c, uint64_t h)
+{
+	const unsigned lo = phash_chunk_lo(t->chunks, c);
+	const unsigned bits = phash_chunk_lo(t->chunks, c + 1) - lo;
+	return (h >> lo) & (((uint64_t)1 << bits) - 1);
+}
+
+/* Expected work for a split into m chunks: keys probed per chunk (all
+ * within radius / m bits), each a lookup plus the entries found there */
+static double
+phash_cost(size_t count, int radius, unsigned m)
+{
+	const unsigned bits = 64 / m;
+	double keys = 0, term = 1;
+	for (int i = 0; i <= radius / (int)m; i++) {
+		keys += term;
+		term = term * (bits - (unsigned)i) / (i + 1);
+	}
+	return m * keys * (4 + (double)count / (double)((uint64_t)1 << bits));
+}
+
+/* Indexes hashes, which must outlive the table, for radius 0 to 63 */
+bool
+phash_table_build(struct phash_table *t, const uint64_t *hashes,
+	size_t count, int radius)
+{
+	*t = (struct phash_table){
+		.hashes = hashes,
+		.count = count,
+		.radius = radius,
+	};
+	if (radius < 0 || radius > 63 || count >= UINT32_MAX)
+		return 0;
+
+	t->chunks = PHASH_MIN_CHUNKS;
+	for (unsigned m = PHASH_MIN_CHUNKS + 1; m <= PHASH_MAX_CHUNKS; m++) {
+		if (phash_cost(count, radius, m)
+				< phash_cost(count, radius, t->chunks))
+			t->chunks = m;
+	}
+	t->subradius = radius / (int)t->chunks;
+
+	for (unsigned c = 0; c < t->chunks; c++) {
+		const unsigned bits = phash_chunk_lo(t->chunks, c + 1)
+			- phash_chunk_lo(t->chunks, c);
+		const size_t buckets = (size_t)1 << bits;
+		uint32_t *start = t->start[c] = calloc(buckets + 1, sizeof(*start));
+		uint32_t *items = t->items[c] = malloc(sizeof(*items)
+			* (count ? count : 1));
+		uint64_t *sorted = t->sorted[c] = malloc(sizeof(*sorted)
+			* (count ? count : 1));
+		if (!start || !items || !sorted)
+			return 0;
+
+		/* Counting sort by chunk value */
+		for (size_t i = 0; i < count; i++)
+			start[phash_chunk(t, c, hashes[i]) + 1]++;
+		for (size_t b = 0; b < buckets; b++)
+			start[b + 1] += start[b];
+		for (size_t i = 0; i < count; i++) {
+			const uint32_t at = start[phash_chunk(t, c, hashes[i])]++;
+			items[at] = (uint32_t)i;
+			sorted[at] = hashes[i];
+		}
+		for (size_t b = buckets; b > 0; b--)
+			start[b] = start[b - 1];
+		start[0] = 0;
+	}
+	return 1;
+}
+
+void
+phash_table_free(struct phash_table *t)
+{
+	for (unsigned c = 0; c < PHASH_MAX_CHUNKS; c++) {
+		free(t->start[c]);
+		free(t->items[c]);
+		free(t->sorted[c]);
+		t->start[c] = t->items[c] = NULL;
+		t->sorted[c] = NULL;
+	}
+}
+
+/* A walk over the buckets near one key of a chunk. Queries compare a hash
+ * against each bucket; pair searches compare the home bucket against each,
+ * so both stay in cache while every pair between them is tried. */
+struct phash_probe {
+	const struct phash_table *t;
+	unsigned chunk;
+	uint64_t hash;
+	bool pairs;
+	uint64_t home;
+	void (*found)(size_t a, size_t b, int distance, void *ctx);
+	void *ctx;
+	size_t compared;
+};
+
+/* True if c is the first chunk within the subradius for a and b, so every
+ * match is reported once */
+static bool
+phash_first_chunk(const struct phash_table *t, unsigned c, uint64_t a,
+	uint64_t b)
+{
+	for (unsigned k = 0; k < c; k++) {
+		if (phash_distance(phash_chunk(t, k, a), phash_chunk(t, k, b))
+				<= t->subradius)
+			return 0;
+	}
+	return 1;
+}
+
+static void
+phash_visit(struct phash_probe *p, uint64_t key)
+{
+	const struct phash_table *t = p->t;
+	const uint32_t *start = t->start[p->chunk];
+	const uint32_t *items = t->items[p->chunk];
+	const uint64_t *sorted = t->sorted[p->chunk];
+
+	if (!p->pairs) {
+		for (uint32_t j = start[key]; j < start[key + 1]; j++) {
+			const int d = phash_distance(p->hash, sorted[j]);
+			p->compared++;
+			if (d <= t->radius
+					&& phash_first_chunk(t, p->chunk, p->hash, sorted[j]))
+				p->found(items[j], items[j], d, p->ctx);
+		}
+		return;
+	}
+
+	/* Each unordered pair of buckets once */
+	if (key < p->home)
+		return;
+	for (uint32_t i = start[p->home]; i < start[p->home + 1]; i++) {
+		const uint64_t a = sorted[i];
+		for (uint32_t j = key == p->home ? i + 1 : start[key];
+				j < start[key + 1]; j++) {
+			const int d = phash_distance(a, sorted[j]);
+			p->compared++;
+			if (d <= t->radius
+					&& phash_first_chunk(t, p->chunk, a, sorted[j])) {
+				const size_t x = items[i], y = items[j];
+				p->found(x < y ? x : y, x < y ? y : x, d, p->ctx);
+			}
+		}
+	}
+}
+
+/* Visits every key within flips bits of key, flipping bits from on */
+static void
+phash_probe_keys(struct phash_probe *p, uint64_t key, unsigned from,
+	int flips)
+{
+	phash_visit(p, key);
+	if (!flips)
+		return;
+	const unsigned bits = phash_chunk_lo(p->t->chunks, p->chunk + 1)
+		- phash_chunk_lo(p->t->chunks, p->chunk);
+	for (unsigned i = from; i < bits; i++)
+		phash_probe_keys(p, key ^ ((uint64_t)1 << i), i + 1, flips - 1);
+}
+
+/* Calls found for every pair of hashes within the radius, a < b. Returns
+ * the number of full comparisons made. */
+size_t
+phash_table_pairs(const struct phash_table *t,
+	void (*found)(size_t a, size_t b, int distance, void *ctx), void *ctx)
+{
+	struct phash_probe p = {
+		.t = t,
+		.pairs = true,
+		.found = found,
+		.ctx = ctx,
+	};
+	for (p.chunk = 0; p.chunk < t->chunks; p.chunk++) {
+		const uint64_t buckets = (uint64_t)1
+			<< (phash_chunk_lo(t->chunks, p.chunk + 1)
+			- phash_chunk_lo(t->chunks, p.chunk));
+		for (p.home = 0; p.home < buckets; p.home++) {
+			if (t->start[p.chunk][p.home] != t->start[p.chunk][p.home + 1])
+				phash_probe_keys(&p, p.home, 0, t->subradius);
+		}
+	}
+	return p.compared;
+}
+
+/* Calls found(i, i, distance, ctx) for every hash within the radius of h.
+ * Returns the number of full comparisons made. */
+size_t
+phash_table_query(const struct phash_table *t, uint64_t h,
+	void (*found)(size_t a, size_t b, int distance, void *ctx), void *ctx)
+{
+	struct phash_probe p = {
+		.t = t,
+		.hash = h,
+		.found = found,
+		.ctx = ctx,
+	};
+	for (p.chunk = 0; p.chunk < t->chunks; p.chunk++)
+		phash_probe_keys(&p, phash_chunk(t, p.chunk, h), 0, t->subradius);
+	return p.compared;
+}
+
+#endif /* PHASH_H */
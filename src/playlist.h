@@ -0,0 +1,396 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "index.h"
+#include "lint.h"
+#include "residency.h"
+#include "thread.h"
+
+#if !defined(_MSC_VER)
+#include <dirent.h>
+#endif
+
+/* A list of skins to step through, made from a multi-file or directory
+ * drop. One background thread does two jobs, in order of priority: decode
+ * the skins within PLAYLIST_AHEAD of the cursor, nearest first, and list
+ * the dropped directories a chunk at a time, so entries show up while a big
+ * directory is still being read. A directory with a library index is listed
+ * from the index instead, which also leaves out the files that are not
+ * skins. The main thread adopts decoded skins into
+ * the residency manager and uploads them right away, which leaves only a
+ * texture swap for the step itself. */
+
+#define PLAYLIST_AHEAD 3
+#define PLAYLIST_CHUNK 256
+
+enum playlist_state {
+	PLAYLIST_IDLE = 0,
+	PLAYLIST_LOADING,
+	PLAYLIST_LOADED,
+};
+
+struct playlist_done {
+	size_t index;
+	unsigned char *source;
+	int size;
+	struct palette_image image;
+};
+
+struct playlist {
+	thread_handle thread;
+	thread_mutex lock;
+	thread_cond wake;
+	bool quit;
+
+	/* Appended by the thread; strings never move once added */
+	char **paths;
+	unsigned char *state;
+	size_t count, cap;
+
+	char **dirs;
+	size_t ndirs, dir;
+	struct index index;
+	size_t indexed;
+	bool tried;
+#if defined(_MSC_VER)
+	FilePathList listing;
+	unsigned listed;
+#else
+	DIR *handle;
+#endif
+
+	size_t cursor;
+	struct playlist_done *done;
+	size_t ndone, donecap;
+};
+
+/* Takes ownership of path. Call with the lock held. */
+static bool
+playlist_add(struct playlist *p, char *path)
+{
+	if (p->count == p->cap) {
+		size_t cap = p->cap ? p->cap * 2 : 64;
+		char **paths = realloc(p->paths, sizeof(*paths) * cap);
+		if (paths)
+			p->paths = paths;
+		unsigned char *state = realloc(p->state, cap);
+		if (state)
+			p->state = state;
+		if (!paths || !state) {
+			free(path);
+			return 0;
+		}
+		p->cap = cap;
+	}
+	p->paths[p->count] = path;
+	p->state[p->count++] = PLAYLIST_IDLE;
+	return 1;
+}
+
+static char *
+playlist_join(const char *dir, const char *name)
+{
+	size_t a = strlen(dir), b = strlen(name);
+	char *s = malloc(a + b + 2);
+	if (s) {
+		memcpy(s, dir, a);
+		s[a] = '/';
+		memcpy(s + a + 1, name, b + 1);
+	}
+	return s;
+}
+
+/* Lists up to PLAYLIST_CHUNK entries without the lock held. Returns false
+ * once every directory has been read. */
+static bool
+playlist_scan(struct playlist *p, char **found, size_t *nfound)
+{
+	*nfound = 0;
+	while (p->dir < p->ndirs) {
+		const char *dir = p->dirs[p->dir];
+		if (!p->tried) {
+			p->tried = true;
+			p->indexed = 0;
+			index_open_dir(&p->index, dir);
+		}
+		if (p->index.map) {
+			while (*nfound < PLAYLIST_CHUNK && p->indexed < p->index.count) {
+				const struct index_entry *e =
+					&p->index.entries[p->indexed++];
+				if (e->kind != SKIN_INVALID)
+					found[(*nfound)++] = index_path(&p->index, dir, e);
+			}
+			if (*nfound == PLAYLIST_CHUNK)
+				return 1;
+			index_close(&p->index);
+			p->tried = false;
+			p->dir++;
+			if (*nfound)
+				return 1;
+			continue;
+		}
+#if defined(_MSC_VER)
+		/* No dirent here, so the directory is read whole up front */
+		if (!p->listing.paths) {
+			p->listing = LoadDirectoryFilesEx(dir, ".png;.qoi", false);
+			p->listed = 0;
+		}
+		while (*nfound < PLAYLIST_CHUNK && p->listed < p->listing.count)
+			found[(*nfound)++] = strdup(p->listing.paths[p->listed++]);
+		if (*nfound == PLAYLIST_CHUNK)
+			return 1;
+		UnloadDirectoryFiles(p->listing);
+		p->listing = (FilePathList){ 0 };
+		p->tried = false;
+		p->dir++;
+		if (*nfound)
+			return 1;
+#else
+		if (!p->handle && !(p->handle = opendir(dir))) {
+			p->tried = false;
+			p->dir++;
+			continue;
+		}
+		struct dirent *d;
+		while (*nfound < PLAYLIST_CHUNK && (d = readdir(p->handle))) {
+			if (d->d_name[0] != '.' && skin_file_name(d->d_name))
+				found[(*nfound)++] = playlist_join(dir, d->d_name);
+		}
+		if (*nfound == PLAYLIST_CHUNK)
+			return 1;
+		closedir(p->handle);
+		p->handle = NULL;
+		p->tried = false;
+		p->dir++;
+		if (*nfound)
+			return 1;
+#endif
+	}
+	return 0;
+}
+
+/* Nearest entry around the cursor that has not been loaded. Call with the
+ * lock held. */
+static bool
+playlist_wanted(struct playlist *p, size_t *index)
+{
+	for (size_t d = 0; d <= PLAYLIST_AHEAD; d++) {
+		size_t ahead = p->cursor + d;
+		if (ahead < p->count && p->state[ahead] == PLAYLIST_IDLE) {
+			*index = ahead;
+			return 1;
+		}
+		if (d <= p->cursor && p->cursor - d < p->count
+				&& p->state[p->cursor - d] == PLAYLIST_IDLE) {
+			*index = p->cursor - d;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void
+playlist_main(void *arg)
+{
+	struct playlist *p = arg;
+	char **found = malloc(sizeof(*found) * PLAYLIST_CHUNK);
+	bool scanning = found != NULL;
+
+	thread_mutex_lock(&p->lock);
+	while (!p->quit) {
+		size_t i;
+		if (playlist_wanted(p, &i)) {
+			p->state[i] = PLAYLIST_LOADING;
+			const char *path = p->paths[i];
+			thread_mutex_unlock(&p->lock);
+
+			struct playlist_done d = { .index = i };
+			struct lint_png png;
+			if (!lint_peek(path, &png))
+				d.source = LoadFileData(path, &d.size);
+			if (d.source)
+				d.image = residency_decode(d.source, d.size);
+
+			thread_mutex_lock(&p->lock);
+			if (p->ndone == p->donecap) {
+				size_t cap = p->donecap ? p->donecap * 2 : 16;
+				struct playlist_done *grown = realloc(p->done,
+					sizeof(*grown) * cap);
+				if (grown) {
+					p->done = grown;
+					p->donecap = cap;
+				}
+			}
+			if (p->ndone < p->donecap) {
+				p->done[p->ndone++] = d;
+			} else {
+				UnloadFileData(d.source);
+				palette_free(&d.image);
+				p->state[i] = PLAYLIST_IDLE;
+			}
+			continue;
+		}
+
+		if (scanning) {
+			size_t n;
+			thread_mutex_unlock(&p->lock);
+			scanning = playlist_scan(p, found, &n);
+			thread_mutex_lock(&p->lock);
+			for (size_t k = 0; k < n; k++) {
+				if (found[k])
+					playlist_add(p, found[k]);
+			}
+			continue;
+		}
+		thread_cond_wait(&p->wake, &p->lock);
+	}
+	thread_mutex_unlock(&p->lock);
+	free(found);
+}
+
+/* Starts a playlist of the skin files and directories in paths */
+struct playlist *
+playlist_new(char **paths, size_t count)
+{
+	struct playlist *p = calloc(1, sizeof(*p));
+	if (!p)
+		return NULL;
+	p->dirs = calloc(count, sizeof(*p->dirs));
+	if (!p->dirs) {
+		free(p);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (DirectoryExists(paths[i]))
+			p->dirs[p->ndirs++] = strdup(paths[i]);
+		else if (skin_file_name(paths[i]))
+			playlist_add(p, strdup(paths[i]));
+	}
+
+	thread_mutex_init(&p->lock);
+	thread_cond_init(&p->wake);
+	if (!thread_start(&p->thread, playlist_main, p)) {
+		thread_cond_destroy(&p->wake);
+		thread_mutex_destroy(&p->lock);
+		for (size_t i = 0; i < p->count; i++)
+			free(p->paths[i]);
+		for (size_t i = 0; i < p->ndirs; i++)
+			free(p->dirs[i]);
+		free(p->paths);
+		free(p->state);
+		free(p->dirs);
+		free(p);
+		return NULL;
+	}
+	return p;
+}
+
+void
+playlist_free(struct playlist *p)
+{
+	if (!p)
+		return;
+
+	thread_mutex_lock(&p->lock);
+	p->quit = true;
+	thread_cond_signal(&p->wake);
+	thread_mutex_unlock(&p->lock);
+	thread_join(p->thread);
+
+	index_close(&p->index);
+#if defined(_MSC_VER)
+	UnloadDirectoryFiles(p->listing);
+#else
+	if (p->handle)
+		closedir(p->handle);
+#endif
+	for (size_t i = 0; i < p->ndone; i++) {
+		UnloadFileData(p->done[i].source);
+		palette_free(&p->done[i].image);
+	}
+	for (size_t i = 0; i < p->count; i++)
+		free(p->paths[i]);
+	for (size_t i = 0; i < p->ndirs; i++)
+		free(p->dirs[i]);
+	thread_cond_destroy(&p->wake);
+	thread_mutex_destroy(&p->lock);
+	free(p->done);
+	free(p->paths);
+	free(p->state);
+	free(p->dirs);
+	free(p);
+}
+
+/* Hands finished loads to res and uploads them. Returns the entry count. */
+size_t
+playlist_poll(struct playlist *p, struct residency *res)
+{
+	thread_mutex_lock(&p->lock);
+	struct playlist_done *done = p->done;
+	size_t ndone = p->ndone;
+	size_t count = p->count;
+	p->done = NULL;
+	p->ndone = p->donecap = 0;
+	thread_mutex_unlock(&p->lock);
+
+	for (size_t i = 0; i < ndone; i++) {
+		struct playlist_done *d = &done[i];
+		thread_mutex_lock(&p->lock);
+		const char *path = p->paths[d->index];
+		p->state[d->index] = PLAYLIST_LOADED;
+		bool near = d->index + PLAYLIST_AHEAD >= p->cursor
+			&& d->index <= p->cursor + PLAYLIST_AHEAD;
+		thread_mutex_unlock(&p->lock);
+
+		if (!d->image.data) {
+			UnloadFileData(d->source);
+			continue;
+		}
+		struct resident *e = residency_adopt(res, path, d->source,
+			d->size, d->image);
+		if (e) {
+			e->pinned = e->pinned || near;
+			residency_texture(res, e);
+		}
+	}
+	free(done);
+	return count;
+}
+
+/* Path of entry i, valid until playlist_free */
+const char *
+playlist_path(struct playlist *p, size_t i)
+{
+	thread_mutex_lock(&p->lock);
+	const char *path = i < p->count ? p->paths[i] : NULL;
+	thread_mutex_unlock(&p->lock);
+	return path;
+}
+
+/* Moves the cursor to i and pins the entries around it in res, unpinning
+ * everything else */
+void
+playlist_seek(struct playlist *p, size_t i, struct residency *res)
+{
+	thread_mutex_lock(&p->lock);
+	p->cursor = i;
+	thread_cond_signal(&p->wake);
+
+	for (size_t k = 0; k < res->count; k++)
+		res->items[k]->pinned = false;
+	size_t lo = i > PLAYLIST_AHEAD ? i - PLAYLIST_AHEAD : 0;
+	for (size_t k = lo; k <= i + PLAYLIST_AHEAD && k < p->count; k++) {
+		struct resident *e = residency_find(res, p->paths[k]);
+		if (e)
+			e->pinned = true;
+	}
+	thread_mutex_unlock(&p->lock);
+}
+
+#endif /* PLAYLIST_H */
@@ -0,0 +1,955 @@
+#ifndef PNG_H
+#define PNG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) \
+		|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PNG_SSE2
+#include <emmintrin.h>
+#endif
+
+/* A PNG encoder for what we export: small RGBA renders and avatars with
+ * big flat or transparent areas. Rows get the usual adaptive filter (the
+ * one whose bytes have the smallest sum of magnitudes, all five computed
+ * together, with SSE2 where there is one); the zlib stream behind them
+ * is made at one of a few efforts:
+ *
+ * - store: no filtering, stored deflate blocks. Fastest, and as big as
+ *   the pixels.
+ * - rle: repeats of the previous byte or pixel only. Filtered flat areas
+ *   are long runs of zeros, so this gets most of the way for our images.
+ * - fast: one hash probe per byte on top of rle.
+ * - small: hash chains with lazy matching.
+ *
+ * Each block is written with dynamic codes, the fixed ones or stored,
+ * whichever is smallest. All buffers live in a struct png_scratch that is
+ * reused from call to call, one per thread; call png_init() once first. */
+
+enum png_effort {
+	PNG_STORE = 0,
+	PNG_RLE,
+	PNG_FAST,
+	PNG_SMALL,
+	PNG_EFFORT_COUNT,
+};
+
+const char *png_effort_names[] = {
+	[PNG_STORE] = "store",
+	[PNG_RLE]   = "rle",
+	[PNG_FAST]  = "fast",
+	[PNG_SMALL] = "small",
+};
+
+/* The effort named name, false if there is none */
+bool
+png_effort_parse(const char *name, enum png_effort *effort)
+{
+	for (int e = 0; e < PNG_EFFORT_COUNT; e++) {
+		if (!strcmp(name, png_effort_names[e])) {
+			*effort = (enum png_effort)e;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+#define PNG_WINDOW 32768
+#define PNG_MIN_MATCH 3
+#define PNG_MAX_MATCH 258
+#define PNG_BLOCK_SYMBOLS 32768
+#define PNG_HASH_BITS 15
+#define PNG_CHAIN 32 /* candidates tried per byte at PNG_SMALL */
+
+struct png_scratch {
+	unsigned char *filtered; /* filter byte and filtered row, each row */
+	size_t filtered_cap;
+	unsigned char *rows;     /* padded current and prior row, candidates */
+	size_t rows_cap;
+	unsigned char *out;
+	size_t out_cap;
+	uint32_t *head;          /* position + 1 of the last use of a hash */
+	uint32_t *prev;          /* position + 1 of the previous one */
+	uint32_t *symbols;       /* literal, or 1 << 31 | length << 16 | dist */
+};
+
+uint32_t png_crc_table[4][256];
+uint8_t png_len_symbol[PNG_MAX_MATCH + 1]; /* minus 257 */
+uint8_t png_dist_symbol[512];
+
+static const uint16_t png_len_base[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+static const uint8_t png_len_extra[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+static const uint16_t png_dist_base[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+	8193, 12289, 16385, 24577,
+};
+static const uint8_t png_dist_extra[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+void
+png_init(void)
+{
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t c = i;
+		for (int k = 0; k < 8; k++)
+			c = c >> 1 ^ (0xedb88320u & (0u - (c & 1)));
+		png_crc_table[0][i] = c;
+	}
+	for (size_t i = 0; i < 256; i++) {
+		for (size_t t = 1; t < 4; t++) {
+			const uint32_t c = png_crc_table[t - 1][i];
+			png_crc_table[t][i] = c >> 8 ^ png_crc_table[0][c & 255];
+		}
+	}
+
+	for (uint8_t s = 0; s < 29; s++) {
+		const unsigned end = s == 28 ? PNG_MAX_MATCH + 1
+			: png_len_base[s + 1];
+		for (unsigned len = png_len_base[s]; len < end; len++)
+			png_len_symbol[len] = s;
+	}
+	/* Distances up to 256 directly, longer ones by (dist - 1) >> 7 */
+	for (uint8_t s = 0; s < 30; s++) {
+		const unsigned end = s == 29 ? PNG_WINDOW + 1 : png_dist_base[s + 1];
+		for (unsigned d = png_dist_base[s]; d < end; d++) {
+			if (d <= 256)
+				png_dist_symbol[d - 1] = s;
+			else
+				png_dist_symbol[256 + ((d - 1) >> 7)] = s;
+		}
+	}
+}
+
+static uint32_t
+png_crc(uint32_t crc, const unsigned char *p, size_t len)
+{
+	crc = ~crc;
+	for (; len >= 4; len -= 4, p += 4) {
+		crc ^= (uint32_t)p[0] | (uint32_t)p[1] << 8
+			| (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+		crc = png_crc_table[3][crc & 255]
+			^ png_crc_table[2][crc >> 8 & 255]
+			^ png_crc_table[1][crc >> 16 & 255]
+			^ png_crc_table[0][crc >> 24];
+	}
+	while (len--)
+		crc = crc >> 8 ^ png_crc_table[0][(crc ^ *p++) & 255];
+	return ~crc;
+}
+
+static uint32_t
+png_adler(const unsigned char *p, size_t len)
+{
+	uint32_t a = 1, b = 0;
+	while (len) {
+		/* The most bytes before b can overflow */
+		size_t n = len < 5552 ? len : 5552;
+		len -= n;
+		for (; n >= 4; n -= 4, p += 4) {
+			a += p[0];
+			b += a;
+			a += p[1];
+			b += a;
+			a += p[2];
+			b += a;
+			a += p[3];
+			b += a;
+		}
+		while (n--) {
+			a += *p++;
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	return b << 16 | a;
+}
+
+static unsigned
+png_dist_code(unsigned dist)
+{
+	return dist <= 256 ? png_dist_symbol[dist - 1]
+		: png_dist_symbol[256 + ((dist - 1) >> 7)];
+}
+
+static bool
+png_reserve(unsigned char **p, size_t *cap, size_t need)
+{
+	if (*cap >= need)
+		return 1;
+	unsigned char *grown = realloc(*p, need);
+	if (!grown)
+		return 0;
+	*p = grown;
+	*cap = need;
+	return 1;
+}
+
+void
+png_scratch_free(struct png_scratch *s)
+{
+	free(s->filtered);
+	free(s->rows);
+	free(s->out);
+	free(s->head);
+	free(s->prev);
+	free(s->symbols);
+	*s = (struct png_scratch){ 0 };
+}
+
+/* Filtering. cur and up point at the current and prior row, each with
+ * four zero bytes in front for the pixel left of the first one. */
+
+static unsigned char
+png_paeth(unsigned char a, unsigned char b, unsigned char c)
+{
+	const int p = a + b - c;
+	const int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+	return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+static unsigned
+png_magnitude(unsigned char v)
+{
+	return v < 128 ? v : 256u - v;
+}
+
+static void
+png_filter_scalar(const unsigned char *cur, const unsigned char *up,
+	size_t from, size_t stride, unsigned char *cand[5], uint64_t score[5])
+{
+	for (size_t x = from; x < stride; x++) {
+		const unsigned char v = cur[x], a = cur[x - 4];
+		const unsigned char b = up[x], c = up[x - 4];
+		const unsigned char f[5] = {
+			v,
+			(unsigned char)(v - a),
+			(unsigned char)(v - b),
+			(unsigned char)(v - ((a + b) >> 1)),
+			(unsigned char)(v - png_paeth(a, b, c)),
+		};
+		for (size_t k = 0; k < 5; k++) {
+			cand[k][x] = f[k];
+			score[k] += png_magnitude(f[k]);
+		}
+	}
+}
+
+#if defined(PNG_SSE2)
+static __m128i
+png_sum_magnitudes(__m128i v)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i m = _mm_min_epu8(v, _mm_sub_epi8(zero, v));
+	return _mm_sad_epu8(m, zero);
+}
+
+/* Paeth predictor of 8 pixels' worth of bytes widened to 16 bits */
+static __m128i
+png_paeth16(__m128i a, __m128i b, __m128i c)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bc = _mm_sub_epi16(b, c), ac = _mm_sub_epi16(a, c);
+	const __m128i abc = _mm_add_epi16(bc, ac);
+	const __m128i pa = _mm_max_epi16(bc, _mm_sub_epi16(zero, bc));
+	const __m128i pb = _mm_max_epi16(ac, _mm_sub_epi16(zero, ac));
+	const __m128i pc = _mm_max_epi16(abc, _mm_sub_epi16(zero, abc));
+	const __m128i not_a = _mm_or_si128(_mm_cmpgt_epi16(pa, pb),
+		_mm_cmpgt_epi16(pa, pc));
+	const __m128i not_b = _mm_cmpgt_epi16(pb, pc);
+	const __m128i bc_pick = _mm_or_si128(_mm_and_si128(not_b, c),
+		_mm_andnot_si128(not_b, b));
+	return _mm_or_si128(_mm_and_si128(not_a, bc_pick),
+		_mm_andnot_si128(not_a, a));
+}
+#endif
+
+static void
+png_filter_row(const unsigned char *cur, const unsigned char *up,
+	size_t stride, unsigned char *cand[5], uint64_t score[5])
+{
+	size_t x = 0;
+	memset(score, 0, 5 * sizeof(*score));
+#if defined(PNG_SSE2)
+	const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi8(1);
+	__m128i sum[5];
+	for (size_t k = 0; k < 5; k++)
+		sum[k] = zero;
+	for (; x + 16 <= stride; x += 16) {
+		const __m128i v = _mm_loadu_si128((const __m128i *)(cur + x));
+		const __m128i a = _mm_loadu_si128((const __m128i *)(cur + x - 4));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(up + x));
+		const __m128i c = _mm_loadu_si128((const __m128i *)(up + x - 4));
+
+		/* _mm_avg_epu8() rounds up, the filter rounds down */
+		const __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+			_mm_and_si128(_mm_xor_si128(a, b), one));
+		const __m128i paeth = _mm_packus_epi16(
+			png_paeth16(_mm_unpacklo_epi8(a, zero),
+				_mm_unpacklo_epi8(b, zero),
+				_mm_unpacklo_epi8(c, zero)),
+			png_paeth16(_mm_unpackhi_epi8(a, zero),
+				_mm_unpackhi_epi8(b, zero),
+				_mm_unpackhi_epi8(c, zero)));
+		const __m128i f[5] = {
+			v,
+			_mm_sub_epi8(v, a),
+			_mm_sub_epi8(v, b),
+			_mm_sub_epi8(v, avg),
+			_mm_sub_epi8(v, paeth),
+		};
+		for (size_t k = 0; k < 5; k++) {
+			_mm_storeu_si128((__m128i *)(cand[k] + x), f[k]);
+			sum[k] = _mm_add_epi64(sum[k], png_sum_magnitudes(f[k]));
+		}
+	}
+	for (size_t k = 0; k < 5; k++) {
+		uint64_t lanes[2];
+		_mm_storeu_si128((__m128i *)lanes, sum[k]);
+		score[k] = lanes[0] + lanes[1];
+	}
+#endif
+	png_filter_scalar(cur, up, x, stride, cand, score);
+}
+
+/* Fills s->filtered with the filtered rows, the zlib payload */
+static bool
+png_filter(struct png_scratch *s, const unsigned char *pixels, size_t stride,
+	size_t height, bool adaptive)
+{
+	const size_t pad = stride + 4;
+	if (!png_reserve(&s->filtered, &s->filtered_cap, (stride + 1) * height)
+			|| !png_reserve(&s->rows, &s->rows_cap, pad * 7))
+		return 0;
+
+	unsigned char *out = s->filtered;
+	if (!adaptive) {
+		for (size_t y = 0; y < height; y++, out += stride + 1) {
+			out[0] = 0;
+			memcpy(out + 1, pixels + y * stride, stride);
+		}
+		return 1;
+	}
+
+	unsigned char *cur = s->rows + 4, *up = s->rows + pad + 4;
+	unsigned char *cand[5];
+	for (size_t k = 0; k < 5; k++)
+		cand[k] = s->rows + pad * (2 + k);
+	memset(s->rows, 0, pad * 2);
+	for (size_t y = 0; y < height; y++, out += stride + 1) {
+		memcpy(cur, pixels + y * stride, stride);
+		uint64_t score[5];
+		png_filter_row(cur, up, stride, cand, score);
+
+		size_t best = 0;
+		for (size_t k = 1; k < 5; k++) {
+			if (score[k] < score[best])
+				best = k;
+		}
+		out[0] = (unsigned char)best;
+		memcpy(out + 1, cand[best], stride);
+
+		unsigned char *t = cur;
+		cur = up;
+		up = t;
+	}
+	return 1;
+}
+
+/* Huffman codes */
+
+struct png_bits {
+	unsigned char *out;
+	size_t len;
+	uint64_t bits;
+	unsigned nbits;
+};
+
+/* At most 16 bits at a time, written out 32 at a time */
+static void
+png_put(struct png_bits *w, uint32_t bits, unsigned n)
+{
+	w->bits |= (uint64_t)bits << w->nbits;
+	w->nbits += n;
+	if (w->nbits >= 32) {
+		unsigned char *o = w->out + w->len;
+		o[0] = (unsigned char)w->bits;
+		o[1] = (unsigned char)(w->bits >> 8);
+		o[2] = (unsigned char)(w->bits >> 16);
+		o[3] = (unsigned char)(w->bits >> 24);
+		w->len += 4;
+		w->bits >>= 32;
+		w->nbits -= 32;
+	}
+}
+
+/* Pads to a byte and writes out everything */
+static void
+png_align(struct png_bits *w)
+{
+	w->nbits = (w->nbits + 7) & ~7u;
+	for (; w->nbits; w->nbits -= 8) {
+		w->out[w->len++] = (unsigned char)w->bits;
+		w->bits >>= 8;
+	}
+}
+
+/* Code lengths of at most limit bits for n symbols with these frequencies:
+ * minimum redundancy lengths (Moffat and Katajainen, in place), then the
+ * longest codes shortened the way zlib and miniz do it */
+static void
+png_lengths(const uint32_t *freq, unsigned n, unsigned limit, uint8_t *len)
+{
+	uint32_t sym[288];
+	int a[288];
+	unsigned m = 0;
+	memset(len, 0, n);
+	for (unsigned i = 0; i < n; i++) {
+		if (freq[i])
+			sym[m++] = i;
+	}
+	if (!m)
+		return;
+	if (m == 1) {
+		len[sym[0]] = 1;
+		return;
+	}
+
+	/* Insertion sort by frequency; at most a few hundred symbols */
+	for (unsigned i = 1; i < m; i++) {
+		const uint32_t t = sym[i];
+		unsigned j = i;
+		for (; j && freq[sym[j - 1]] > freq[t]; j--)
+			sym[j] = sym[j - 1];
+		sym[j] = t;
+	}
+	for (unsigned i = 0; i < m; i++)
+		a[i] = (int)freq[sym[i]];
+
+	const int count = (int)m;
+	int root = 0, leaf = 2, next;
+	a[0] += a[1];
+	for (next = 1; next < count - 1; next++) {
+		if (leaf >= count || a[root] < a[leaf]) {
+			a[next] = a[root];
+			a[root++] = next;
+		} else {
+			a[next] = a[leaf++];
+		}
+		if (leaf >= count || (root < next && a[root] < a[leaf])) {
+			a[next] += a[root];
+			a[root++] = next;
+		} else {
+			a[next] += a[leaf++];
+		}
+	}
+	a[count - 2] = 0;
+	for (next = count - 3; next >= 0; next--)
+		a[next] = a[a[next]] + 1;
+	int avail = 1, used = 0, depth = 0;
+	root = count - 2;
+	next = count - 1;
+	while (avail > 0) {
+		while (root >= 0 && a[root] == depth) {
+			used++;
+			root--;
+		}
+		while (avail > used) {
+			a[next--] = depth;
+			avail--;
+		}
+		avail = 2 * used;
+		depth++;
+		used = 0;
+	}
+
+	unsigned num[33] = { 0 };
+	for (unsigned i = 0; i < m; i++)
+		num[a[i] < (int)limit ? a[i] : (int)limit]++;
+	uint32_t kraft = 0;
+	for (unsigned l = 1; l <= limit; l++)
+		kraft += num[l] << (limit - l);
+	while (kraft > 1u << limit) {
+		num[limit]--;
+		for (unsigned l = limit - 1; l; l--) {
+			if (num[l]) {
+				num[l]--;
+				num[l + 1] += 2;
+				break;
+			}
+		}
+		kraft--;
+	}
+
+	/* Least frequent symbols get the longest codes */
+	unsigned i = 0;
+	for (unsigned l = limit; l; l--) {
+		for (unsigned k = 0; k < num[l]; k++)
+			len[sym[i++]] = (uint8_t)l;
+	}
+}
+
+/* Canonical codes for len, bit reversed since deflate sends them from the
+ * top bit down */
+static void
+png_codes(const uint8_t *len, unsigned n, uint16_t *code)
+{
+	unsigned count[16] = { 0 }, next[16];
+	for (unsigned i = 0; i < n; i++)
+		count[len[i]]++;
+	count[0] = 0;
+	unsigned c = 0;
+	for (unsigned l = 1; l < 16; l++) {
+		c = (c + count[l - 1]) << 1;
+		next[l] = c;
+	}
+	for (unsigned i = 0; i < n; i++) {
+		if (!len[i])
+			continue;
+		unsigned v = next[len[i]]++, r = 0;
+		for (unsigned b = 0; b < len[i]; b++)
+			r |= (v >> b & 1) << (len[i] - 1 - b);
+		code[i] = (uint16_t)r;
+	}
+}
+
+struct png_block {
+	uint32_t lit_freq[286], dist_freq[30];
+	uint8_t lit_len[288], dist_len[30];
+	uint16_t lit_code[288], dist_code[30];
+	/* Code lengths of both alphabets, run length coded */
+	uint8_t cl_sym[286 + 30], cl_extra[286 + 30];
+	unsigned ncl, nlit, ndist, nclen;
+	uint32_t cl_freq[19];
+	uint8_t cl_len[19];
+	uint16_t cl_code[19];
+};
+
+static const uint8_t png_cl_order[19] = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+};
+
+static void
+png_fixed_lengths(uint8_t lit[288], uint8_t dist[30])
+{
+	memset(lit, 8, 144);
+	memset(lit + 144, 9, 112);
+	memset(lit + 256, 7, 24);
+	memset(lit + 280, 8, 8);
+	memset(dist, 5, 30);
+}
+
+/* Bits the symbols take with these lengths, headers aside */
+static uint64_t
+png_cost(const struct png_block *b, const uint8_t *lit, const uint8_t *dist)
+{
+	uint64_t bits = 0;
+	for (unsigned i = 0; i < 286; i++)
+		bits += (uint64_t)b->lit_freq[i]
+			* (lit[i] + (i > 256 ? png_len_extra[i - 257] : 0u));
+	for (unsigned i = 0; i < 30; i++)
+		bits += (uint64_t)b->dist_freq[i] * (dist[i] + png_dist_extra[i]);
+	return bits;
+}
+
+/* Dynamic code lengths for the block and what their header costs */
+static uint64_t
+png_dynamic(struct png_block *b)
+{
+	png_lengths(b->lit_freq, 286, 15, b->lit_len);
+	b->lit_len[286] = b->lit_len[287] = 0;
+	png_lengths(b->dist_freq, 30, 15, b->dist_len);
+	/* A block with no matches still needs one distance code */
+	bool any = false;
+	for (unsigned i = 0; i < 30; i++)
+		any |= b->dist_len[i] != 0;
+	if (!any)
+		b->dist_len[0] = 1;
+
+	b->nlit = 286;
+	while (b->nlit > 257 && !b->lit_len[b->nlit - 1])
+		b->nlit--;
+	b->ndist = 30;
+	while (b->ndist > 1 && !b->dist_len[b->ndist - 1])
+		b->ndist--;
+
+	uint8_t lens[286 + 30];
+	const unsigned total = b->nlit + b->ndist;
+	memcpy(lens, b->lit_len, b->nlit);
+	memcpy(lens + b->nlit, b->dist_len, b->ndist);
+	memset(b->cl_freq, 0, sizeof(b->cl_freq));
+	b->ncl = 0;
+	for (unsigned i = 0; i < total;) {
+		const uint8_t l = lens[i];
+		unsigned run = 1;
+		while (i + run < total && lens[i + run] == l)
+			run++;
+		i += run;
+		if (!l) {
+			while (run >= 11) {
+				const unsigned r = run < 138 ? run : 138;
+				b->cl_sym[b->ncl] = 18;
+				b->cl_extra[b->ncl++] = (uint8_t)(r - 11);
+				run -= r;
+			}
+			if (run >= 3) {
+				b->cl_sym[b->ncl] = 17;
+				b->cl_extra[b->ncl++] = (uint8_t)(run - 3);
+				run = 0;
+			}
+		} else {
+			b->cl_sym[b->ncl++] = l;
+			run--;
+			while (run >= 3) {
+				const unsigned r = run < 6 ? run : 6;
+				b->cl_sym[b->ncl] = 16;
+				b->cl_extra[b->ncl++] = (uint8_t)(r - 3);
+				run -= r;
+			}
+		}
+		while (run--)
+			b->cl_sym[b->ncl++] = l;
+	}
+	for (unsigned i = 0; i < b->ncl; i++)
+		b->cl_freq[b->cl_sym[i]]++;
+
+	/* zlib wants this one code complete, which takes two symbols */
+	unsigned used = 0;
+	for (unsigned i = 0; i < 19; i++)
+		used += b->cl_freq[i] != 0;
+	if (used < 2)
+		b->cl_freq[b->cl_freq[0] ? 1 : 0] = 1;
+	png_lengths(b->cl_freq, 19, 7, b->cl_len);
+
+	b->nclen = 19;
+	while (b->nclen > 4 && !b->cl_len[png_cl_order[b->nclen - 1]])
+		b->nclen--;
+
+	uint64_t bits = 5 + 5 + 4 + 3 * (uint64_t)b->nclen;
+	for (unsigned i = 0; i < b->ncl; i++) {
+		const uint8_t s = b->cl_sym[i];
+		bits += b->cl_len[s] + (s == 16 ? 2u : s == 17 ? 3u : s == 18 ? 7u : 0u);
+	}
+	return bits;
+}
+
+static void
+png_put_symbols(struct png_bits *w, const uint32_t *symbols, size_t n,
+	const struct png_block *b)
+{
+	for (size_t i = 0; i < n; i++) {
+		const uint32_t s = symbols[i];
+		if (!(s >> 31)) {
+			png_put(w, b->lit_code[s], b->lit_len[s]);
+			continue;
+		}
+		const unsigned len = s >> 16 & 511, dist = s & 0xffff;
+		const unsigned ls = png_len_symbol[len], ds = png_dist_code(dist);
+		png_put(w, b->lit_code[257 + ls], b->lit_len[257 + ls]);
+		png_put(w, len - png_len_base[ls], png_len_extra[ls]);
+		png_put(w, b->dist_code[ds], b->dist_len[ds]);
+		png_put(w, dist - png_dist_base[ds], png_dist_extra[ds]);
+	}
+}
+
+static void
+png_stored(struct png_bits *w, const unsigned char *data, size_t from,
+	size_t to, bool last)
+{
+	size_t at = from;
+	do {
+		const size_t part = to - at < 65535 ? to - at : 65535;
+		png_put(w, last && at + part == to, 1);
+		png_put(w, 0, 2);
+		png_align(w);
+		png_put(w, (uint32_t)part, 16);
+		png_put(w, (uint32_t)part ^ 0xffff, 16);
+		memcpy(w->out + w->len, data + at, part);
+		w->len += part;
+		at += part;
+	} while (at < to);
+}
+
+/* Writes data[from, to) as one block, coded as symbols, taking whichever
+ * of dynamic, fixed and stored is smallest */
+static void
+png_block(struct png_bits *w, struct png_block *b, const uint32_t *symbols,
+	size_t n, const unsigned char *data, size_t from, size_t to, bool last)
+{
+	b->lit_freq[256]++;
+	const uint64_t dynamic = 3 + png_dynamic(b)
+		+ png_cost(b, b->lit_len, b->dist_len);
+	uint8_t fixed_lit[288], fixed_dist[30];
+	png_fixed_lengths(fixed_lit, fixed_dist);
+	const uint64_t fixed = 3 + png_cost(b, fixed_lit, fixed_dist);
+	const size_t len = to - from;
+	const uint64_t stored = (len / 65535 + 1) * 40 + 7 + (uint64_t)len * 8;
+
+	if (stored <= dynamic && stored <= fixed) {
+		png_stored(w, data, from, to, last);
+		return;
+	}
+
+	png_put(w, last, 1);
+	if (fixed <= dynamic) {
+		memcpy(b->lit_len, fixed_lit, sizeof(fixed_lit));
+		memcpy(b->dist_len, fixed_dist, sizeof(fixed_dist));
+		png_put(w, 1, 2);
+	} else {
+		png_put(w, 2, 2);
+		png_put(w, b->nlit - 257, 5);
+		png_put(w, b->ndist - 1, 5);
+		png_put(w, b->nclen - 4, 4);
+		for (unsigned i = 0; i < b->nclen; i++)
+			png_put(w, b->cl_len[png_cl_order[i]], 3);
+		png_codes(b->cl_len, 19, b->cl_code);
+		for (unsigned i = 0; i < b->ncl; i++) {
+			const uint8_t s = b->cl_sym[i];
+			png_put(w, b->cl_code[s], b->cl_len[s]);
+			if (s >= 16)
+				png_put(w, b->cl_extra[i], s == 16 ? 2 : s == 17 ? 3 : 7);
+		}
+	}
+	png_codes(b->lit_len, 288, b->lit_code);
+	png_codes(b->dist_len, 30, b->dist_code);
+	png_put_symbols(w, symbols, n, b);
+	png_put(w, b->lit_code[256], b->lit_len[256]);
+}
+
+/* Matching */
+
+static unsigned
+png_match_len(const unsigned char *data, size_t at, size_t ref, size_t end)
+{
+	size_t max = end - at < PNG_MAX_MATCH ? end - at : PNG_MAX_MATCH;
+	size_t n = 0;
+	for (; n + 8 <= max; n += 8) {
+		uint64_t x, y;
+		memcpy(&x, data + at + n, 8);
+		memcpy(&y, data + ref + n, 8);
+		if (x != y)
+			break;
+	}
+	while (n < max && data[at + n] == data[ref + n])
+		n++;
+	return (unsigned)n;
+}
+
+static uint32_t
+png_hash(const unsigned char *p, unsigned bits)
+{
+	const uint32_t v = (uint32_t)p[0] | (uint32_t)p[1] << 8
+		| (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+	return v * 2654435761u >> (32 - bits);
+}
+
+/* Longest match at i: a repeat of the last byte or pixel, and past effort
+ * rle the hashed candidates too */
+static unsigned
+png_find(struct png_scratch *s, const unsigned char *data, size_t i,
+	size_t n, enum png_effort effort, unsigned bits, unsigned *dist)
+{
+	unsigned best = 0;
+	*dist = 0;
+	if (i >= 1) {
+		best = png_match_len(data, i, i - 1, n);
+		*dist = 1;
+	}
+	if (i >= 4 && best < PNG_MAX_MATCH) {
+		const unsigned len = png_match_len(data, i, i - 4, n);
+		if (len > best) {
+			best = len;
+			*dist = 4;
+		}
+	}
+	if (effort == PNG_RLE || i + 4 > n)
+		return best;
+
+	const uint32_t h = png_hash(data + i, bits);
+	uint32_t cand = s->head[h];
+	s->head[h] = (uint32_t)i + 1;
+	if (effort == PNG_SMALL)
+		s->prev[i % PNG_WINDOW] = cand;
+	const unsigned chain = effort == PNG_SMALL ? PNG_CHAIN : 1;
+	const size_t most = n - i < PNG_MAX_MATCH ? n - i : PNG_MAX_MATCH;
+	for (unsigned k = 0; cand && best < most; ) {
+		const size_t ref = cand - 1;
+		if (i - ref >= PNG_WINDOW)
+			break;
+		if (data[ref + best] == data[i + best]) {
+			const unsigned len = png_match_len(data, i, ref, n);
+			if (len > best) {
+				best = len;
+				*dist = (unsigned)(i - ref);
+			}
+		}
+		if (++k == chain)
+			break;
+		cand = s->prev[ref % PNG_WINDOW];
+	}
+	return best;
+}
+
+/* Hash inserts for the bytes a match covers, so later matches can start
+ * inside it; only small bothers */
+static void
+png_insert(struct png_scratch *s, const unsigned char *data, size_t from,
+	size_t to, size_t n, unsigned bits)
+{
+	for (size_t i = from; i < to && i + 4 <= n; i++) {
+		const uint32_t h = png_hash(data + i, bits);
+		s->prev[i % PNG_WINDOW] = s->head[h];
+		s->head[h] = (uint32_t)i + 1;
+	}
+}
+
+static bool
+png_deflate(struct png_scratch *s, struct png_bits *w, const unsigned char *data,
+	size_t n, enum png_effort effort)
+{
+	if (effort == PNG_STORE) {
+		png_stored(w, data, 0, n, true);
+		return 1;
+	}
+
+	if (!s->symbols)
+		s->symbols = malloc(sizeof(*s->symbols) * PNG_BLOCK_SYMBOLS);
+	if (!s->head)
+		s->head = malloc(sizeof(*s->head) << PNG_HASH_BITS);
+	if (!s->prev)
+		s->prev = malloc(sizeof(*s->prev) * PNG_WINDOW);
+	if (!s->symbols || !s->head || !s->prev)
+		return 0;
+
+	/* A table about the size of the input is cheaper to clear */
+	unsigned bits = 10;
+	while (bits < PNG_HASH_BITS && (size_t)1 << bits < n)
+		bits++;
+	memset(s->head, 0, sizeof(*s->head) << bits);
+
+	struct png_block b;
+	size_t i = 0;
+	do {
+		const size_t from = i;
+		size_t count = 0;
+		memset(b.lit_freq, 0, sizeof(b.lit_freq));
+		memset(b.dist_freq, 0, sizeof(b.dist_freq));
+		while (i < n && count < PNG_BLOCK_SYMBOLS) {
+			unsigned dist, len = png_find(s, data, i, n, effort, bits,
+				&dist);
+			size_t inserted = i + 1;
+			if (len >= PNG_MIN_MATCH && effort == PNG_SMALL
+					&& len < PNG_MAX_MATCH && i + 1 < n) {
+				/* Lazy: a longer match one byte on wins */
+				unsigned dist2;
+				const unsigned len2 = png_find(s, data, i + 1, n, effort,
+					bits, &dist2);
+				inserted = i + 2;
+				if (len2 > len && count + 1 < PNG_BLOCK_SYMBOLS) {
+					s->symbols[count++] = data[i];
+					b.lit_freq[data[i]]++;
+					i++;
+					len = len2;
+					dist = dist2;
+				}
+			}
+			if (len >= PNG_MIN_MATCH && effort == PNG_SMALL)
+				png_insert(s, data, inserted, i + len, n, bits);
+
+			if (len < PNG_MIN_MATCH) {
+				s->symbols[count++] = data[i];
+				b.lit_freq[data[i]]++;
+				i++;
+				continue;
+			}
+			s->symbols[count++] = 1u << 31 | len << 16 | dist;
+			b.lit_freq[257 + png_len_symbol[len]]++;
+			b.dist_freq[png_dist_code(dist)]++;
+			i += len;
+		}
+		png_block(w, &b, s->symbols, count, data, from, i, i == n);
+	} while (i < n);
+	return 1;
+}
+
+/* PNG file */
+
+static void
+png_be32(unsigned char *p, uint32_t v)
+{
+	p[0] = (unsigned char)(v >> 24);
+	p[1] = (unsigned char)(v >> 16);
+	p[2] = (unsigned char)(v >> 8);
+	p[3] = (unsigned char)v;
+}
+
+/* Encodes RGBA8 pixels. Returns the file in s, valid until the next call
+ * with s, or NULL if out of memory. */
+const unsigned char *
+png_encode(struct png_scratch *s, const void *pixels, int width, int height,
+	enum png_effort effort, size_t *size)
+{
+	if (width < 1 || height < 1 || effort >= PNG_EFFORT_COUNT)
+		return NULL;
+	const size_t stride = (size_t)width * 4, h = (size_t)height;
+	if (!png_filter(s, pixels, stride, h, effort != PNG_STORE))
+		return NULL;
+	const size_t n = (stride + 1) * h;
+
+	/* No block is written bigger than stored, which costs 5 bytes per
+	 * 65535 and a byte to align; blocks hold at least 32768 bytes */
+	const size_t bound = 8 + 25 + 8 + 2 + n + (n / 8192 + 4) * 8 + 4 + 4
+		+ 12;
+	if (!png_reserve(&s->out, &s->out_cap, bound))
+		return NULL;
+
+	unsigned char *o = s->out;
+	static const unsigned char sig[8] = {
+		0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n',
+	};
+	memcpy(o, sig, 8);
+	png_be32(o + 8, 13);
+	memcpy(o + 12, "IHDR", 4);
+	png_be32(o + 16, (uint32_t)width);
+	png_be32(o + 20, (uint32_t)height);
+	memcpy(o + 24, (const unsigned char[]){ 8, 6, 0, 0, 0 }, 5);
+	png_be32(o + 29, png_crc(0, o + 12, 17));
+
+	/* IDAT: zlib header, deflate stream, Adler-32 */
+	struct png_bits w = { .out = o + 41, .len = 0 };
+	static const unsigned char level[PNG_EFFORT_COUNT] = {
+		0x01, 0x5e, 0x9c, 0xda,
+	};
+	w.out[w.len++] = 0x78;
+	w.out[w.len++] = level[effort];
+	if (!png_deflate(s, &w, s->filtered, n, effort))
+		return NULL;
+	png_align(&w);
+	png_be32(w.out + w.len, png_adler(s->filtered, n));
+	w.len += 4;
+	png_be32(o + 33, (uint32_t)w.len);
+	memcpy(o + 37, "IDAT", 4);
+	png_be32(o + 41 + w.len, png_crc(0, o + 37, w.len + 4));
+
+	unsigned char *end = o + 41 + w.len + 4;
+	png_be32(end, 0);
+	memcpy(end + 4, "IEND", 4);
+	png_be32(end + 8, png_crc(0, end + 4, 4));
+	*size = (size_t)(end + 12 - o);
+	return o;
+}
+
+#endif /* PNG_H */
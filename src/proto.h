@@ -0,0 +1,104 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Wire protocol between skin-serve and its clients. Requests and responses
+ * are a fixed header followed by length bytes of payload, and may be
+ * pipelined: responses carry the request id and can come back out of order.
+ * Fields are in host byte order, both ends run on the same machine. */
+
+#define PROTO_SOCKET "/tmp/skin-serve.sock"
+#define PROTO_REQUEST_MAGIC 0x514b4e53u  /* "SNKQ" */
+#define PROTO_RESPONSE_MAGIC 0x524b4e53u /* "SNKR" */
+#define PROTO_MAX_PAYLOAD (16u << 20)
+#define PROTO_MAX_SIZE 4096
+
+/* Preset values with this bit set select an orthographic view (enum
+ * ortho_view in the low bits), rendered on the CPU without touching GL */
+#define PROTO_PRESET_ORTHO 0x80u
+
+enum proto_source {
+	PROTO_SOURCE_PNG = 0,  /* payload is the PNG file */
+	PROTO_SOURCE_PATH,     /* payload is a path under the server's -r root */
+	PROTO_SOURCE_COUNT
+};
+
+enum proto_format {
+	PROTO_FORMAT_RGBA = 0, /* payload is width*height*4 bytes, top row first */
+	PROTO_FORMAT_PNG,
+	PROTO_FORMAT_COUNT
+};
+
+enum proto_status {
+	PROTO_OK = 0,
+	PROTO_EREQUEST,
+	PROTO_EREAD,
+	PROTO_EDECODE,
+	PROTO_EENCODE,
+	PROTO_EDENIED, /* path source outside the server's -r root */
+};
+
+struct proto_request {
+	uint32_t magic;
+	uint32_t id;
+	uint8_t source;
+	uint8_t preset;
+	uint8_t format;
+	uint8_t reserved;
+	uint16_t width;
+	uint16_t height;
+	uint32_t length;
+	uint16_t hidden;  /* bit i hides enum model part i */
+	uint16_t reserved2;
+};
+static_assert(sizeof(struct proto_request) == 24, "Request header is padded");
+
+struct proto_response {
+	uint32_t magic;
+	uint32_t id;
+	uint32_t status;
+	uint16_t width;
+	uint16_t height;
+	uint32_t length;
+};
+static_assert(sizeof(struct proto_response) == 20, "Response header is padded");
+
+bool
+read_full(int fd, void *buf, size_t len)
+{
+	unsigned char *p = buf;
+	while (len) {
+		ssize_t n = read(fd, p, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return 0;
+		p += n;
+		len -= (size_t)n;
+	}
+	return 1;
+}
+
+bool
+write_full(int fd, const void *buf, size_t len)
+{
+	const unsigned char *p = buf;
+	while (len) {
+		ssize_t n = write(fd, p, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return 0;
+		p += n;
+		len -= (size_t)n;
+	}
+	return 1;
+}
+
+#endif /* PROTO_H */
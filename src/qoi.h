@@ -0,0 +1,199 @@
+#ifndef QOI_H
+#define QOI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The Quite OK Image format (qoiformat.org), for pipelines where we pick
+ * the interchange format: one pass each way, no entropy coding, at some
+ * cost in size next to PNG. Pixels are always RGBA8 on our side; files
+ * with three channels decode with opaque alpha. Nothing here depends on
+ * raylib, so the bundler can use it too. raylib carries its own copy of
+ * the reference coder, whose qoi_encode/qoi_decode names are taken. */
+
+#define QOI_HEADER 14
+#define QOI_PADDING 8
+#define QOI_MAX_PIXELS 400000000u
+
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xc0
+#define QOI_OP_RGB   0xfe
+#define QOI_OP_RGBA  0xff
+
+static unsigned
+qoi_hash(const unsigned char *px)
+{
+	return (px[0] * 3u + px[1] * 5u + px[2] * 7u + px[3] * 11u) % 64;
+}
+
+static uint32_t
+qoi_be32(const unsigned char *p)
+{
+	return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16
+		| (uint32_t)p[2] << 8 | p[3];
+}
+
+/* Whether data starts like a QOI file, whatever follows */
+bool
+qoi_is(const unsigned char *data, size_t size)
+{
+	return size >= 4 && !memcmp(data, "qoif", 4);
+}
+
+/* Reads the header. False if data is not a QOI file we can decode. */
+bool
+qoi_peek(const unsigned char *data, size_t size, unsigned *width,
+	unsigned *height)
+{
+	if (size < QOI_HEADER + QOI_PADDING || !qoi_is(data, size))
+		return 0;
+	const uint32_t w = qoi_be32(data + 4), h = qoi_be32(data + 8);
+	if (!w || !h || h > QOI_MAX_PIXELS / w
+			|| (data[12] != 3 && data[12] != 4) || data[13] > 1)
+		return 0;
+	*width = w;
+	*height = h;
+	return 1;
+}
+
+/* Decodes a file whose header qoi_peek() accepted into width * height
+ * RGBA8 pixels. False if the stream ends early. */
+bool
+qoi_unpack(const unsigned char *data, size_t size, unsigned char *out)
+{
+	const size_t n = (size_t)qoi_be32(data + 4) * qoi_be32(data + 8);
+	const size_t end = size - QOI_PADDING;
+	unsigned char index[64][4] = { 0 };
+	unsigned char px[4] = { 0, 0, 0, 255 };
+	size_t p = QOI_HEADER;
+	unsigned run = 0;
+
+	for (size_t i = 0; i < n; i++, out += 4) {
+		if (run) {
+			run--;
+			memcpy(out, px, 4);
+			continue;
+		}
+		if (p >= end)
+			return 0;
+		const unsigned op = data[p++];
+		if (op == QOI_OP_RGB) {
+			if (end - p < 3)
+				return 0;
+			memcpy(px, data + p, 3);
+			p += 3;
+		} else if (op == QOI_OP_RGBA) {
+			if (end - p < 4)
+				return 0;
+			memcpy(px, data + p, 4);
+			p += 4;
+		} else if ((op & 0xc0) == QOI_OP_INDEX) {
+			memcpy(px, index[op], 4);
+		} else if ((op & 0xc0) == QOI_OP_DIFF) {
+			px[0] = (unsigned char)(px[0] + (op >> 4 & 3) - 2);
+			px[1] = (unsigned char)(px[1] + (op >> 2 & 3) - 2);
+			px[2] = (unsigned char)(px[2] + (op & 3) - 2);
+		} else if ((op & 0xc0) == QOI_OP_LUMA) {
+			if (p == end)
+				return 0;
+			const unsigned next = data[p++];
+			const unsigned dg = (op & 0x3f) - 32;
+			px[0] = (unsigned char)(px[0] + dg + (next >> 4) - 8);
+			px[1] = (unsigned char)(px[1] + dg);
+			px[2] = (unsigned char)(px[2] + dg + (next & 15) - 8);
+		} else {
+			run = op & 0x3f;
+		}
+		memcpy(index[qoi_hash(px)], px, 4);
+		memcpy(out, px, 4);
+	}
+	return 1;
+}
+
+/* Room qoi_pack() needs at most */
+size_t
+qoi_bound(unsigned width, unsigned height)
+{
+	return QOI_HEADER + (size_t)width * height * 5 + QOI_PADDING;
+}
+
+/* Encodes width * height RGBA8 pixels into out, which holds at least
+ * qoi_bound() bytes. Returns the file size. */
+size_t
+qoi_pack(const unsigned char *pixels, unsigned width, unsigned height,
+	unsigned char *out)
+{
+	const size_t n = (size_t)width * height;
+	unsigned char index[64][4] = { 0 };
+	unsigned char prev[4] = { 0, 0, 0, 255 };
+	unsigned char *o = out;
+	unsigned run = 0;
+
+	memcpy(o, "qoif", 4);
+	const uint32_t dims[2] = { width, height };
+	for (size_t k = 0; k < 2; k++) {
+		o[4 + k * 4] = (unsigned char)(dims[k] >> 24);
+		o[5 + k * 4] = (unsigned char)(dims[k] >> 16);
+		o[6 + k * 4] = (unsigned char)(dims[k] >> 8);
+		o[7 + k * 4] = (unsigned char)dims[k];
+	}
+	o[12] = 4;
+	o[13] = 0;
+	o += QOI_HEADER;
+
+	for (size_t i = 0; i < n; i++) {
+		const unsigned char *px = pixels + i * 4;
+		if (!memcmp(px, prev, 4)) {
+			if (++run == 62) {
+				*o++ = (unsigned char)(QOI_OP_RUN | (run - 1));
+				run = 0;
+			}
+			continue;
+		}
+		if (run) {
+			*o++ = (unsigned char)(QOI_OP_RUN | (run - 1));
+			run = 0;
+		}
+
+		const unsigned h = qoi_hash(px);
+		if (!memcmp(index[h], px, 4)) {
+			*o++ = (unsigned char)(QOI_OP_INDEX | h);
+		} else if (px[3] != prev[3]) {
+			*o++ = QOI_OP_RGBA;
+			memcpy(o, px, 4);
+			o += 4;
+		} else {
+			const int dr = (signed char)(px[0] - prev[0]);
+			const int dg = (signed char)(px[1] - prev[1]);
+			const int db = (signed char)(px[2] - prev[2]);
+			const int dr_dg = dr - dg, db_dg = db - dg;
+			if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1
+					&& db >= -2 && db <= 1) {
+				*o++ = (unsigned char)(QOI_OP_DIFF | (dr + 2) << 4
+					| (dg + 2) << 2 | (db + 2));
+			} else if (dg >= -32 && dg <= 31 && dr_dg >= -8
+					&& dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+				*o++ = (unsigned char)(QOI_OP_LUMA | (dg + 32));
+				*o++ = (unsigned char)((dr_dg + 8) << 4 | (db_dg + 8));
+			} else {
+				*o++ = QOI_OP_RGB;
+				memcpy(o, px, 3);
+				o += 3;
+			}
+		}
+		memcpy(index[h], px, 4);
+		memcpy(prev, px, 4);
+	}
+	if (run)
+		*o++ = (unsigned char)(QOI_OP_RUN | (run - 1));
+
+	static const unsigned char padding[QOI_PADDING] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+	memcpy(o, padding, QOI_PADDING);
+	return (size_t)(o + QOI_PADDING - out);
+}
+
+#endif /* QOI_H */
@@ -0,0 +1,129 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Bounded blocking FIFO of pointers shared between threads. Pushing to a
+ * full queue waits, which is how producers get backpressure. */
+struct queue {
+	void **items;
+	size_t cap;
+	size_t head;
+	size_t count;
+	bool closed;
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+};
+
+bool
+queue_init(struct queue *q, size_t cap)
+{
+	q->items = calloc(cap, sizeof(*q->items));
+	if (!q->items)
+		return 0;
+	q->cap = cap;
+	q->head = 0;
+	q->count = 0;
+	q->closed = 0;
+	pthread_mutex_init(&q->lock, NULL);
+	pthread_cond_init(&q->not_empty, NULL);
+	pthread_cond_init(&q->not_full, NULL);
+	return 1;
+}
+
+void
+queue_free(struct queue *q)
+{
+	pthread_cond_destroy(&q->not_full);
+	pthread_cond_destroy(&q->not_empty);
+	pthread_mutex_destroy(&q->lock);
+	free(q->items);
+}
+
+/* Wakes every waiter; pops drain what is left, then return NULL */
+void
+queue_close(struct queue *q)
+{
+	pthread_mutex_lock(&q->lock);
+	q->closed = 1;
+	pthread_cond_broadcast(&q->not_empty);
+	pthread_cond_broadcast(&q->not_full);
+	pthread_mutex_unlock(&q->lock);
+}
+
+bool
+queue_push(struct queue *q, void *item)
+{
+	pthread_mutex_lock(&q->lock);
+	while (q->count == q->cap && !q->closed)
+		pthread_cond_wait(&q->not_full, &q->lock);
+	if (q->closed) {
+		pthread_mutex_unlock(&q->lock);
+		return 0;
+	}
+	q->items[(q->head + q->count) % q->cap] = item;
+	q->count++;
+	pthread_cond_signal(&q->not_empty);
+	pthread_mutex_unlock(&q->lock);
+	return 1;
+}
+
+/* Returns false instead of waiting when the queue is full */
+bool
+queue_try_push(struct queue *q, void *item)
+{
+	pthread_mutex_lock(&q->lock);
+	bool ok = q->count < q->cap && !q->closed;
+	if (ok) {
+		q->items[(q->head + q->count) % q->cap] = item;
+		q->count++;
+		pthread_cond_signal(&q->not_empty);
+	}
+	pthread_mutex_unlock(&q->lock);
+	return ok;
+}
+
+/* Waits at most timeout_ms, forever when negative. NULL on timeout or once
+ * the queue is closed and empty. */
+void *
+queue_pop(struct queue *q, long timeout_ms)
+{
+	struct timespec deadline;
+	if (timeout_ms >= 0) {
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += timeout_ms / 1000;
+		deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+	}
+
+	pthread_mutex_lock(&q->lock);
+	while (!q->count && !q->closed) {
+		if (timeout_ms < 0) {
+			pthread_cond_wait(&q->not_empty, &q->lock);
+		} else if (pthread_cond_timedwait(&q->not_empty, &q->lock,
+				&deadline) == ETIMEDOUT) {
+			break;
+		}
+	}
+
+	void *item = NULL;
+	if (q->count) {
+		item = q->items[q->head];
+		q->head = (q->head + 1) % q->cap;
+		q->count--;
+		pthread_cond_signal(&q->not_full);
+	}
+	pthread_mutex_unlock(&q->lock);
+	return item;
+}
+
+#endif /* QUEUE_H */
@@ -0,0 +1,428 @@
+#ifndef RESIDENCY_H
+#define RESIDENCY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "skin.h"
+#include "palette.h"
+
+/* Keeps skins the viewer has seen around at three levels: the compressed
+ * file, the decoded image packed by palette.h and the GPU texture. Decoded
+ * images and files share the cpu budget, textures have their own; when
+ * either is exceeded the least recently used entries that are not pinned
+ * lose that level, and get it back from the compressed bytes when they are
+ * asked for again. Once a skin has neither an image nor a texture left its
+ * file goes too, and the entry with it: asking for the path again reads it
+ * like the first time. Pinned entries are the ones on screen. Entries are
+ * found by path through a hash table. Main thread only, textures need the
+ * GL context. */
+
+#define RESIDENCY_CPU_MB 64
+#define RESIDENCY_GPU_MB 128
+
+struct resident {
+	char *path;
+	uint64_t hash;         /* fnv1a of path */
+	struct resident *next; /* in its bucket */
+	size_t index;          /* in items */
+	const unsigned char *source;
+	int source_size;
+	bool source_owned; /* false for bundled skins, which cost nothing */
+	long mtime;
+
+	struct palette_image image;
+	unsigned version; /* bumped whenever image is set */
+	Texture2D texture;
+	uint64_t used;
+	bool pinned;
+};
+
+struct residency {
+	struct resident **items;
+	size_t count, cap;
+	struct resident **buckets; /* cap of them, a power of two */
+
+	size_t cpu_budget, gpu_budget;
+	size_t cpu_bytes, gpu_bytes, source_bytes;
+	uint64_t tick;
+
+	size_t decodes, uploads, cpu_evictions, gpu_evictions, file_evictions;
+};
+
+void
+residency_init(struct residency *r, size_t cpu_budget, size_t gpu_budget)
+{
+	*r = (struct residency){
+		.cpu_budget = cpu_budget,
+		.gpu_budget = gpu_budget,
+	};
+}
+
+static size_t
+residency_texture_size(const Texture2D *t)
+{
+	return t->id ? (size_t)GetPixelDataSize(t->width, t->height,
+		t->format) : 0;
+}
+
+static void
+residency_drop_image(struct residency *r, struct resident *e)
+{
+	r->cpu_bytes -= palette_size(&e->image);
+	palette_free(&e->image);
+}
+
+static void
+residency_drop_texture(struct residency *r, struct resident *e)
+{
+	r->gpu_bytes -= residency_texture_size(&e->texture);
+	UnloadTexture(e->texture);
+	e->texture = (Texture2D){ 0 };
+}
+
+static void
+residency_drop_source(struct residency *r, struct resident *e)
+{
+	if (e->source_owned) {
+		r->source_bytes -= (size_t)e->source_size;
+		UnloadFileData((unsigned char *)e->source);
+	}
+	e->source = NULL;
+	e->source_size = 0;
+}
+
+static bool
+residency_read(struct residency *r, struct resident *e)
+{
+	const unsigned char *bundled = get_bundle(e->path);
+	if (bundled) {
+		e->source = bundled;
+		e->source_size = (int)get_bundle_size(e->path);
+		e->source_owned = false;
+	} else {
+		int size = 0;
+		e->source = LoadFileData(e->path, &size);
+		e->source_size = size;
+		e->source_owned = true;
+		e->mtime = GetFileModTime(e->path);
+		r->source_bytes += (size_t)e->source_size;
+	}
+	return e->source;
+}
+
+void
+residency_touch(struct residency *r, struct resident *e)
+{
+	e->used = ++r->tick;
+}
+
+static struct resident **
+residency_bucket(struct residency *r, uint64_t hash)
+{
+	return &r->buckets[hash & (r->cap - 1)];
+}
+
+struct resident *
+residency_find(struct residency *r, const char *path)
+{
+	if (!r->cap)
+		return NULL;
+	const uint64_t hash = fnv1a(path, strlen(path));
+	for (struct resident *e = *residency_bucket(r, hash); e; e = e->next) {
+		if (e->hash == hash && !strcmp(e->path, path))
+			return e;
+	}
+	return NULL;
+}
+
+/* Doubles items and buckets, keeping a bucket per item slot */
+static bool
+residency_grow(struct residency *r)
+{
+	size_t cap = r->cap ? r->cap * 2 : 16;
+	struct resident **buckets = calloc(cap, sizeof(*buckets));
+	struct resident **grown = realloc(r->items, sizeof(*grown) * cap);
+	if (grown)
+		r->items = grown;
+	if (!buckets || !grown) {
+		free(buckets);
+		return 0;
+	}
+
+	free(r->buckets);
+	r->buckets = buckets;
+	r->cap = cap;
+	for (size_t i = 0; i < r->count; i++) {
+		struct resident *e = r->items[i];
+		struct resident **b = residency_bucket(r, e->hash);
+		e->next = *b;
+		*b = e;
+	}
+	return 1;
+}
+
+static struct resident *
+residency_new(struct residency *r, const char *path)
+{
+	if (r->count == r->cap && !residency_grow(r))
+		return NULL;
+
+	struct resident *e = calloc(1, sizeof(*e));
+	if (!e || !(e->path = strdup(path))) {
+		free(e);
+		return NULL;
+	}
+	e->hash = fnv1a(path, strlen(path));
+	e->index = r->count;
+	r->items[r->count++] = e;
+	struct resident **b = residency_bucket(r, e->hash);
+	e->next = *b;
+	*b = e;
+	residency_touch(r, e);
+	return e;
+}
+
+/* Frees e and whatever it still holds */
+static void
+residency_remove(struct residency *r, struct resident *e)
+{
+	struct resident **b = residency_bucket(r, e->hash);
+	while (*b != e)
+		b = &(*b)->next;
+	*b = e->next;
+
+	struct resident *last = r->items[--r->count];
+	r->items[e->index] = last;
+	last->index = e->index;
+
+	residency_drop_texture(r, e);
+	residency_drop_image(r, e);
+	residency_drop_source(r, e);
+	free(e->path);
+	free(e);
+}
+
+/* Entry for path, reading the file the first time. Returns NULL if it can
+ * not be read. */
+struct resident *
+residency_open(struct residency *r, const char *path)
+{
+	struct resident *e = residency_find(r, path);
+	if (e) {
+		residency_touch(r, e);
+		return e;
+	}
+
+	e = residency_new(r, path);
+	if (e && !residency_read(r, e)) {
+		residency_remove(r, e);
+		return NULL;
+	}
+	return e;
+}
+
+/* Decodes a skin file and packs it, no data if either fails. Safe off the
+ * main thread. */
+struct palette_image
+residency_decode(const unsigned char *source, int source_size)
+{
+	struct palette_image packed;
+	Image img = skin_decode(source, source_size);
+	if (img.data)
+		ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	palette_pack(&packed, &img);
+	UnloadImage(img);
+	return packed;
+}
+
+void
+residency_set_image(struct residency *r, struct resident *e,
+	struct palette_image img)
+{
+	residency_drop_image(r, e);
+	e->image = img;
+	e->version++;
+	r->cpu_bytes += palette_size(&e->image);
+}
+
+/* Takes over a file read and decoded (by residency_decode()) elsewhere,
+ * e.g. on a loader thread. Frees both instead when path already has an
+ * entry. */
+struct resident *
+residency_adopt(struct residency *r, const char *path,
+	unsigned char *source, int source_size, struct palette_image img)
+{
+	struct resident *e = residency_find(r, path);
+	if (!e && (e = residency_new(r, path))) {
+		e->source = source;
+		e->source_size = source_size;
+		e->source_owned = true;
+		e->mtime = GetFileModTime(path);
+		r->source_bytes += (size_t)source_size;
+		residency_set_image(r, e, img);
+		return e;
+	}
+	UnloadFileData(source);
+	palette_free(&img);
+	return e;
+}
+
+/* Decoded pixels of e, decoding again if they were evicted */
+const struct palette_image *
+residency_image(struct residency *r, struct resident *e)
+{
+	residency_touch(r, e);
+	if (!e->image.data && e->source) {
+		residency_set_image(r, e,
+			residency_decode(e->source, e->source_size));
+		r->decodes++;
+	}
+	return &e->image;
+}
+
+/* Texture of e, uploading it if it was evicted. The pixels are expanded
+ * for the upload only. */
+Texture2D
+residency_texture(struct residency *r, struct resident *e)
+{
+	residency_touch(r, e);
+	if (!e->texture.id) {
+		Image img = palette_expand(residency_image(r, e));
+		if (img.data) {
+			e->texture = LoadTextureFromImage(img);
+			r->gpu_bytes += residency_texture_size(&e->texture);
+			r->uploads++;
+		}
+		UnloadImage(img);
+	}
+	return e->texture;
+}
+
+/* Reads e from disk again after it changed. Its texture is dropped, so the
+ * next residency_texture() uploads the new pixels. A file that can not be
+ * read or decoded, say one caught halfway through being saved, leaves e as
+ * it was and returns false. */
+bool
+residency_refresh(struct residency *r, struct resident *e)
+{
+	if (!e->source_owned)
+		return 0;
+
+	int size = 0;
+	unsigned char *source = LoadFileData(e->path, &size);
+	e->mtime = GetFileModTime(e->path);
+	if (!source)
+		return 0;
+	struct palette_image img = residency_decode(source, size);
+	r->decodes++;
+	if (!img.data) {
+		UnloadFileData(source);
+		return 0;
+	}
+
+	residency_drop_texture(r, e);
+	residency_drop_source(r, e);
+	e->source = source;
+	e->source_size = size;
+	r->source_bytes += (size_t)size;
+	residency_set_image(r, e, img);
+	return 1;
+}
+
+enum residency_level {
+	RESIDENCY_TEXTURE,
+	RESIDENCY_IMAGE,
+	RESIDENCY_FILE, /* entries left with only their file */
+};
+
+static bool
+residency_holds(const struct resident *e, enum residency_level level)
+{
+	switch (level) {
+	case RESIDENCY_TEXTURE:
+		return e->texture.id;
+	case RESIDENCY_IMAGE:
+		return e->image.data;
+	case RESIDENCY_FILE:
+		return e->source_owned && !e->texture.id && !e->image.data;
+	}
+	return 0;
+}
+
+static struct resident *
+residency_lru(struct residency *r, enum residency_level level)
+{
+	struct resident *lru = NULL;
+	for (size_t i = 0; i < r->count; i++) {
+		struct resident *e = r->items[i];
+		if (e->pinned || !residency_holds(e, level))
+			continue;
+		if (!lru || e->used < lru->used)
+			lru = e;
+	}
+	return lru;
+}
+
+/* Evicts until both budgets hold or only pinned entries are left. Images
+ * go before files: a file is a fraction of the size and saves a read. */
+void
+residency_trim(struct residency *r)
+{
+	struct resident *e;
+	while (r->gpu_bytes > r->gpu_budget
+			&& (e = residency_lru(r, RESIDENCY_TEXTURE))) {
+		residency_drop_texture(r, e);
+		r->gpu_evictions++;
+	}
+	while (r->cpu_bytes + r->source_bytes > r->cpu_budget
+			&& (e = residency_lru(r, RESIDENCY_IMAGE))) {
+		residency_drop_image(r, e);
+		r->cpu_evictions++;
+	}
+	while (r->cpu_bytes + r->source_bytes > r->cpu_budget
+			&& (e = residency_lru(r, RESIDENCY_FILE))) {
+		residency_remove(r, e);
+		r->file_evictions++;
+	}
+}
+
+void
+residency_free(struct residency *r)
+{
+	for (size_t i = 0; i < r->count; i++) {
+		struct resident *e = r->items[i];
+		residency_drop_texture(r, e);
+		residency_drop_image(r, e);
+		residency_drop_source(r, e);
+		free(e->path);
+		free(e);
+	}
+	free(r->items);
+	free(r->buckets);
+	r->items = r->buckets = NULL;
+	r->count = r->cap = 0;
+}
+
+/* One line summary, in a static buffer */
+const char *
+residency_stats(const struct residency *r)
+{
+	static char buf[256];
+	snprintf(buf, sizeof(buf), "%zu skins, cpu %.1f/%.1f MB, "
+		"gpu %.1f/%.1f MB, files %.1f MB, %zu decodes, %zu uploads, "
+		"evicted %zu cpu %zu gpu %zu files",
+		r->count,
+		(double)r->cpu_bytes / 1048576.0, (double)r->cpu_budget / 1048576.0,
+		(double)r->gpu_bytes / 1048576.0, (double)r->gpu_budget / 1048576.0,
+		(double)r->source_bytes / 1048576.0,
+		r->decodes, r->uploads, r->cpu_evictions, r->gpu_evictions,
+		r->file_evictions);
+	return buf;
+}
+
+#endif /* RESIDENCY_H */
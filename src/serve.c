@@ -0,0 +1,693 @@
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "raylib.h"
+#include "skin.h"
+#include "headless.h"
+#include "proto.h"
+#include "queue.h"
+#include "cache.h"
+#include "ortho.h"
+#include "png.h"
+
+/* skin-serve keeps a GL context (see headless.h), the twelve models and a
+ * render texture alive and renders skins sent over a Unix domain socket.
+ *
+ * The socket is created 0600, so only the user running skin-serve can
+ * connect. Requests that name a file instead of carrying it are refused
+ * unless -r gives a directory, and then only served for files under it
+ * once symlinks and .. are resolved; it should not be writable by anyone
+ * untrusted.
+ *
+ * Each connection has a reader thread that parses requests into jobs and a
+ * writer thread that sends the responses back. Jobs are decoded by a pool
+ * of workers, rendered by the main thread (which owns the GL context), then
+ * encoded by the workers, which hand a copy of the response to the writer
+ * and never touch the socket. At most SERVE_INFLIGHT jobs exist at once and
+ * at most SERVE_CONN_INFLIGHT requests of one connection are unanswered;
+ * readers wait for both before reading the next request, so a client that
+ * pipelines faster than we render, or reads its responses slower, is
+ * slowed down by the socket buffer filling up without holding up others.
+ *
+ * With -c, finished renders are kept in an on-disk cache keyed by the
+ * skin file's bytes and every request field that changes the output, and
+ * repeats are answered before decoding anything.
+ *
+ * Orthographic presets are drawn by the worker that decoded the skin and
+ * never reach the main thread.
+ *
+ * PNG responses are encoded by png.h at the effort given with -z, each
+ * worker reusing its own scratch buffers. */
+
+#define SERVE_WORKERS 4
+#define SERVE_INFLIGHT 64
+#define SERVE_CONN_INFLIGHT 16
+#define SERVE_CACHE_MB 256
+
+enum stage {
+	STAGE_DECODE = 0,
+	STAGE_ENCODE,
+};
+
+struct conn {
+	int fd;
+	int refs;       /* the reader and every request not yet answered */
+	int unanswered;
+	pthread_mutex_t lock; /* guards refs and unanswered */
+	pthread_cond_t answered;
+	struct queue out; /* struct reply, for the writer */
+};
+
+struct reply {
+	struct proto_response res;
+	unsigned char data[];
+};
+
+struct job {
+	struct conn *conn;
+	struct proto_request req;
+	enum stage stage;
+	unsigned char *payload;
+	Image image;
+	bool slim;
+	struct cache_key key;
+	uint32_t status;
+};
+
+struct queue work;   /* decode and encode, for the worker pool */
+struct queue render; /* decoded skins, for the main thread */
+
+pthread_mutex_t inflight_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t inflight_free = PTHREAD_COND_INITIALIZER;
+int inflight = 0;
+
+struct cache cache;
+bool use_cache = false;
+char *root = NULL; /* resolved -r, NULL refuses path requests */
+enum png_effort effort = PNG_FAST;
+
+volatile sig_atomic_t quit = 0;
+volatile sig_atomic_t print_stats = 0;
+
+void
+on_terminate(int sig)
+{
+	(void)sig;
+	quit = 1;
+}
+
+void
+on_usr1(int sig)
+{
+	(void)sig;
+	print_stats = 1;
+}
+
+void
+inflight_acquire(void)
+{
+	pthread_mutex_lock(&inflight_lock);
+	while (inflight >= SERVE_INFLIGHT)
+		pthread_cond_wait(&inflight_free, &inflight_lock);
+	inflight++;
+	pthread_mutex_unlock(&inflight_lock);
+}
+
+void
+inflight_release(void)
+{
+	pthread_mutex_lock(&inflight_lock);
+	inflight--;
+	pthread_cond_signal(&inflight_free);
+	pthread_mutex_unlock(&inflight_lock);
+}
+
+/* Once nothing refers to c its writer is told to finish; the writer frees
+ * it after sending what is left. */
+void
+conn_release(struct conn *c)
+{
+	pthread_mutex_lock(&c->lock);
+	int refs = --c->refs;
+	pthread_mutex_unlock(&c->lock);
+	if (!refs)
+		queue_close(&c->out);
+}
+
+/* Waits until c may have another request in flight */
+void
+conn_acquire(struct conn *c)
+{
+	pthread_mutex_lock(&c->lock);
+	while (c->unanswered >= SERVE_CONN_INFLIGHT)
+		pthread_cond_wait(&c->answered, &c->lock);
+	c->unanswered++;
+	c->refs++;
+	pthread_mutex_unlock(&c->lock);
+}
+
+void
+conn_answered(struct conn *c)
+{
+	pthread_mutex_lock(&c->lock);
+	c->unanswered--;
+	pthread_cond_signal(&c->answered);
+	pthread_mutex_unlock(&c->lock);
+	conn_release(c);
+}
+
+/* Sends the replies of one connection in the order they were finished.
+ * After a failed write the rest are dropped and both ends shut down, so
+ * the reader stops too. */
+void *
+writer_main(void *arg)
+{
+	struct conn *c = arg;
+	bool broken = false;
+	struct reply *r;
+
+	while ((r = queue_pop(&c->out, -1))) {
+		if (!broken && !(write_full(c->fd, &r->res, sizeof(r->res))
+				&& (!r->res.length
+				|| write_full(c->fd, r->data, r->res.length)))) {
+			shutdown(c->fd, SHUT_RDWR);
+			broken = true;
+		}
+		free(r);
+		conn_answered(c);
+	}
+
+	close(c->fd);
+	queue_free(&c->out);
+	pthread_cond_destroy(&c->answered);
+	pthread_mutex_destroy(&c->lock);
+	free(c);
+	return NULL;
+}
+
+/* Hands the response to the connection's writer and retires the job */
+void
+job_finish(struct job *j, const void *data, uint32_t length)
+{
+	struct proto_response res = {
+		.magic = PROTO_RESPONSE_MAGIC,
+		.id = j->req.id,
+		.status = j->status,
+		.width = j->status == PROTO_OK ? j->req.width : 0,
+		.height = j->status == PROTO_OK ? j->req.height : 0,
+		.length = j->status == PROTO_OK ? length : 0,
+	};
+
+	/* data may be a worker's scratch buffer, so the writer gets a copy */
+	struct reply *r = malloc(sizeof(*r) + res.length);
+	if (!r) {
+		res.status = PROTO_EENCODE;
+		res.width = res.height = 0;
+		res.length = 0;
+		r = malloc(sizeof(*r));
+	}
+	if (r) {
+		r->res = res;
+		if (res.length)
+			memcpy(r->data, data, res.length);
+		/* Never waits: the queue holds every unanswered request */
+		queue_push(&j->conn->out, r);
+	} else {
+		fprintf(stderr, "Out of memory!\n");
+		shutdown(j->conn->fd, SHUT_RDWR);
+		conn_answered(j->conn);
+	}
+
+	UnloadImage(j->image);
+	free(j->payload);
+	free(j);
+	inflight_release();
+}
+
+void job_encode(struct job *j, struct png_scratch *png);
+
+/* Renders at the largest integer scale that fits, centred */
+void
+job_ortho(struct job *j, struct png_scratch *png)
+{
+	enum ortho_view view = j->req.preset & ~PROTO_PRESET_ORTHO;
+	struct ortho_plan plan = { 0 };
+	uint32_t *pixels = NULL;
+
+	bool ok = ortho_plan(&plan, view, 1, j->image.width, j->image.height,
+		j->slim);
+	int scale = ok ? j->req.width / plan.width : 0;
+	if (ok && j->req.height / plan.height < scale)
+		scale = j->req.height / plan.height;
+	if (scale < 1)
+		scale = 1;
+	ok = ok && ortho_plan(&plan, view, scale, j->image.width,
+		j->image.height, j->slim);
+	if (ok)
+		pixels = malloc(sizeof(*pixels)
+			* (size_t)plan.width * (size_t)plan.height);
+	if (!pixels) {
+		ortho_plan_free(&plan);
+		j->status = PROTO_EENCODE;
+		job_finish(j, NULL, 0);
+		return;
+	}
+	ortho_render(&plan, j->image.data, j->req.hidden, pixels);
+
+	/* Clip when even scale 1 is bigger than the request */
+	Image out = GenImageColor(j->req.width, j->req.height, BLANK);
+	int dx = (j->req.width - plan.width) / 2;
+	int dy = (j->req.height - plan.height) / 2;
+	for (int y = 0; y < plan.height; y++) {
+		if (y + dy < 0 || y + dy >= j->req.height)
+			continue;
+		for (int x = 0; x < plan.width; x++) {
+			if (x + dx < 0 || x + dx >= j->req.width)
+				continue;
+			((uint32_t *)out.data)[(y + dy) * j->req.width + x + dx] =
+				pixels[(size_t)y * (size_t)plan.width + (size_t)x];
+		}
+	}
+	free(pixels);
+	ortho_plan_free(&plan);
+
+	UnloadImage(j->image);
+	j->image = out;
+	j->stage = STAGE_ENCODE;
+	job_encode(j, png);
+}
+
+/* Resolves path into resolved, true if that is under root */
+bool
+path_allowed(const char *path, char resolved[PATH_MAX])
+{
+	if (!root || !realpath(path, resolved))
+		return 0;
+	size_t n = strlen(root);
+	return !strncmp(resolved, root, n)
+		&& (root[n - 1] == '/' || resolved[n] == '/');
+}
+
+void
+job_decode(struct job *j, struct png_scratch *png)
+{
+	unsigned char *data = j->payload;
+	int size = (int)j->req.length;
+	unsigned char *file = NULL;
+
+	if (j->req.source == PROTO_SOURCE_PATH) {
+		char resolved[PATH_MAX];
+		if (!path_allowed((char *)j->payload, resolved)) {
+			j->status = PROTO_EDENIED;
+			job_finish(j, NULL, 0);
+			return;
+		}
+		file = LoadFileData(resolved, &size);
+		if (!file) {
+			j->status = PROTO_EREAD;
+			job_finish(j, NULL, 0);
+			return;
+		}
+		data = file;
+	}
+
+	if (use_cache) {
+		j->key = (struct cache_key){
+			.source = fnv1a(data, (size_t)size),
+			.width = j->req.width,
+			.height = j->req.height,
+			.hidden = j->req.hidden & ((1u << MODEL_COUNT) - 1),
+			.preset = j->req.preset,
+			.format = j->req.format,
+		};
+		uint32_t length;
+		unsigned char *hit = cache_get(&cache, &j->key, &length);
+		if (hit) {
+			UnloadFileData(file);
+			job_finish(j, hit, length);
+			free(hit);
+			return;
+		}
+	}
+
+	j->image = skin_decode(data, size);
+	UnloadFileData(file);
+	if (j->image.data) {
+		ImageFormat(&j->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		image_upgrade_legacy(&j->image);
+	}
+	/* Smaller images would have faces under a texel wide */
+	if (!j->image.data || skin_kind_of(j->image.width,
+			j->image.height) < SKIN_MODERN) {
+		j->status = PROTO_EDECODE;
+		job_finish(j, NULL, 0);
+		return;
+	}
+	j->slim = skin_is_slim(&j->image);
+
+	if (j->req.preset & PROTO_PRESET_ORTHO)
+		job_ortho(j, png);
+	else
+		queue_push(&render, j);
+}
+
+void
+job_encode(struct job *j, struct png_scratch *png)
+{
+	/* Render textures come back bottom row first */
+	if (!(j->req.preset & PROTO_PRESET_ORTHO))
+		ImageFlipVertical(&j->image);
+
+	if (j->req.format == PROTO_FORMAT_RGBA) {
+		uint32_t size = (uint32_t)GetPixelDataSize(j->image.width,
+			j->image.height, j->image.format);
+		if (use_cache)
+			cache_put(&cache, &j->key, j->image.data, size);
+		job_finish(j, j->image.data, size);
+		return;
+	}
+
+	size_t size = 0;
+	const unsigned char *file = png_encode(png, j->image.data,
+		j->image.width, j->image.height, effort, &size);
+	if (!file || size > UINT32_MAX) {
+		j->status = PROTO_EENCODE;
+		file = NULL;
+		size = 0;
+	} else if (use_cache) {
+		cache_put(&cache, &j->key, file, (uint32_t)size);
+	}
+	job_finish(j, file, (uint32_t)size);
+}
+
+void *
+worker_main(void *arg)
+{
+	(void)arg;
+	struct png_scratch png = { 0 };
+	struct job *j;
+	while ((j = queue_pop(&work, -1))) {
+		if (j->stage == STAGE_DECODE)
+			job_decode(j, &png);
+		else
+			job_encode(j, &png);
+	}
+	png_scratch_free(&png);
+	return NULL;
+}
+
+bool
+request_valid(const struct proto_request *r)
+{
+	return r->magic == PROTO_REQUEST_MAGIC
+		&& r->source < PROTO_SOURCE_COUNT
+		&& r->format < PROTO_FORMAT_COUNT
+		&& (r->preset < CAMERA_PRESET_COUNT
+			|| (r->preset & PROTO_PRESET_ORTHO
+				&& (r->preset & ~PROTO_PRESET_ORTHO)
+					< ORTHO_VIEW_COUNT))
+		&& r->width && r->width <= PROTO_MAX_SIZE
+		&& r->height && r->height <= PROTO_MAX_SIZE
+		&& r->length && r->length <= PROTO_MAX_PAYLOAD;
+}
+
+void *
+reader_main(void *arg)
+{
+	struct conn *c = arg;
+	struct proto_request req;
+
+	for (;;) {
+		conn_acquire(c);
+		inflight_acquire();
+		if (!read_full(c->fd, &req, sizeof(req))) {
+			inflight_release();
+			conn_answered(c);
+			break;
+		}
+
+		struct job *j = calloc(1, sizeof(*j));
+		if (!j) {
+			inflight_release();
+			conn_answered(c);
+			break;
+		}
+		j->req = req;
+		j->conn = c;
+
+		if (!request_valid(&req)) {
+			/* Framing can not be trusted past a bad header */
+			j->status = PROTO_EREQUEST;
+			job_finish(j, NULL, 0);
+			break;
+		}
+
+		/* One extra byte keeps paths NUL terminated */
+		j->payload = calloc(req.length + 1, 1);
+		if (!j->payload || !read_full(c->fd, j->payload, req.length)) {
+			j->status = PROTO_EREQUEST;
+			job_finish(j, NULL, 0);
+			break;
+		}
+		queue_push(&work, j);
+	}
+
+	conn_release(c);
+	return NULL;
+}
+
+void *
+accept_main(void *arg)
+{
+	int sock = *(int *)arg;
+	for (;;) {
+		int fd = accept(sock, NULL, NULL);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			perror("accept");
+			return NULL;
+		}
+
+		struct conn *c = calloc(1, sizeof(*c));
+		if (!c) {
+			close(fd);
+			continue;
+		}
+		if (!queue_init(&c->out, SERVE_CONN_INFLIGHT)) {
+			free(c);
+			close(fd);
+			continue;
+		}
+		c->fd = fd;
+		c->refs = 1;
+		pthread_mutex_init(&c->lock, NULL);
+		pthread_cond_init(&c->answered, NULL);
+
+		pthread_t t;
+		if (pthread_create(&t, NULL, writer_main, c)) {
+			queue_free(&c->out);
+			pthread_cond_destroy(&c->answered);
+			pthread_mutex_destroy(&c->lock);
+			free(c);
+			close(fd);
+			continue;
+		}
+		pthread_detach(t);
+		if (pthread_create(&t, NULL, reader_main, c)) {
+			conn_release(c);
+			continue;
+		}
+		pthread_detach(t);
+	}
+}
+
+int
+listen_on(const char *path)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "Socket path too long!\n");
+		return -1;
+	}
+	strcpy(addr.sun_path, path);
+
+	int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		perror("socket");
+		return -1;
+	}
+	unlink(path);
+	/* Created 0600 from the start, there is no window to connect in
+	 * before a chmod */
+	mode_t mask = umask(0177);
+	int bound = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	umask(mask);
+	if (bound < 0 || listen(sock, 64) < 0) {
+		perror("bind");
+		close(sock);
+		return -1;
+	}
+	return sock;
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-serve [-s socket] [-w workers]"
+		" [-c cachefile [-C megabytes]]\n"
+		"\t[-z store|rle|fast|small] [-r root]\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *path = PROTO_SOCKET;
+	const char *cachefile = NULL;
+	long cache_mb = SERVE_CACHE_MB;
+	int workers = SERVE_WORKERS;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-s") && i + 1 < argc)
+			path = argv[++i];
+		else if (!strcmp(argv[i], "-w") && i + 1 < argc)
+			workers = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+			cachefile = argv[++i];
+		else if (!strcmp(argv[i], "-C") && i + 1 < argc)
+			cache_mb = atol(argv[++i]);
+		else if (!strcmp(argv[i], "-z") && i + 1 < argc
+				&& png_effort_parse(argv[i + 1], &effort))
+			i++;
+		else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+			if (!(root = realpath(argv[++i], NULL))) {
+				perror(argv[i]);
+				return EXIT_FAILURE;
+			}
+		}
+		else {
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (workers < 1)
+		workers = 1;
+
+	if (cachefile) {
+		if (cache_mb < 1)
+			cache_mb = 1;
+		if (!cache_open(&cache, cachefile, (uint64_t)cache_mb << 20))
+			return EXIT_FAILURE;
+		use_cache = true;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGTERM, on_terminate);
+	signal(SIGINT, on_terminate);
+	signal(SIGUSR1, on_usr1);
+
+	SetTraceLogLevel(LOG_WARNING);
+	if (!headless_init(64, 64, "skin-serve")) {
+		fprintf(stderr, "No GL context!\n");
+		return EXIT_FAILURE;
+	}
+
+	char *skin = "resources/models/obj/osage-chan-lagtrain.qoi";
+	Image image = skin_decode(get_bundle(skin), (int)get_bundle_size(skin));
+	Texture2D placeholder = LoadTextureFromImage(image);
+	UnloadImage(image);
+	Model models[2][MODEL_COUNT] = {0}; /* indexed by slim */
+	for (size_t slim = 0; slim < 2; slim++) {
+		if (!load_models(models[slim], slim, placeholder)) {
+			fprintf(stderr, "Out of memory!\n");
+			return EXIT_FAILURE;
+		}
+	}
+	png_init();
+	ortho_init();
+
+	/* Every job fits in either queue, so pushes never wait */
+	if (!queue_init(&work, SERVE_INFLIGHT * 2)
+			|| !queue_init(&render, SERVE_INFLIGHT)) {
+		fprintf(stderr, "Out of memory!\n");
+		return EXIT_FAILURE;
+	}
+
+	int sock = listen_on(path);
+	if (sock < 0)
+		return EXIT_FAILURE;
+
+	pthread_t t;
+	for (int i = 0; i < workers; i++) {
+		if (pthread_create(&t, NULL, worker_main, NULL)) {
+			perror("pthread_create");
+			return EXIT_FAILURE;
+		}
+		pthread_detach(t);
+	}
+	if (pthread_create(&t, NULL, accept_main, &sock)) {
+		perror("pthread_create");
+		return EXIT_FAILURE;
+	}
+	pthread_detach(t);
+	fprintf(stderr, "skin-serve: listening on %s\n", path);
+
+	RenderTexture2D rt = { 0 };
+	while (!quit) {
+		if (print_stats && use_cache) {
+			cache_print_stats(&cache, stderr);
+			print_stats = 0;
+		}
+
+		struct job *j = queue_pop(&render, 100);
+		if (!j)
+			continue;
+
+		if (rt.texture.width != j->req.width
+				|| rt.texture.height != j->req.height) {
+			UnloadRenderTexture(rt);
+			rt = LoadRenderTexture(j->req.width, j->req.height);
+		}
+
+		Texture2D texture = LoadTextureFromImage(j->image);
+		set_models_texture(models[j->slim], texture);
+		render_models(rt, models[j->slim], camera_preset(j->req.preset),
+			j->req.hidden);
+		UnloadTexture(texture);
+
+		UnloadImage(j->image);
+		j->image = LoadImageFromTexture(rt.texture);
+		ImageFormat(&j->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		j->stage = STAGE_ENCODE;
+		queue_push(&work, j);
+	}
+
+	close(sock);
+	unlink(path);
+	if (use_cache) {
+		cache_print_stats(&cache, stderr);
+		cache_close(&cache);
+	}
+	UnloadRenderTexture(rt);
+	/* Unloading a model unloads its texture, the placeholder only once */
+	for (size_t slim = 0; slim < 2; slim++) {
+		set_models_texture(models[slim], (Texture2D){ 0 });
+		for (size_t i = 0; i < MODEL_COUNT; i++)
+			UnloadModel(models[slim][i]);
+	}
+	UnloadTexture(placeholder);
+	headless_close();
+	free(root);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,496 @@
+#ifndef SKIN_H
+#define SKIN_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "bundle.h"
+#include "qoi.h"
+
+enum model {
+	MODEL_HEAD = 0,
+	MODEL_BODY,
+	MODEL_LARM,
+	MODEL_LLEG,
+	MODEL_RARM,
+	MODEL_RLEG,
+	MODEL_LAYER_HEAD,
+	MODEL_LAYER_BODY,
+	MODEL_LAYER_LARM,
+	MODEL_LAYER_LLEG,
+	MODEL_LAYER_RARM,
+	MODEL_LAYER_RLEG,
+	MODEL_COUNT
+};
+
+struct button {
+	Rectangle rec;
+	bool active;
+};
+
+/* Each part as a box in the layout every skin has: where its faces start
+ * in the texture, its size (in texels and pixels, a texture of 64 being 16
+ * pixels to the unit) and its corner towards -x -y -z. Overlay boxes are
+ * grown on every side so they stand off the base layer. Arms are classic,
+ * slim ones are a pixel narrower, lost on the side away from the body. */
+struct skin_box {
+	int u, v;
+	int w, h, d;
+	double x, y, z;
+	double inflate;
+};
+
+const struct skin_box skin_boxes[] = {
+	[MODEL_HEAD]       = {  0,  0, 8,  8, 8, -4.0, 24, -4, 0.00 },
+	[MODEL_BODY]       = { 16, 16, 8, 12, 4, -4.0, 12, -2, 0.00 },
+	[MODEL_LARM]       = { 32, 48, 4, 12, 4, -8.0, 12, -2, 0.00 },
+	[MODEL_LLEG]       = { 16, 48, 4, 12, 4, -3.9,  0, -2, 0.00 },
+	[MODEL_RARM]       = { 40, 16, 4, 12, 4,  4.0, 12, -2, 0.00 },
+	[MODEL_RLEG]       = {  0, 16, 4, 12, 4, -0.1,  0, -2, 0.00 },
+	[MODEL_LAYER_HEAD] = { 32,  0, 8,  8, 8, -4.0, 24, -4, 0.50 },
+	[MODEL_LAYER_BODY] = { 16, 32, 8, 12, 4, -4.0, 12, -2, 0.25 },
+	[MODEL_LAYER_LARM] = { 48, 48, 4, 12, 4, -8.0, 12, -2, 0.25 },
+	[MODEL_LAYER_LLEG] = {  0, 48, 4, 12, 4, -3.9,  0, -2, 0.25 },
+	[MODEL_LAYER_RARM] = { 40, 32, 4, 12, 4,  4.0, 12, -2, 0.25 },
+	[MODEL_LAYER_RLEG] = {  0, 32, 4, 12, 4, -0.1,  0, -2, 0.25 },
+};
+static_assert(MODEL_COUNT == sizeof(skin_boxes)/sizeof(*skin_boxes),
+	"Model count is wrong");
+
+/* The faces of a box in the order they are made: corners as bits (4 for
+ * +x, 2 for +y, 1 for +z), where the face sits in the box's texels as
+ * multiples of depth and width across and of depth down, its size (0 for
+ * width, 1 for depth, 2 for height) and the texel corner of each box
+ * corner (1 for right, 2 for bottom). */
+const struct {
+	unsigned char corners[4];
+	unsigned char du[2], dv;
+	unsigned char size[2];
+	unsigned char uv[4];
+	float normal[3];
+} skin_faces[6] = {
+	{ { 4, 0, 2, 6 }, { 1, 0 }, 1, { 0, 2 }, { 2, 3, 1, 0 }, {  0,  0, -1 } },
+	{ { 5, 4, 6, 7 }, { 0, 0 }, 1, { 1, 2 }, { 2, 3, 1, 0 }, {  1,  0,  0 } },
+	{ { 1, 5, 7, 3 }, { 2, 1 }, 1, { 0, 2 }, { 2, 3, 1, 0 }, {  0,  0,  1 } },
+	{ { 0, 1, 3, 2 }, { 1, 1 }, 1, { 1, 2 }, { 2, 3, 1, 0 }, { -1,  0,  0 } },
+	{ { 3, 7, 6, 2 }, { 1, 0 }, 0, { 0, 1 }, { 1, 0, 2, 3 }, {  0,  1,  0 } },
+	{ { 0, 4, 5, 1 }, { 1, 1 }, 0, { 0, 1 }, { 3, 2, 0, 1 }, {  0, -1,  0 } },
+};
+
+#define SKIN_VERTICES 36 /* of a part, two triangles a face */
+
+static bool
+skin_is_arm(enum model i)
+{
+	return i == MODEL_LARM || i == MODEL_RARM
+		|| i == MODEL_LAYER_LARM || i == MODEL_LAYER_RARM;
+}
+
+/* Texel width of part i */
+int
+skin_box_width(enum model i, bool slim)
+{
+	return skin_boxes[i].w - (slim && skin_is_arm(i));
+}
+
+/* Corners of part i in model units, inflation included */
+void
+skin_box_bounds(enum model i, bool slim, float lo[3], float hi[3])
+{
+	const struct skin_box *b = &skin_boxes[i];
+	const double w = skin_box_width(i, slim);
+	const double x = b->x + (b->x < 0 ? b->w - w : 0);
+	const double at[3] = { x, b->y, b->z }, size[3] = { w, b->h, b->d };
+	for (size_t k = 0; k < 3; k++) {
+		lo[k] = (float)((at[k] - b->inflate) / 16);
+		hi[k] = (float)((at[k] + size[k] + b->inflate) / 16);
+	}
+}
+
+/* Face f of part i: corners counter-clockwise seen from outside, and their
+ * UVs as fractions of the texture with v down, the way raylib has them */
+void
+skin_face(enum model i, bool slim, size_t f, float pos[4][3], float uv[4][2])
+{
+	const struct skin_box *b = &skin_boxes[i];
+	const int w = skin_box_width(i, slim);
+	const int sizes[3] = { w, b->d, b->h };
+	const int u0 = b->u + skin_faces[f].du[0] * b->d + skin_faces[f].du[1] * w;
+	const int v0 = b->v + skin_faces[f].dv * b->d;
+	const int u1 = u0 + sizes[skin_faces[f].size[0]];
+	const int v1 = v0 + sizes[skin_faces[f].size[1]];
+
+	float box[2][3];
+	skin_box_bounds(i, slim, box[0], box[1]);
+	for (size_t k = 0; k < 4; k++) {
+		const unsigned c = skin_faces[f].corners[k];
+		pos[k][0] = box[c >> 2 & 1][0];
+		pos[k][1] = box[c >> 1 & 1][1];
+		pos[k][2] = box[c & 1][2];
+		const unsigned t = skin_faces[f].uv[k];
+		uv[k][0] = (float)(t & 1 ? u1 : u0) / 64;
+		uv[k][1] = (float)(t & 2 ? v1 : v0) / 64;
+	}
+}
+
+/* The SKIN_VERTICES vertices of part i as triangles: three floats of
+ * position and normal and two of UV each */
+void
+skin_vertices(enum model i, bool slim, float *pos, float *uv, float *normal)
+{
+	static const size_t fan[6] = { 0, 1, 2, 0, 2, 3 };
+	for (size_t f = 0; f < 6; f++) {
+		float p[4][3], t[4][2];
+		skin_face(i, slim, f, p, t);
+		for (size_t k = 0; k < 6; k++, pos += 3, uv += 2, normal += 3) {
+			memcpy(pos, p[fan[k]], sizeof(p[0]));
+			memcpy(uv, t[fan[k]], sizeof(t[0]));
+			memcpy(normal, skin_faces[f].normal, sizeof(p[0]));
+		}
+	}
+}
+
+const unsigned char *
+get_bundle(char *f)
+{
+	for (size_t i = 0; i < resources_count; i += 1) {
+		char *b = &((char *)bundle)[resources[i].offset];
+		if (strcmp(f, resources[i].fileName) == 0)
+			return (unsigned char *)b;
+	}
+	return NULL;
+}
+
+size_t
+get_bundle_size(char *f)
+{
+	for (size_t i = 0; i < resources_count; i += 1) {
+		if (strcmp(f, resources[i].fileName) == 0)
+			return resources[i].size;
+	}
+	return 0;
+}
+
+/* Whether name looks like a skin file: .png or .qoi in any case. Unlike
+ * IsFileExtension() this is safe off the main thread. */
+bool
+skin_file_name(const char *name)
+{
+	size_t len = strlen(name);
+	if (len < 4 || name[len - 4] != '.')
+		return 0;
+	const char *ext = name + len - 3;
+	const char c[3] = {
+		(char)(ext[0] | 0x20), (char)(ext[1] | 0x20), (char)(ext[2] | 0x20),
+	};
+	return !memcmp(c, "png", 3) || !memcmp(c, "qoi", 3);
+}
+
+/* Decodes a skin file in memory: QOI with qoi.h, anything else as PNG by
+ * raylib. QOI comes out as RGBA8. */
+Image
+skin_decode(const unsigned char *data, int size)
+{
+	unsigned w, h;
+	if (!data || size <= 0)
+		return (Image){ 0 };
+	if (!qoi_is(data, (size_t)size))
+		return LoadImageFromMemory(".png", data, size);
+	if (!qoi_peek(data, (size_t)size, &w, &h) || w > INT32_MAX / h)
+		return (Image){ 0 };
+
+	Image img = {
+		.data = RL_MALLOC((size_t)w * h * 4),
+		.width = (int)w,
+		.height = (int)h,
+		.mipmaps = 1,
+		.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+	};
+	if (img.data && !qoi_unpack(data, (size_t)size, img.data)) {
+		RL_FREE(img.data);
+		img.data = NULL;
+	}
+	return img.data ? img : (Image){ 0 };
+}
+
+/* skin_decode() on a file */
+Image
+skin_load(const char *path)
+{
+	int size = 0;
+	unsigned char *data = LoadFileData(path, &size);
+	Image img = skin_decode(data, size);
+	UnloadFileData(data);
+	return img;
+}
+
+/* Fixed camera presets, as position and target */
+const Vector3 camera_presets[][2] = {
+	{ { -1.0f, 2.0f, -1.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {  0.0f, 1.0f,  2.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {  0.0f, 1.0f, -2.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {  2.0f, 1.0f,  0.0f }, { 0.0f, 1.0f, 0.0f } },
+};
+#define CAMERA_PRESET_COUNT (sizeof(camera_presets)/sizeof(*camera_presets))
+
+Camera
+camera_preset(size_t i)
+{
+	return (Camera){
+		.position = camera_presets[i][0],
+		.target = camera_presets[i][1],
+		.up = { 0.0f, 1.0f, 0.0f },
+		.fovy = 90.0f,
+		.projection = CAMERA_PERSPECTIVE,
+	};
+}
+
+/* Builds the parts from skin_boxes, with slim or classic arms. Needs a GL
+ * context; false if out of memory, with models unloaded. */
+bool
+load_models(Model *models, bool slim, Texture2D texture)
+{
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		Mesh mesh = {
+			.vertexCount = SKIN_VERTICES,
+			.triangleCount = SKIN_VERTICES / 3,
+			.vertices = RL_MALLOC(sizeof(float) * 3 * SKIN_VERTICES),
+			.texcoords = RL_MALLOC(sizeof(float) * 2 * SKIN_VERTICES),
+			.normals = RL_MALLOC(sizeof(float) * 3 * SKIN_VERTICES),
+		};
+		if (!mesh.vertices || !mesh.texcoords || !mesh.normals) {
+			UnloadMesh(mesh);
+			while (i--)
+				UnloadModel(models[i]);
+			return 0;
+		}
+		skin_vertices(i, slim, mesh.vertices, mesh.texcoords, mesh.normals);
+		UploadMesh(&mesh, false);
+		models[i] = LoadModelFromMesh(mesh);
+		models[i].materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+	}
+	return 1;
+}
+
+void
+set_models_texture(Model *models, Texture2D texture)
+{
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		models[i].materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+	}
+}
+
+/* Draw the parts not set in hidden (bit per enum model) from camera into rt,
+ * on a transparent background */
+void
+render_models(RenderTexture2D rt, const Model *models, Camera camera,
+	unsigned hidden)
+{
+	BeginTextureMode(rt);
+	ClearBackground(BLANK);
+	BeginMode3D(camera);
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		if (!(hidden & (1u << i)))
+			DrawModel(models[i], (Vector3){ 0 }, 1.0f, WHITE);
+	}
+	EndMode3D();
+	EndTextureMode();
+}
+
+uint64_t
+fnv1a(const void *data, size_t len)
+{
+	const unsigned char *p = data;
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+enum skin_kind {
+	SKIN_INVALID = 0,
+	SKIN_LEGACY, /* 64x32 */
+	SKIN_MODERN, /* 64x64 */
+	SKIN_HD,     /* square, a multiple of 64 */
+};
+
+const char *skin_kind_names[] = {
+	[SKIN_INVALID] = "invalid",
+	[SKIN_LEGACY]  = "legacy",
+	[SKIN_MODERN]  = "modern",
+	[SKIN_HD]      = "hd",
+};
+
+enum skin_kind
+skin_kind_of(int width, int height)
+{
+	if (width < 64 || width % 64)
+		return SKIN_INVALID;
+	if (height * 2 == width)
+		return SKIN_LEGACY;
+	if (height != width)
+		return SKIN_INVALID;
+	return width == 64 ? SKIN_MODERN : SKIN_HD;
+}
+
+/* Slim arms are a texel narrower, which leaves the last two columns of the
+ * right arm's front and back (and top and bottom) unused: texels of a 64
+ * wide skin that are transparent on slim ones */
+const Rectangle skin_slim_unused[] = { { 50, 16, 2, 4 }, { 54, 20, 2, 12 } };
+#define SKIN_SLIM_UNUSED (sizeof(skin_slim_unused)/sizeof(*skin_slim_unused))
+
+/* Expects RGBA8 */
+bool
+skin_is_slim(const Image *img)
+{
+	if (skin_kind_of(img->width, img->height) < SKIN_MODERN
+			|| img->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+		return 0;
+
+	const int u = img->width / 64;
+	const uint32_t *px = img->data;
+	for (size_t i = 0; i < SKIN_SLIM_UNUSED; i++) {
+		const Rectangle r = skin_slim_unused[i];
+		for (int y = (int)r.y * u; y < (int)(r.y + r.height) * u; y++) {
+			for (int x = (int)r.x * u; x < (int)(r.x + r.width) * u; x++) {
+				if (px[(size_t)y * (size_t)img->width + (size_t)x] >> 24)
+					return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+static void
+image_copy_mirrored(Image *img, int sx, int sy, int dx, int dy, int w, int h)
+{
+	uint32_t *px = img->data;
+	const size_t stride = (size_t)img->width;
+	for (int y = 0; y < h; y++) {
+		const uint32_t *src = px + (size_t)(sy + y) * stride + sx;
+		uint32_t *dst = px + (size_t)(dy + y) * stride + dx;
+		for (int x = 0; x < w; x++)
+			dst[x] = src[w - 1 - x];
+	}
+}
+
+/* Legacy skins are half as tall and have one arm and one leg for both
+ * sides. Grow an RGBA8 one to the square layout with the left limbs
+ * mirrored from the right ones, the way the game does. */
+void
+image_upgrade_legacy(Image *img)
+{
+	if (img->width < 64 || img->height * 2 != img->width
+			|| img->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+		return;
+
+	const int u = img->width / 64;
+	ImageResizeCanvas(img, img->width, img->width, 0, 0, BLANK);
+
+	/* Right leg at (0, 16) and right arm at (40, 16) go to (16, 48) and
+	 * (32, 48). Each face is flipped and the two sides trade places. */
+	const int limbs[2][4] = { { 0, 16, 16, 48 }, { 40, 16, 32, 48 } };
+	const int faces[6][4] = {
+		{ 4, 0, 4, 0 },   /* top */
+		{ 8, 0, 8, 0 },   /* bottom */
+		{ 0, 4, 8, 4 },   /* outer side */
+		{ 4, 4, 4, 4 },   /* front */
+		{ 8, 4, 0, 4 },   /* inner side */
+		{ 12, 4, 12, 4 }, /* back */
+	};
+	for (size_t l = 0; l < 2; l++) {
+		for (size_t f = 0; f < 6; f++) {
+			int h = faces[f][1] ? 12 : 4;
+			image_copy_mirrored(img,
+				(limbs[l][0] + faces[f][0]) * u,
+				(limbs[l][1] + faces[f][1]) * u,
+				(limbs[l][2] + faces[f][2]) * u,
+				(limbs[l][3] + faces[f][3]) * u,
+				4 * u, h * u);
+		}
+	}
+}
+
+void
+buttons_update(struct button *button, int w, int h)
+{
+	const float min = (float)(w < h ? w : h);
+	const float UI_PIXEL = min * 0.01f;
+
+	button[MODEL_HEAD].rec = (Rectangle){
+		UI_PIXEL * 4, 0,
+		UI_PIXEL * 8, UI_PIXEL * 8,
+	};
+
+	button[MODEL_BODY].rec = (Rectangle){
+		UI_PIXEL * 4, UI_PIXEL * 8,
+		UI_PIXEL * 8, UI_PIXEL * 12,
+	};
+
+	button[MODEL_RARM].rec = (Rectangle){
+		0, UI_PIXEL * 8,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	button[MODEL_LARM].rec = (Rectangle){
+		UI_PIXEL * 12, UI_PIXEL * 8,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	button[MODEL_RLEG].rec = (Rectangle){
+		UI_PIXEL * 4, UI_PIXEL * 20,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	button[MODEL_LLEG].rec = (Rectangle){
+		UI_PIXEL * 8, UI_PIXEL * 20,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	const float pad = UI_PIXEL * (16 + 1);
+
+	button[MODEL_LAYER_HEAD].rec = (Rectangle){
+		pad + UI_PIXEL * 4, 0,
+		UI_PIXEL * 8, UI_PIXEL * 8,
+	};
+
+	button[MODEL_LAYER_BODY].rec = (Rectangle){
+		pad + UI_PIXEL * 4, UI_PIXEL * 8,
+		UI_PIXEL * 8, UI_PIXEL * 12,
+	};
+
+	/* position of arms/legs are swapped */
+	button[MODEL_LAYER_RARM].rec = (Rectangle){
+		pad, UI_PIXEL * 8,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	button[MODEL_LAYER_LARM].rec = (Rectangle){
+		pad + UI_PIXEL * 12, UI_PIXEL * 8,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	button[MODEL_LAYER_RLEG].rec = (Rectangle){
+		pad + UI_PIXEL * 4, UI_PIXEL * 20,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	button[MODEL_LAYER_LLEG].rec = (Rectangle){
+		pad + UI_PIXEL * 8, UI_PIXEL * 20,
+		UI_PIXEL * 4, UI_PIXEL * 12,
+	};
+
+	for (size_t i = 0; i < MODEL_COUNT; i++) {
+		button[i].rec.x += UI_PIXEL;
+		button[i].rec.y += (float)h - UI_PIXEL * 33;
+	}
+}
+
+#endif /* SKIN_H */
@@ -0,0 +1,1290 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "raylib.h"
+#include "skin.h"
+#include "anim.h"
+#include "voxel.h"
+#include "cull.h"
+#include "dynres.h"
+#include "gallery.h"
+#include "headless.h"
+#include "ortho.h"
+#include "png.h"
+
+/* skin-test renders a fixed set of skins from every camera preset through
+ * a headless context (see headless.h) and compares each picture with a
+ * golden PNG in tests/golden. Another GPU or driver rasterizes the odd edge
+ * pixel differently, so a pixel only counts as different past a per
+ * channel tolerance, and a few of those are allowed.
+ *
+ * The CPU orthographic views of ortho.h are checked the same way against
+ * GL drawing the models through an orthographic camera that sees the same
+ * canvas, and the front view timed both ways. So is the gallery's
+ * instanced drawing against DrawModel placing the same players, and
+ * drawing a gallery of TEST_PLAYERS players is timed.
+ *
+ * Checks that need no GPU run alongside: the pivots anim.h finds for both
+ * arm shapes, and its SSE2 batches against the one at a time evaluation;
+ * and that the voxel overlay of each skin covers exactly the faces a
+ * texel by texel count leaves exposed, in no more quads than that; and
+ * cull.h's sorting of the overlay triangles against the texels under
+ * them, packed and not; and the dynamic resolution controller, fed the
+ * frame times of made-up loads. Posed renders of the bundled skin, each
+ * skin's voxels and a render at half size stretched to the full one have
+ * goldens too, and the overlay drawn culled is compared with drawing all
+ * of it; tests/skins/opaque.png has overlay faces that must be drawn
+ * without blending there.
+ *
+ * Loading each skin and each render are timed too, and the fastest of
+ * TEST_RUNS compared with the checked-in tests/baseline.json; a case more
+ * than the threshold slower (and by more than noise) fails. A machine that
+ * is busy for a while makes every case look slow, so slow cases get up to
+ * TEST_TRIES more rounds before failing; a real regression stays slow.
+ *
+ * -u writes the goldens and the baseline from this run instead, for
+ * changes meant to alter them; they are reviewed like any other diff.
+ * Pictures that fail are written to .build for a look. */
+
+#define TEST_SIZE 256
+#define TEST_RUNS 15
+#define TEST_TRIES 3
+#define TEST_BATCH 8 /* per run, a render takes well under a millisecond */
+#define TEST_TOLERANCE 16   /* per channel, before a pixel differs */
+#define TEST_MAX_DIFF 0.005 /* of the pixels, that may differ */
+#define TEST_THRESHOLD 10.0 /* percent slower than the baseline */
+#define TEST_NOISE_MS 0.02
+#define TEST_CASES 128
+#define TEST_GOLDEN "tests/golden"
+#define TEST_BASELINE "tests/baseline.json"
+#define TEST_FAILED ".build/test-%s.png"
+#define TEST_ORTHO_SCALE 4
+#define TEST_PLAYERS 1024 /* in the timed gallery */
+#define TEST_ANIM_EPSILON 1e-5f
+#define TEST_VOXEL_EPSILON 1e-4 /* of the area, float rounding */
+#define TEST_DYNRES_BUDGET (1 / 60.0f)
+#define TEST_DYNRES_FRAMES 4000
+#define TEST_DYNRES_SETTLED 3000 /* frames before the scale is looked at */
+#define TEST_DYNRES_OVER 0.05    /* of settled frames over budget */
+#define TEST_DYNRES_SCALE 0.5f   /* of the stretched render */
+#define TEST_DYNRES_BLUR 0.05    /* of its pixels differing from full size */
+
+struct test_skin {
+	const char *name;
+	const char *path;
+	bool opaque_overlay; /* has overlay faces cull.h must find opaque */
+};
+
+const struct test_skin test_skins[] = {
+	/* The bundled skin has slim arms */
+	{ "default", "resources/models/obj/osage-chan-lagtrain.png", false },
+	{ "classic", "tests/skins/classic.png", false },
+	{ "opaque",  "tests/skins/opaque.png",  true },  /* hat, no trousers */
+	{ "legacy",  "tests/skins/legacy.png",  false }, /* 64x32 */
+	{ "hd",      "tests/skins/hd.png",      false }, /* 128x128 */
+};
+#define TEST_SKINS (sizeof(test_skins)/sizeof(*test_skins))
+
+/* A skin loaded for the render cases, the file kept for the load case */
+struct test_loaded {
+	unsigned char *owned;
+	const unsigned char *file;
+	int size;
+	Image img;
+	Texture2D texture;
+	Model *models;
+	struct ortho_plan plan; /* front view */
+	uint32_t *ortho;
+	RenderTexture2D ortho_rt;
+	struct test_case *ortho_cases[2]; /* CPU, GL */
+};
+
+enum test_kind {
+	TEST_LOAD = 0,
+	TEST_RENDER,   /* from a camera preset */
+	TEST_ORTHO,    /* front view on the CPU */
+	TEST_ORTHO_GL, /* the same through GL */
+	TEST_GALLERY,
+};
+
+struct test_case {
+	char name[32];
+	struct test_loaded *skin;
+	enum test_kind kind;
+	int preset;
+	double best_ms;
+	double baseline_ms; /* 0 if not in the baseline */
+};
+
+struct test_loaded loaded[TEST_SKINS];
+struct test_case cases[TEST_CASES];
+size_t case_count;
+size_t goldens;
+size_t failed;
+bool update;
+double threshold = TEST_THRESHOLD;
+struct png_scratch png;
+struct gallery gallery;
+Camera gallery_camera;
+RenderTexture2D gallery_rt;
+
+long long
+now_ns(void)
+{
+	struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	timespec_get(&ts, TIME_UTC);
+#endif
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void
+test_fail(const char *name, const char *why)
+{
+	printf("FAIL\t%s\t%s\n", name, why);
+	failed++;
+}
+
+bool
+test_write_png(const char *path, const Image *img)
+{
+	size_t size = 0;
+	const unsigned char *file = png_encode(&png, img->data, img->width,
+		img->height, PNG_SMALL, &size);
+	return file && size <= INT32_MAX
+		&& SaveFileData(path, (void *)file, (int)size);
+}
+
+/* Fails name when more than max of the pixels of img differ from want,
+ * both RGBA8 and top row first; against names want in the message */
+bool
+test_compare(const char *name, const Image *img, const Image *want,
+	const char *against, double max)
+{
+	size_t differ = 0, worst = 0;
+	const size_t pixels = (size_t)img->width * (size_t)img->height;
+	if (want->width != img->width || want->height != img->height) {
+		differ = pixels;
+	} else {
+		const unsigned char *a = img->data, *b = want->data;
+		for (size_t i = 0; i < pixels; i++) {
+			size_t d = 0;
+			for (size_t c = 0; c < 4; c++) {
+				size_t e = (size_t)abs(a[i * 4 + c] - b[i * 4 + c]);
+				d = e > d ? e : d;
+			}
+			differ += d > TEST_TOLERANCE;
+			worst = d > worst ? d : worst;
+		}
+	}
+
+	if ((double)differ > (double)pixels * max) {
+		const char *path = TextFormat(TEST_FAILED, name);
+		test_write_png(path, img);
+		test_fail(name, TextFormat("%zu pixels differ from %s (worst by %zu),"
+			" see %s", differ, against, worst, path));
+		return 0;
+	}
+	if (differ) {
+		printf("note\t%s\t%zu pixels differ (worst by %zu), within limits\n",
+			name, differ, worst);
+	}
+	return 1;
+}
+
+/* Checks an RGBA8 picture, top row first, against its golden */
+void
+test_image(const char *name, const Image *img)
+{
+	const char *golden = TextFormat("%s/%s.png", TEST_GOLDEN, name);
+	if (update) {
+		if (!test_write_png(golden, img))
+			test_fail(name, TextFormat("could not write %s", golden));
+		goldens++;
+		return;
+	}
+
+	Image want = LoadImage(golden);
+	if (!want.data) {
+		test_fail(name, TextFormat("no golden %s, run with -u", golden));
+		return;
+	}
+	ImageFormat(&want, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	test_compare(name, img, &want, golden, TEST_MAX_DIFF);
+	UnloadImage(want);
+}
+
+/* Decodes the skin the way the renderers do, legacy ones grown to the
+ * square layout. Returns no data if the file can not be read. */
+Image
+test_decode(const unsigned char *file, int size)
+{
+	Image img = skin_decode(file, size);
+	if (img.data) {
+		ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		image_upgrade_legacy(&img);
+	}
+	return img;
+}
+
+struct test_case *
+test_add(const char *name, struct test_loaded *l, enum test_kind kind,
+	int preset)
+{
+	if (case_count == TEST_CASES) {
+		test_fail(name, "too many cases, raise TEST_CASES");
+		return NULL;
+	}
+	struct test_case *c = &cases[case_count++];
+	snprintf(c->name, sizeof(c->name), "%s", name);
+	c->skin = l;
+	c->kind = kind;
+	c->preset = preset;
+	c->best_ms = INFINITY;
+	return c;
+}
+
+/* Loads one skin and checks its render from every preset, adding a case
+ * to time each */
+void
+test_skin(const struct test_skin *s, struct test_loaded *l,
+	Model shapes[2][MODEL_COUNT], RenderTexture2D rt)
+{
+	l->file = get_bundle((char *)s->path);
+	if (l->file)
+		l->size = (int)get_bundle_size((char *)s->path);
+	else
+		l->file = l->owned = LoadFileData(s->path, &l->size);
+	if (!l->file) {
+		test_fail(s->name, TextFormat("could not read %s", s->path));
+		return;
+	}
+	l->img = test_decode(l->file, l->size);
+	l->texture = LoadTextureFromImage(l->img);
+	if (!l->img.data || !l->texture.id) {
+		test_fail(s->name, TextFormat("could not load %s", s->path));
+		return;
+	}
+	l->models = shapes[skin_is_slim(&l->img)];
+	test_add(TextFormat("%s_load", s->name), l, TEST_LOAD, 0);
+
+	set_models_texture(l->models, l->texture);
+	for (int p = 0; p < (int)CAMERA_PRESET_COUNT; p++) {
+		struct test_case *c = test_add(TextFormat("%s_%d", s->name, p), l,
+			TEST_RENDER, p);
+		if (!c)
+			return;
+		render_models(rt, l->models, camera_preset((size_t)p), 0);
+		Image out = LoadImageFromTexture(rt.texture);
+		/* Render textures come back bottom row first */
+		ImageFlipVertical(&out);
+		ImageFormat(&out, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		test_image(c->name, &out);
+		UnloadImage(out);
+	}
+}
+
+/* A camera that sees the canvas p laid out, on a render texture its size */
+Camera
+test_ortho_camera(const struct ortho_plan *p)
+{
+	const float *right = ortho_axes[p->view][0];
+	const float *forward = ortho_axes[p->view][1];
+	const float k = 16.0f * (float)p->scale;
+	const float h = ((float)p->ox + (float)p->width / 2) / k;
+	const Vector3 centre = {
+		right[0] * h,
+		-((float)p->oy + (float)p->height / 2) / k,
+		right[2] * h,
+	};
+	return (Camera){
+		.position = {
+			centre.x - forward[0] * 4,
+			centre.y,
+			centre.z - forward[2] * 4,
+		},
+		.target = centre,
+		.up = { 0.0f, 1.0f, 0.0f },
+		.fovy = (float)p->height / k,
+		.projection = CAMERA_ORTHOGRAPHIC,
+	};
+}
+
+/* Whether pixel i of n covering a run of texels has its centre on the edge
+ * between two of them, where GL may sample either */
+bool
+test_on_texel_edge(const int *texels, int n, int i)
+{
+	const int run = abs(texels[n - 1] - texels[0]) + 1;
+	return (2 * i + 1) * run % (2 * n) == 0;
+}
+
+/* Whether GL may draw pixel x, y of overlay face i of p unlike ortho.h:
+ * its centre is on the edge between texels that differ, so either may be
+ * sampled, or its texel is not fully opaque and covers overlay that GL
+ * draws later, which fails the depth test there but shows in ortho.h */
+bool
+test_ortho_unsure(const struct ortho_plan *p, size_t i, const uint32_t *tex,
+	int x, int y)
+{
+	const struct ortho_face *f = &p->faces[i];
+	const int w = f->x1 - f->x0, h = f->y1 - f->y0;
+	const int u = x - f->x0, v = y - f->y0;
+	const uint32_t own = tex[(size_t)f->rows[v] * (size_t)p->texw
+		+ (size_t)f->cols[u]];
+	bool clear = (own >> 24) != 0xff;
+	for (int dv = -1; dv <= 1; dv++) {
+		if (dv && (v + dv < 0 || v + dv >= h
+				|| !test_on_texel_edge(f->rows, h, v)))
+			continue;
+		for (int du = -1; du <= 1; du++) {
+			if (du && (u + du < 0 || u + du >= w
+					|| !test_on_texel_edge(f->cols, w, u)))
+				continue;
+			const uint32_t t = tex[(size_t)f->rows[v + dv]
+				* (size_t)p->texw + (size_t)f->cols[u + du]];
+			if (t != own)
+				return 1;
+		}
+	}
+	/* Faces come back to front, the ones behind f are before it */
+	for (size_t k = 0; clear && k < i; k++) {
+		const struct ortho_face *b = &p->faces[k];
+		if (b->part > f->part && x >= b->x0 && x < b->x1
+				&& y >= b->y0 && y < b->y1)
+			return 1;
+	}
+	return 0;
+}
+
+/* Clears, in both pictures, the pixels test_ortho_unsure() finds; overlay
+ * texels are 4.5 pixels wide at TEST_ORTHO_SCALE, so some are centred on
+ * texel edges. Everywhere else the two must agree. Returns the pixels
+ * cleared. */
+size_t
+test_ortho_mask(const struct ortho_plan *p, const uint32_t *tex,
+	uint32_t *cpu, uint32_t *gl)
+{
+	size_t masked = 0;
+	for (size_t i = 0; i < p->count; i++) {
+		const struct ortho_face *f = &p->faces[i];
+		if (f->part < MODEL_LAYER_HEAD)
+			continue;
+		for (int y = f->y0; y < f->y1; y++) {
+			const size_t row = (size_t)y * (size_t)p->width;
+			for (int x = f->x0; x < f->x1; x++) {
+				if (!test_ortho_unsure(p, i, tex, x, y))
+					continue;
+				masked += cpu[row + (size_t)x]
+					|| gl[row + (size_t)x];
+				cpu[row + (size_t)x] = 0;
+				gl[row + (size_t)x] = 0;
+			}
+		}
+	}
+	return masked;
+}
+
+/* Checks every orthographic view of a loaded skin against GL, keeping the
+ * front one to time both ways */
+void
+test_ortho(const struct test_skin *s, struct test_loaded *l)
+{
+	const bool slim = skin_is_slim(&l->img);
+	set_models_texture(l->models, l->texture);
+	for (int v = 0; v < ORTHO_VIEW_COUNT; v++) {
+		const char *name = TextFormat("%s_ortho_%s", s->name,
+			ortho_view_names[v]);
+		struct ortho_plan plan = { 0 };
+		if (!ortho_plan(&plan, (enum ortho_view)v, TEST_ORTHO_SCALE,
+				l->img.width, l->img.height, slim)) {
+			test_fail(name, "could not plan");
+			return;
+		}
+		uint32_t *pixels = malloc(sizeof(*pixels)
+			* (size_t)plan.width * (size_t)plan.height);
+		RenderTexture2D rt = LoadRenderTexture(plan.width, plan.height);
+		if (!pixels || !rt.id) {
+			test_fail(name, "out of memory");
+			free(pixels);
+			ortho_plan_free(&plan);
+			return;
+		}
+
+		ortho_render(&plan, l->img.data, 0, pixels);
+		render_models(rt, l->models, test_ortho_camera(&plan), 0);
+		Image gl = LoadImageFromTexture(rt.texture);
+		ImageFlipVertical(&gl);
+		ImageFormat(&gl, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		const Image cpu = {
+			.data = pixels,
+			.width = plan.width,
+			.height = plan.height,
+			.mipmaps = 1,
+			.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+		};
+		const size_t masked = test_ortho_mask(&plan, l->img.data, pixels,
+			gl.data);
+		printf("note\t%s\t%zu of %d pixels not compared\n", name,
+			masked, plan.width * plan.height);
+		if (!test_compare(name, &cpu, &gl, "GL", 0))
+			test_write_png(TextFormat(TEST_FAILED,
+				TextFormat("%s_gl", name)), &gl);
+		UnloadImage(gl);
+
+		if (v != ORTHO_FRONT) {
+			UnloadRenderTexture(rt);
+			free(pixels);
+			ortho_plan_free(&plan);
+			continue;
+		}
+		l->plan = plan;
+		l->ortho = pixels;
+		l->ortho_rt = rt;
+		l->ortho_cases[0] = test_add(TextFormat("%s_ortho", s->name), l,
+			TEST_ORTHO, 0);
+		l->ortho_cases[1] = test_add(TextFormat("%s_ortho_gl", s->name),
+			l, TEST_ORTHO_GL, 0);
+	}
+}
+
+/* Returns the draw calls made */
+size_t
+test_gallery_draw(RenderTexture2D *rt, Camera camera)
+{
+	BeginTextureMode(*rt);
+	ClearBackground(BLANK);
+	BeginMode3D(camera);
+	size_t draws = gallery_draw(&gallery);
+	EndMode3D();
+	EndTextureMode();
+	return draws;
+}
+
+/* Places the loaded skins in a gallery and checks its instanced drawing
+ * against DrawModel with the same transforms, then fills the gallery up
+ * to TEST_PLAYERS players for a case to time */
+void
+test_gallery(Model shapes[2][MODEL_COUNT])
+{
+	if (!gallery_init(&gallery)) {
+		test_fail("gallery", "out of memory");
+		return;
+	}
+	gallery_rt = LoadRenderTexture(TEST_SIZE, TEST_SIZE);
+	RenderTexture2D want_rt = LoadRenderTexture(TEST_SIZE, TEST_SIZE);
+
+	/* The first row, players as wide as the picture; like gallery_run */
+	const float width = (float)TEST_SKINS * GALLERY_SPACING;
+	Camera camera = {
+		.target = {
+			-((float)TEST_SKINS - 1) * GALLERY_SPACING / 2,
+			GALLERY_ROW - 0.25f - width / 2,
+			0.0f,
+		},
+		.up = { 0.0f, 1.0f, 0.0f },
+		.fovy = width,
+		.projection = CAMERA_ORTHOGRAPHIC,
+	};
+	camera.position = camera.target;
+	camera.position.z = -8.0f;
+
+	/* The reference draws the tiles too, HD skins are scaled down */
+	Image tiles[TEST_SKINS];
+	Texture2D textures[TEST_SKINS];
+	size_t ntiles = 0;
+	BeginTextureMode(want_rt);
+	ClearBackground(BLANK);
+	BeginMode3D(camera);
+	for (size_t i = 0; i < TEST_SKINS; i++) {
+		const struct test_loaded *l = &loaded[i];
+		if (!l->models)
+			continue;
+		Image tile = ImageCopy(l->img);
+		ImageResizeNN(&tile, GALLERY_TILE, GALLERY_TILE);
+		if (!gallery_add(&gallery, &tile)) {
+			UnloadImage(tile);
+			break;
+		}
+		tiles[ntiles] = tile;
+		textures[ntiles] = LoadTextureFromImage(tile);
+
+		const Matrix t = gallery_transform((int)ntiles);
+		Model *models = shapes[skin_is_slim(&tile)];
+		set_models_texture(models, textures[ntiles++]);
+		for (size_t j = 0; j < MODEL_COUNT; j++) {
+			models[j].transform = t;
+			DrawModel(models[j], (Vector3){ 0 }, 1.0f, WHITE);
+			models[j].transform = MatrixIdentity();
+		}
+	}
+	EndMode3D();
+	EndTextureMode();
+
+	test_gallery_draw(&gallery_rt, camera);
+	Image got = LoadImageFromTexture(gallery_rt.texture);
+	Image want = LoadImageFromTexture(want_rt.texture);
+	ImageFlipVertical(&got);
+	ImageFlipVertical(&want);
+	ImageFormat(&got, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	ImageFormat(&want, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	test_image("gallery", &got);
+	if (!test_compare("gallery_parity", &got, &want, "DrawModel",
+			TEST_MAX_DIFF))
+		test_write_png(TextFormat(TEST_FAILED, "gallery_drawmodel"),
+			&want);
+	UnloadImage(got);
+	UnloadImage(want);
+	UnloadRenderTexture(want_rt);
+
+	for (int i = gallery.placed; ntiles && i < TEST_PLAYERS; i++) {
+		if (!gallery_add(&gallery, &tiles[(size_t)i % ntiles]))
+			break;
+	}
+	for (size_t i = 0; i < ntiles; i++) {
+		UnloadImage(tiles[i]);
+		UnloadTexture(textures[i]);
+	}
+
+	/* Every column, as many rows as fit */
+	gallery_camera = camera;
+	gallery_camera.fovy = GALLERY_COLUMNS * GALLERY_SPACING;
+	gallery_camera.target.x = -(GALLERY_COLUMNS - 1) * GALLERY_SPACING / 2;
+	gallery_camera.target.y = GALLERY_ROW - 0.25f - gallery_camera.fovy / 2;
+	gallery_camera.position = gallery_camera.target;
+	gallery_camera.position.z = -8.0f;
+	const size_t draws = test_gallery_draw(&gallery_rt, gallery_camera);
+	printf("note\tgallery\t%d players in %zu draw calls\n", gallery.placed,
+		draws);
+	test_add(TextFormat("gallery_%d", TEST_PLAYERS), NULL, TEST_GALLERY, 0);
+}
+
+static double
+test_length(const float v[3])
+{
+	return sqrt((double)ortho_dot(v, v));
+}
+
+/* Area of the exposed faces of the voxels over face of an RGBA8 skin,
+ * texel by texel, adding how many there are to *exposed */
+double
+test_voxel_faces(const struct voxel_face *face, const unsigned char *pixels,
+	int texw, size_t *exposed)
+{
+	const float *ds = face->ds, *dt = face->dt;
+	const float cross[3] = {
+		ds[1] * dt[2] - ds[2] * dt[1],
+		ds[2] * dt[0] - ds[0] * dt[2],
+		ds[0] * dt[1] - ds[1] * dt[0],
+	};
+	const double outer = test_length(cross);
+	const double across_s = test_length(dt) * face->depth;
+	const double across_t = test_length(ds) * face->depth;
+	double area = 0;
+	for (int t = 0; t < face->h; t++) {
+		for (int s = 0; s < face->w; s++) {
+			const size_t at = ((size_t)(face->y + t) * (size_t)texw
+				+ (size_t)(face->x + s)) * 4 + 3;
+			if (!pixels[at])
+				continue;
+			area += outer;
+			++*exposed;
+			for (int side = 0; side < 4; side++) {
+				const int ns = s + (side == 0) - (side == 1);
+				const int nt = t + (side == 2) - (side == 3);
+				if (ns >= 0 && ns < face->w && nt >= 0 && nt < face->h
+						&& pixels[((size_t)(face->y + nt) * (size_t)texw
+						+ (size_t)(face->x + ns)) * 4 + 3])
+					continue;
+				area += side < 2 ? across_s : across_t;
+				++*exposed;
+			}
+		}
+	}
+	return area;
+}
+
+/* Checks each part's voxels against test_voxel_faces: the same area, in
+ * triangles that face the way their normals do, from at most as many
+ * quads as there are exposed texel faces; then renders them */
+void
+test_voxel(const struct test_skin *s, struct test_loaded *l,
+	RenderTexture2D rt)
+{
+	const bool slim = skin_is_slim(&l->img);
+	struct voxel_part parts[VOXEL_PARTS];
+	struct voxel_mesh m = { 0 };
+	size_t quads = 0, exposed = 0;
+	voxel_plan(parts, l->img.width, l->img.height, slim);
+	for (size_t j = 0; j < VOXEL_PARTS; j++) {
+		size_t faces = 0;
+		double want = 0;
+		for (size_t f = 0; f < 6; f++)
+			want += test_voxel_faces(&parts[j].faces[f], l->img.data,
+				l->img.width, &faces);
+		if (!voxel_build(&m, &parts[j], l->img.data, l->img.width,
+				l->img.height)) {
+			test_fail(s->name, "out of memory");
+			break;
+		}
+
+		double got = 0;
+		size_t backwards = 0;
+		for (size_t v = 0; v < m.count; v += 3) {
+			const float *p = m.pos + v * 3;
+			float e1[3], e2[3];
+			for (size_t k = 0; k < 3; k++) {
+				e1[k] = p[3 + k] - p[k];
+				e2[k] = p[6 + k] - p[k];
+			}
+			const float cross[3] = {
+				e1[1] * e2[2] - e1[2] * e2[1],
+				e1[2] * e2[0] - e1[0] * e2[2],
+				e1[0] * e2[1] - e1[1] * e2[0],
+			};
+			got += test_length(cross) / 2;
+			backwards += ortho_dot(cross, m.normal + v * 3) <= 0;
+		}
+		const char *name = TextFormat("%s_voxel_%zu", s->name, j);
+		if (fabs(got - want) > want * TEST_VOXEL_EPSILON + 1e-9)
+			test_fail(name, TextFormat("area %g, %g exposed", got, want));
+		if (backwards)
+			test_fail(name, TextFormat("%zu triangles face inwards",
+				backwards));
+		if (m.quads > faces || (!m.quads) != (!faces))
+			test_fail(name, TextFormat("%zu quads for %zu exposed faces",
+				m.quads, faces));
+		quads += m.quads;
+		exposed += faces;
+	}
+	voxel_mesh_free(&m);
+	printf("note\t%s\tvoxels in %zu quads for %zu exposed texel faces\n",
+		s->name, quads, exposed);
+
+	struct palette_image packed;
+	if (!palette_pack(&packed, &l->img)) {
+		test_fail(s->name, "out of memory");
+		return;
+	}
+	struct voxel_layer layer = { 0 };
+	voxel_layer_update(&layer, &packed, slim);
+	voxel_layer_texture(&layer, l->texture);
+	palette_free(&packed);
+	set_models_texture(l->models, l->texture);
+
+	BeginTextureMode(rt);
+	ClearBackground(BLANK);
+	BeginMode3D(camera_preset(0));
+	for (size_t j = 0; j < VOXEL_PARTS; j++) {
+		DrawModel(l->models[j], (Vector3){ 0 }, 1.0f, WHITE);
+		if (layer.models[j].meshCount)
+			DrawModel(layer.models[j], (Vector3){ 0 }, 1.0f, WHITE);
+	}
+	EndMode3D();
+	EndTextureMode();
+	voxel_layer_free(&layer);
+
+	Image out = LoadImageFromTexture(rt.texture);
+	ImageFlipVertical(&out);
+	ImageFormat(&out, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	test_image(TextFormat("%s_voxel", s->name), &out);
+	UnloadImage(out);
+}
+
+/* cull_alpha() of every texel whose centre lies in triangle t of mesh,
+ * edges included, on a w x h skin */
+unsigned
+test_cull_texels(const Mesh *mesh, int t, const Image *img)
+{
+	float c[3][2];
+	for (int k = 0; k < 3; k++) {
+		const int i = t * 3 + k;
+		const int v = mesh->indices ? mesh->indices[i] : i;
+		c[k][0] = mesh->texcoords[v * 2] * (float)img->width;
+		c[k][1] = mesh->texcoords[v * 2 + 1] * (float)img->height;
+	}
+	const unsigned char *pixels = img->data;
+	unsigned seen = 0;
+	for (int y = 0; y < img->height; y++) {
+		for (int x = 0; x < img->width; x++) {
+			const float px = (float)x + 0.5f, py = (float)y + 0.5f;
+			int in = 0, out = 0;
+			for (int k = 0; k < 3; k++) {
+				const float *a = c[k], *b = c[(k + 1) % 3];
+				const float e = (b[0] - a[0]) * (py - a[1])
+					- (b[1] - a[1]) * (px - a[0]);
+				in += e > 1e-4f;
+				out += e < -1e-4f;
+			}
+			if (!in || !out)
+				seen |= cull_alpha(pixels[((size_t)y * (size_t)img->width
+					+ (size_t)x) * 4 + 3]);
+		}
+	}
+	return seen;
+}
+
+/* Checks cull_classify() on the skin as RGBA8 and packed against looking
+ * at every texel of each face, as both triangles of a face are sorted
+ * alike; then draws the overlay culled and compares it with drawing all
+ * of it */
+void
+test_cull(const struct test_skin *s, struct test_loaded *l,
+	RenderTexture2D rt)
+{
+	struct palette_image forms[2] = {
+		{
+			.data = l->img.data, .width = l->img.width,
+			.height = l->img.height, .bits = 32,
+			.stride = (size_t)l->img.width * 4,
+		},
+	};
+	if (!palette_pack(&forms[1], &l->img)) {
+		test_fail(s->name, "out of memory");
+		return;
+	}
+
+	struct cull_layer c = { 0 };
+	for (size_t j = 0; j < CULL_PARTS; j++) {
+		if (!cull_plan(&c.parts[j],
+				&l->models[MODEL_LAYER_HEAD + j].meshes[0])) {
+			test_fail(s->name, "out of memory");
+			cull_free(&c);
+			palette_free(&forms[1]);
+			return;
+		}
+	}
+	for (size_t form = 0; form < 2; form++) {
+		cull_classify(&c, &forms[form]);
+		size_t wrong = 0;
+		for (size_t j = 0; j < CULL_PARTS; j++) {
+			const struct cull_part *p = &c.parts[j];
+			const Mesh *mesh = &l->models[MODEL_LAYER_HEAD + j].meshes[0];
+			for (int t = 0; t < p->triangles; t++) {
+				unsigned seen = 0;
+				for (int u = 0; u < p->triangles; u++) {
+					if (!memcmp(p->boxes[t], p->boxes[u],
+							sizeof(p->boxes[t])))
+						seen |= test_cull_texels(mesh, u, &l->img);
+				}
+				const enum cull_kind want = seen == 1 ? CULL_EMPTY
+					: seen == 2 ? CULL_OPAQUE : CULL_BLEND;
+				wrong += p->kinds[t] != want;
+			}
+		}
+		if (wrong)
+			test_fail(TextFormat("%s_cull", s->name), TextFormat(
+				"%zu triangles sorted wrong from %u bit pixels", wrong,
+				forms[form].bits));
+	}
+	printf("note\t%s\toverlay %zu triangles culled, %zu opaque, %zu"
+		" blended, from %u bit pixels\n", s->name,
+		c.triangles[CULL_EMPTY], c.triangles[CULL_OPAQUE],
+		c.triangles[CULL_BLEND], forms[1].bits);
+	if (s->opaque_overlay && !c.triangles[CULL_OPAQUE])
+		test_fail(TextFormat("%s_cull", s->name),
+			"no overlay triangle sorted opaque");
+	cull_free(&c);
+
+	if (!cull_init(&c, l->models)) {
+		test_fail(s->name, "out of memory");
+		palette_free(&forms[1]);
+		return;
+	}
+	cull_update(&c, &forms[1]);
+	palette_free(&forms[1]);
+	set_models_texture(l->models, l->texture);
+
+	render_models(rt, l->models, camera_preset(0), 0);
+	Image want = LoadImageFromTexture(rt.texture);
+	ImageFlipVertical(&want);
+	ImageFormat(&want, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	BeginTextureMode(rt);
+	ClearBackground(BLANK);
+	BeginMode3D(camera_preset(0));
+	for (size_t j = 0; j < MODEL_LAYER_HEAD; j++)
+		DrawModel(l->models[j], (Vector3){ 0 }, 1.0f, WHITE);
+	cull_draw(&c, l->models, 0);
+	EndMode3D();
+	EndTextureMode();
+	Image out = LoadImageFromTexture(rt.texture);
+	ImageFlipVertical(&out);
+	ImageFormat(&out, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	test_compare(TextFormat("%s_cull", s->name), &out, &want,
+		"drawing every triangle", TEST_MAX_DIFF);
+	UnloadImage(out);
+	UnloadImage(want);
+	cull_free(&c);
+}
+
+/* A made-up renderer: its CPU takes cpu seconds a frame, its GPU gpu at
+ * the full size and less with the area */
+struct test_load {
+	const char *name;
+	float cpu, gpu;
+	float budget;
+};
+
+const struct test_load test_loads[] = {
+	{ "light",     0.002f, 0.005f, TEST_DYNRES_BUDGET },
+	{ "gpu_1.5x",  0.002f, 1.5f * TEST_DYNRES_BUDGET, TEST_DYNRES_BUDGET },
+	{ "gpu_4x",    0.002f, 4 * TEST_DYNRES_BUDGET, TEST_DYNRES_BUDGET },
+	{ "cpu_bound", 2 * TEST_DYNRES_BUDGET, 0.001f, TEST_DYNRES_BUDGET },
+	{ "off",       0.002f, 4 * TEST_DYNRES_BUDGET, 0 },
+};
+#define TEST_LOADS (sizeof(test_loads)/sizeof(*test_loads))
+
+/* Seconds of the next frame of load at d's scale, paced to the budget */
+static float
+test_frame(const struct dynres *d, const struct test_load *load)
+{
+	return fmaxf(load->cpu + load->gpu * d->scale * d->scale, load->budget);
+}
+
+/* Feeds dynres_update() each load's frames: loads that fit, that are
+ * bound by the CPU, or that have it turned off keep the full size; the
+ * rest settle where a frame just fits, going over budget only on the
+ * odd step up. From there back to the light load the full size comes
+ * back. Then draws the bundled skin at TEST_DYNRES_SCALE. */
+void
+test_dynres(struct test_loaded *l, RenderTexture2D rt)
+{
+	struct dynres d, scaled = { 0 };
+	for (size_t i = 0; i < TEST_LOADS; i++) {
+		const struct test_load *load = &test_loads[i];
+		const char *name = TextFormat("dynres_%s", load->name);
+		const float room = load->budget - load->cpu;
+		const bool fits = load->budget <= 0 || room <= 0
+			|| load->gpu <= room;
+		const float ideal = fits ? 1 : sqrtf(room / load->gpu);
+		float lo = 1, hi = 0;
+		size_t over = 0;
+		dynres_init(&d, load->budget);
+		for (size_t f = 0; f < TEST_DYNRES_FRAMES; f++) {
+			const float frame = test_frame(&d, load);
+			if (f >= TEST_DYNRES_SETTLED) {
+				over += frame > load->budget * DYNRES_SLACK;
+				lo = fminf(lo, d.scale);
+				hi = fmaxf(hi, d.scale);
+			}
+			dynres_update(&d, frame, load->cpu);
+		}
+		if (fits ? d.changes != 0 : lo < ideal - 2 * DYNRES_STEP
+				|| hi > ideal + 2 * DYNRES_STEP
+				|| (double)over > TEST_DYNRES_OVER
+				* (TEST_DYNRES_FRAMES - TEST_DYNRES_SETTLED))
+			test_fail(name, TextFormat("scale %.3f to %.3f for %.3f, %zu"
+				" frames over budget, %zu changes", (double)lo,
+				(double)hi, (double)ideal, over, d.changes));
+		printf("note\t%s\tscale %.3f to %.3f for %.3f, %zu frames over"
+			" budget, %zu changes\n", name, (double)lo, (double)hi,
+			(double)ideal, over, d.changes);
+		if (!fits)
+			scaled = d;
+	}
+
+	/* From where the last load that did not fit left it */
+	d = scaled;
+	size_t frames = 0;
+	while (d.scale < 1 && frames < TEST_DYNRES_FRAMES) {
+		dynres_update(&d, test_frame(&d, &test_loads[0]),
+			test_loads[0].cpu);
+		frames++;
+	}
+	if (d.scale < 1)
+		test_fail("dynres_recover", TextFormat("at %.3f after %zu frames",
+			(double)d.scale, frames));
+	printf("note\tdynres_recover\tfull size after %zu frames\n", frames);
+
+	if (!l->models)
+		return;
+	set_models_texture(l->models, l->texture);
+	render_models(rt, l->models, camera_preset(0), 0);
+	Image full = LoadImageFromTexture(rt.texture);
+	ImageFlipVertical(&full);
+	ImageFormat(&full, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	dynres_init(&d, TEST_DYNRES_BUDGET);
+	d.scale = TEST_DYNRES_SCALE;
+	if (!dynres_begin(&d, TEST_SIZE, TEST_SIZE)) {
+		test_fail("dynres", "no render texture");
+		UnloadImage(full);
+		return;
+	}
+	ClearBackground(BLANK);
+	BeginMode3D(camera_preset(0));
+	for (size_t j = 0; j < MODEL_COUNT; j++)
+		DrawModel(l->models[j], (Vector3){ 0 }, 1.0f, WHITE);
+	EndMode3D();
+	EndTextureMode();
+	BeginTextureMode(rt);
+	ClearBackground(BLANK);
+	dynres_draw(&d);
+	EndTextureMode();
+	dynres_free(&d);
+
+	Image out = LoadImageFromTexture(rt.texture);
+	ImageFlipVertical(&out);
+	ImageFormat(&out, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	test_image("default_dynres", &out);
+	test_compare("default_dynres_full", &out, &full, "the full size",
+		TEST_DYNRES_BLUR);
+	UnloadImage(out);
+	UnloadImage(full);
+}
+
+/* Where each part should turn, in texels: the neck, the shoulders half an
+ * arm's depth under its top and the hips, for classic and slim arms */
+const float test_pivots[2][ANIM_JOINTS][3] = {
+	{
+		[MODEL_HEAD] = { 0, 24, 0 },
+		[MODEL_BODY] = { 0, 24, 0 },
+		[MODEL_LARM] = { -6, 22, 0 },
+		[MODEL_LLEG] = { -1.9f, 12, 0 },
+		[MODEL_RARM] = { 6, 22, 0 },
+		[MODEL_RLEG] = { 1.9f, 12, 0 },
+	},
+	{
+		[MODEL_HEAD] = { 0, 24, 0 },
+		[MODEL_BODY] = { 0, 24, 0 },
+		[MODEL_LARM] = { -5.5f, 22, 0 },
+		[MODEL_LLEG] = { -1.9f, 12, 0 },
+		[MODEL_RARM] = { 5.5f, 22, 0 },
+		[MODEL_RLEG] = { 1.9f, 12, 0 },
+	},
+};
+
+/* Checks the rigs of both shapes, that every pose keeps each part's pivot
+ * in place, and that a batch evaluated four at a time agrees with one at a
+ * time; then renders the bundled skin walking and waving */
+void
+test_anim(Model shapes[2][MODEL_COUNT], struct test_loaded *l,
+	RenderTexture2D rt)
+{
+	struct anim_rig rigs[2];
+	for (size_t slim = 0; slim < 2; slim++) {
+		BoundingBox parts[ANIM_JOINTS];
+		for (size_t j = 0; j < ANIM_JOINTS; j++)
+			parts[j] = GetMeshBoundingBox(shapes[slim][j].meshes[0]);
+		anim_rig_init(&rigs[slim], parts);
+		for (size_t j = 0; j < ANIM_JOINTS; j++) {
+			const float *got = rigs[slim].pivot[j];
+			const float *want = test_pivots[slim][j];
+			if (fabsf(got[0] - want[0] / 16) > TEST_ANIM_EPSILON
+					|| fabsf(got[1] - want[1] / 16) > TEST_ANIM_EPSILON
+					|| fabsf(got[2] - want[2] / 16) > TEST_ANIM_EPSILON)
+				test_fail(TextFormat("anim_pivot_%zu_%zu", slim, j),
+					TextFormat("at %g %g %g, want %g %g %g",
+					got[0] * 16, got[1] * 16, got[2] * 16,
+					want[0], want[1], want[2]));
+		}
+	}
+
+	/* Every animation at a spread of phases, in mixed groups of four */
+	struct anim_batch lanes = { 0 }, one = { 0 };
+	const size_t n = ANIM_COUNT * ANIM_COUNT * 16;
+	if (!anim_batch_resize(&lanes, n) || !anim_batch_resize(&one, n)) {
+		test_fail("anim", "out of memory");
+		anim_batch_free(&lanes);
+		anim_batch_free(&one);
+		return;
+	}
+	for (size_t i = 0; i < n; i++) {
+		lanes.anim[i] = one.anim[i] = (unsigned char)(i < n / 2
+			? i / 4 % ANIM_COUNT : i * 7 % 11 % ANIM_COUNT);
+		lanes.phase[i] = one.phase[i] = (float)(i % 37) / 37;
+	}
+	anim_batch_update(&lanes, 0.3f);
+	for (size_t i = 0; i < one.cap; i++)
+		anim_eval_one(&one, i, 0.3f);
+
+	float worst = 0, drift = 0;
+	for (size_t i = 0; i < n; i++) {
+		worst = fmaxf(worst, fabsf(lanes.phase[i] - one.phase[i]));
+		for (size_t j = 0; j < ANIM_JOINTS; j++) {
+			for (size_t e = 0; e < ANIM_TURN; e++) {
+				const size_t at = anim_turn_index(i, j, e);
+				worst = fmaxf(worst, fabsf(lanes.turn[at] - one.turn[at]));
+			}
+			const float *p = rigs[i % 2].pivot[j];
+			const Vector3 v = Vector3Transform((Vector3){ p[0], p[1], p[2] },
+				anim_matrix(&lanes, &rigs[i % 2], i, j));
+			drift = fmaxf(drift, Vector3Distance(v,
+				(Vector3){ p[0], p[1], p[2] }));
+		}
+	}
+	if (worst > TEST_ANIM_EPSILON)
+		test_fail("anim_lanes", TextFormat("differ from one at a time by"
+			" %g", worst));
+	if (drift > TEST_ANIM_EPSILON)
+		test_fail("anim_pivots", TextFormat("pivots move by %g", drift));
+	printf("note\tanim\t%zu characters, lanes within %g of one at a time,"
+		" pivots within %g\n", n, worst, drift);
+
+	/* A quarter into the loop, where the limbs swing furthest */
+	if (l->models) {
+		const bool slim = l->models == shapes[1];
+		set_models_texture(l->models, l->texture);
+		for (size_t a = ANIM_WALK; a < ANIM_COUNT; a++) {
+			one.anim[0] = (unsigned char)a;
+			one.phase[0] = 0;
+			anim_batch_update(&one, 0.25f / anim_curves[a].hz);
+			anim_apply(l->models, &one, &rigs[slim], 0);
+			render_models(rt, l->models, camera_preset(0), 0);
+			Image out = LoadImageFromTexture(rt.texture);
+			ImageFlipVertical(&out);
+			ImageFormat(&out, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+			test_image(TextFormat("default_%s", anim_names[a]), &out);
+			UnloadImage(out);
+		}
+		for (size_t j = 0; j < MODEL_COUNT; j++)
+			l->models[j].transform = MatrixIdentity();
+	}
+	anim_batch_free(&lanes);
+	anim_batch_free(&one);
+}
+
+void
+test_unload(struct test_loaded *l)
+{
+	UnloadRenderTexture(l->ortho_rt);
+	free(l->ortho);
+	ortho_plan_free(&l->plan);
+	UnloadTexture(l->texture);
+	UnloadImage(l->img);
+	UnloadFileData(l->owned);
+	*l = (struct test_loaded){ 0 };
+}
+
+/* Milliseconds for one of c, the mean of a batch */
+double
+test_run(const struct test_case *c, RenderTexture2D rt)
+{
+	const struct test_loaded *l = c->skin;
+	if (l)
+		set_models_texture(l->models, l->texture);
+	long long t0 = now_ns();
+	for (size_t b = 0; b < TEST_BATCH; b++) {
+		switch (c->kind) {
+		case TEST_LOAD: {
+			Image img = test_decode(l->file, l->size);
+			UnloadTexture(LoadTextureFromImage(img));
+			UnloadImage(img);
+			break;
+		}
+		case TEST_RENDER:
+			render_models(rt, l->models,
+				camera_preset((size_t)c->preset), 0);
+			UnloadImage(LoadImageFromTexture(rt.texture));
+			break;
+		case TEST_ORTHO:
+			ortho_render(&l->plan, l->img.data, 0, l->ortho);
+			break;
+		case TEST_ORTHO_GL:
+			render_models(l->ortho_rt, l->models,
+				test_ortho_camera(&l->plan), 0);
+			UnloadImage(LoadImageFromTexture(l->ortho_rt.texture));
+			break;
+		case TEST_GALLERY:
+			test_gallery_draw(&gallery_rt, gallery_camera);
+			UnloadImage(LoadImageFromTexture(gallery_rt.texture));
+			break;
+		}
+	}
+	return (double)(now_ns() - t0) / 1e6 / TEST_BATCH;
+}
+
+bool
+test_slow(const struct test_case *c)
+{
+	const double want = c->baseline_ms, got = c->best_ms;
+	return want > 0 && (got - want) / want * 100 > threshold
+		&& got - want > TEST_NOISE_MS;
+}
+
+/* Times the cases TEST_RUNS more times, all of them or only the slow ones,
+ * round robin so a moment of the machine being busy lands on every case
+ * alike */
+void
+test_round(RenderTexture2D rt, bool only_slow)
+{
+	for (size_t r = 0; r < TEST_RUNS; r++) {
+		for (size_t i = 0; i < case_count; i++) {
+			if (only_slow && !test_slow(&cases[i]))
+				continue;
+			const double ms = test_run(&cases[i], rt);
+			if (ms < cases[i].best_ms)
+				cases[i].best_ms = ms;
+		}
+	}
+}
+
+bool
+baseline_write(const char *fp)
+{
+	FILE *f = fopen(fp, "w");
+	if (!f)
+		return 0;
+	/* One case per line, so baseline_read can read it back with sscanf */
+	fprintf(f, "{\n\t\"runs\": %d,\n\t\"batch\": %d,\n\t\"cases\": {\n",
+		TEST_RUNS, TEST_BATCH);
+	for (size_t i = 0; i < case_count; i++)
+		fprintf(f, "\t\t\"%s\": { \"best_ms\": %.4f }%s\n",
+			cases[i].name, cases[i].best_ms,
+			i + 1 < case_count ? "," : "");
+	fprintf(f, "\t}\n}\n");
+	return fclose(f) == 0;
+}
+
+bool
+baseline_read(const char *fp)
+{
+	FILE *f = fopen(fp, "r");
+	if (!f)
+		return 0;
+	char line[256];
+	while (fgets(line, sizeof(line), f)) {
+		char name[32];
+		double ms;
+		if (sscanf(line, " \"%31[^\"]\": { \"best_ms\": %lf", name, &ms) != 2)
+			continue;
+		for (size_t i = 0; i < case_count; i++) {
+			if (!strcmp(name, cases[i].name))
+				cases[i].baseline_ms = ms;
+		}
+	}
+	fclose(f);
+	return 1;
+}
+
+/* Fails every case past threshold, or missing from the baseline */
+void
+baseline_compare(void)
+{
+	printf("\ncase\t\tbaseline\tcurrent\t\tdelta\n");
+	for (size_t i = 0; i < case_count; i++) {
+		const struct test_case *c = &cases[i];
+		if (c->baseline_ms <= 0) {
+			test_fail(c->name, "not in the baseline, run with -u");
+			continue;
+		}
+		const bool slow = test_slow(c);
+		printf("%-15s\t%8.3f ms\t%8.3f ms\t%+6.1f%%%s\n", c->name,
+			c->baseline_ms, c->best_ms,
+			(c->best_ms - c->baseline_ms) / c->baseline_ms * 100,
+			slow ? "\tFAIL" : "");
+		failed += slow;
+	}
+}
+
+void
+usage(void)
+{
+	fprintf(stderr, "Usage: skin-test [-u] [-t threshold%%]\n"
+		"\t-u\twrite the goldens and the baseline from this run\n"
+		"\t-t\tallowed slowdown against the baseline (default %.0f%%)\n",
+		TEST_THRESHOLD);
+}
+
+int
+main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-u"))
+			update = true;
+		else if (!strcmp(argv[i], "-t") && i + 1 < argc
+				&& atof(argv[i + 1]) > 0)
+			threshold = atof(argv[++i]);
+		else {
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	SetTraceLogLevel(LOG_WARNING);
+	if (!headless_init(TEST_SIZE, TEST_SIZE, "skin-test")) {
+		fprintf(stderr, "No GL context!\n");
+		return EXIT_FAILURE;
+	}
+	png_init();
+	ortho_init();
+
+	Model shapes[2][MODEL_COUNT];
+	for (size_t slim = 0; slim < 2; slim++) {
+		if (!load_models(shapes[slim], slim, (Texture2D){ 0 })) {
+			fprintf(stderr, "Out of memory!\n");
+			return EXIT_FAILURE;
+		}
+	}
+	RenderTexture2D rt = LoadRenderTexture(TEST_SIZE, TEST_SIZE);
+
+	for (size_t i = 0; i < TEST_SKINS; i++)
+		test_skin(&test_skins[i], &loaded[i], shapes, rt);
+	for (size_t i = 0; i < TEST_SKINS; i++) {
+		if (loaded[i].models)
+			test_ortho(&test_skins[i], &loaded[i]);
+	}
+	for (size_t i = 0; i < TEST_SKINS; i++) {
+		if (loaded[i].models)
+			test_voxel(&test_skins[i], &loaded[i], rt);
+	}
+	for (size_t i = 0; i < TEST_SKINS; i++) {
+		if (loaded[i].models)
+			test_cull(&test_skins[i], &loaded[i], rt);
+	}
+	test_gallery(shapes);
+	test_anim(shapes, &loaded[0], rt);
+	test_dynres(&loaded[0], rt);
+
+	test_round(rt, false);
+	if (update) {
+		if (!baseline_write(TEST_BASELINE))
+			test_fail(TEST_BASELINE, "could not write");
+		else if (!failed)
+			printf("Wrote %s and %zu goldens in %s\n", TEST_BASELINE,
+				goldens, TEST_GOLDEN);
+	} else if (!baseline_read(TEST_BASELINE)) {
+		test_fail(TEST_BASELINE, "no baseline, run with -u");
+	} else {
+		for (size_t t = 0; t < TEST_TRIES; t++) {
+			size_t slow = 0;
+			for (size_t i = 0; i < case_count; i++)
+				slow += test_slow(&cases[i]);
+			if (!slow)
+				break;
+			printf("note\t%zu cases slow, timing them again\n", slow);
+			test_round(rt, true);
+		}
+		baseline_compare();
+	}
+	for (size_t i = 0; i < TEST_SKINS; i++) {
+		struct test_case **c = loaded[i].ortho_cases;
+		if (c[0] && c[1])
+			printf("note\t%s\tfront view %.3f ms on the CPU, %.3f ms"
+				" through GL, %.1fx\n", test_skins[i].name,
+				c[0]->best_ms, c[1]->best_ms,
+				c[1]->best_ms / c[0]->best_ms);
+	}
+	printf("%zu cases, %zu failed\n", case_count, failed);
+
+	UnloadRenderTexture(rt);
+	UnloadRenderTexture(gallery_rt);
+	gallery_free(&gallery);
+	for (size_t i = 0; i < TEST_SKINS; i++)
+		test_unload(&loaded[i]);
+	for (size_t slim = 0; slim < 2; slim++) {
+		for (size_t i = 0; i < MODEL_COUNT; i++)
+			UnloadModel(shapes[slim][i]);
+	}
+	png_scratch_free(&png);
+	headless_close();
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* The few thread primitives the viewer needs for background loading.
+ * pthreads everywhere except MSVC, which only has C11 threads. */
+
+#if defined(_MSC_VER)
+#include <threads.h>
+
+typedef thrd_t thread_handle;
+typedef mtx_t thread_mutex;
+typedef cnd_t thread_cond;
+#define THREAD_RETURN int
+
+#define thread_mutex_init(m)    mtx_init((m), mtx_plain)
+#define thread_mutex_destroy(m) mtx_destroy(m)
+#define thread_mutex_lock(m)    mtx_lock(m)
+#define thread_mutex_unlock(m)  mtx_unlock(m)
+#define thread_cond_init(c)     cnd_init(c)
+#define thread_cond_destroy(c)  cnd_destroy(c)
+#define thread_cond_wait(c, m)  cnd_wait((c), (m))
+#define thread_cond_signal(c)   cnd_signal(c)
+#define thread_cond_broadcast(c) cnd_broadcast(c)
+#else
+#include <pthread.h>
+
+typedef pthread_t thread_handle;
+typedef pthread_mutex_t thread_mutex;
+typedef pthread_cond_t thread_cond;
+#define THREAD_RETURN void *
+
+#define thread_mutex_init(m)    pthread_mutex_init((m), NULL)
+#define thread_mutex_destroy(m) pthread_mutex_destroy(m)
+#define thread_mutex_lock(m)    pthread_mutex_lock(m)
+#define thread_mutex_unlock(m)  pthread_mutex_unlock(m)
+#define thread_cond_init(c)     pthread_cond_init((c), NULL)
+#define thread_cond_destroy(c)  pthread_cond_destroy(c)
+#define thread_cond_wait(c, m)  pthread_cond_wait((c), (m))
+#define thread_cond_signal(c)   pthread_cond_signal(c)
+#define thread_cond_broadcast(c) pthread_cond_broadcast(c)
+#endif
+
+struct thread_start {
+	void (*fn)(void *);
+	void *arg;
+};
+
+static THREAD_RETURN
+thread_trampoline(void *p)
+{
+	struct thread_start s = *(struct thread_start *)p;
+	free(p);
+	s.fn(s.arg);
+	return 0;
+}
+
+bool
+thread_start(thread_handle *t, void (*fn)(void *), void *arg)
+{
+	struct thread_start *s = malloc(sizeof(*s));
+	if (!s)
+		return 0;
+	s->fn = fn;
+	s->arg = arg;
+#if defined(_MSC_VER)
+	if (thrd_create(t, thread_trampoline, s) == thrd_success)
+		return 1;
+#else
+	if (!pthread_create(t, NULL, thread_trampoline, s))
+		return 1;
+#endif
+	free(s);
+	return 0;
+}
+
+void
+thread_join(thread_handle t)
+{
+#if defined(_MSC_VER)
+	thrd_join(t, NULL);
+#else
+	pthread_join(t, NULL);
+#endif
+}
+
+#endif /* THREAD_H */
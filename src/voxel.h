@@ -0,0 +1,454 @@
+#ifndef VOXEL_H
+#define VOXEL_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "skin.h"
+#include "ortho.h"
+#include "palette.h"
+
+/* The overlay as voxels instead of flat shells: every texel of an overlay
+ * face that is not fully transparent becomes a cube one texel across,
+ * standing on the face of the part under it. Faces towards the part and
+ * between neighbouring cubes are never seen and left out; what is left is
+ * merged greedily, outer faces into rectangles and side faces into strips,
+ * with UVs running across the merged quad so it still shows every texel.
+ *
+ * Which faces exist only depends on which texels are covered, so each
+ * part keeps a hash of that and is rebuilt only when it changes; drawing
+ * over a transparent texel, or recolouring, costs nothing. Faces and UVs
+ * are those of the overlay boxes in skin.h, moved onto the box of the part
+ * under them. */
+
+#define VOXEL_PARTS MODEL_LAYER_HEAD /* one for each part with an overlay */
+
+/* An overlay face, texel (x + s, y + t) of the skin standing on
+ * origin + s * ds + t * dt */
+struct voxel_face {
+	int x, y, w, h;
+	float origin[3], ds[3], dt[3];
+	float normal[3];
+	float depth; /* one texel */
+};
+
+struct voxel_part {
+	struct voxel_face faces[6];
+};
+
+/* Triangles being built, three floats of position and normal and two of
+ * UV a vertex */
+struct voxel_mesh {
+	float *pos, *uv, *normal;
+	size_t count, cap;
+	size_t quads;
+	unsigned char *mask;
+	size_t mask_cap;
+};
+
+struct voxel_layer {
+	Model models[VOXEL_PARTS];
+	uint64_t keys[VOXEL_PARTS];
+	bool built[VOXEL_PARTS];
+	size_t quads[VOXEL_PARTS];
+	struct voxel_part parts[VOXEL_PARTS];
+	int texw, texh;
+	bool slim;
+	struct voxel_mesh mesh;
+};
+
+static void
+voxel_clamp(float out[3], const float in[3], const float lo[3],
+	const float hi[3])
+{
+	for (size_t k = 0; k < 3; k++)
+		out[k] = fminf(fmaxf(in[k], lo[k]), hi[k]);
+}
+
+/* Lays the overlay faces out for a texw x texh skin */
+void
+voxel_plan(struct voxel_part parts[VOXEL_PARTS], int texw, int texh,
+	bool slim)
+{
+	for (size_t j = 0; j < VOXEL_PARTS; j++) {
+		float lo[3], hi[3];
+		skin_box_bounds(j, slim, lo, hi);
+
+		for (size_t f = 0; f < 6; f++) {
+			struct voxel_face *face = &parts[j].faces[f];
+			float pos[4][3], uv[4][2];
+			skin_face(VOXEL_PARTS + j, slim, f, pos, uv);
+			int u[4], r[4];
+			for (size_t v = 0; v < 4; v++) {
+				u[v] = (int)floorf(uv[v][0] * (float)texw + 0.5f);
+				r[v] = (int)floorf(uv[v][1] * (float)texh + 0.5f);
+			}
+			/* Corners a (first texel), b (along x) and c (along y) */
+			size_t a = 0, b = 0, c = 0;
+			for (size_t v = 1; v < 4; v++) {
+				if (u[v] <= u[a] && r[v] <= r[a]) a = v;
+				if (u[v] >= u[b] && r[v] <= r[b]) b = v;
+				if (u[v] <= u[c] && r[v] >= r[c]) c = v;
+			}
+			*face = (struct voxel_face){
+				.x = u[a], .y = r[a], .w = u[b] - u[a], .h = r[c] - r[a],
+			};
+			if (face->w <= 0 || face->h <= 0 || face->x < 0 || face->y < 0
+					|| face->x + face->w > texw
+					|| face->y + face->h > texh) {
+				face->w = face->h = 0;
+				continue;
+			}
+
+			float pa[3], pb[3], pc[3];
+			voxel_clamp(pa, pos[a], lo, hi);
+			voxel_clamp(pb, pos[b], lo, hi);
+			voxel_clamp(pc, pos[c], lo, hi);
+			for (size_t k = 0; k < 3; k++) {
+				face->origin[k] = pa[k];
+				face->ds[k] = (pb[k] - pa[k]) / (float)face->w;
+				face->dt[k] = (pc[k] - pa[k]) / (float)face->h;
+				face->normal[k] = skin_faces[f].normal[k];
+			}
+			face->depth = sqrtf(ortho_dot(face->ds, face->ds));
+		}
+	}
+}
+
+/* Alpha of the first texel of row t of face, four bytes a texel. Faces
+ * lie inside the skin they were planned for. */
+static const unsigned char *
+voxel_alpha(const struct voxel_face *face, const unsigned char *pixels,
+	int texw, int t)
+{
+	return pixels + ((size_t)(face->y + t) * (size_t)texw
+		+ (size_t)face->x) * 4 + 3;
+}
+
+/* Hash of which texels of part are covered */
+uint64_t
+voxel_key(const struct voxel_part *part, const unsigned char *pixels,
+	int texw)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (size_t f = 0; f < 6; f++) {
+		const struct voxel_face *face = &part->faces[f];
+		for (int t = 0; t < face->h; t++) {
+			const unsigned char *alpha = voxel_alpha(face, pixels, texw, t);
+			uint64_t bits = 0;
+			for (int s = 0; s < face->w; s++) {
+				bits = bits << 1 | (alpha[s * 4] != 0);
+				if (s % 64 == 63 || s == face->w - 1) {
+					h ^= bits;
+					h *= 0x100000001b3ULL;
+					bits = 0;
+				}
+			}
+		}
+	}
+	return h;
+}
+
+static bool
+voxel_reserve(struct voxel_mesh *m, size_t more)
+{
+	if (m->count + more <= m->cap)
+		return 1;
+	size_t cap = m->cap ? m->cap : 1024;
+	while (cap < m->count + more)
+		cap *= 2;
+	float *pos = realloc(m->pos, sizeof(*pos) * 3 * cap);
+	if (pos)
+		m->pos = pos;
+	float *uv = realloc(m->uv, sizeof(*uv) * 2 * cap);
+	if (uv)
+		m->uv = uv;
+	float *normal = realloc(m->normal, sizeof(*normal) * 3 * cap);
+	if (normal)
+		m->normal = normal;
+	if (!pos || !uv || !normal)
+		return 0;
+	m->cap = cap;
+	return 1;
+}
+
+/* Two triangles facing n */
+static bool
+voxel_quad(struct voxel_mesh *m, float p[4][3], float uv[4][2],
+	const float n[3])
+{
+	if (!voxel_reserve(m, 6))
+		return 0;
+	float e1[3], e2[3];
+	for (size_t k = 0; k < 3; k++) {
+		e1[k] = p[1][k] - p[0][k];
+		e2[k] = p[2][k] - p[0][k];
+	}
+	const float cross[3] = {
+		e1[1] * e2[2] - e1[2] * e2[1],
+		e1[2] * e2[0] - e1[0] * e2[2],
+		e1[0] * e2[1] - e1[1] * e2[0],
+	};
+	static const size_t ccw[6] = { 0, 1, 2, 0, 2, 3 };
+	static const size_t cw[6] = { 0, 2, 1, 0, 3, 2 };
+	const size_t *order = ortho_dot(cross, n) > 0 ? ccw : cw;
+	for (size_t i = 0; i < 6; i++, m->count++) {
+		memcpy(m->pos + m->count * 3, p[order[i]], sizeof(p[0]));
+		memcpy(m->uv + m->count * 2, uv[order[i]], sizeof(uv[0]));
+		memcpy(m->normal + m->count * 3, n, sizeof(float) * 3);
+	}
+	m->quads++;
+	return 1;
+}
+
+/* Corner of texel (s, t) of face, out depths from the part */
+static void
+voxel_point(const struct voxel_face *face, float s, float t, float out,
+	float p[3])
+{
+	for (size_t k = 0; k < 3; k++)
+		p[k] = face->origin[k] + s * face->ds[k] + t * face->dt[k]
+			+ out * face->depth * face->normal[k];
+}
+
+static bool
+voxel_face_build(struct voxel_mesh *m, const struct voxel_face *face,
+	const unsigned char *pixels, int texw, int texh)
+{
+	const int w = face->w, h = face->h;
+	const size_t n = (size_t)w * (size_t)h;
+	if (!n)
+		return 1;
+	if (n > m->mask_cap) {
+		unsigned char *mask = realloc(m->mask, n);
+		if (!mask)
+			return 0;
+		m->mask = mask;
+		m->mask_cap = n;
+	}
+	/* 1 covered, 2 covered and its outer face emitted */
+	unsigned char *mask = m->mask;
+	for (int t = 0; t < h; t++) {
+		const unsigned char *alpha = voxel_alpha(face, pixels, texw, t);
+		for (int s = 0; s < w; s++)
+			mask[t * w + s] = alpha[s * 4] != 0;
+	}
+
+	const float tw = (float)texw, th = (float)texh;
+	float p[4][3], uv[4][2];
+
+	/* Outer faces, greedy rectangles */
+	for (int t = 0; t < h; t++) {
+		for (int s = 0; s < w; s++) {
+			if (mask[t * w + s] != 1)
+				continue;
+			int rw = 1, rh = 1;
+			while (s + rw < w && mask[t * w + s + rw] == 1)
+				rw++;
+			for (bool full = true; full && t + rh < h; ) {
+				for (int k = 0; k < rw && full; k++)
+					full = mask[(t + rh) * w + s + k] == 1;
+				if (full)
+					rh++;
+			}
+			for (int dy = 0; dy < rh; dy++)
+				memset(mask + (t + dy) * w + s, 2, (size_t)rw);
+
+			const float s0 = (float)s, s1 = (float)(s + rw);
+			const float t0 = (float)t, t1 = (float)(t + rh);
+			voxel_point(face, s0, t0, 1, p[0]);
+			voxel_point(face, s1, t0, 1, p[1]);
+			voxel_point(face, s1, t1, 1, p[2]);
+			voxel_point(face, s0, t1, 1, p[3]);
+			const float u0 = ((float)face->x + s0) / tw;
+			const float u1 = ((float)face->x + s1) / tw;
+			const float v0 = ((float)face->y + t0) / th;
+			const float v1 = ((float)face->y + t1) / th;
+			memcpy(uv, (float[4][2]){ { u0, v0 }, { u1, v0 },
+				{ u1, v1 }, { u0, v1 } }, sizeof(uv));
+			if (!voxel_quad(m, p, uv, face->normal))
+				return 0;
+		}
+	}
+
+	/* Side faces where there is no neighbour, strips along the edge.
+	 * Each samples its own texel's centre across its depth. */
+	for (int side = 0; side < 4; side++) {
+		const bool along_t = side < 2; /* faces facing -s or +s */
+		const int d = side % 2 ? 1 : -1;
+		const int lines = along_t ? w : h, len = along_t ? h : w;
+		float normal[3];
+		const float *dir = along_t ? face->ds : face->dt;
+		for (size_t k = 0; k < 3; k++)
+			normal[k] = (float)d * dir[k] / face->depth;
+
+		/* Lines are columns when along_t, rows otherwise */
+		const size_t step = along_t ? 1 : (size_t)w;
+		const size_t next = along_t ? (size_t)w : 1;
+		for (int a = 0; a < lines; a++) {
+			const unsigned char *line = mask + (size_t)a * step;
+			const unsigned char *over = a + d < 0 || a + d >= lines
+				? NULL : line + (ptrdiff_t)d * (ptrdiff_t)step;
+			for (int b = 0; b < len; ) {
+				size_t at = (size_t)b * next;
+				if (!line[at] || (over && over[at])) {
+					b++;
+					continue;
+				}
+				int run = 1;
+				for (at += next; b + run < len && line[at]
+						&& !(over && over[at]); at += next)
+					run++;
+
+				const float e = (float)(d > 0 ? a + 1 : a);
+				const float b0 = (float)b, b1 = (float)(b + run);
+				const float mid = ((float)a + 0.5f);
+				if (along_t) {
+					voxel_point(face, e, b0, 0, p[0]);
+					voxel_point(face, e, b1, 0, p[1]);
+					voxel_point(face, e, b1, 1, p[2]);
+					voxel_point(face, e, b0, 1, p[3]);
+					const float u = ((float)face->x + mid) / tw;
+					const float v0 = ((float)face->y + b0) / th;
+					const float v1 = ((float)face->y + b1) / th;
+					memcpy(uv, (float[4][2]){ { u, v0 }, { u, v1 },
+						{ u, v1 }, { u, v0 } }, sizeof(uv));
+				} else {
+					voxel_point(face, b0, e, 0, p[0]);
+					voxel_point(face, b1, e, 0, p[1]);
+					voxel_point(face, b1, e, 1, p[2]);
+					voxel_point(face, b0, e, 1, p[3]);
+					const float v = ((float)face->y + mid) / th;
+					const float u0 = ((float)face->x + b0) / tw;
+					const float u1 = ((float)face->x + b1) / tw;
+					memcpy(uv, (float[4][2]){ { u0, v }, { u1, v },
+						{ u1, v }, { u0, v } }, sizeof(uv));
+				}
+				if (!voxel_quad(m, p, uv, normal))
+					return 0;
+				b += run;
+			}
+		}
+	}
+	return 1;
+}
+
+/* Builds the voxels of part into m from RGBA8 pixels. False if memory
+ * runs out. */
+bool
+voxel_build(struct voxel_mesh *m, const struct voxel_part *part,
+	const unsigned char *pixels, int texw, int texh)
+{
+	m->count = m->quads = 0;
+	for (size_t f = 0; f < 6; f++) {
+		if (!voxel_face_build(m, &part->faces[f], pixels, texw, texh))
+			return 0;
+	}
+	return 1;
+}
+
+void
+voxel_mesh_free(struct voxel_mesh *m)
+{
+	free(m->pos);
+	free(m->uv);
+	free(m->normal);
+	free(m->mask);
+	*m = (struct voxel_mesh){ 0 };
+}
+
+/* A model of what m holds, needs a GL context. No meshes if m is empty or
+ * memory runs out. */
+static Model
+voxel_upload(const struct voxel_mesh *m)
+{
+	if (!m->count)
+		return (Model){ 0 };
+	Mesh mesh = {
+		.vertexCount = (int)m->count,
+		.triangleCount = (int)(m->count / 3),
+		.vertices = RL_MALLOC(sizeof(float) * 3 * m->count),
+		.texcoords = RL_MALLOC(sizeof(float) * 2 * m->count),
+		.normals = RL_MALLOC(sizeof(float) * 3 * m->count),
+	};
+	if (!mesh.vertices || !mesh.texcoords || !mesh.normals) {
+		UnloadMesh(mesh);
+		return (Model){ 0 };
+	}
+	memcpy(mesh.vertices, m->pos, sizeof(float) * 3 * m->count);
+	memcpy(mesh.texcoords, m->uv, sizeof(float) * 2 * m->count);
+	memcpy(mesh.normals, m->normal, sizeof(float) * 3 * m->count);
+	UploadMesh(&mesh, false);
+	return LoadModelFromMesh(mesh);
+}
+
+/* Brings the voxels up to date with skin on slim or classic arms,
+ * rebuilding the parts whose covered texels changed, and logs what that
+ * took. Needs a GL context. */
+void
+voxel_layer_update(struct voxel_layer *l, const struct palette_image *skin,
+	bool slim)
+{
+	const double start = GetTime();
+	Image img = palette_expand(skin);
+	if (!img.data)
+		return;
+	if (img.width != l->texw || img.height != l->texh || slim != l->slim) {
+		voxel_plan(l->parts, img.width, img.height, slim);
+		l->texw = img.width;
+		l->texh = img.height;
+		l->slim = slim;
+		memset(l->built, 0, sizeof(l->built));
+	}
+
+	size_t rebuilt = 0, quads = 0;
+	for (size_t j = 0; j < VOXEL_PARTS; j++) {
+		const uint64_t key = voxel_key(&l->parts[j], img.data,
+			img.width);
+		if (l->built[j] && key == l->keys[j]) {
+			quads += l->quads[j];
+			continue;
+		}
+		UnloadModel(l->models[j]);
+		l->models[j] = (Model){ 0 };
+		l->built[j] = false;
+		if (!voxel_build(&l->mesh, &l->parts[j], img.data,
+				img.width, img.height))
+			continue;
+		l->models[j] = voxel_upload(&l->mesh);
+		l->keys[j] = key;
+		l->quads[j] = l->mesh.quads;
+		l->built[j] = true;
+		quads += l->quads[j];
+		rebuilt++;
+	}
+	UnloadImage(img);
+	fprintf(stderr, "voxels: rebuilt %zu of %d parts, %zu quads, %.2f ms\n",
+		rebuilt, VOXEL_PARTS, quads, (GetTime() - start) * 1000.0);
+}
+
+void
+voxel_layer_texture(struct voxel_layer *l, Texture2D texture)
+{
+	for (size_t j = 0; j < VOXEL_PARTS; j++) {
+		if (l->models[j].meshCount)
+			l->models[j].materials[0].maps[MATERIAL_MAP_DIFFUSE]
+				.texture = texture;
+	}
+}
+
+void
+voxel_layer_free(struct voxel_layer *l)
+{
+	for (size_t j = 0; j < VOXEL_PARTS; j++)
+		UnloadModel(l->models[j]);
+	voxel_mesh_free(&l->mesh);
+	*l = (struct voxel_layer){ 0 };
+}
+
+#endif /* VOXEL_H */